@@ -15,6 +15,7 @@
 #include <QMimeData>
 #include <QMouseEvent>
 #include <QPainter>
+#include <QResizeEvent>
 #include <QScrollBar>
 #include <QtGlobal>
 #include <QVariant>
@@ -215,6 +216,21 @@ void GraphView::applyZoom(qreal factor, const QPoint& anchorPos) {
     const QPointF delta = after - before;
     translate(delta.x(), delta.y());
     emit zoomChanged(static_cast<int>(m_zoom * 100.0));
+    emitVisibleSceneRect();
+}
+
+void GraphView::scrollContentsBy(int dx, int dy) {
+    QGraphicsView::scrollContentsBy(dx, dy);
+    emitVisibleSceneRect();
+}
+
+void GraphView::resizeEvent(QResizeEvent* event) {
+    QGraphicsView::resizeEvent(event);
+    emitVisibleSceneRect();
+}
+
+void GraphView::emitVisibleSceneRect() {
+    emit visibleSceneRectChanged(mapToScene(viewport()->rect()).boundingRect());
 }
 
 void GraphView::dragEnterEvent(QDragEnterEvent* event) {
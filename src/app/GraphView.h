@@ -7,6 +7,7 @@ class QDragEnterEvent;
 class QDragLeaveEvent;
 class QDragMoveEvent;
 class QDropEvent;
+class QResizeEvent;
 
 class GraphView : public QGraphicsView {
     Q_OBJECT
@@ -17,6 +18,8 @@ public:
 signals:
     void paletteItemDropped(const QString& typeName, const QPointF& scenePos);
     void zoomChanged(int percent);
+    // Scene area on screen after a scroll, resize or zoom.
+    void visibleSceneRectChanged(const QRectF& sceneRect);
 
 protected:
     void drawBackground(QPainter* painter, const QRectF& rect) override;
@@ -29,9 +32,12 @@ protected:
     void dragLeaveEvent(QDragLeaveEvent* event) override;
     void dragMoveEvent(QDragMoveEvent* event) override;
     void dropEvent(QDropEvent* event) override;
+    void scrollContentsBy(int dx, int dy) override;
+    void resizeEvent(QResizeEvent* event) override;
 
 private:
     void applyZoom(qreal factor, const QPoint& anchorPos);
+    void emitVisibleSceneRect();
     QPointF effectiveDropPreviewPos() const;
 
     bool m_panning = false;
@@ -3,11 +3,17 @@
 #include "GraphView.h"
 #include "items/EdgeItem.h"
 #include "items/NodeItem.h"
+#include "model/BinaryGraphFormat.h"
+#include "model/BinaryGraphView.h"
+#include "model/ComponentCatalog.h"
+#include "model/GraphJournal.h"
 #include "model/GraphSerializer.h"
+#include "model/NetlistFormats.h"
 #include "panels/LayerPanel.h"
 #include "panels/PalettePanel.h"
 #include "panels/ProjectTreePanel.h"
 #include "panels/PropertyPanel.h"
+#include "panels/SearchPanel.h"
 #include "scene/EditorScene.h"
 
 #include <QAction>
@@ -19,17 +25,20 @@
 #include <QFileInfo>
 #include <QGraphicsScene>
 #include <QGraphicsSimpleTextItem>
+#include <QInputDialog>
 #include <QKeySequence>
 #include <QLabel>
 #include <QMenu>
 #include <QMenuBar>
 #include <QMessageBox>
+#include <QProgressBar>
 #include <QSignalBlocker>
 #include <QSpinBox>
 #include <QStatusBar>
 #include <QStyle>
 #include <QTableWidget>
 #include <QTabWidget>
+#include <QTimer>
 #include <QToolBar>
 #include <QUndoGroup>
 #include <QUndoStack>
@@ -38,6 +47,15 @@
 
 #include <algorithm>
 
+namespace {
+// Journal records are fsynced together at most this long after an edit.
+constexpr int kJournalSyncDelayMs = 1000;
+// Past this size the journal is folded into the base file by a background save.
+constexpr qint64 kJournalCompactionBytes = 8 * 1024 * 1024;
+// Documents this large only get items for the tiles around the viewport.
+constexpr int kLazyLoadNodeThreshold = 20000;
+}  // namespace
+
 MainWindow::MainWindow(QWidget* parent)
     : QMainWindow(parent) {
     setupWindow();
@@ -47,7 +65,10 @@ MainWindow::MainWindow(QWidget* parent)
     setupRightDock();
     setupSignalBindings();
     populateDemoGraph();
-    rebuildProjectTreeNodes();
+}
+
+MainWindow::~MainWindow() {
+    waitForPendingSaves();
 }
 
 int MainWindow::documentCount() const {
@@ -85,6 +106,53 @@ int MainWindow::newDocument(const QString& title) {
     return index;
 }
 
+int MainWindow::importNetlist(const QString& path, bool autoLayout) {
+    if (path.isEmpty()) {
+        return -1;
+    }
+
+    NetlistImportOptions options;
+    options.autoLayout = autoLayout;
+    GraphDocument document;
+    QString error;
+    NetlistImportReport report;
+    if (!NetlistFormats::importFile(path, &document, options, &error, &report)) {
+        showCriticalMessage(QStringLiteral("Import Failed"), error);
+        return -1;
+    }
+    // The tab has no file yet, so the first save asks where to put it.
+    const int index = createEditorTab(QFileInfo(path).completeBaseName(), &document);
+    if (index < 0) {
+        return -1;
+    }
+    setDocumentDirty(index, true);
+    m_editorTabs->setCurrentIndex(index);
+    QString message = QStringLiteral("Imported %1 nodes and %2 edges from %3")
+                          .arg(document.nodes.size())
+                          .arg(document.edges.size())
+                          .arg(path);
+    if (report.skippedSelfLoops > 0 || report.skippedDuplicates > 0) {
+        message += QStringLiteral(" (skipped %1 self-loops and %2 duplicate edges)")
+                       .arg(report.skippedSelfLoops)
+                       .arg(report.skippedDuplicates);
+    }
+    statusBar()->showMessage(message, 4000);
+    return index;
+}
+
+bool MainWindow::exportNetlist(const QString& path) {
+    if (!m_scene || path.isEmpty()) {
+        return false;
+    }
+    QString error;
+    if (!NetlistFormats::exportFile(m_scene->toDocument(), path, &error)) {
+        showCriticalMessage(QStringLiteral("Export Failed"), error);
+        return false;
+    }
+    statusBar()->showMessage(QStringLiteral("Exported: %1").arg(path), 2500);
+    return true;
+}
+
 bool MainWindow::openDocumentByDialog() {
     const QString path = requestOpenFilePath();
     if (path.isEmpty()) {
@@ -98,30 +166,65 @@ bool MainWindow::openDocumentFromPath(const QString& path) {
         return false;
     }
 
-    GraphDocument document;
+    const QString title = QFileInfo(path).fileName();
     QString error;
-    if (!GraphSerializer::loadFromFile(&document, path, &error)) {
-        showCriticalMessage(QStringLiteral("Open Failed"), error);
-        return false;
+    int index = -1;
+    int recoveredEdits = 0;
+    std::shared_ptr<ChunkLayout> chunkLayout;
+    // Unsaved edits journaled by a session that did not close cleanly are
+    // replayed on top of the file, which needs a GraphDocument.
+    const bool recover = GraphJournal::hasRecoverableEdits(path);
+    BinaryGraphView binaryView;
+    if (!recover && BinaryGraphFormat::isBinaryPath(path) && binaryView.open(path) &&
+        binaryView.schemaVersion() == GraphSerializer::kCurrentSchemaVersion) {
+        // Current binary files build items from the mapped records without an
+        // intermediate GraphDocument.
+        index = createEditorTab(title, nullptr, path, &binaryView);
+    } else {
+        GraphDocument document;
+        if (!GraphSerializer::loadFromFile(&document, path, &error)) {
+            showCriticalMessage(QStringLiteral("Open Failed"), error);
+            return false;
+        }
+        if (ChunkedGraphFormat::isChunkedPath(path)) {
+            chunkLayout = std::make_shared<ChunkLayout>(document);
+        }
+        if (recover && !GraphJournal::replay(path, &document, &recoveredEdits)) {
+            recoveredEdits = 0;
+        }
+        index = createEditorTab(title, &document, path);
     }
-
-    const QString title = QFileInfo(path).fileName();
-    const int index = createEditorTab(title, &document, path);
     if (index < 0) {
         return false;
     }
 
+    // Later saves of a chunked file only rewrite the tiles edited from here on.
+    m_documents[index].chunkLayout = chunkLayout;
+    m_documents[index].scene->takeUnsavedChanges();
+    openJournal(index);
     m_editorTabs->setCurrentIndex(index);
+    if (recoveredEdits > 0) {
+        // The recovered state exists only in the journal until it is saved,
+        // and no undo step describes it.
+        m_documents[index].scene->requireFullSave();
+        if (m_documents[index].undoStack) {
+            m_documents[index].undoStack->resetClean();
+        }
+        setDocumentDirty(index, true);
+        statusBar()->showMessage(QStringLiteral("Opened: %1 (recovered %2 unsaved edits)").arg(path).arg(recoveredEdits),
+                                 5000);
+        return true;
+    }
     statusBar()->showMessage(QStringLiteral("Opened: %1").arg(path), 2500);
     return true;
 }
 
-bool MainWindow::saveCurrentDocument(bool saveAs) {
+bool MainWindow::saveCurrentDocument(bool saveAs, SaveMode mode) {
     const int index = currentDocumentIndex();
     if (index < 0) {
         return false;
     }
-    return saveDocument(index, saveAs);
+    return saveDocument(index, saveAs, mode);
 }
 
 bool MainWindow::closeDocument(int index) {
@@ -132,6 +235,14 @@ bool MainWindow::closeDocument(int index) {
     return closeDocumentTab(resolvedIndex);
 }
 
+int MainWindow::pendingSaveCount() const {
+    return static_cast<int>(m_pendingSaves.size());
+}
+
+void MainWindow::waitForPendingSaves() {
+    waitForPendingSaves(nullptr);
+}
+
 void MainWindow::setOpenFileDialogProvider(const std::function<QString()>& provider) {
     m_openFileDialogProvider = provider;
 }
@@ -161,6 +272,18 @@ void MainWindow::setupWindow() {
     setWindowTitle(QStringLiteral("EDA Editor Prototype"));
     setDockOptions(QMainWindow::AllowNestedDocks | QMainWindow::AllowTabbedDocks | QMainWindow::AnimatedDocks);
     statusBar()->showMessage(QStringLiteral("Ready"));
+
+    m_saveProgress = new QProgressBar(this);
+    m_saveProgress->setRange(0, 0);
+    m_saveProgress->setTextVisible(false);
+    m_saveProgress->setMaximumWidth(120);
+    m_saveProgress->setVisible(false);
+    statusBar()->addPermanentWidget(m_saveProgress);
+
+    m_journalSyncTimer = new QTimer(this);
+    m_journalSyncTimer->setSingleShot(true);
+    m_journalSyncTimer->setInterval(kJournalSyncDelayMs);
+    connect(m_journalSyncTimer, &QTimer::timeout, this, &MainWindow::syncJournals);
 }
 
 void MainWindow::setupMenusAndToolbar() {
@@ -187,6 +310,9 @@ void MainWindow::setupMenusAndToolbar() {
     m_saveAsAction = projectMenu->addAction(QStringLiteral("Save As"));
     m_saveAsAction->setShortcut(QKeySequence::SaveAs);
 
+    QAction* importNetlistAction = projectMenu->addAction(QStringLiteral("Import Netlist..."));
+    QAction* exportNetlistAction = projectMenu->addAction(QStringLiteral("Export Netlist..."));
+
     QAction* closeTabAction = projectMenu->addAction(QStringLiteral("Close Tab"));
     closeTabAction->setShortcut(QKeySequence::Close);
 
@@ -226,6 +352,20 @@ void MainWindow::setupMenusAndToolbar() {
     sendBackAction->setShortcut(QKeySequence(QStringLiteral("Ctrl+[")));
     QAction* bringForwardAction = editMenu->addAction(QStringLiteral("Bring Forward"));
     QAction* sendBackwardAction = editMenu->addAction(QStringLiteral("Send Backward"));
+    editMenu->addSeparator();
+    QAction* findNodeAction = editMenu->addAction(QStringLiteral("Find Node"));
+    findNodeAction->setShortcut(QKeySequence::Find);
+    QAction* selectFanInAction = editMenu->addAction(QStringLiteral("Select Fan-in Cone"));
+    selectFanInAction->setShortcut(QKeySequence(QStringLiteral("Ctrl+Alt+Left")));
+    QAction* selectFanOutAction = editMenu->addAction(QStringLiteral("Select Fan-out Cone"));
+    selectFanOutAction->setShortcut(QKeySequence(QStringLiteral("Ctrl+Alt+Right")));
+    QAction* selectFanInLimitedAction = editMenu->addAction(QStringLiteral("Select Fan-in Cone (Limited)..."));
+    selectFanInLimitedAction->setShortcut(QKeySequence(QStringLiteral("Ctrl+Alt+Shift+Left")));
+    QAction* selectFanOutLimitedAction = editMenu->addAction(QStringLiteral("Select Fan-out Cone (Limited)..."));
+    selectFanOutLimitedAction->setShortcut(QKeySequence(QStringLiteral("Ctrl+Alt+Shift+Right")));
+    editMenu->addSeparator();
+    m_dagOnlyAction = editMenu->addAction(QStringLiteral("DAG Only"));
+    m_dagOnlyAction->setCheckable(true);
 
     runMenu->addAction(style()->standardIcon(QStyle::SP_MediaPlay), QStringLiteral("Run"));
     runMenu->addAction(style()->standardIcon(QStyle::SP_MediaStop), QStringLiteral("Stop"));
@@ -260,11 +400,19 @@ void MainWindow::setupMenusAndToolbar() {
     });
 
     connect(m_saveAction, &QAction::triggered, this, [this]() {
-        saveCurrentDocument(false);
+        saveCurrentDocument(false, SaveMode::Background);
     });
 
     connect(m_saveAsAction, &QAction::triggered, this, [this]() {
-        saveCurrentDocument(true);
+        saveCurrentDocument(true, SaveMode::Background);
+    });
+
+    connect(importNetlistAction, &QAction::triggered, this, [this]() {
+        importNetlistByDialog();
+    });
+
+    connect(exportNetlistAction, &QAction::triggered, this, [this]() {
+        exportNetlistByDialog();
     });
 
     connect(closeTabAction, &QAction::triggered, this, [this]() {
@@ -277,11 +425,15 @@ void MainWindow::setupMenusAndToolbar() {
             return;
         }
         m_scene->clearGraph();
+        m_scene->requireFullSave();
         if (m_documents[index].undoStack) {
             m_documents[index].undoStack->clear();
         }
+        // Clearing is not undoable, so it is journaled here rather than per command.
+        GraphDelta cleared;
+        cleared.cleared = true;
+        appendJournal(index, cleared);
         setDocumentDirty(index, true);
-        rebuildProjectTreeNodes();
         statusBar()->showMessage(QStringLiteral("Graph cleared"), 2000);
     });
 
@@ -296,7 +448,6 @@ void MainWindow::setupMenusAndToolbar() {
             return;
         }
         if (m_scene->autoLayoutWithUndo(true)) {
-            rebuildProjectTreeNodes();
             statusBar()->showMessage(QStringLiteral("Auto layout applied"), 2000);
             return;
         }
@@ -412,6 +563,81 @@ void MainWindow::setupMenusAndToolbar() {
             statusBar()->showMessage(QStringLiteral("Layer operation skipped"), 1200);
         }
     });
+
+    connect(findNodeAction, &QAction::triggered, this, [this]() {
+        if (!m_searchDock) {
+            return;
+        }
+        m_searchDock->show();
+        m_searchDock->raise();
+        m_searchPanel->focusQuery();
+    });
+
+    // The limited variants ask for a hop budget and a node type to keep.
+    auto selectCone = [this](GraphCsr::Direction direction, bool limited) {
+        if (!m_scene) {
+            return;
+        }
+        int maxHops = -1;
+        QString typeFilter;
+        if (limited) {
+            const QString title =
+                direction == GraphCsr::Direction::FanIn ? QStringLiteral("Fan-in Cone") : QStringLiteral("Fan-out Cone");
+            bool ok = false;
+            const int hops =
+                QInputDialog::getInt(this, title, QStringLiteral("Maximum hops (0 = unlimited):"), 0, 0, 1000000, 1, &ok);
+            if (!ok) {
+                return;
+            }
+            maxHops = hops > 0 ? hops : -1;
+
+            QStringList types{QStringLiteral("(any type)")};
+            const ComponentCatalog& catalog = ComponentCatalog::instance();
+            for (const QString& category : catalog.categories()) {
+                types += catalog.typesInCategory(category);
+            }
+            const QString type = QInputDialog::getItem(this, title, QStringLiteral("Node type:"), types, 0, true, &ok);
+            if (!ok) {
+                return;
+            }
+            if (type != types.first()) {
+                typeFilter = type.trimmed();
+            }
+        }
+        const int count = m_scene->selectConeFromSelection(direction, maxHops, typeFilter);
+        statusBar()->showMessage(QStringLiteral("Cone: %1 node(s)").arg(count), 2000);
+    };
+    connect(selectFanInAction, &QAction::triggered, this, [selectCone]() {
+        selectCone(GraphCsr::Direction::FanIn, false);
+    });
+    connect(selectFanOutAction, &QAction::triggered, this, [selectCone]() {
+        selectCone(GraphCsr::Direction::FanOut, false);
+    });
+    connect(selectFanInLimitedAction, &QAction::triggered, this, [selectCone]() {
+        selectCone(GraphCsr::Direction::FanIn, true);
+    });
+    connect(selectFanOutLimitedAction, &QAction::triggered, this, [selectCone]() {
+        selectCone(GraphCsr::Direction::FanOut, true);
+    });
+
+    connect(editMenu, &QMenu::aboutToShow, this, [this]() {
+        m_dagOnlyAction->setEnabled(m_scene != nullptr);
+        m_dagOnlyAction->setChecked(m_scene && m_scene->dagEnforced());
+    });
+
+    connect(m_dagOnlyAction, &QAction::triggered, this, [this](bool checked) {
+        if (!m_scene) {
+            return;
+        }
+        if (m_scene->setDagEnforced(checked)) {
+            statusBar()->showMessage(checked ? QStringLiteral("DAG enforcement enabled")
+                                             : QStringLiteral("DAG enforcement disabled"),
+                                     1200);
+            return;
+        }
+        m_dagOnlyAction->setChecked(false);
+        statusBar()->showMessage(QStringLiteral("Graph contains a cycle"), 2000);
+    });
 }
 
 void MainWindow::setupCentralArea() {
@@ -433,6 +659,9 @@ void MainWindow::setupLeftDocks() {
     m_projectDock->setAllowedAreas(Qt::LeftDockWidgetArea | Qt::RightDockWidgetArea);
     m_projectDock->setMinimumWidth(230);
     m_projectPanel = new ProjectTreePanel(m_projectDock);
+    if (m_scene) {
+        m_projectPanel->setScene(m_scene);
+    }
     m_projectDock->setWidget(m_projectPanel);
     addDockWidget(Qt::LeftDockWidgetArea, m_projectDock);
 
@@ -454,13 +683,25 @@ void MainWindow::setupLeftDocks() {
     m_layerDock->setWidget(m_layerPanel);
     addDockWidget(Qt::LeftDockWidgetArea, m_layerDock);
 
+    m_searchDock = new QDockWidget(QStringLiteral("Search"), this);
+    m_searchDock->setAllowedAreas(Qt::LeftDockWidgetArea | Qt::RightDockWidgetArea);
+    m_searchPanel = new SearchPanel(m_searchDock);
+    if (m_scene) {
+        m_searchPanel->setScene(m_scene);
+    }
+    m_searchDock->setWidget(m_searchPanel);
+    addDockWidget(Qt::LeftDockWidgetArea, m_searchDock);
+
     splitDockWidget(m_projectDock, m_propertyDock, Qt::Vertical);
     splitDockWidget(m_propertyDock, m_layerDock, Qt::Vertical);
+    tabifyDockWidget(m_projectDock, m_searchDock);
+    m_projectDock->raise();
     m_layerDock->hide();
 
     m_viewMenu->addAction(m_projectDock->toggleViewAction());
     m_viewMenu->addAction(m_propertyDock->toggleViewAction());
     m_viewMenu->addAction(m_layerDock->toggleViewAction());
+    m_viewMenu->addAction(m_searchDock->toggleViewAction());
 }
 
 void MainWindow::setupRightDock() {
@@ -477,22 +718,17 @@ void MainWindow::setupSignalBindings() {
     connect(m_editorTabs, &QTabWidget::currentChanged, this, &MainWindow::activateEditorTab);
     connect(m_editorTabs, &QTabWidget::tabCloseRequested, this, &MainWindow::closeDocumentTab);
     connect(m_propertyTable, &QTableWidget::cellChanged, this, &MainWindow::onPropertyCellChanged);
-    connect(m_projectPanel, &ProjectTreePanel::nodeSelected, this, [this](const QString& nodeId) {
-        if (!m_scene || nodeId.isEmpty()) {
+    auto focusNode = [this](const QString& nodeId) {
+        NodeItem* node = findNodeById(nodeId);
+        if (!node) {
             return;
         }
-
-        for (QGraphicsItem* sceneItem : m_scene->items()) {
-            if (NodeItem* node = dynamic_cast<NodeItem*>(sceneItem)) {
-                if (node->nodeId() == nodeId) {
-                    m_scene->clearSelection();
-                    node->setSelected(true);
-                    m_graphView->centerOn(node);
-                    break;
-                }
-            }
-        }
-    });
+        m_scene->clearSelection();
+        node->setSelected(true);
+        m_graphView->centerOn(node);
+    };
+    connect(m_projectPanel, &ProjectTreePanel::nodeSelected, this, focusNode);
+    connect(m_searchPanel, &SearchPanel::nodeSelected, this, focusNode);
 }
 
 void MainWindow::populateDemoGraph() {
@@ -539,9 +775,13 @@ void MainWindow::populateDemoGraph() {
     setDocumentDirty(index, false);
 }
 
-int MainWindow::createEditorTab(const QString& title, const GraphDocument* initialDocument, const QString& filePath) {
+int MainWindow::createEditorTab(const QString& title,
+                                const GraphDocument* initialDocument,
+                                const QString& filePath,
+                                const BinaryGraphView* initialView) {
     EditorScene* scene = new EditorScene(this);
     scene->setSceneRect(0, 0, 3600, 2400);
+    scene->setLazyLoadThreshold(kLazyLoadNodeThreshold);
 
     QUndoStack* undoStack = new QUndoStack(this);
     scene->setUndoStack(undoStack);
@@ -549,7 +789,9 @@ int MainWindow::createEditorTab(const QString& title, const GraphDocument* initi
         m_undoGroup->addStack(undoStack);
     }
 
-    if (initialDocument && !scene->fromDocument(*initialDocument)) {
+    const bool built = initialView ? scene->fromBinaryView(*initialView)
+                                   : (!initialDocument || scene->fromDocument(*initialDocument));
+    if (!built) {
         if (m_undoGroup) {
             m_undoGroup->removeStack(undoStack);
         }
@@ -587,6 +829,7 @@ int MainWindow::createEditorTab(const QString& title, const GraphDocument* initi
         }
     });
 
+    connect(view, &GraphView::visibleSceneRectChanged, scene, &EditorScene::setViewportRect);
     connect(view, &GraphView::zoomChanged, this, [this, view](int percent) {
         if (view == m_graphView) {
             statusBar()->showMessage(QStringLiteral("Zoom: %1%").arg(percent), 1500);
@@ -607,17 +850,27 @@ int MainWindow::createEditorTab(const QString& title, const GraphDocument* initi
                 }
             });
 
+    connect(scene, &EditorScene::dagEnforcedChanged, this, [this, scene](bool enforced) {
+        if (scene != m_scene || !m_dagOnlyAction) {
+            return;
+        }
+        // The toggle itself already updated the action; only a change the user
+        // did not ask for (a restored edge closing a cycle) needs reporting.
+        if (!enforced && m_dagOnlyAction->isChecked()) {
+            statusBar()->showMessage(QStringLiteral("DAG enforcement disabled: the graph contains a cycle"), 3000);
+        }
+        m_dagOnlyAction->setChecked(enforced);
+    });
+
     connect(scene, &EditorScene::graphChanged, this, [this, scene]() {
         const int i = documentIndexForScene(scene);
         if (i < 0) {
             return;
         }
+        ++m_documents[i].editGeneration;
         if (!m_documents[i].suppressDirtyTracking) {
             setDocumentDirty(i, true);
         }
-        if (scene == m_scene) {
-            rebuildProjectTreeNodes();
-        }
     });
 
     connect(undoStack, &QUndoStack::cleanChanged, this, [this, undoStack](bool clean) {
@@ -628,6 +881,13 @@ int MainWindow::createEditorTab(const QString& title, const GraphDocument* initi
         setDocumentDirty(i, !clean);
     });
 
+    connect(scene, &EditorScene::editCommitted, this, [this, scene](const GraphChangeSet& changes) {
+        const int i = documentIndexForScene(scene);
+        if (i >= 0 && m_documents[i].journal) {
+            appendJournal(i, scene->deltaFor(changes));
+        }
+    });
+
     return index;
 }
 
@@ -641,9 +901,15 @@ void MainWindow::activateEditorTab(int index) {
         if (m_propertyTable) {
             updatePropertyTable(QString(), QString(), QString(), QPointF(), 0, 0);
         }
+        if (m_projectPanel) {
+            m_projectPanel->setScene(nullptr);
+        }
         if (m_layerPanel) {
             m_layerPanel->setScene(nullptr);
         }
+        if (m_searchPanel) {
+            m_searchPanel->setScene(nullptr);
+        }
         return;
     }
 
@@ -653,7 +919,7 @@ void MainWindow::activateEditorTab(int index) {
         m_undoGroup->setActiveStack(m_documents[index].undoStack);
     }
     if (m_projectPanel) {
-        rebuildProjectTreeNodes();
+        m_projectPanel->setScene(m_scene);
     }
     if (m_propertyTable) {
         updatePropertyTable(QString(), QString(), QString(), QPointF(), 0, 0);
@@ -661,6 +927,12 @@ void MainWindow::activateEditorTab(int index) {
     if (m_layerPanel) {
         m_layerPanel->setScene(m_scene);
     }
+    if (m_searchPanel) {
+        m_searchPanel->setScene(m_scene);
+    }
+    if (m_dagOnlyAction) {
+        m_dagOnlyAction->setChecked(m_scene->dagEnforced());
+    }
     statusBar()->showMessage(QStringLiteral("Active tab: %1").arg(m_documents[index].title), 1200);
 }
 
@@ -697,7 +969,11 @@ QString MainWindow::requestOpenFilePath() const {
         return m_openFileDialogProvider();
     }
     return QFileDialog::getOpenFileName(
-        const_cast<MainWindow*>(this), QStringLiteral("Open Graph"), QString(), QStringLiteral("EDA Graph (*.json)"));
+        const_cast<MainWindow*>(this),
+        QStringLiteral("Open Graph"),
+        QString(),
+        QStringLiteral("EDA Graph (*.json *.edab *.edac *.edaz);;EDA Graph JSON (*.json);;EDA Binary Graph (*.edab);;"
+                       "EDA Chunked Graph (*.edac);;EDA Compressed Graph (*.edaz)"));
 }
 
 QString MainWindow::requestSaveFilePath(const QString& suggested) const {
@@ -705,7 +981,46 @@ QString MainWindow::requestSaveFilePath(const QString& suggested) const {
         return m_saveFileDialogProvider(suggested);
     }
     return QFileDialog::getSaveFileName(
-        const_cast<MainWindow*>(this), QStringLiteral("Save Graph"), suggested, QStringLiteral("EDA Graph (*.json)"));
+        const_cast<MainWindow*>(this),
+        QStringLiteral("Save Graph"),
+        suggested,
+        QStringLiteral("EDA Graph JSON (*.json);;EDA Binary Graph (*.edab);;EDA Chunked Graph (*.edac);;"
+                       "EDA Compressed Graph (*.edaz)"));
+}
+
+void MainWindow::importNetlistByDialog() {
+    const QString path = QFileDialog::getOpenFileName(
+        this,
+        QStringLiteral("Import Netlist"),
+        QString(),
+        QStringLiteral("Netlists (*.csv *.graphml *.dot *.gv);;CSV Edge List (*.csv);;GraphML (*.graphml);;"
+                       "Graphviz DOT (*.dot *.gv)"));
+    if (path.isEmpty()) {
+        return;
+    }
+    const QMessageBox::StandardButton layout =
+        QMessageBox::question(this,
+                              QStringLiteral("Import Netlist"),
+                              QStringLiteral("Arrange the imported nodes in layers along the edges?
+"
+                                             "Otherwise positions from the file are kept."),
+                              QMessageBox::Yes | QMessageBox::No,
+                              QMessageBox::No);
+    importNetlist(path, layout == QMessageBox::Yes);
+}
+
+void MainWindow::exportNetlistByDialog() {
+    if (!m_scene) {
+        return;
+    }
+    const QString path = QFileDialog::getSaveFileName(
+        this,
+        QStringLiteral("Export Netlist"),
+        QString(),
+        QStringLiteral("CSV Edge List (*.csv);;GraphML (*.graphml);;Graphviz DOT (*.dot *.gv)"));
+    if (!path.isEmpty()) {
+        exportNetlist(path);
+    }
 }
 
 QMessageBox::StandardButton MainWindow::requestUnsavedDecision(const QString& docTitle) const {
@@ -727,7 +1042,7 @@ void MainWindow::showCriticalMessage(const QString& title, const QString& text)
     QMessageBox::critical(const_cast<MainWindow*>(this), title, text);
 }
 
-bool MainWindow::saveDocument(int index, bool saveAs) {
+bool MainWindow::saveDocument(int index, bool saveAs, SaveMode mode) {
     if (index < 0 || index >= m_documents.size()) {
         return false;
     }
@@ -744,29 +1059,189 @@ bool MainWindow::saveDocument(int index, bool saveAs) {
         return false;
     }
 
-    QString error;
-    const GraphDocument document = doc.scene->toDocument();
-    if (!GraphSerializer::saveToFile(document, path, &error)) {
-        showCriticalMessage(QStringLiteral("Save Failed"), error);
+    // Saves of one document must land in order, otherwise an older snapshot
+    // could replace a newer file.
+    waitForPendingSaves(doc.scene);
+
+    // The snapshot is a plain value whose strings are implicitly shared with
+    // the scene, so taking it is one pass over the items without deep copies.
+    // Serializing and writing it is left to a worker thread.
+    auto pending = std::make_unique<PendingSave>();
+    pending->id = m_nextSaveId++;
+    pending->scene = doc.scene;
+    pending->path = path;
+    pending->editGeneration = doc.editGeneration;
+    pending->journalOffset = doc.journal ? doc.journal->size() : -1;
+    pending->fullSaveRequired = doc.scene->fullSaveRequired();
+    pending->changes = doc.scene->takeUnsavedChanges();
+    // A chunked file already on disk only needs the tiles the edits touched:
+    // where the entities were at the last save and where they are now.
+    pending->incremental = !pending->fullSaveRequired && doc.chunkLayout && path == doc.filePath &&
+                           ChunkedGraphFormat::isChunkedPath(path) && QFileInfo::exists(path);
+    const quint64 id = pending->id;
+    std::function<SaveOutcome()> write;
+    if (pending->incremental) {
+        QSet<quint64> tiles = doc.chunkLayout->tilesOf(pending->changes);
+        tiles.unite(doc.scene->chunkTilesOf(pending->changes));
+        pending->tiles = doc.scene->chunkTileContents(tiles);
+        write = [path, settings = doc.scene->documentSettings(), tiles = pending->tiles]() {
+            SaveOutcome outcome;
+            outcome.ok = ChunkedGraphFormat::writeTiles(path, settings, tiles, &outcome.error);
+            return outcome;
+        };
+    } else {
+        write = [path, snapshot = doc.scene->toDocument()]() {
+            SaveOutcome outcome;
+            outcome.ok = GraphSerializer::saveToFile(snapshot, path, &outcome.error);
+            if (outcome.ok && ChunkedGraphFormat::isChunkedPath(path)) {
+                outcome.layout = std::make_shared<ChunkLayout>(snapshot);
+            }
+            return outcome;
+        };
+    }
+    pending->outcome = std::async(std::launch::async, [this, id, write = std::move(write)]() {
+        const SaveOutcome outcome = write();
+        QMetaObject::invokeMethod(
+            this, [this, id]() { finishPendingSave(id); }, Qt::QueuedConnection);
+        return outcome;
+    });
+    m_pendingSaves.push_back(std::move(pending));
+    updateSaveProgress();
+    statusBar()->showMessage(QStringLiteral("Saving: %1...").arg(path));
+
+    if (mode == SaveMode::Blocking) {
+        return finishPendingSave(id);
+    }
+    return true;
+}
+
+bool MainWindow::finishPendingSave(quint64 id) {
+    const auto it = std::find_if(m_pendingSaves.begin(), m_pendingSaves.end(), [id](const auto& pending) {
+        return pending->id == id;
+    });
+    if (it == m_pendingSaves.end()) {
+        return false;  // already collected by waitForPendingSaves()
+    }
+    const std::unique_ptr<PendingSave> pending = std::move(*it);
+    m_pendingSaves.erase(it);
+    const SaveOutcome outcome = pending->outcome.get();
+    updateSaveProgress();
+
+    if (!outcome.ok) {
+        // The file still lacks these edits, so the next save must cover them.
+        if (documentIndexForScene(pending->scene) >= 0) {
+            pending->scene->restoreUnsavedChanges(pending->changes, pending->fullSaveRequired);
+        }
+        statusBar()->clearMessage();
+        showCriticalMessage(QStringLiteral("Save Failed"), outcome.error);
         return false;
     }
 
-    doc.filePath = path;
-    doc.title = QFileInfo(path).fileName();
-    setDocumentDirty(index, false);
-    if (doc.undoStack) {
-        doc.undoStack->setClean();
+    const int index = documentIndexForScene(pending->scene);
+    if (index >= 0) {
+        DocumentContext& doc = m_documents[index];
+        doc.filePath = pending->path;
+        doc.title = QFileInfo(pending->path).fileName();
+        // Edits made while the worker was writing are not in the file.
+        if (doc.editGeneration == pending->editGeneration) {
+            setDocumentDirty(index, false);
+            if (doc.undoStack) {
+                doc.undoStack->setClean();
+            }
+        }
+        updateTabTitle(index);
+
+        if (pending->incremental) {
+            doc.chunkLayout->update(pending->tiles, pending->changes);
+        } else {
+            doc.chunkLayout = outcome.layout;
+        }
+
+        // The new base holds every record up to the snapshot; later ones stay.
+        if (doc.journal) {
+            doc.journal->rebase(pending->path, pending->journalOffset);
+        } else {
+            openJournal(index);
+        }
     }
 
-    statusBar()->showMessage(QStringLiteral("Saved: %1").arg(path), 2500);
+    statusBar()->showMessage(QStringLiteral("Saved: %1").arg(pending->path), 2500);
     return true;
 }
 
+void MainWindow::waitForPendingSaves(const EditorScene* scene) {
+    while (true) {
+        const auto it = std::find_if(m_pendingSaves.begin(), m_pendingSaves.end(), [scene](const auto& pending) {
+            return !scene || pending->scene == scene;
+        });
+        if (it == m_pendingSaves.end()) {
+            return;
+        }
+        finishPendingSave((*it)->id);
+    }
+}
+
+void MainWindow::updateSaveProgress() {
+    if (m_saveProgress) {
+        m_saveProgress->setVisible(!m_pendingSaves.empty());
+    }
+}
+
+bool MainWindow::hasPendingSave(const EditorScene* scene) const {
+    return std::any_of(m_pendingSaves.begin(), m_pendingSaves.end(), [scene](const auto& pending) {
+        return pending->scene == scene;
+    });
+}
+
+void MainWindow::openJournal(int index) {
+    if (index < 0 || index >= m_documents.size() || m_documents[index].filePath.isEmpty()) {
+        return;
+    }
+    DocumentContext& doc = m_documents[index];
+    auto journal = std::make_shared<GraphJournal>();
+    QString error;
+    if (!journal->open(doc.filePath, &error)) {
+        statusBar()->showMessage(QStringLiteral("Edit journal unavailable: %1").arg(error), 4000);
+        return;
+    }
+    doc.journal = journal;
+}
+
+void MainWindow::appendJournal(int index, const GraphDelta& delta) {
+    if (index < 0 || index >= m_documents.size()) {
+        return;
+    }
+    DocumentContext& doc = m_documents[index];
+    if (!doc.journal || delta.isEmpty()) {
+        return;
+    }
+    if (!doc.journal->append(delta)) {
+        statusBar()->showMessage(QStringLiteral("Edit journal write failed: %1").arg(doc.journal->errorString()), 4000);
+        return;
+    }
+    if (doc.journal->unsyncedRecords() > 0 && !m_journalSyncTimer->isActive()) {
+        m_journalSyncTimer->start();
+    }
+    if (doc.journal->size() >= kJournalCompactionBytes && !hasPendingSave(doc.scene)) {
+        saveDocument(index, false, SaveMode::Background);
+    }
+}
+
+void MainWindow::syncJournals() {
+    for (const DocumentContext& doc : m_documents) {
+        if (doc.journal) {
+            doc.journal->sync();
+        }
+    }
+}
+
 bool MainWindow::maybeSaveDocument(int index) {
     if (index < 0 || index >= m_documents.size()) {
         return true;
     }
 
+    // A save still in flight decides whether the document is dirty.
+    waitForPendingSaves(m_documents[index].scene);
     const DocumentContext& doc = m_documents[index];
     if (!doc.dirty) {
         return true;
@@ -775,7 +1250,7 @@ bool MainWindow::maybeSaveDocument(int index) {
     const QMessageBox::StandardButton choice = requestUnsavedDecision(doc.title);
 
     if (choice == QMessageBox::Save) {
-        return saveDocument(index, false);
+        return saveDocument(index, false, SaveMode::Blocking);
     }
     if (choice == QMessageBox::Discard) {
         return true;
@@ -797,6 +1272,9 @@ bool MainWindow::closeDocumentTab(int index) {
     m_documents.removeAt(index);
     m_editorTabs->removeTab(index);
 
+    if (doc.journal) {
+        doc.journal->discard();  // saved or deliberately discarded
+    }
     if (m_undoGroup && doc.undoStack) {
         m_undoGroup->removeStack(doc.undoStack);
     }
@@ -1051,7 +1529,7 @@ void MainWindow::updatePropertyTable(const QString& itemType,
                     return;
                 }
                 const PropertyData prop = m_dynamicPropertyRows.value(row);
-                m_scene->setNodePropertyWithUndo(m_selectedItemId, prop.key, text);
+                applyNodePropertyEdit(prop.key, text);
             });
         } else if (prop.type == QStringLiteral("int")) {
             auto* spin = new QSpinBox(m_propertyTable);
@@ -1063,7 +1541,7 @@ void MainWindow::updatePropertyTable(const QString& itemType,
                     return;
                 }
                 const PropertyData prop = m_dynamicPropertyRows.value(row);
-                m_scene->setNodePropertyWithUndo(m_selectedItemId, prop.key, QString::number(v));
+                applyNodePropertyEdit(prop.key, QString::number(v));
             });
         } else if (prop.type == QStringLiteral("double")) {
             auto* spin = new QDoubleSpinBox(m_propertyTable);
@@ -1076,7 +1554,7 @@ void MainWindow::updatePropertyTable(const QString& itemType,
                     return;
                 }
                 const PropertyData prop = m_dynamicPropertyRows.value(row);
-                m_scene->setNodePropertyWithUndo(m_selectedItemId, prop.key, QString::number(v, 'f', 4));
+                applyNodePropertyEdit(prop.key, QString::number(v, 'f', 4));
             });
         } else {
             auto* item = new QTableWidgetItem(prop.value);
@@ -1092,11 +1570,23 @@ void MainWindow::updatePropertyTable(const QString& itemType,
     m_propertyTableUpdating = false;
 }
 
-void MainWindow::rebuildProjectTreeNodes() {
-    if (!m_projectPanel) {
+void MainWindow::applyNodePropertyEdit(const QString& key, const QString& value) {
+    if (!m_scene || m_selectedItemId.isEmpty()) {
+        return;
+    }
+    switch (m_propertyPanel->applyScope()) {
+    case PropertyPanel::ApplyScope::Selection:
+        m_scene->setSelectionPropertyWithUndo(key, value);
         return;
+    case PropertyPanel::ApplyScope::SameType:
+        if (const NodeItem* node = findNodeById(m_selectedItemId)) {
+            m_scene->setTypePropertyWithUndo(node->typeName(), key, value);
+        }
+        return;
+    case PropertyPanel::ApplyScope::Node:
+        break;
     }
-    m_projectPanel->rebuildFromScene(m_scene);
+    m_scene->setNodePropertyWithUndo(m_selectedItemId, key, value);
 }
 
 void MainWindow::onPropertyCellChanged(int row, int column) {
@@ -1111,7 +1601,7 @@ void MainWindow::onPropertyCellChanged(int row, int column) {
     if (m_dynamicPropertyRows.contains(row)) {
         const PropertyData prop = m_dynamicPropertyRows.value(row);
         if (prop.type == QStringLiteral("string") && valueItem) {
-            m_scene->setNodePropertyWithUndo(m_selectedItemId, prop.key, valueItem->text().trimmed());
+            applyNodePropertyEdit(prop.key, valueItem->text().trimmed());
         }
         return;
     }
@@ -1122,9 +1612,7 @@ void MainWindow::onPropertyCellChanged(int row, int column) {
     const QString value = valueItem->text().trimmed();
 
     if (row == 2) {
-        if (m_scene->renameNodeWithUndo(m_selectedItemId, value)) {
-            rebuildProjectTreeNodes();
-        }
+        m_scene->renameNodeWithUndo(m_selectedItemId, value);
         return;
     }
 
@@ -1143,14 +1631,7 @@ NodeItem* MainWindow::findNodeById(const QString& nodeId) const {
     if (!m_scene || nodeId.isEmpty()) {
         return nullptr;
     }
-    for (QGraphicsItem* item : m_scene->items()) {
-        if (NodeItem* node = dynamic_cast<NodeItem*>(item)) {
-            if (node->nodeId() == nodeId) {
-                return node;
-            }
-        }
-    }
-    return nullptr;
+    return m_scene->loadNode(nodeId);
 }
 
 void MainWindow::closeEvent(QCloseEvent* event) {
@@ -1160,5 +1641,11 @@ void MainWindow::closeEvent(QCloseEvent* event) {
             return;
         }
     }
+    waitForPendingSaves();
+    for (const DocumentContext& doc : m_documents) {
+        if (doc.journal) {
+            doc.journal->discard();
+        }
+    }
     event->accept();
 }
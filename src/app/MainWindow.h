@@ -1,6 +1,8 @@
 #pragma once
 
+#include "model/ChunkedGraphFormat.h"
 #include "model/GraphDocument.h"
+#include "model/GraphJournal.h"
 
 #include <QMainWindow>
 #include <QHash>
@@ -10,14 +12,20 @@
 #include <QVector>
 
 #include <functional>
+#include <future>
+#include <memory>
+#include <vector>
 
+class BinaryGraphView;
 class EditorScene;
 class GraphView;
 class QDockWidget;
 class QMenu;
+class QProgressBar;
 class QAction;
 class QTableWidget;
 class QTabWidget;
+class QTimer;
 class QUndoStack;
 class QUndoGroup;
 class QCloseEvent;
@@ -26,12 +34,21 @@ class ProjectTreePanel;
 class PropertyPanel;
 class PalettePanel;
 class LayerPanel;
+class SearchPanel;
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
 
 public:
+    // Background saves finish on a worker thread; Blocking waits for the
+    // result before returning.
+    enum class SaveMode {
+        Blocking,
+        Background
+    };
+
     explicit MainWindow(QWidget* parent = nullptr);
+    ~MainWindow() override;
 
     // Automation/test helpers
     int documentCount() const;
@@ -43,8 +60,13 @@ public:
     int newDocument(const QString& title = QString());
     bool openDocumentByDialog();
     bool openDocumentFromPath(const QString& path);
-    bool saveCurrentDocument(bool saveAs = false);
+    bool saveCurrentDocument(bool saveAs = false, SaveMode mode = SaveMode::Blocking);
+    // Opens a CSV, GraphML or DOT netlist as a new unsaved tab.
+    int importNetlist(const QString& path, bool autoLayout = false);
+    bool exportNetlist(const QString& path);
     bool closeDocument(int index = -1);
+    int pendingSaveCount() const;
+    void waitForPendingSaves();
 
     void setOpenFileDialogProvider(const std::function<QString()>& provider);
     void setSaveFileDialogProvider(const std::function<QString(const QString& suggested)>& provider);
@@ -61,6 +83,33 @@ private:
         QString filePath;
         bool dirty = false;
         bool suppressDirtyTracking = false;
+        quint64 editGeneration = 0;
+        // Edit journal next to filePath; shared because contexts are copied.
+        std::shared_ptr<GraphJournal> journal;
+        // Where each entity sits in filePath when that is a chunked file.
+        std::shared_ptr<ChunkLayout> chunkLayout;
+    };
+
+    struct SaveOutcome {
+        bool ok = false;
+        QString error;
+        std::shared_ptr<ChunkLayout> layout;  // full saves of chunked files
+    };
+
+    // A save running on a worker thread. The document is identified by its
+    // scene because tab indices shift while the save is in flight.
+    struct PendingSave {
+        quint64 id = 0;
+        EditorScene* scene = nullptr;
+        QString path;
+        quint64 editGeneration = 0;
+        qint64 journalOffset = -1;  // journal size when the snapshot was taken
+        // Incremental saves rewrite only `tiles`, the footprint of `changes`.
+        bool incremental = false;
+        QHash<quint64, GraphDocument> tiles;
+        GraphChangeSet changes;
+        bool fullSaveRequired = false;  // scene state before the changes were taken
+        std::future<SaveOutcome> outcome;
     };
 
     void setupWindow();
@@ -70,16 +119,28 @@ private:
     void setupRightDock();
     void setupSignalBindings();
     void populateDemoGraph();
-    int createEditorTab(const QString& title, const GraphDocument* initialDocument = nullptr, const QString& filePath = QString());
+    int createEditorTab(const QString& title,
+                        const GraphDocument* initialDocument = nullptr,
+                        const QString& filePath = QString(),
+                        const BinaryGraphView* initialView = nullptr);
     void activateEditorTab(int index);
     int documentIndexForScene(const EditorScene* scene) const;
     int documentIndexForUndoStack(const QUndoStack* stack) const;
     int currentDocumentIndex() const;
     QString requestOpenFilePath() const;
     QString requestSaveFilePath(const QString& suggested) const;
+    void importNetlistByDialog();
+    void exportNetlistByDialog();
     QMessageBox::StandardButton requestUnsavedDecision(const QString& docTitle) const;
     void showCriticalMessage(const QString& title, const QString& text) const;
-    bool saveDocument(int index, bool saveAs);
+    bool saveDocument(int index, bool saveAs, SaveMode mode);
+    bool finishPendingSave(quint64 id);
+    void waitForPendingSaves(const EditorScene* scene);
+    void updateSaveProgress();
+    bool hasPendingSave(const EditorScene* scene) const;
+    void openJournal(int index);
+    void appendJournal(int index, const GraphDelta& delta);
+    void syncJournals();
     bool maybeSaveDocument(int index);
     bool closeDocumentTab(int index);
     void setDocumentDirty(int index, bool dirty);
@@ -90,8 +151,8 @@ private:
                              const QPointF& pos,
                              int inputCount,
                              int outputCount);
-    void rebuildProjectTreeNodes();
     void onPropertyCellChanged(int row, int column);
+    void applyNodePropertyEdit(const QString& key, const QString& value);
     NodeItem* findNodeById(const QString& nodeId) const;
     void closeEvent(QCloseEvent* event) override;
 
@@ -105,20 +166,27 @@ private:
     QDockWidget* m_propertyDock = nullptr;
     QDockWidget* m_paletteDock = nullptr;
     QDockWidget* m_layerDock = nullptr;
+    QDockWidget* m_searchDock = nullptr;
 
     ProjectTreePanel* m_projectPanel = nullptr;
     PropertyPanel* m_propertyPanel = nullptr;
     PalettePanel* m_palettePanel = nullptr;
     LayerPanel* m_layerPanel = nullptr;
+    SearchPanel* m_searchPanel = nullptr;
     QUndoGroup* m_undoGroup = nullptr;
     QAction* m_saveAction = nullptr;
     QAction* m_saveAsAction = nullptr;
+    QAction* m_dagOnlyAction = nullptr;
     QString m_selectedItemType;
     QString m_selectedItemId;
     QHash<int, PropertyData> m_dynamicPropertyRows;
     bool m_propertyTableUpdating = false;
     int m_untitledCounter = 1;
     QVector<DocumentContext> m_documents;
+    std::vector<std::unique_ptr<PendingSave>> m_pendingSaves;
+    quint64 m_nextSaveId = 1;
+    QProgressBar* m_saveProgress = nullptr;
+    QTimer* m_journalSyncTimer = nullptr;
 
     std::function<QString()> m_openFileDialogProvider;
     std::function<QString(const QString& suggested)> m_saveFileDialogProvider;
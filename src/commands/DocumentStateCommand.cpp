@@ -49,5 +49,14 @@ bool DocumentStateCommand::mergeWith(const QUndoCommand* other) {
         return false;
     }
     m_after = rhs->m_after;
+    m_changesKnown = false;
     return true;
 }
+
+void DocumentStateCommand::collectChanges(GraphChangeSet* changes) const {
+    if (!m_changesKnown) {
+        m_changes = GraphChangeSet::between(m_before, m_after);
+        m_changesKnown = true;
+    }
+    changes->unite(m_changes);
+}
@@ -1,12 +1,14 @@
 #pragma once
 
+#include "JournaledCommand.h"
 #include "model/GraphDocument.h"
+#include "model/GraphJournal.h"
 
 #include <QUndoCommand>
 
 class EditorScene;
 
-class DocumentStateCommand : public QUndoCommand {
+class DocumentStateCommand : public QUndoCommand, public JournaledCommand {
 public:
     DocumentStateCommand(EditorScene* scene,
                          const GraphDocument& before,
@@ -18,6 +20,7 @@ public:
 
     void undo() override;
     void redo() override;
+    void collectChanges(GraphChangeSet* changes) const override;
     int id() const override;
     bool mergeWith(const QUndoCommand* other) override;
 
@@ -28,4 +31,7 @@ private:
     bool m_alreadyApplied = true;
     bool m_firstRedo = true;
     QString m_mergeKey;
+    // Diffing the two documents is linear in their size; done once per state.
+    mutable GraphChangeSet m_changes;
+    mutable bool m_changesKnown = false;
 };
@@ -0,0 +1,98 @@
+#include "GraphEditCommands.h"
+
+#include "model/GraphJournal.h"
+#include "scene/EditorScene.h"
+
+ConnectEdgesCommand::ConnectEdgesCommand(EditorScene* scene,
+                                         const QVector<EdgeData>& edges,
+                                         bool alreadyApplied,
+                                         QUndoCommand* parent)
+    : QUndoCommand(QStringLiteral("Connect"), parent),
+      m_scene(scene),
+      m_edges(edges),
+      m_alreadyApplied(alreadyApplied) {}
+
+void ConnectEdgesCommand::undo() {
+    if (!m_scene) {
+        return;
+    }
+    QSet<QString> edgeIds;
+    for (const EdgeData& edge : m_edges) {
+        edgeIds.insert(edge.id);
+    }
+    m_scene->applyDeleteInternal(QSet<QString>(), edgeIds, true);
+}
+
+void ConnectEdgesCommand::redo() {
+    if (m_firstRedo && m_alreadyApplied) {
+        m_firstRedo = false;
+        return;
+    }
+    m_firstRedo = false;
+    if (m_scene) {
+        m_scene->applyRestoreInternal(QVector<NodeData>(), m_edges, QHash<QString, QString>(), QSet<QString>(), true);
+    }
+}
+
+void ConnectEdgesCommand::collectChanges(GraphChangeSet* changes) const {
+    for (const EdgeData& edge : m_edges) {
+        changes->edgeIds.insert(edge.id);
+    }
+}
+
+DeleteItemsCommand::DeleteItemsCommand(EditorScene* scene,
+                                       const QVector<NodeData>& nodes,
+                                       const QVector<EdgeData>& edges,
+                                       const QHash<QString, QString>& survivorGroupIds,
+                                       const QSet<QString>& collapsedGroupIds,
+                                       bool alreadyApplied,
+                                       QUndoCommand* parent)
+    : QUndoCommand(QStringLiteral("Delete"), parent),
+      m_scene(scene),
+      m_nodes(nodes),
+      m_edges(edges),
+      m_survivorGroupIds(survivorGroupIds),
+      m_collapsedGroupIds(collapsedGroupIds),
+      m_alreadyApplied(alreadyApplied) {}
+
+void DeleteItemsCommand::undo() {
+    if (m_scene) {
+        m_scene->applyRestoreInternal(m_nodes, m_edges, m_survivorGroupIds, m_collapsedGroupIds, true);
+    }
+}
+
+void DeleteItemsCommand::redo() {
+    if (m_firstRedo && m_alreadyApplied) {
+        m_firstRedo = false;
+        return;
+    }
+    m_firstRedo = false;
+    if (!m_scene) {
+        return;
+    }
+    QSet<QString> nodeIds;
+    for (const NodeData& node : m_nodes) {
+        nodeIds.insert(node.id);
+    }
+    QSet<QString> edgeIds;
+    for (const EdgeData& edge : m_edges) {
+        edgeIds.insert(edge.id);
+    }
+    m_scene->applyDeleteInternal(nodeIds, edgeIds, true);
+}
+
+void DeleteItemsCommand::collectChanges(GraphChangeSet* changes) const {
+    for (const NodeData& node : m_nodes) {
+        changes->nodeIds.insert(node.id);
+    }
+    for (const EdgeData& edge : m_edges) {
+        changes->edgeIds.insert(edge.id);
+    }
+    // Nodes left behind in a dissolved group change their group id.
+    for (auto it = m_survivorGroupIds.constBegin(); it != m_survivorGroupIds.constEnd(); ++it) {
+        changes->nodeIds.insert(it.key());
+    }
+    if (!m_collapsedGroupIds.isEmpty()) {
+        changes->settings = true;
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "JournaledCommand.h"
+#include "model/GraphDocument.h"
+
+#include <QUndoCommand>
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+class EditorScene;
+
+class ConnectEdgesCommand : public QUndoCommand, public JournaledCommand {
+public:
+    ConnectEdgesCommand(EditorScene* scene,
+                        const QVector<EdgeData>& edges,
+                        bool alreadyApplied,
+                        QUndoCommand* parent = nullptr);
+
+    void undo() override;
+    void redo() override;
+    void collectChanges(GraphChangeSet* changes) const override;
+
+private:
+    EditorScene* m_scene = nullptr;
+    QVector<EdgeData> m_edges;
+    bool m_alreadyApplied = true;
+    bool m_firstRedo = true;
+};
+
+class DeleteItemsCommand : public QUndoCommand, public JournaledCommand {
+public:
+    DeleteItemsCommand(EditorScene* scene,
+                       const QVector<NodeData>& nodes,
+                       const QVector<EdgeData>& edges,
+                       const QHash<QString, QString>& survivorGroupIds,
+                       const QSet<QString>& collapsedGroupIds,
+                       bool alreadyApplied,
+                       QUndoCommand* parent = nullptr);
+
+    void undo() override;
+    void redo() override;
+    void collectChanges(GraphChangeSet* changes) const override;
+
+private:
+    EditorScene* m_scene = nullptr;
+    QVector<NodeData> m_nodes;
+    QVector<EdgeData> m_edges;
+    QHash<QString, QString> m_survivorGroupIds;
+    QSet<QString> m_collapsedGroupIds;
+    bool m_alreadyApplied = true;
+    bool m_firstRedo = true;
+};
@@ -0,0 +1,12 @@
+#pragma once
+
+struct GraphChangeSet;
+
+// Implemented by undo commands so the edit journal learns which entities a
+// command touched without diffing the whole document. The set is the same
+// whether the command was last applied or undone.
+class JournaledCommand {
+public:
+    virtual ~JournaledCommand() = default;
+    virtual void collectChanges(GraphChangeSet* changes) const = 0;
+};
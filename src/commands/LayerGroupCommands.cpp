@@ -0,0 +1,72 @@
+#include "LayerGroupCommands.h"
+
+#include "model/GraphJournal.h"
+#include "scene/EditorScene.h"
+
+LayerFlagCommand::LayerFlagCommand(EditorScene* scene,
+                                   const QString& layerId,
+                                   LayerFlag flag,
+                                   bool beforeValue,
+                                   bool afterValue,
+                                   bool alreadyApplied,
+                                   QUndoCommand* parent)
+    : QUndoCommand(flag == LayerFlag::Visible ? QStringLiteral("Layer Visibility") : QStringLiteral("Layer Lock"), parent),
+      m_scene(scene),
+      m_layerId(layerId),
+      m_flag(flag),
+      m_beforeValue(beforeValue),
+      m_afterValue(afterValue),
+      m_alreadyApplied(alreadyApplied) {}
+
+void LayerFlagCommand::undo() {
+    if (m_scene) {
+        m_scene->applyLayerFlagInternal(m_layerId, m_flag, m_beforeValue);
+    }
+}
+
+void LayerFlagCommand::redo() {
+    if (m_firstRedo && m_alreadyApplied) {
+        m_firstRedo = false;
+        return;
+    }
+    m_firstRedo = false;
+    if (m_scene) {
+        m_scene->applyLayerFlagInternal(m_layerId, m_flag, m_afterValue);
+    }
+}
+
+void LayerFlagCommand::collectChanges(GraphChangeSet* changes) const {
+    changes->settings = true;
+}
+
+GroupCollapseCommand::GroupCollapseCommand(EditorScene* scene,
+                                           const QSet<QString>& groupIds,
+                                           bool collapsed,
+                                           bool alreadyApplied,
+                                           QUndoCommand* parent)
+    : QUndoCommand(collapsed ? QStringLiteral("Collapse Group") : QStringLiteral("Expand Group"), parent),
+      m_scene(scene),
+      m_groupIds(groupIds),
+      m_collapsed(collapsed),
+      m_alreadyApplied(alreadyApplied) {}
+
+void GroupCollapseCommand::undo() {
+    if (m_scene) {
+        m_scene->applyGroupCollapsedInternal(m_groupIds, !m_collapsed);
+    }
+}
+
+void GroupCollapseCommand::redo() {
+    if (m_firstRedo && m_alreadyApplied) {
+        m_firstRedo = false;
+        return;
+    }
+    m_firstRedo = false;
+    if (m_scene) {
+        m_scene->applyGroupCollapsedInternal(m_groupIds, m_collapsed);
+    }
+}
+
+void GroupCollapseCommand::collectChanges(GraphChangeSet* changes) const {
+    changes->settings = true;
+}
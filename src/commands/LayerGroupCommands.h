@@ -0,0 +1,55 @@
+#pragma once
+
+#include "JournaledCommand.h"
+
+#include <QUndoCommand>
+
+#include <QSet>
+#include <QString>
+
+class EditorScene;
+enum class LayerFlag;
+
+class LayerFlagCommand : public QUndoCommand, public JournaledCommand {
+public:
+    LayerFlagCommand(EditorScene* scene,
+                     const QString& layerId,
+                     LayerFlag flag,
+                     bool beforeValue,
+                     bool afterValue,
+                     bool alreadyApplied,
+                     QUndoCommand* parent = nullptr);
+
+    void undo() override;
+    void redo() override;
+    void collectChanges(GraphChangeSet* changes) const override;
+
+private:
+    EditorScene* m_scene = nullptr;
+    QString m_layerId;
+    LayerFlag m_flag;
+    bool m_beforeValue = false;
+    bool m_afterValue = false;
+    bool m_alreadyApplied = true;
+    bool m_firstRedo = true;
+};
+
+class GroupCollapseCommand : public QUndoCommand, public JournaledCommand {
+public:
+    GroupCollapseCommand(EditorScene* scene,
+                         const QSet<QString>& groupIds,
+                         bool collapsed,
+                         bool alreadyApplied,
+                         QUndoCommand* parent = nullptr);
+
+    void undo() override;
+    void redo() override;
+    void collectChanges(GraphChangeSet* changes) const override;
+
+private:
+    EditorScene* m_scene = nullptr;
+    QSet<QString> m_groupIds;
+    bool m_collapsed = true;
+    bool m_alreadyApplied = true;
+    bool m_firstRedo = true;
+};
@@ -1,5 +1,6 @@
 #include "NodeEditCommands.h"
 
+#include "model/GraphJournal.h"
 #include "scene/EditorScene.h"
 
 namespace {
@@ -38,6 +39,10 @@ void NodeMoveCommand::redo() {
     }
 }
 
+void NodeMoveCommand::collectChanges(GraphChangeSet* changes) const {
+    changes->nodeIds.insert(m_nodeId);
+}
+
 int NodeMoveCommand::id() const {
     return mergeId(QStringLiteral("move:%1").arg(m_nodeId));
 }
@@ -51,6 +56,75 @@ bool NodeMoveCommand::mergeWith(const QUndoCommand* other) {
     return true;
 }
 
+MultiNodeMoveCommand::MultiNodeMoveCommand(EditorScene* scene,
+                                           const QHash<QString, QPointF>& beforeScenePositions,
+                                           const QHash<QString, QPointF>& afterScenePositions,
+                                           bool alreadyApplied,
+                                           QUndoCommand* parent)
+    : QUndoCommand(afterScenePositions.size() == 1 ? QStringLiteral("Move Node") : QStringLiteral("Move Nodes"), parent),
+      m_scene(scene),
+      m_beforeScenePositions(beforeScenePositions),
+      m_afterScenePositions(afterScenePositions),
+      m_alreadyApplied(alreadyApplied) {}
+
+void MultiNodeMoveCommand::undo() {
+    if (m_scene) {
+        m_scene->applyNodeScenePositionsInternal(m_beforeScenePositions, true);
+    }
+}
+
+void MultiNodeMoveCommand::redo() {
+    if (m_firstRedo && m_alreadyApplied) {
+        m_firstRedo = false;
+        return;
+    }
+    m_firstRedo = false;
+    if (m_scene) {
+        m_scene->applyNodeScenePositionsInternal(m_afterScenePositions, true);
+    }
+}
+
+void MultiNodeMoveCommand::collectChanges(GraphChangeSet* changes) const {
+    for (auto it = m_afterScenePositions.constBegin(); it != m_afterScenePositions.constEnd(); ++it) {
+        changes->nodeIds.insert(it.key());
+    }
+}
+
+NodeZOrderCommand::NodeZOrderCommand(EditorScene* scene,
+                                     const QHash<QString, qreal>& beforeZ,
+                                     const QHash<QString, qreal>& afterZ,
+                                     const QString& text,
+                                     bool alreadyApplied,
+                                     QUndoCommand* parent)
+    : QUndoCommand(text, parent),
+      m_scene(scene),
+      m_beforeZ(beforeZ),
+      m_afterZ(afterZ),
+      m_alreadyApplied(alreadyApplied) {}
+
+void NodeZOrderCommand::undo() {
+    if (m_scene) {
+        m_scene->applyNodeZValuesInternal(m_beforeZ, true);
+    }
+}
+
+void NodeZOrderCommand::redo() {
+    if (m_firstRedo && m_alreadyApplied) {
+        m_firstRedo = false;
+        return;
+    }
+    m_firstRedo = false;
+    if (m_scene) {
+        m_scene->applyNodeZValuesInternal(m_afterZ, true);
+    }
+}
+
+void NodeZOrderCommand::collectChanges(GraphChangeSet* changes) const {
+    for (auto it = m_afterZ.constBegin(); it != m_afterZ.constEnd(); ++it) {
+        changes->nodeIds.insert(it.key());
+    }
+}
+
 NodeRenameCommand::NodeRenameCommand(EditorScene* scene,
                                      const QString& nodeId,
                                      const QString& beforeName,
@@ -81,6 +155,10 @@ void NodeRenameCommand::redo() {
     }
 }
 
+void NodeRenameCommand::collectChanges(GraphChangeSet* changes) const {
+    changes->nodeIds.insert(m_nodeId);
+}
+
 int NodeRenameCommand::id() const {
     return mergeId(QStringLiteral("rename:%1").arg(m_nodeId));
 }
@@ -126,6 +204,10 @@ void NodePropertyCommand::redo() {
     }
 }
 
+void NodePropertyCommand::collectChanges(GraphChangeSet* changes) const {
+    changes->nodeIds.insert(m_nodeId);
+}
+
 int NodePropertyCommand::id() const {
     return mergeId(QStringLiteral("prop:%1:%2").arg(m_nodeId, m_key));
 }
@@ -138,3 +220,47 @@ bool NodePropertyCommand::mergeWith(const QUndoCommand* other) {
     m_afterValue = rhs->m_afterValue;
     return true;
 }
+
+MultiNodePropertyCommand::MultiNodePropertyCommand(EditorScene* scene,
+                                                   const QString& key,
+                                                   const QHash<QString, QString>& beforeValues,
+                                                   const QString& afterValue,
+                                                   bool alreadyApplied,
+                                                   QUndoCommand* parent)
+    : QUndoCommand(beforeValues.size() == 1 ? QStringLiteral("Edit Property")
+                                            : QStringLiteral("Edit Property (%1 Nodes)").arg(beforeValues.size()),
+                   parent),
+      m_scene(scene),
+      m_key(key),
+      m_beforeValues(beforeValues),
+      m_afterValue(afterValue),
+      m_alreadyApplied(alreadyApplied) {}
+
+void MultiNodePropertyCommand::undo() {
+    if (m_scene) {
+        m_scene->applyNodePropertyValuesInternal(m_key, m_beforeValues, true);
+    }
+}
+
+void MultiNodePropertyCommand::redo() {
+    if (m_firstRedo && m_alreadyApplied) {
+        m_firstRedo = false;
+        return;
+    }
+    m_firstRedo = false;
+    if (!m_scene) {
+        return;
+    }
+    QHash<QString, QString> afterValues;
+    afterValues.reserve(m_beforeValues.size());
+    for (auto it = m_beforeValues.constBegin(); it != m_beforeValues.constEnd(); ++it) {
+        afterValues.insert(it.key(), m_afterValue);
+    }
+    m_scene->applyNodePropertyValuesInternal(m_key, afterValues, true);
+}
+
+void MultiNodePropertyCommand::collectChanges(GraphChangeSet* changes) const {
+    for (auto it = m_beforeValues.constBegin(); it != m_beforeValues.constEnd(); ++it) {
+        changes->nodeIds.insert(it.key());
+    }
+}
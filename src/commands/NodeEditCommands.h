@@ -1,13 +1,16 @@
 #pragma once
 
+#include "JournaledCommand.h"
+
 #include <QUndoCommand>
 
+#include <QHash>
 #include <QPointF>
 #include <QString>
 
 class EditorScene;
 
-class NodeMoveCommand : public QUndoCommand {
+class NodeMoveCommand : public QUndoCommand, public JournaledCommand {
 public:
     NodeMoveCommand(EditorScene* scene,
                     const QString& nodeId,
@@ -18,6 +21,7 @@ public:
 
     void undo() override;
     void redo() override;
+    void collectChanges(GraphChangeSet* changes) const override;
     int id() const override;
     bool mergeWith(const QUndoCommand* other) override;
 
@@ -30,7 +34,48 @@ private:
     bool m_firstRedo = true;
 };
 
-class NodeRenameCommand : public QUndoCommand {
+class MultiNodeMoveCommand : public QUndoCommand, public JournaledCommand {
+public:
+    MultiNodeMoveCommand(EditorScene* scene,
+                         const QHash<QString, QPointF>& beforeScenePositions,
+                         const QHash<QString, QPointF>& afterScenePositions,
+                         bool alreadyApplied,
+                         QUndoCommand* parent = nullptr);
+
+    void undo() override;
+    void redo() override;
+    void collectChanges(GraphChangeSet* changes) const override;
+
+private:
+    EditorScene* m_scene = nullptr;
+    QHash<QString, QPointF> m_beforeScenePositions;
+    QHash<QString, QPointF> m_afterScenePositions;
+    bool m_alreadyApplied = true;
+    bool m_firstRedo = true;
+};
+
+class NodeZOrderCommand : public QUndoCommand, public JournaledCommand {
+public:
+    NodeZOrderCommand(EditorScene* scene,
+                      const QHash<QString, qreal>& beforeZ,
+                      const QHash<QString, qreal>& afterZ,
+                      const QString& text,
+                      bool alreadyApplied,
+                      QUndoCommand* parent = nullptr);
+
+    void undo() override;
+    void redo() override;
+    void collectChanges(GraphChangeSet* changes) const override;
+
+private:
+    EditorScene* m_scene = nullptr;
+    QHash<QString, qreal> m_beforeZ;
+    QHash<QString, qreal> m_afterZ;
+    bool m_alreadyApplied = true;
+    bool m_firstRedo = true;
+};
+
+class NodeRenameCommand : public QUndoCommand, public JournaledCommand {
 public:
     NodeRenameCommand(EditorScene* scene,
                       const QString& nodeId,
@@ -41,6 +86,7 @@ public:
 
     void undo() override;
     void redo() override;
+    void collectChanges(GraphChangeSet* changes) const override;
     int id() const override;
     bool mergeWith(const QUndoCommand* other) override;
 
@@ -53,7 +99,7 @@ private:
     bool m_firstRedo = true;
 };
 
-class NodePropertyCommand : public QUndoCommand {
+class NodePropertyCommand : public QUndoCommand, public JournaledCommand {
 public:
     NodePropertyCommand(EditorScene* scene,
                         const QString& nodeId,
@@ -65,6 +111,7 @@ public:
 
     void undo() override;
     void redo() override;
+    void collectChanges(GraphChangeSet* changes) const override;
     int id() const override;
     bool mergeWith(const QUndoCommand* other) override;
 
@@ -77,3 +124,25 @@ private:
     bool m_alreadyApplied = true;
     bool m_firstRedo = true;
 };
+
+class MultiNodePropertyCommand : public QUndoCommand, public JournaledCommand {
+public:
+    MultiNodePropertyCommand(EditorScene* scene,
+                             const QString& key,
+                             const QHash<QString, QString>& beforeValues,
+                             const QString& afterValue,
+                             bool alreadyApplied,
+                             QUndoCommand* parent = nullptr);
+
+    void undo() override;
+    void redo() override;
+    void collectChanges(GraphChangeSet* changes) const override;
+
+private:
+    EditorScene* m_scene = nullptr;
+    QString m_key;
+    QHash<QString, QString> m_beforeValues;
+    QString m_afterValue;
+    bool m_alreadyApplied = true;
+    bool m_firstRedo = true;
+};
@@ -72,21 +72,23 @@ struct BundleMetrics {
     int siblingCount = 0;
 };
 
-int layerBucketForNode(const NodeItem* node, bool horizontalDominant) {
-    if (!node) {
-        return 0;
+bool bundleSiblingMatch(EdgeBundleScope scope,
+                        bool horizontalDominant,
+                        const NodeItem* sourceNode,
+                        const NodeItem* targetNode,
+                        const NodeItem* otherSource,
+                        const NodeItem* otherTarget) {
+    if (scope == EdgeBundleScope::PerLayer) {
+        return EdgeItem::bundleLayerBucket(otherSource, horizontalDominant) ==
+                   EdgeItem::bundleLayerBucket(sourceNode, horizontalDominant) &&
+               EdgeItem::bundleLayerBucket(otherTarget, horizontalDominant) ==
+                   EdgeItem::bundleLayerBucket(targetNode, horizontalDominant);
     }
-    constexpr qreal kLayerBucketStep = 180.0;
-    const QPointF center = node->sceneBoundingRect().center();
-    const qreal axis = horizontalDominant ? center.x() : center.y();
-    return static_cast<int>(std::round(axis / kLayerBucketStep));
-}
-
-QString groupKey(const NodeItem* node) {
-    if (!node || node->groupId().isEmpty()) {
-        return QStringLiteral("__ungrouped__");
+    if (scope == EdgeBundleScope::PerGroup) {
+        return EdgeItem::bundleGroupKey(otherSource) == EdgeItem::bundleGroupKey(sourceNode) &&
+               EdgeItem::bundleGroupKey(otherTarget) == EdgeItem::bundleGroupKey(targetNode);
     }
-    return node->groupId();
+    return otherSource->nodeId() == sourceNode->nodeId() && otherTarget->nodeId() == targetNode->nodeId();
 }
 
 BundleMetrics computeBundleMetrics(const EdgeItem* edge) {
@@ -101,21 +103,38 @@ BundleMetrics computeBundleMetrics(const EdgeItem* edge) {
         return metrics;
     }
 
-    QVector<const EdgeItem*> siblings;
-    const QList<QGraphicsItem*> sceneItems = edge->scene()->items();
-    siblings.reserve(sceneItems.size());
     const QPointF from = sourceNode->sceneBoundingRect().center();
     const QPointF to = targetNode->sceneBoundingRect().center();
-    const bool horizontalDominant = std::abs(to.x() - from.x()) >= std::abs(to.y() - from.y());
+    const bool horizontalDominant = EdgeItem::isBundleHorizontal(sourceNode, targetNode);
     const EdgeBundleScope scope = edge->bundleScope();
-    const int sourceLayerBucket = layerBucketForNode(sourceNode, horizontalDominant);
-    const int targetLayerBucket = layerBucketForNode(targetNode, horizontalDominant);
-    const QString sourceGroup = groupKey(sourceNode);
-    const QString targetGroup = groupKey(targetNode);
-
-    for (QGraphicsItem* item : sceneItems) {
-        const EdgeItem* other = dynamic_cast<const EdgeItem*>(item);
-        if (!other || !other->sourcePort() || !other->targetPort()) {
+
+    // Global bundles share the source node, so its output adjacency is enough;
+    // the other scopes ask the scene's bundle index when the node has one.
+    QVector<const EdgeItem*> candidates;
+    const EdgeBundleLookup* lookup = sourceNode->bundleLookup();
+    if (scope == EdgeBundleScope::Global) {
+        for (const PortItem* port : sourceNode->outputPorts()) {
+            for (const EdgeItem* other : port->edges()) {
+                if (other->scene() == edge->scene()) {
+                    candidates.push_back(other);
+                }
+            }
+        }
+    } else if (lookup) {
+        candidates = lookup->bundleCandidates(edge);
+    } else {
+        const QList<QGraphicsItem*> sceneItems = edge->scene()->items();
+        candidates.reserve(sceneItems.size());
+        for (QGraphicsItem* item : sceneItems) {
+            if (const EdgeItem* other = dynamic_cast<const EdgeItem*>(item)) {
+                candidates.push_back(other);
+            }
+        }
+    }
+
+    QVector<const EdgeItem*> siblings;
+    for (const EdgeItem* other : candidates) {
+        if (!other->sourcePort() || !other->targetPort()) {
             continue;
         }
         const NodeItem* otherSource = other->sourcePort()->ownerNode();
@@ -123,16 +142,7 @@ BundleMetrics computeBundleMetrics(const EdgeItem* edge) {
         if (!otherSource || !otherTarget) {
             continue;
         }
-        bool siblingMatch = false;
-        if (scope == EdgeBundleScope::PerLayer) {
-            siblingMatch = layerBucketForNode(otherSource, horizontalDominant) == sourceLayerBucket &&
-                           layerBucketForNode(otherTarget, horizontalDominant) == targetLayerBucket;
-        } else if (scope == EdgeBundleScope::PerGroup) {
-            siblingMatch = groupKey(otherSource) == sourceGroup && groupKey(otherTarget) == targetGroup;
-        } else {
-            siblingMatch = otherSource->nodeId() == sourceNode->nodeId() && otherTarget->nodeId() == targetNode->nodeId();
-        }
-        if (siblingMatch) {
+        if (bundleSiblingMatch(scope, horizontalDominant, sourceNode, targetNode, otherSource, otherTarget)) {
             siblings.push_back(other);
         }
     }
@@ -640,6 +650,44 @@ bool EdgeItem::passthrough() const {
     return m_passthrough;
 }
 
+bool EdgeItem::isBundleSiblingOf(const EdgeItem* other) const {
+    if (!other || !m_sourcePort || !m_targetPort || !other->sourcePort() || !other->targetPort()) {
+        return false;
+    }
+    const NodeItem* sourceNode = m_sourcePort->ownerNode();
+    const NodeItem* targetNode = m_targetPort->ownerNode();
+    const NodeItem* otherSource = other->sourcePort()->ownerNode();
+    const NodeItem* otherTarget = other->targetPort()->ownerNode();
+    if (!sourceNode || !targetNode || !otherSource || !otherTarget) {
+        return false;
+    }
+    return bundleSiblingMatch(
+        m_bundleScope, isBundleHorizontal(sourceNode, targetNode), sourceNode, targetNode, otherSource, otherTarget);
+}
+
+int EdgeItem::bundleLayerBucket(const NodeItem* node, bool horizontalDominant) {
+    if (!node) {
+        return 0;
+    }
+    constexpr qreal kLayerBucketStep = 180.0;
+    const QPointF center = node->sceneBoundingRect().center();
+    const qreal axis = horizontalDominant ? center.x() : center.y();
+    return static_cast<int>(std::round(axis / kLayerBucketStep));
+}
+
+QString EdgeItem::bundleGroupKey(const NodeItem* node) {
+    if (!node || node->groupId().isEmpty()) {
+        return QStringLiteral("__ungrouped__");
+    }
+    return node->groupId();
+}
+
+bool EdgeItem::isBundleHorizontal(const NodeItem* sourceNode, const NodeItem* targetNode) {
+    const QPointF from = sourceNode->sceneBoundingRect().center();
+    const QPointF to = targetNode->sceneBoundingRect().center();
+    return std::abs(to.x() - from.x()) >= std::abs(to.y() - from.y());
+}
+
 void EdgeItem::setTargetPort(PortItem* port) {
     if (m_targetPort == port) {
         return;
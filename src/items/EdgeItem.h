@@ -4,7 +4,10 @@
 #include <QPointF>
 #include <QPointer>
 #include <QString>
+#include <QVector>
 
+class EdgeItem;
+class NodeItem;
 class PortItem;
 
 enum class EdgeRoutingMode {
@@ -28,6 +31,17 @@ enum class EdgeRoutingProfile {
     Dense
 };
 
+// Candidate siblings for PerLayer/PerGroup bundles, so an edge does not have
+// to scan every scene item. Nodes report moves and group changes through it.
+class EdgeBundleLookup {
+public:
+    virtual ~EdgeBundleLookup() = default;
+
+    virtual void nodeChanged(NodeItem* node) = 0;
+    // Superset of the edge's siblings; the caller applies the exact match.
+    virtual QVector<const EdgeItem*> bundleCandidates(const EdgeItem* edge) const = 0;
+};
+
 class EdgeItem : public QGraphicsPathItem {
 public:
     explicit EdgeItem(const QString& edgeId, PortItem* sourcePort, QGraphicsItem* parent = nullptr);
@@ -42,6 +56,12 @@ public:
     EdgeBundleScope bundleScope() const;
     qreal bundleSpacing() const;
     bool passthrough() const;
+    bool isBundleSiblingOf(const EdgeItem* other) const;
+
+    // Keys the PerLayer and PerGroup scopes compare on.
+    static int bundleLayerBucket(const NodeItem* node, bool horizontalDominant);
+    static QString bundleGroupKey(const NodeItem* node);
+    static bool isBundleHorizontal(const NodeItem* sourceNode, const NodeItem* targetNode);
 
     void setTargetPort(PortItem* port);
     void setPreviewEnd(const QPointF& scenePos);
@@ -1,6 +1,7 @@
 #include "NodeItem.h"
 
-#include <QGraphicsSceneMouseEvent>
+#include "EdgeItem.h"
+
 #include <QPainter>
 
 NodeItem::NodeItem(const QString& nodeId,
@@ -70,6 +71,7 @@ void NodeItem::setDisplayName(const QString& name) {
     }
     m_displayName = name;
     update();
+    emit displayNameChanged(this);
 }
 
 const QString& NodeItem::groupId() const {
@@ -77,7 +79,15 @@ const QString& NodeItem::groupId() const {
 }
 
 void NodeItem::setGroupId(const QString& groupId) {
+    if (m_groupId == groupId) {
+        return;
+    }
+    const QString previous = m_groupId;
     m_groupId = groupId;
+    if (m_bundleLookup) {
+        m_bundleLookup->nodeChanged(this);
+    }
+    emit groupIdChanged(this, previous);
 }
 
 const QString& NodeItem::layerId() const {
@@ -85,7 +95,12 @@ const QString& NodeItem::layerId() const {
 }
 
 void NodeItem::setLayerId(const QString& layerId) {
+    if (m_layerId == layerId) {
+        return;
+    }
+    const QString previous = m_layerId;
     m_layerId = layerId;
+    emit layerIdChanged(this, previous);
 }
 
 PortItem* NodeItem::addPort(const QString& portId, const QString& name, PortDirection direction) {
@@ -115,80 +130,71 @@ PortItem* NodeItem::firstOutputPort() const {
     return m_outputPorts.isEmpty() ? nullptr : m_outputPorts.first();
 }
 
-const QVector<PropertyData>& NodeItem::properties() const {
+QVector<PropertyData> NodeItem::properties() const {
+    return m_properties.toPropertyData();
+}
+
+const PropertyStore& NodeItem::propertyStore() const {
     return m_properties;
 }
 
 void NodeItem::setProperties(const QVector<PropertyData>& properties) {
-    m_properties = properties;
+    m_properties.assign(properties);
 }
 
 QString NodeItem::propertyValue(const QString& key) const {
-    for (const PropertyData& p : m_properties) {
-        if (p.key == key) {
-            return p.value;
-        }
-    }
-    return QString();
+    return m_properties.text(key);
 }
 
 QString NodeItem::propertyType(const QString& key) const {
-    for (const PropertyData& p : m_properties) {
-        if (p.key == key) {
-            return p.type;
-        }
-    }
-    return QStringLiteral("string");
+    return m_properties.typeName(key);
 }
 
 bool NodeItem::setPropertyValue(const QString& key, const QString& value) {
-    for (PropertyData& p : m_properties) {
-        if (p.key == key) {
-            if (p.value == value) {
-                return false;
-            }
-            p.value = value;
-            return true;
-        }
-    }
-    return false;
+    return m_properties.setText(key, value);
+}
+
+void NodeItem::setEdgeUpdatesSuspended(bool suspended) {
+    m_edgeUpdatesSuspended = suspended;
+}
+
+EdgeBundleLookup* NodeItem::bundleLookup() const {
+    return m_bundleLookup;
+}
+
+void NodeItem::setBundleLookup(EdgeBundleLookup* lookup) {
+    m_bundleLookup = lookup;
 }
 
 QVariant NodeItem::itemChange(GraphicsItemChange change, const QVariant& value) {
     if (change == QGraphicsItem::ItemPositionHasChanged || change == QGraphicsItem::ItemRotationHasChanged ||
         change == QGraphicsItem::ItemTransformHasChanged || change == QGraphicsItem::ItemScenePositionHasChanged) {
-        for (PortItem* port : m_inputPorts) {
-            if (port) {
-                port->updateConnectedEdges();
-            }
+        // Refiled even while edge updates are suspended, so the batch reroute
+        // that follows sees every node in its new bucket.
+        if (m_bundleLookup) {
+            m_bundleLookup->nodeChanged(this);
         }
-        for (PortItem* port : m_outputPorts) {
-            if (port) {
-                port->updateConnectedEdges();
+        if (!m_edgeUpdatesSuspended) {
+            for (PortItem* port : m_inputPorts) {
+                if (port) {
+                    port->updateConnectedEdges();
+                }
+            }
+            for (PortItem* port : m_outputPorts) {
+                if (port) {
+                    port->updateConnectedEdges();
+                }
             }
         }
         emit nodeMoved(this);
+    } else if (change == QGraphicsItem::ItemZValueChange) {
+        m_previousZ = zValue();
+    } else if (change == QGraphicsItem::ItemZValueHasChanged) {
+        emit zValueChanged(this, m_previousZ);
     }
     return QGraphicsObject::itemChange(change, value);
 }
 
-void NodeItem::mousePressEvent(QGraphicsSceneMouseEvent* event) {
-    if (event->button() == Qt::LeftButton) {
-        m_dragStartPos = pos();
-    }
-    QGraphicsObject::mousePressEvent(event);
-}
-
-void NodeItem::mouseReleaseEvent(QGraphicsSceneMouseEvent* event) {
-    if (event->button() == Qt::LeftButton) {
-        const QPointF endPos = pos();
-        if (m_dragStartPos != endPos) {
-            emit nodeDragFinished(this, m_dragStartPos, endPos);
-        }
-    }
-    QGraphicsObject::mouseReleaseEvent(event);
-}
-
 void NodeItem::layoutPorts() {
     auto layoutSide = [this](const QVector<PortItem*>& ports, qreal xPos) {
         if (ports.isEmpty()) {
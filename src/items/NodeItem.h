@@ -1,6 +1,7 @@
 #pragma once
 
 #include "model/GraphDocument.h"
+#include "model/PropertyStore.h"
 #include "PortItem.h"
 
 #include <QGraphicsObject>
@@ -8,7 +9,7 @@
 #include <QString>
 #include <QVector>
 
-class QGraphicsSceneMouseEvent;
+class EdgeBundleLookup;
 
 class NodeItem : public QGraphicsObject {
     Q_OBJECT
@@ -40,20 +41,25 @@ public:
     PortItem* firstInputPort() const;
     PortItem* firstOutputPort() const;
 
-    const QVector<PropertyData>& properties() const;
+    QVector<PropertyData> properties() const;
+    const PropertyStore& propertyStore() const;
     void setProperties(const QVector<PropertyData>& properties);
     QString propertyValue(const QString& key) const;
     QString propertyType(const QString& key) const;
     bool setPropertyValue(const QString& key, const QString& value);
+    void setEdgeUpdatesSuspended(bool suspended);
+    EdgeBundleLookup* bundleLookup() const;
+    void setBundleLookup(EdgeBundleLookup* lookup);
 
 signals:
     void nodeMoved(NodeItem* node);
-    void nodeDragFinished(NodeItem* node, const QPointF& oldPos, const QPointF& newPos);
+    void displayNameChanged(NodeItem* node);
+    void groupIdChanged(NodeItem* node, const QString& previousGroupId);
+    void layerIdChanged(NodeItem* node, const QString& previousLayerId);
+    void zValueChanged(NodeItem* node, qreal previousZ);
 
 protected:
     QVariant itemChange(GraphicsItemChange change, const QVariant& value) override;
-    void mousePressEvent(QGraphicsSceneMouseEvent* event) override;
-    void mouseReleaseEvent(QGraphicsSceneMouseEvent* event) override;
 
 private:
     void layoutPorts();
@@ -64,8 +70,10 @@ private:
     QSizeF m_size;
     QVector<PortItem*> m_inputPorts;
     QVector<PortItem*> m_outputPorts;
-    QVector<PropertyData> m_properties;
+    PropertyStore m_properties;
     QString m_groupId;
     QString m_layerId;
-    QPointF m_dragStartPos;
+    bool m_edgeUpdatesSuspended = false;
+    EdgeBundleLookup* m_bundleLookup = nullptr;
+    qreal m_previousZ = 0.0;
 };
@@ -58,6 +58,10 @@ NodeItem* PortItem::ownerNode() const {
     return m_ownerNode;
 }
 
+const QList<EdgeItem*>& PortItem::edges() const {
+    return m_edges;
+}
+
 void PortItem::addEdge(EdgeItem* edge) {
     if (!m_edges.contains(edge)) {
         m_edges.append(edge);
@@ -30,6 +30,7 @@ public:
     PortDirection direction() const;
     NodeItem* ownerNode() const;
 
+    const QList<EdgeItem*>& edges() const;
     void addEdge(EdgeItem* edge);
     void removeEdge(EdgeItem* edge);
     void updateConnectedEdges();
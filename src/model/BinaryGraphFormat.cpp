@@ -0,0 +1,259 @@
+#include "BinaryGraphFormat.h"
+
+#include "BinaryGraphView.h"
+
+#include <QFileInfo>
+#include <QHash>
+#include <QPair>
+#include <QtEndian>
+
+#include <cstring>
+
+namespace {
+constexpr int kSectionAlignment = 8;
+
+void storeU16(char* p, quint16 value) {
+    qToLittleEndian(value, p);
+}
+
+void storeU32(char* p, quint32 value) {
+    qToLittleEndian(value, p);
+}
+
+void storeU64(char* p, quint64 value) {
+    qToLittleEndian(value, p);
+}
+
+void storeF64(char* p, double value) {
+    quint64 bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    storeU64(p, bits);
+}
+
+// Deduplicates strings while encoding; index 0 is always the empty string.
+class StringTableBuilder {
+public:
+    StringTableBuilder() {
+        indexOf(QString());
+    }
+
+    quint32 indexOf(const QString& text) {
+        const auto it = m_indexByText.constFind(text);
+        if (it != m_indexByText.constEnd()) {
+            return it.value();
+        }
+        const quint32 index = static_cast<quint32>(m_strings.size());
+        m_indexByText.insert(text, index);
+        m_strings.push_back(text);
+        m_totalUnits += text.size();
+        return index;
+    }
+
+    // u32 count, u32 offsets[count + 1] in UTF-16 units, UTF-16LE data.
+    QByteArray encode() const {
+        const int count = m_strings.size();
+        const qint64 headerBytes = 4 + 4 * (static_cast<qint64>(count) + 1);
+        QByteArray section(static_cast<int>(headerBytes + 2 * m_totalUnits), Qt::Uninitialized);
+        char* p = section.data();
+        storeU32(p, static_cast<quint32>(count));
+        char* offsets = p + 4;
+        char* data = p + headerBytes;
+        quint32 cursor = 0;
+        for (int i = 0; i < count; ++i) {
+            const QString& text = m_strings[i];
+            storeU32(offsets + 4 * i, cursor);
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+            std::memcpy(data + 2 * static_cast<qint64>(cursor), text.constData(), 2 * static_cast<size_t>(text.size()));
+#else
+            for (int c = 0; c < text.size(); ++c) {
+                storeU16(data + 2 * (static_cast<qint64>(cursor) + c), text.at(c).unicode());
+            }
+#endif
+            cursor += static_cast<quint32>(text.size());
+        }
+        storeU32(offsets + 4 * count, cursor);
+        return section;
+    }
+
+private:
+    QHash<QString, quint32> m_indexByText;
+    QVector<QString> m_strings;
+    qint64 m_totalUnits = 0;
+};
+}  // namespace
+
+bool BinaryGraphFormat::isBinaryPath(const QString& filePath) {
+    return QFileInfo(filePath).suffix().compare(QStringLiteral("edab"), Qt::CaseInsensitive) == 0;
+}
+
+bool BinaryGraphFormat::hasMagic(const QByteArray& payload) {
+    return payload.size() >= 4 && qFromLittleEndian<quint32>(payload.constData()) == kMagic;
+}
+
+QByteArray BinaryGraphFormat::encode(const GraphDocument& document) {
+    StringTableBuilder strings;
+    QVector<QPair<quint32, QByteArray>> sections;
+
+    QByteArray settings(kSettingsRecordSize + 4 * document.collapsedGroupIds.size(), '\0');
+    {
+        char* p = settings.data();
+        storeF64(p, document.autoLayoutXSpacing);
+        storeF64(p + 8, document.autoLayoutYSpacing);
+        storeF64(p + 16, document.edgeBundleSpacing);
+        storeU32(p + 24, strings.indexOf(document.autoLayoutMode));
+        storeU32(p + 28, strings.indexOf(document.activeLayerId));
+        storeU32(p + 32, strings.indexOf(document.edgeRoutingProfile));
+        storeU32(p + 36, strings.indexOf(document.edgeBundlePolicy));
+        storeU32(p + 40, strings.indexOf(document.edgeBundleScope));
+        storeU32(p + 44, document.dagOnly ? 1u : 0u);
+        storeU32(p + 48, static_cast<quint32>(document.collapsedGroupIds.size()));
+        char* groups = p + kSettingsRecordSize;
+        for (const QString& groupId : document.collapsedGroupIds) {
+            storeU32(groups, strings.indexOf(groupId));
+            groups += 4;
+        }
+    }
+    sections.push_back(qMakePair(static_cast<quint32>(Settings), settings));
+
+    QByteArray layers(kLayerRecordSize * document.layers.size(), Qt::Uninitialized);
+    {
+        char* p = layers.data();
+        for (const LayerData& layer : document.layers) {
+            storeU32(p, strings.indexOf(layer.id));
+            storeU32(p + 4, strings.indexOf(layer.name));
+            storeU32(p + 8, (layer.visible ? 1u : 0u) | (layer.locked ? 2u : 0u));
+            p += kLayerRecordSize;
+        }
+    }
+    sections.push_back(qMakePair(static_cast<quint32>(Layers), layers));
+
+    int portCount = 0;
+    int propertyCount = 0;
+    for (const NodeData& node : document.nodes) {
+        portCount += node.ports.size();
+        propertyCount += node.properties.size();
+    }
+    QByteArray nodes(kNodeRecordSize * document.nodes.size(), '\0');
+    QByteArray ports(kPortRecordSize * portCount, Qt::Uninitialized);
+    QByteArray properties(kPropertyRecordSize * propertyCount, Qt::Uninitialized);
+    {
+        char* n = nodes.data();
+        char* port = ports.data();
+        char* property = properties.data();
+        quint32 firstPort = 0;
+        quint32 firstProperty = 0;
+        for (const NodeData& node : document.nodes) {
+            storeF64(n, node.position.x());
+            storeF64(n + 8, node.position.y());
+            storeF64(n + 16, node.size.width());
+            storeF64(n + 24, node.size.height());
+            storeF64(n + 32, node.rotationDegrees);
+            storeF64(n + 40, node.z);
+            storeU32(n + 48, strings.indexOf(node.id));
+            storeU32(n + 52, strings.indexOf(node.type));
+            storeU32(n + 56, strings.indexOf(node.name));
+            storeU32(n + 60, strings.indexOf(node.groupId));
+            storeU32(n + 64, strings.indexOf(node.layerId));
+            storeU32(n + 68, firstPort);
+            storeU32(n + 72, static_cast<quint32>(node.ports.size()));
+            storeU32(n + 76, firstProperty);
+            storeU32(n + 80, static_cast<quint32>(node.properties.size()));
+            n += kNodeRecordSize;
+
+            for (const PortData& data : node.ports) {
+                storeU32(port, strings.indexOf(data.id));
+                storeU32(port + 4, strings.indexOf(data.name));
+                storeU32(port + 8, strings.indexOf(data.direction));
+                port += kPortRecordSize;
+            }
+            for (const PropertyData& data : node.properties) {
+                storeU32(property, strings.indexOf(data.key));
+                storeU32(property + 4, strings.indexOf(data.type));
+                storeU32(property + 8, strings.indexOf(data.value));
+                property += kPropertyRecordSize;
+            }
+            firstPort += static_cast<quint32>(node.ports.size());
+            firstProperty += static_cast<quint32>(node.properties.size());
+        }
+    }
+    sections.push_back(qMakePair(static_cast<quint32>(Nodes), nodes));
+    sections.push_back(qMakePair(static_cast<quint32>(Ports), ports));
+    sections.push_back(qMakePair(static_cast<quint32>(Properties), properties));
+
+    QByteArray edges(kEdgeRecordSize * document.edges.size(), Qt::Uninitialized);
+    {
+        char* p = edges.data();
+        for (const EdgeData& edge : document.edges) {
+            storeU32(p, strings.indexOf(edge.id));
+            storeU32(p + 4, strings.indexOf(edge.fromNodeId));
+            storeU32(p + 8, strings.indexOf(edge.fromPortId));
+            storeU32(p + 12, strings.indexOf(edge.toNodeId));
+            storeU32(p + 16, strings.indexOf(edge.toPortId));
+            p += kEdgeRecordSize;
+        }
+    }
+    sections.push_back(qMakePair(static_cast<quint32>(Edges), edges));
+
+    // The string table goes first so a reader can resolve records in one pass.
+    sections.prepend(qMakePair(static_cast<quint32>(Strings), strings.encode()));
+
+    auto aligned = [](qint64 offset) {
+        return (offset + kSectionAlignment - 1) / kSectionAlignment * kSectionAlignment;
+    };
+    qint64 total = aligned(kHeaderSize + kDirectoryEntrySize * static_cast<qint64>(sections.size()));
+    QVector<qint64> offsets;
+    offsets.reserve(sections.size());
+    for (const auto& section : sections) {
+        offsets.push_back(total);
+        total = aligned(total + section.second.size());
+    }
+
+    QByteArray payload(static_cast<int>(total), '\0');
+    char* p = payload.data();
+    storeU32(p, kMagic);
+    storeU16(p + 4, kFormatVersion);
+    storeU16(p + 6, 0);
+    storeU32(p + 8, static_cast<quint32>(document.schemaVersion));
+    storeU32(p + 12, static_cast<quint32>(sections.size()));
+    for (int i = 0; i < sections.size(); ++i) {
+        char* entry = p + kHeaderSize + kDirectoryEntrySize * i;
+        storeU32(entry, sections[i].first);
+        storeU32(entry + 4, 0);
+        storeU64(entry + 8, static_cast<quint64>(offsets[i]));
+        storeU64(entry + 16, static_cast<quint64>(sections[i].second.size()));
+        std::memcpy(p + offsets[i], sections[i].second.constData(), static_cast<size_t>(sections[i].second.size()));
+    }
+    return payload;
+}
+
+bool BinaryGraphFormat::decode(const QByteArray& payload, GraphDocument* document, QString* errorMessage) {
+    if (!document) {
+        if (errorMessage) {
+            *errorMessage = QStringLiteral("Document pointer is null");
+        }
+        return false;
+    }
+    BinaryGraphView view;
+    if (!view.attach(payload, errorMessage)) {
+        return false;
+    }
+
+    *document = view.settings();
+    document->nodes.reserve(view.nodeCount());
+    NodeData node;
+    for (int i = 0; i < view.nodeCount(); ++i) {
+        view.readNode(i, &node);
+        if (!node.id.isEmpty()) {
+            document->nodes.push_back(node);
+        }
+    }
+    document->edges.reserve(view.edgeCount());
+    EdgeData edge;
+    for (int i = 0; i < view.edgeCount(); ++i) {
+        view.readEdge(i, &edge);
+        if (!edge.fromNodeId.isEmpty() && !edge.toNodeId.isEmpty()) {
+            document->edges.push_back(edge);
+        }
+    }
+    return true;
+}
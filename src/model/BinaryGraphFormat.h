@@ -0,0 +1,47 @@
+#pragma once
+
+#include "GraphDocument.h"
+
+#include <QByteArray>
+#include <QString>
+
+// Versioned little-endian `.edab` encoding of a GraphDocument.
+//
+// Layout: a 16-byte header (magic, format version, schema version, section
+// count), a directory of (tag, offset, size) entries, then 8-byte aligned
+// sections. Every string is stored once as UTF-16 in the STRS section and
+// referenced by index from fixed-width layer, node, port, property and edge
+// records. Unknown sections are skipped so newer writers stay readable.
+class BinaryGraphFormat {
+public:
+    static constexpr quint32 kMagic = 0x42414445;  // "EDAB"
+    static constexpr quint16 kFormatVersion = 1;
+    static constexpr int kHeaderSize = 16;
+    static constexpr int kDirectoryEntrySize = 24;
+
+    enum SectionTag : quint32 {
+        Strings = 0x53525453,     // "STRS"
+        Settings = 0x4154454d,    // "META"
+        Layers = 0x5259414c,      // "LAYR"
+        Nodes = 0x45444f4e,       // "NODE"
+        Ports = 0x54524f50,       // "PORT"
+        Properties = 0x504f5250,  // "PROP"
+        Edges = 0x45474445        // "EDGE"
+    };
+
+    // Fixed record sizes in bytes.
+    static constexpr int kSettingsRecordSize = 56;
+    static constexpr int kLayerRecordSize = 12;
+    static constexpr int kNodeRecordSize = 88;
+    static constexpr int kPortRecordSize = 12;
+    static constexpr int kPropertyRecordSize = 12;
+    static constexpr int kEdgeRecordSize = 20;
+
+    static bool isBinaryPath(const QString& filePath);
+    static bool hasMagic(const QByteArray& payload);
+
+    static QByteArray encode(const GraphDocument& document);
+    // Fills the document exactly as stored; schema migration and settings
+    // normalization are left to GraphSerializer.
+    static bool decode(const QByteArray& payload, GraphDocument* document, QString* errorMessage = nullptr);
+};
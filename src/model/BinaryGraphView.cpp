@@ -0,0 +1,428 @@
+#include "BinaryGraphView.h"
+
+#include "BinaryGraphFormat.h"
+#include "StringAtom.h"
+
+#include <QSysInfo>
+#include <QtEndian>
+
+#include <climits>
+#include <cstring>
+
+namespace {
+quint16 loadU16(const char* p) {
+    return qFromLittleEndian<quint16>(p);
+}
+
+quint32 loadU32(const char* p) {
+    return qFromLittleEndian<quint32>(p);
+}
+
+quint64 loadU64(const char* p) {
+    return qFromLittleEndian<quint64>(p);
+}
+
+double loadF64(const char* p) {
+    const quint64 bits = loadU64(p);
+    double value = 0.0;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+bool fail(QString* errorMessage, const QString& message) {
+    if (errorMessage) {
+        *errorMessage = message;
+    }
+    return false;
+}
+
+struct RawSection {
+    const char* data = nullptr;
+    quint64 size = 0;
+    bool present = false;
+};
+}  // namespace
+
+BinaryGraphView::~BinaryGraphView() {
+    close();
+}
+
+bool BinaryGraphView::open(const QString& filePath, QString* errorMessage) {
+    close();
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return fail(errorMessage, QStringLiteral("Cannot open file for read: %1").arg(m_file.errorString()));
+    }
+    const qint64 size = m_file.size();
+    if (size > 0) {
+        m_mapped = m_file.map(0, size);
+        if (!m_mapped) {
+            const QString reason = m_file.errorString();
+            close();
+            return fail(errorMessage, QStringLiteral("Cannot map file: %1").arg(reason));
+        }
+    }
+    if (!parse(reinterpret_cast<const char*>(m_mapped), size, errorMessage)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool BinaryGraphView::attach(const QByteArray& payload, QString* errorMessage) {
+    close();
+    if (!parse(payload.constData(), payload.size(), errorMessage)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void BinaryGraphView::close() {
+    if (m_mapped) {
+        m_file.unmap(m_mapped);
+        m_mapped = nullptr;
+    }
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_base = nullptr;
+    m_stringOffsets = nullptr;
+    m_stringData = nullptr;
+    m_swappedStrings.clear();
+    m_stringCount = 0;
+    m_settings = nullptr;
+    m_collapsedCount = 0;
+    m_layers = Section();
+    m_nodes = Section();
+    m_ports = Section();
+    m_properties = Section();
+    m_edges = Section();
+}
+
+bool BinaryGraphView::isOpen() const {
+    return m_base != nullptr;
+}
+
+bool BinaryGraphView::parse(const char* data, qint64 size, QString* errorMessage) {
+    if (!data || size < BinaryGraphFormat::kHeaderSize || loadU32(data) != BinaryGraphFormat::kMagic) {
+        return fail(errorMessage, QStringLiteral("Binary graph: missing EDAB header"));
+    }
+    const quint64 payloadSize = static_cast<quint64>(size);
+    const quint16 formatVersion = loadU16(data + 4);
+    if (formatVersion == 0 || formatVersion > BinaryGraphFormat::kFormatVersion) {
+        return fail(errorMessage, QStringLiteral("Binary graph: unsupported format version %1").arg(formatVersion));
+    }
+    const quint64 sectionCount = loadU32(data + 12);
+    if (BinaryGraphFormat::kHeaderSize + BinaryGraphFormat::kDirectoryEntrySize * sectionCount > payloadSize) {
+        return fail(errorMessage, QStringLiteral("Binary graph: section directory is truncated"));
+    }
+
+    RawSection strings;
+    RawSection settings;
+    RawSection layers;
+    RawSection nodes;
+    RawSection ports;
+    RawSection properties;
+    RawSection edges;
+    for (quint64 i = 0; i < sectionCount; ++i) {
+        const char* entry = data + BinaryGraphFormat::kHeaderSize + BinaryGraphFormat::kDirectoryEntrySize * i;
+        const quint64 offset = loadU64(entry + 8);
+        const quint64 length = loadU64(entry + 16);
+        if (offset > payloadSize || length > payloadSize - offset) {
+            return fail(errorMessage, QStringLiteral("Binary graph: section %1 lies outside the file").arg(i));
+        }
+        RawSection* target = nullptr;
+        switch (loadU32(entry)) {
+        case BinaryGraphFormat::Strings:
+            target = &strings;
+            break;
+        case BinaryGraphFormat::Settings:
+            target = &settings;
+            break;
+        case BinaryGraphFormat::Layers:
+            target = &layers;
+            break;
+        case BinaryGraphFormat::Nodes:
+            target = &nodes;
+            break;
+        case BinaryGraphFormat::Ports:
+            target = &ports;
+            break;
+        case BinaryGraphFormat::Properties:
+            target = &properties;
+            break;
+        case BinaryGraphFormat::Edges:
+            target = &edges;
+            break;
+        default:
+            break;  // unknown sections are skipped
+        }
+        if (target && !target->present) {
+            *target = RawSection{data + offset, length, true};
+        }
+    }
+    if (!strings.present || !settings.present) {
+        return fail(errorMessage, QStringLiteral("Binary graph: required section missing"));
+    }
+
+    if (strings.size < 8) {
+        return fail(errorMessage, QStringLiteral("Binary graph: string table is truncated"));
+    }
+    const quint64 stringCount = loadU32(strings.data);
+    const quint64 stringHeader = 4 + 4 * (stringCount + 1);
+    if (stringHeader > strings.size) {
+        return fail(errorMessage, QStringLiteral("Binary graph: string table is truncated"));
+    }
+    const char* stringData = strings.data + stringHeader;
+    const bool littleEndianHost = QSysInfo::ByteOrder == QSysInfo::LittleEndian;
+    if (littleEndianHost && reinterpret_cast<quintptr>(stringData) % alignof(QChar) != 0) {
+        return fail(errorMessage, QStringLiteral("Binary graph: string table is misaligned"));
+    }
+    const quint64 stringUnits = (strings.size - stringHeader) / 2;
+    if (!littleEndianHost && stringUnits > static_cast<quint64>(INT_MAX)) {
+        return fail(errorMessage, QStringLiteral("Binary graph: string table is too large"));
+    }
+    quint32 previous = loadU32(strings.data + 4);
+    for (quint64 i = 0; i < stringCount; ++i) {
+        const quint32 end = loadU32(strings.data + 4 + 4 * (i + 1));
+        if (end < previous || end > stringUnits) {
+            return fail(errorMessage, QStringLiteral("Binary graph: string %1 is out of range").arg(i));
+        }
+        previous = end;
+    }
+
+    if (settings.size < static_cast<quint64>(BinaryGraphFormat::kSettingsRecordSize)) {
+        return fail(errorMessage, QStringLiteral("Binary graph: settings record is truncated"));
+    }
+    const quint64 collapsedCount = loadU32(settings.data + 48);
+    if (BinaryGraphFormat::kSettingsRecordSize + 4 * collapsedCount > settings.size) {
+        return fail(errorMessage, QStringLiteral("Binary graph: collapsed group list is truncated"));
+    }
+
+    auto section = [](const RawSection& raw, int recordSize, bool* ok) {
+        const quint64 count = raw.size / static_cast<quint64>(recordSize);
+        if (count > static_cast<quint64>(INT_MAX)) {
+            *ok = false;
+            return Section();
+        }
+        return Section{raw.data, static_cast<int>(count)};
+    };
+    bool countsOk = true;
+    m_base = data;
+    m_stringOffsets = strings.data + 4;
+    if (littleEndianHost) {
+        m_stringData = reinterpret_cast<const QChar*>(stringData);
+    } else {
+        // UTF-16LE text cannot be viewed in place here; keep a host-order copy.
+        m_swappedStrings.resize(static_cast<int>(stringUnits));
+        for (quint64 i = 0; i < stringUnits; ++i) {
+            m_swappedStrings[static_cast<int>(i)] = QChar(loadU16(stringData + 2 * i));
+        }
+        m_stringData = m_swappedStrings.constData();
+    }
+    m_stringCount = static_cast<int>(stringCount);
+    m_settings = settings.data;
+    m_collapsedCount = static_cast<int>(collapsedCount);
+    m_layers = section(layers, BinaryGraphFormat::kLayerRecordSize, &countsOk);
+    m_nodes = section(nodes, BinaryGraphFormat::kNodeRecordSize, &countsOk);
+    m_ports = section(ports, BinaryGraphFormat::kPortRecordSize, &countsOk);
+    m_properties = section(properties, BinaryGraphFormat::kPropertyRecordSize, &countsOk);
+    m_edges = section(edges, BinaryGraphFormat::kEdgeRecordSize, &countsOk);
+    if (!countsOk) {
+        return fail(errorMessage, QStringLiteral("Binary graph: too many records"));
+    }
+
+    const Section settingsRecord{m_settings, 1};
+    const Section collapsedGroups{m_settings + BinaryGraphFormat::kSettingsRecordSize, m_collapsedCount};
+    if (!validateStringIndices(settingsRecord, BinaryGraphFormat::kSettingsRecordSize, 24, 5) ||
+        !validateStringIndices(collapsedGroups, 4, 0, 1) ||
+        !validateStringIndices(m_layers, BinaryGraphFormat::kLayerRecordSize, 0, 2) ||
+        !validateStringIndices(m_nodes, BinaryGraphFormat::kNodeRecordSize, 48, 5) ||
+        !validateStringIndices(m_ports, BinaryGraphFormat::kPortRecordSize, 0, 3) ||
+        !validateStringIndices(m_properties, BinaryGraphFormat::kPropertyRecordSize, 0, 3) ||
+        !validateStringIndices(m_edges, BinaryGraphFormat::kEdgeRecordSize, 0, 5)) {
+        return fail(errorMessage, QStringLiteral("Binary graph: string index out of range"));
+    }
+
+    const char* node = m_nodes.data;
+    for (int i = 0; i < m_nodes.count; ++i, node += BinaryGraphFormat::kNodeRecordSize) {
+        const quint64 firstPort = loadU32(node + 68);
+        const quint64 nodePorts = loadU32(node + 72);
+        const quint64 firstProperty = loadU32(node + 76);
+        const quint64 nodeProperties = loadU32(node + 80);
+        if (firstPort + nodePorts > static_cast<quint64>(m_ports.count) ||
+            firstProperty + nodeProperties > static_cast<quint64>(m_properties.count)) {
+            return fail(errorMessage, QStringLiteral("Binary graph: node %1 references missing records").arg(i));
+        }
+    }
+    return true;
+}
+
+bool BinaryGraphView::validateStringIndices(const Section& section,
+                                            int recordSize,
+                                            int fieldOffset,
+                                            int fieldCount) const {
+    const quint32 limit = static_cast<quint32>(m_stringCount);
+    const char* record = section.data;
+    for (int i = 0; i < section.count; ++i, record += recordSize) {
+        for (int f = 0; f < fieldCount; ++f) {
+            if (loadU32(record + fieldOffset + 4 * f) >= limit) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int BinaryGraphView::schemaVersion() const {
+    return m_base ? static_cast<int>(loadU32(m_base + 8)) : 0;
+}
+
+int BinaryGraphView::stringCount() const {
+    return m_stringCount;
+}
+
+QStringView BinaryGraphView::string(quint32 index) const {
+    if (index >= static_cast<quint32>(m_stringCount)) {
+        return QStringView();
+    }
+    const quint32 begin = loadU32(m_stringOffsets + 4 * static_cast<quint64>(index));
+    const quint32 end = loadU32(m_stringOffsets + 4 * (static_cast<quint64>(index) + 1));
+    return QStringView(m_stringData + begin, static_cast<qsizetype>(end - begin));
+}
+
+int BinaryGraphView::layerCount() const {
+    return m_layers.count;
+}
+
+int BinaryGraphView::nodeCount() const {
+    return m_nodes.count;
+}
+
+int BinaryGraphView::portCount() const {
+    return m_ports.count;
+}
+
+int BinaryGraphView::propertyCount() const {
+    return m_properties.count;
+}
+
+int BinaryGraphView::edgeCount() const {
+    return m_edges.count;
+}
+
+LayerData BinaryGraphView::layer(int index) const {
+    const char* p = m_layers.data + BinaryGraphFormat::kLayerRecordSize * static_cast<qint64>(index);
+    const quint32 flags = loadU32(p + 8);
+    return LayerData{string(loadU32(p)).toString(),
+                     string(loadU32(p + 4)).toString(),
+                     (flags & 1u) != 0,
+                     (flags & 2u) != 0};
+}
+
+NodeRecordView BinaryGraphView::node(int index) const {
+    const char* p = m_nodes.data + BinaryGraphFormat::kNodeRecordSize * static_cast<qint64>(index);
+    NodeRecordView record;
+    record.position = QPointF(loadF64(p), loadF64(p + 8));
+    record.size = QSizeF(loadF64(p + 16), loadF64(p + 24));
+    record.rotationDegrees = loadF64(p + 32);
+    record.z = loadF64(p + 40);
+    record.id = string(loadU32(p + 48));
+    record.type = string(loadU32(p + 52));
+    record.name = string(loadU32(p + 56));
+    record.groupId = string(loadU32(p + 60));
+    record.layerId = string(loadU32(p + 64));
+    record.firstPort = static_cast<int>(loadU32(p + 68));
+    record.portCount = static_cast<int>(loadU32(p + 72));
+    record.firstProperty = static_cast<int>(loadU32(p + 76));
+    record.propertyCount = static_cast<int>(loadU32(p + 80));
+    return record;
+}
+
+PortRecordView BinaryGraphView::port(int index) const {
+    const char* p = m_ports.data + BinaryGraphFormat::kPortRecordSize * static_cast<qint64>(index);
+    return PortRecordView{string(loadU32(p)), string(loadU32(p + 4)), string(loadU32(p + 8))};
+}
+
+PropertyRecordView BinaryGraphView::property(int index) const {
+    const char* p = m_properties.data + BinaryGraphFormat::kPropertyRecordSize * static_cast<qint64>(index);
+    return PropertyRecordView{string(loadU32(p)), string(loadU32(p + 4)), string(loadU32(p + 8))};
+}
+
+EdgeRecordView BinaryGraphView::edge(int index) const {
+    const char* p = m_edges.data + BinaryGraphFormat::kEdgeRecordSize * static_cast<qint64>(index);
+    return EdgeRecordView{string(loadU32(p)),
+                          string(loadU32(p + 4)),
+                          string(loadU32(p + 8)),
+                          string(loadU32(p + 12)),
+                          string(loadU32(p + 16))};
+}
+
+GraphDocument BinaryGraphView::settings() const {
+    GraphDocument document;
+    if (!m_base) {
+        return document;
+    }
+    document.schemaVersion = schemaVersion();
+    document.autoLayoutXSpacing = loadF64(m_settings);
+    document.autoLayoutYSpacing = loadF64(m_settings + 8);
+    document.edgeBundleSpacing = loadF64(m_settings + 16);
+    document.autoLayoutMode = string(loadU32(m_settings + 24)).toString();
+    document.activeLayerId = string(loadU32(m_settings + 28)).toString();
+    document.edgeRoutingProfile = string(loadU32(m_settings + 32)).toString();
+    document.edgeBundlePolicy = string(loadU32(m_settings + 36)).toString();
+    document.edgeBundleScope = string(loadU32(m_settings + 40)).toString();
+    document.dagOnly = (loadU32(m_settings + 44) & 1u) != 0;
+    const char* groups = m_settings + BinaryGraphFormat::kSettingsRecordSize;
+    for (int i = 0; i < m_collapsedCount; ++i) {
+        const QStringView groupId = string(loadU32(groups + 4 * i));
+        if (!groupId.isEmpty()) {
+            document.collapsedGroupIds.push_back(groupId.toString());
+        }
+    }
+    document.layers.reserve(m_layers.count);
+    for (int i = 0; i < m_layers.count; ++i) {
+        document.layers.push_back(layer(i));
+    }
+    return document;
+}
+
+void BinaryGraphView::readNode(int index, NodeData* out) const {
+    const NodeRecordView record = node(index);
+    out->id = record.id.toString();
+    out->type = record.type.toString();
+    out->name = record.name.toString();
+    out->position = record.position;
+    out->size = record.size;
+    out->rotationDegrees = record.rotationDegrees;
+    out->z = record.z;
+    out->groupId = record.groupId.toString();
+    out->layerId = record.layerId.toString();
+
+    out->ports.resize(record.portCount);
+    for (int k = 0; k < record.portCount; ++k) {
+        const PortRecordView portRecord = port(record.firstPort + k);
+        PortData& data = out->ports[k];
+        data.id = portRecord.id.toString();
+        data.name = portRecord.name.toString();
+        data.direction = StringAtom::intern(portRecord.direction.toString());
+    }
+    out->properties.resize(record.propertyCount);
+    for (int k = 0; k < record.propertyCount; ++k) {
+        const PropertyRecordView propertyRecord = property(record.firstProperty + k);
+        PropertyData& data = out->properties[k];
+        data.key = StringAtom::intern(propertyRecord.key.toString());
+        data.type = StringAtom::intern(propertyRecord.type.toString());
+        data.value = propertyRecord.value.toString();
+    }
+}
+
+void BinaryGraphView::readEdge(int index, EdgeData* out) const {
+    const EdgeRecordView record = edge(index);
+    out->id = record.id.toString();
+    out->fromNodeId = record.fromNodeId.toString();
+    out->fromPortId = record.fromPortId.toString();
+    out->toNodeId = record.toNodeId.toString();
+    out->toPortId = record.toPortId.toString();
+}
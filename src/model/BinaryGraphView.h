@@ -0,0 +1,112 @@
+#pragma once
+
+#include "GraphDocument.h"
+
+#include <QByteArray>
+#include <QFile>
+#include <QPointF>
+#include <QSizeF>
+#include <QString>
+#include <QStringView>
+#include <QVector>
+
+struct NodeRecordView {
+    QPointF position;
+    QSizeF size;
+    qreal rotationDegrees = 0.0;
+    qreal z = 1.0;
+    QStringView id;
+    QStringView type;
+    QStringView name;
+    QStringView groupId;
+    QStringView layerId;
+    int firstPort = 0;
+    int portCount = 0;
+    int firstProperty = 0;
+    int propertyCount = 0;
+};
+
+struct PortRecordView {
+    QStringView id;
+    QStringView name;
+    QStringView direction;
+};
+
+struct PropertyRecordView {
+    QStringView key;
+    QStringView type;
+    QStringView value;
+};
+
+struct EdgeRecordView {
+    QStringView id;
+    QStringView fromNodeId;
+    QStringView fromPortId;
+    QStringView toNodeId;
+    QStringView toPortId;
+};
+
+// Read-only view over an `.edab` payload. open() maps the file with
+// QFile::map, so records and strings are read straight from the page cache;
+// attach() does the same over bytes the caller keeps alive. Every offset and
+// string index is validated once up front, after which accessors are plain
+// loads. String views point into the mapping; on a big-endian host the string
+// data is copied once into host order and records are still read in place.
+class BinaryGraphView {
+public:
+    BinaryGraphView() = default;
+    ~BinaryGraphView();
+    BinaryGraphView(const BinaryGraphView&) = delete;
+    BinaryGraphView& operator=(const BinaryGraphView&) = delete;
+
+    bool open(const QString& filePath, QString* errorMessage = nullptr);
+    bool attach(const QByteArray& payload, QString* errorMessage = nullptr);
+    void close();
+    bool isOpen() const;
+
+    int schemaVersion() const;
+    int stringCount() const;
+    QStringView string(quint32 index) const;
+
+    int layerCount() const;
+    int nodeCount() const;
+    int portCount() const;
+    int propertyCount() const;
+    int edgeCount() const;
+
+    LayerData layer(int index) const;
+    NodeRecordView node(int index) const;
+    PortRecordView port(int index) const;
+    PropertyRecordView property(int index) const;
+    EdgeRecordView edge(int index) const;
+
+    // Settings, layers and collapsed groups only; nodes and edges stay empty.
+    GraphDocument settings() const;
+    // Materialize one record, reusing out's storage.
+    void readNode(int index, NodeData* out) const;
+    void readEdge(int index, EdgeData* out) const;
+
+private:
+    struct Section {
+        const char* data = nullptr;
+        int count = 0;
+    };
+
+    bool parse(const char* data, qint64 size, QString* errorMessage);
+    bool validateStringIndices(const Section& section, int recordSize, int fieldOffset, int fieldCount) const;
+
+    QFile m_file;
+    uchar* m_mapped = nullptr;
+    const char* m_base = nullptr;
+    const char* m_stringOffsets = nullptr;
+    const QChar* m_stringData = nullptr;
+    QVector<QChar> m_swappedStrings;
+    int m_stringCount = 0;
+    const char* m_settings = nullptr;
+    int m_collapsedCount = 0;
+    Section m_layers;
+    Section m_nodes;
+    Section m_ports;
+    Section m_properties;
+    Section m_edges;
+};
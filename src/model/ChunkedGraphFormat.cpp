@@ -0,0 +1,469 @@
+#include "ChunkedGraphFormat.h"
+
+#include "BinaryGraphFormat.h"
+#include "Crc32.h"
+#include "FileSync.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtEndian>
+#include <QtMath>
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+constexpr qint64 kChunkAlignment = 8;
+// Files below this size are never compacted; dead chunks cost little there.
+constexpr qint64 kCompactionMinBytes = 1 << 20;
+
+struct ChunkHeader {
+    int schemaVersion = 0;
+    quint32 chunkCount = 0;
+    quint64 tableOffset = 0;
+    quint32 tableCrc = 0;
+};
+
+bool fail(QString* errorMessage, const QString& message) {
+    if (errorMessage) {
+        *errorMessage = message;
+    }
+    return false;
+}
+
+qint64 aligned(qint64 offset) {
+    return (offset + kChunkAlignment - 1) & ~(kChunkAlignment - 1);
+}
+
+int tileCoordinate(qreal value) {
+    const qreal tile = qFloor(value / ChunkedGraphFormat::kTileSize);
+    return static_cast<int>(qBound<qreal>(std::numeric_limits<int>::min(), tile, std::numeric_limits<int>::max()));
+}
+
+QByteArray encodeHeader(const ChunkHeader& header) {
+    QByteArray out(ChunkedGraphFormat::kHeaderSize, '\0');
+    char* p = out.data();
+    qToLittleEndian<quint32>(ChunkedGraphFormat::kMagic, p);
+    qToLittleEndian<quint16>(ChunkedGraphFormat::kFormatVersion, p + 4);
+    qToLittleEndian<qint32>(header.schemaVersion, p + 8);
+    qToLittleEndian<quint32>(header.chunkCount, p + 12);
+    qToLittleEndian<quint64>(header.tableOffset, p + 16);
+    qToLittleEndian<quint32>(header.tableCrc, p + 24);
+    return out;
+}
+
+QByteArray encodeTable(const QVector<ChunkedGraphFormat::ChunkEntry>& entries) {
+    QByteArray out(entries.size() * ChunkedGraphFormat::kChunkEntrySize, '\0');
+    char* p = out.data();
+    for (const ChunkedGraphFormat::ChunkEntry& entry : entries) {
+        qToLittleEndian<quint32>(entry.kind, p);
+        qToLittleEndian<quint32>(static_cast<quint32>(entry.tile >> 32), p + 4);
+        qToLittleEndian<quint32>(static_cast<quint32>(entry.tile), p + 8);
+        qToLittleEndian<quint32>(entry.crc, p + 12);
+        qToLittleEndian<quint64>(entry.offset, p + 16);
+        qToLittleEndian<quint32>(entry.size, p + 24);
+        p += ChunkedGraphFormat::kChunkEntrySize;
+    }
+    return out;
+}
+
+// Reads and validates the header and chunk table. Chunk payloads are only
+// bounds-checked here; their CRCs are verified when they are read.
+bool readTable(QFile* file, ChunkHeader* header, QVector<ChunkedGraphFormat::ChunkEntry>* entries, QString* errorMessage) {
+    const qint64 fileSize = file->size();
+    if (!file->seek(0)) {
+        return fail(errorMessage, QStringLiteral("Cannot read file: %1").arg(file->errorString()));
+    }
+    const QByteArray headerBytes = file->read(ChunkedGraphFormat::kHeaderSize);
+    if (headerBytes.size() != ChunkedGraphFormat::kHeaderSize) {
+        return fail(errorMessage, QStringLiteral("Chunked file is truncated"));
+    }
+    const char* p = headerBytes.constData();
+    if (qFromLittleEndian<quint32>(p) != ChunkedGraphFormat::kMagic) {
+        return fail(errorMessage, QStringLiteral("Not a chunked EDA graph file"));
+    }
+    const quint16 version = qFromLittleEndian<quint16>(p + 4);
+    if (version != ChunkedGraphFormat::kFormatVersion) {
+        return fail(errorMessage, QStringLiteral("Unsupported chunked format version: %1").arg(version));
+    }
+    header->schemaVersion = qFromLittleEndian<qint32>(p + 8);
+    header->chunkCount = qFromLittleEndian<quint32>(p + 12);
+    header->tableOffset = qFromLittleEndian<quint64>(p + 16);
+    header->tableCrc = qFromLittleEndian<quint32>(p + 24);
+
+    const qint64 tableSize = qint64(header->chunkCount) * ChunkedGraphFormat::kChunkEntrySize;
+    if (header->tableOffset < quint64(ChunkedGraphFormat::kHeaderSize) ||
+        header->tableOffset > quint64(fileSize) || tableSize > fileSize - qint64(header->tableOffset)) {
+        return fail(errorMessage, QStringLiteral("Chunk table is out of bounds"));
+    }
+    if (!file->seek(qint64(header->tableOffset))) {
+        return fail(errorMessage, QStringLiteral("Cannot read file: %1").arg(file->errorString()));
+    }
+    const QByteArray table = file->read(tableSize);
+    if (table.size() != tableSize || Crc32::compute(table) != header->tableCrc) {
+        return fail(errorMessage, QStringLiteral("Chunk table checksum mismatch"));
+    }
+
+    entries->clear();
+    entries->reserve(static_cast<int>(header->chunkCount));
+    const char* e = table.constData();
+    for (quint32 i = 0; i < header->chunkCount; ++i, e += ChunkedGraphFormat::kChunkEntrySize) {
+        ChunkedGraphFormat::ChunkEntry entry;
+        const quint32 kind = qFromLittleEndian<quint32>(e);
+        if (kind != ChunkedGraphFormat::SettingsChunk && kind != ChunkedGraphFormat::TileChunk) {
+            return fail(errorMessage, QStringLiteral("Unknown chunk kind: %1").arg(kind));
+        }
+        entry.kind = static_cast<ChunkedGraphFormat::ChunkKind>(kind);
+        entry.tile = (quint64(qFromLittleEndian<quint32>(e + 4)) << 32) | qFromLittleEndian<quint32>(e + 8);
+        entry.crc = qFromLittleEndian<quint32>(e + 12);
+        entry.offset = qFromLittleEndian<quint64>(e + 16);
+        entry.size = qFromLittleEndian<quint32>(e + 24);
+        if (entry.offset < quint64(ChunkedGraphFormat::kHeaderSize) || entry.offset > quint64(fileSize) ||
+            entry.size > quint64(fileSize) - entry.offset) {
+            return fail(errorMessage, QStringLiteral("Chunk %1 is out of bounds").arg(i));
+        }
+        entries->push_back(entry);
+    }
+    return true;
+}
+
+bool readChunk(QFile* file, const ChunkedGraphFormat::ChunkEntry& entry, QByteArray* payload, QString* errorMessage) {
+    if (!file->seek(qint64(entry.offset))) {
+        return fail(errorMessage, QStringLiteral("Cannot read file: %1").arg(file->errorString()));
+    }
+    *payload = file->read(entry.size);
+    if (payload->size() != qint64(entry.size) || Crc32::compute(*payload) != entry.crc) {
+        return fail(errorMessage, QStringLiteral("Chunk checksum mismatch at offset %1").arg(entry.offset));
+    }
+    return true;
+}
+
+// Appends aligned chunks at a running offset and finishes with the table and
+// the header, which is written last so it only ever points at complete data.
+class ChunkSink {
+public:
+    ChunkSink(QFileDevice* device, qint64 offset)
+        : m_device(device),
+          m_offset(offset) {}
+
+    bool add(ChunkedGraphFormat::ChunkKind kind, quint64 tile, const QByteArray& payload) {
+        if (!pad()) {
+            return false;
+        }
+        ChunkedGraphFormat::ChunkEntry entry;
+        entry.kind = kind;
+        entry.tile = tile;
+        entry.crc = Crc32::compute(payload);
+        entry.offset = quint64(m_offset);
+        entry.size = static_cast<quint32>(payload.size());
+        if (m_device->write(payload) != payload.size()) {
+            return false;
+        }
+        m_offset += payload.size();
+        m_entries.push_back(entry);
+        return true;
+    }
+
+    void keep(const ChunkedGraphFormat::ChunkEntry& entry) {
+        m_entries.push_back(entry);
+    }
+
+    // Writes the table; with `syncBeforeHeader` the table and chunks are made
+    // durable before the header that publishes them.
+    bool finish(int schemaVersion, bool syncBeforeHeader) {
+        if (!pad()) {
+            return false;
+        }
+        const QByteArray table = encodeTable(m_entries);
+        ChunkHeader header;
+        header.schemaVersion = schemaVersion;
+        header.chunkCount = static_cast<quint32>(m_entries.size());
+        header.tableOffset = quint64(m_offset);
+        header.tableCrc = Crc32::compute(table);
+        if (m_device->write(table) != table.size()) {
+            return false;
+        }
+        m_offset += table.size();
+        if (syncBeforeHeader && !FileSync::flushToDisk(m_device)) {
+            return false;
+        }
+        const QByteArray headerBytes = encodeHeader(header);
+        return m_device->seek(0) && m_device->write(headerBytes) == headerBytes.size();
+    }
+
+    qint64 end() const {
+        return m_offset;
+    }
+
+private:
+    bool pad() {
+        const qint64 next = aligned(m_offset);
+        if (!m_device->seek(m_offset)) {
+            return false;
+        }
+        if (next > m_offset) {
+            const QByteArray zeros(static_cast<int>(next - m_offset), '\0');
+            if (m_device->write(zeros) != zeros.size()) {
+                return false;
+            }
+        }
+        m_offset = next;
+        return true;
+    }
+
+    QFileDevice* m_device = nullptr;
+    qint64 m_offset = 0;
+    QVector<ChunkedGraphFormat::ChunkEntry> m_entries;
+};
+
+GraphDocument settingsOf(const GraphDocument& document) {
+    GraphDocument settings = document;
+    settings.nodes.clear();
+    settings.edges.clear();
+    return settings;
+}
+
+QHash<quint64, GraphDocument> partition(const GraphDocument& document) {
+    QHash<quint64, GraphDocument> tiles;
+    QHash<QString, quint64> nodeTiles;
+    nodeTiles.reserve(document.nodes.size());
+    for (const NodeData& node : document.nodes) {
+        const quint64 tile = ChunkedGraphFormat::tileKey(node.position);
+        nodeTiles.insert(node.id, tile);
+        tiles[tile].nodes.push_back(node);
+    }
+    for (const EdgeData& edge : document.edges) {
+        const auto it = nodeTiles.constFind(edge.fromNodeId);
+        if (it != nodeTiles.constEnd()) {
+            tiles[it.value()].edges.push_back(edge);
+        }
+    }
+    return tiles;
+}
+
+QVector<quint64> sortedTiles(const QHash<quint64, GraphDocument>& tiles) {
+    QVector<quint64> keys;
+    keys.reserve(tiles.size());
+    for (auto it = tiles.constBegin(); it != tiles.constEnd(); ++it) {
+        keys.push_back(it.key());
+    }
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+// Rewrites a file that has accumulated dead chunks, copying live chunks as is.
+bool compact(QFile* source, const ChunkHeader& header, const QVector<ChunkedGraphFormat::ChunkEntry>& entries,
+             QString* errorMessage) {
+    QSaveFile target(source->fileName());
+    if (!target.open(QIODevice::WriteOnly)) {
+        return fail(errorMessage, QStringLiteral("Cannot open file: %1").arg(target.errorString()));
+    }
+    ChunkSink sink(&target, ChunkedGraphFormat::kHeaderSize);
+    for (const ChunkedGraphFormat::ChunkEntry& entry : entries) {
+        QByteArray payload;
+        if (!readChunk(source, entry, &payload, errorMessage)) {
+            target.cancelWriting();
+            return false;
+        }
+        if (!sink.add(entry.kind, entry.tile, payload)) {
+            target.cancelWriting();
+            return fail(errorMessage, QStringLiteral("Cannot write file: %1").arg(target.errorString()));
+        }
+    }
+    if (!sink.finish(header.schemaVersion, false)) {
+        target.cancelWriting();
+        return fail(errorMessage, QStringLiteral("Cannot write file: %1").arg(target.errorString()));
+    }
+    source->close();
+    if (!target.commit()) {
+        return fail(errorMessage, QStringLiteral("Cannot replace file: %1").arg(target.errorString()));
+    }
+    return true;
+}
+}  // namespace
+
+bool ChunkedGraphFormat::isChunkedPath(const QString& filePath) {
+    return QFileInfo(filePath).suffix().compare(QStringLiteral("edac"), Qt::CaseInsensitive) == 0;
+}
+
+quint64 ChunkedGraphFormat::tileKey(const QPointF& position) {
+    const quint32 x = static_cast<quint32>(tileCoordinate(position.x()));
+    const quint32 y = static_cast<quint32>(tileCoordinate(position.y()));
+    return (quint64(x) << 32) | y;
+}
+
+QRectF ChunkedGraphFormat::tileBounds(quint64 tile) {
+    const qint32 x = static_cast<qint32>(static_cast<quint32>(tile >> 32));
+    const qint32 y = static_cast<qint32>(static_cast<quint32>(tile));
+    return QRectF(x * kTileSize, y * kTileSize, kTileSize, kTileSize);
+}
+
+bool ChunkedGraphFormat::write(const GraphDocument& document, const QString& filePath, QString* errorMessage) {
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return fail(errorMessage, QStringLiteral("Cannot open file: %1").arg(file.errorString()));
+    }
+    const QHash<quint64, GraphDocument> tiles = partition(document);
+    ChunkSink sink(&file, kHeaderSize);
+    bool ok = sink.add(SettingsChunk, 0, BinaryGraphFormat::encode(settingsOf(document)));
+    for (const quint64 tile : sortedTiles(tiles)) {
+        ok = ok && sink.add(TileChunk, tile, BinaryGraphFormat::encode(tiles.value(tile)));
+    }
+    if (!ok || !sink.finish(document.schemaVersion, false)) {
+        file.cancelWriting();
+        return fail(errorMessage, QStringLiteral("Cannot write file: %1").arg(file.errorString()));
+    }
+    if (!file.commit()) {
+        return fail(errorMessage, QStringLiteral("Cannot replace file: %1").arg(file.errorString()));
+    }
+    return true;
+}
+
+bool ChunkedGraphFormat::writeTiles(const QString& filePath,
+                                    const GraphDocument& settings,
+                                    const QHash<quint64, GraphDocument>& tiles,
+                                    QString* errorMessage) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadWrite)) {
+        return fail(errorMessage, QStringLiteral("Cannot open file: %1").arg(file.errorString()));
+    }
+    ChunkHeader header;
+    QVector<ChunkEntry> entries;
+    if (!readTable(&file, &header, &entries, errorMessage)) {
+        return false;
+    }
+
+    // New chunks go after everything that exists, so the current table and
+    // the chunks it references stay intact until the header is replaced.
+    ChunkSink sink(&file, file.size());
+    bool ok = sink.add(SettingsChunk, 0, BinaryGraphFormat::encode(settingsOf(settings)));
+    for (const ChunkEntry& entry : entries) {
+        if (entry.kind == TileChunk && !tiles.contains(entry.tile)) {
+            sink.keep(entry);
+        }
+    }
+    for (const quint64 tile : sortedTiles(tiles)) {
+        const GraphDocument content = tiles.value(tile);
+        if (!content.nodes.isEmpty() || !content.edges.isEmpty()) {
+            ok = ok && sink.add(TileChunk, tile, BinaryGraphFormat::encode(content));
+        }
+    }
+    if (!ok || !sink.finish(settings.schemaVersion, true) || !FileSync::flushToDisk(&file)) {
+        return fail(errorMessage, QStringLiteral("Cannot write file: %1").arg(file.errorString()));
+    }
+
+    if (sink.end() < kCompactionMinBytes) {
+        return true;
+    }
+    ChunkHeader updated;
+    if (!readTable(&file, &updated, &entries, errorMessage)) {
+        return false;
+    }
+    qint64 liveBytes = kHeaderSize + qint64(entries.size()) * kChunkEntrySize;
+    for (const ChunkEntry& entry : entries) {
+        liveBytes += aligned(entry.size);
+    }
+    if (sink.end() <= 2 * liveBytes) {
+        return true;
+    }
+    return compact(&file, updated, entries, errorMessage);
+}
+
+bool ChunkedGraphFormat::read(const QString& filePath, GraphDocument* document, QString* errorMessage) {
+    if (!document) {
+        return fail(errorMessage, QStringLiteral("Document pointer is null"));
+    }
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail(errorMessage, QStringLiteral("Cannot open file: %1").arg(file.errorString()));
+    }
+    ChunkHeader header;
+    QVector<ChunkEntry> entries;
+    if (!readTable(&file, &header, &entries, errorMessage)) {
+        return false;
+    }
+
+    GraphDocument result;
+    for (const ChunkEntry& entry : entries) {
+        QByteArray payload;
+        GraphDocument chunk;
+        if (!readChunk(&file, entry, &payload, errorMessage) ||
+            !BinaryGraphFormat::decode(payload, &chunk, errorMessage)) {
+            return false;
+        }
+        if (entry.kind == SettingsChunk) {
+            QVector<NodeData> nodes = std::move(result.nodes);
+            QVector<EdgeData> edges = std::move(result.edges);
+            result = std::move(chunk);
+            result.nodes = std::move(nodes);
+            result.edges = std::move(edges);
+        } else {
+            result.nodes += chunk.nodes;
+            result.edges += chunk.edges;
+        }
+    }
+    result.schemaVersion = header.schemaVersion;
+    *document = std::move(result);
+    return true;
+}
+
+bool ChunkedGraphFormat::readChunkTable(const QString& filePath, QVector<ChunkEntry>* entries, QString* errorMessage) {
+    if (!entries) {
+        return fail(errorMessage, QStringLiteral("Entry pointer is null"));
+    }
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail(errorMessage, QStringLiteral("Cannot open file: %1").arg(file.errorString()));
+    }
+    ChunkHeader header;
+    return readTable(&file, &header, entries, errorMessage);
+}
+
+ChunkLayout::ChunkLayout(const GraphDocument& document) {
+    m_nodeTiles.reserve(document.nodes.size());
+    for (const NodeData& node : document.nodes) {
+        m_nodeTiles.insert(node.id, ChunkedGraphFormat::tileKey(node.position));
+    }
+    m_edgeTiles.reserve(document.edges.size());
+    for (const EdgeData& edge : document.edges) {
+        const auto it = m_nodeTiles.constFind(edge.fromNodeId);
+        if (it != m_nodeTiles.constEnd()) {
+            m_edgeTiles.insert(edge.id, it.value());
+        }
+    }
+}
+
+QSet<quint64> ChunkLayout::tilesOf(const GraphChangeSet& changes) const {
+    QSet<quint64> tiles;
+    for (const QString& id : changes.nodeIds) {
+        const auto it = m_nodeTiles.constFind(id);
+        if (it != m_nodeTiles.constEnd()) {
+            tiles.insert(it.value());
+        }
+    }
+    for (const QString& id : changes.edgeIds) {
+        const auto it = m_edgeTiles.constFind(id);
+        if (it != m_edgeTiles.constEnd()) {
+            tiles.insert(it.value());
+        }
+    }
+    return tiles;
+}
+
+void ChunkLayout::update(const QHash<quint64, GraphDocument>& tiles, const GraphChangeSet& changes) {
+    for (const QString& id : changes.nodeIds) {
+        m_nodeTiles.remove(id);
+    }
+    for (const QString& id : changes.edgeIds) {
+        m_edgeTiles.remove(id);
+    }
+    for (auto it = tiles.constBegin(); it != tiles.constEnd(); ++it) {
+        for (const NodeData& node : it.value().nodes) {
+            m_nodeTiles.insert(node.id, it.key());
+        }
+        for (const EdgeData& edge : it.value().edges) {
+            m_edgeTiles.insert(edge.id, it.key());
+        }
+    }
+}
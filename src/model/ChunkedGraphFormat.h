@@ -0,0 +1,80 @@
+#pragma once
+
+#include "GraphDocument.h"
+#include "GraphJournal.h"
+
+#include <QHash>
+#include <QPointF>
+#include <QRectF>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+// Chunked `.edac` container: the document split into square spatial tiles so
+// a save can rewrite only the tiles whose entities changed.
+//
+// Layout: a 32-byte header (magic, format version, schema version, chunk
+// count, chunk table offset and CRC-32), 8-byte aligned chunks, and a chunk
+// table of 32-byte entries (kind, tile x/y, CRC-32, offset, size). Each chunk
+// is an `.edab` payload: the settings chunk holds settings and layers, a tile
+// chunk holds the nodes positioned in the tile and the edges leaving them.
+//
+// An incremental update appends the new chunks and a new table at the end of
+// the file and then rewrites the header, which is the commit point; until
+// then the previous table still describes a complete document. Once dead
+// chunks outweigh live ones the file is rewritten compactly.
+class ChunkedGraphFormat {
+public:
+    static constexpr quint32 kMagic = 0x43414445;  // "EDAC"
+    static constexpr quint16 kFormatVersion = 1;
+    static constexpr int kHeaderSize = 32;
+    static constexpr int kChunkEntrySize = 32;
+    static constexpr qreal kTileSize = 2048.0;
+
+    enum ChunkKind : quint32 {
+        SettingsChunk = 0,
+        TileChunk = 1
+    };
+
+    struct ChunkEntry {
+        ChunkKind kind = TileChunk;
+        quint64 tile = 0;
+        quint32 crc = 0;
+        quint64 offset = 0;
+        quint32 size = 0;
+    };
+
+    static bool isChunkedPath(const QString& filePath);
+    static quint64 tileKey(const QPointF& position);
+    static QRectF tileBounds(quint64 tile);
+
+    // Writes the whole document through QSaveFile.
+    static bool write(const GraphDocument& document, const QString& filePath, QString* errorMessage = nullptr);
+    // Replaces the settings chunk and the given tiles of an existing file. Each
+    // tile document holds that tile's complete new content; empty tiles are
+    // dropped from the table.
+    static bool writeTiles(const QString& filePath,
+                           const GraphDocument& settings,
+                           const QHash<quint64, GraphDocument>& tiles,
+                           QString* errorMessage = nullptr);
+    // Fills the document exactly as stored, after checking every chunk's CRC.
+    static bool read(const QString& filePath, GraphDocument* document, QString* errorMessage = nullptr);
+    static bool readChunkTable(const QString& filePath, QVector<ChunkEntry>* entries, QString* errorMessage = nullptr);
+};
+
+// Tile each node and edge was stored in by the last save of a chunked file.
+// An edge lives in the tile of its source node.
+class ChunkLayout {
+public:
+    ChunkLayout() = default;
+    explicit ChunkLayout(const GraphDocument& document);
+
+    // Tiles the given entities occupied at the last save.
+    QSet<quint64> tilesOf(const GraphChangeSet& changes) const;
+    // Records a successful writeTiles() of `tiles` made for `changes`.
+    void update(const QHash<quint64, GraphDocument>& tiles, const GraphChangeSet& changes);
+
+private:
+    QHash<QString, quint64> m_nodeTiles;
+    QHash<QString, quint64> m_edgeTiles;
+};
@@ -0,0 +1,205 @@
+#include "CompressedGraphFormat.h"
+
+#include <QFileInfo>
+#include <QtEndian>
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+namespace {
+// zlib's default; higher levels cost far more time for little gain on JSON.
+constexpr int kCompressionLevel = 6;
+
+bool fail(QString* errorMessage, const QString& message) {
+    if (errorMessage) {
+        *errorMessage = message;
+    }
+    return false;
+}
+
+// Blocks compressed or inflated ahead of the one being written or appended.
+size_t workerCount() {
+    return std::max<size_t>(2, std::thread::hardware_concurrency());
+}
+
+// Upper bound on what qCompress can produce for rawSize bytes: zlib's worst
+// case expansion plus the 4-byte length prefix qCompress writes first.
+quint32 maxCompressedSize(quint32 rawSize) {
+    return rawSize + rawSize / 1000 + 64 + 4;
+}
+
+QByteArray encodeHeader() {
+    QByteArray out(CompressedGraphFormat::kHeaderSize, '\0');
+    char* p = out.data();
+    qToLittleEndian<quint32>(CompressedGraphFormat::kMagic, p);
+    qToLittleEndian<quint16>(CompressedGraphFormat::kFormatVersion, p + 4);
+    qToLittleEndian<quint32>(CompressedGraphFormat::kBlockSize, p + 8);
+    return out;
+}
+
+QByteArray encodeBlock(const QByteArray& raw) {
+    const QByteArray compressed = qCompress(raw, kCompressionLevel);
+    QByteArray out(CompressedGraphFormat::kBlockHeaderSize, '\0');
+    qToLittleEndian<quint32>(static_cast<quint32>(compressed.size()), out.data());
+    qToLittleEndian<quint32>(static_cast<quint32>(raw.size()), out.data() + 4);
+    out.append(compressed);
+    return out;
+}
+}  // namespace
+
+bool CompressedGraphFormat::isCompressedPath(const QString& filePath) {
+    return QFileInfo(filePath).suffix().compare(QStringLiteral("edaz"), Qt::CaseInsensitive) == 0;
+}
+
+bool CompressedGraphFormat::hasMagic(const QByteArray& payload) {
+    return payload.size() >= 4 && qFromLittleEndian<quint32>(payload.constData()) == kMagic;
+}
+
+bool CompressedGraphFormat::readPayload(QIODevice* device, QByteArray* payload, QString* errorMessage) {
+    const QByteArray header = device->read(kHeaderSize);
+    if (header.size() != kHeaderSize || !hasMagic(header)) {
+        return fail(errorMessage, QStringLiteral("Not a compressed EDA graph"));
+    }
+    const quint16 version = qFromLittleEndian<quint16>(header.constData() + 4);
+    if (version > kFormatVersion) {
+        return fail(errorMessage, QStringLiteral("Unsupported compressed format version %1").arg(version));
+    }
+
+    // Each pending future inflates one block; sizes are checked in file order.
+    std::deque<std::pair<std::future<QByteArray>, int>> pending;
+    const size_t maxPending = workerCount();
+    payload->clear();
+    auto collect = [&](size_t keep) {
+        while (pending.size() > keep) {
+            const QByteArray raw = pending.front().first.get();
+            const int expected = pending.front().second;
+            pending.pop_front();
+            if (raw.size() != expected) {
+                return false;
+            }
+            payload->append(raw);
+        }
+        return true;
+    };
+
+    while (true) {
+        const QByteArray blockHeader = device->read(kBlockHeaderSize);
+        if (blockHeader.size() != kBlockHeaderSize) {
+            return fail(errorMessage, QStringLiteral("Compressed file is truncated"));
+        }
+        const quint32 compressedSize = qFromLittleEndian<quint32>(blockHeader.constData());
+        const quint32 rawSize = qFromLittleEndian<quint32>(blockHeader.constData() + 4);
+        if (compressedSize == 0) {
+            break;
+        }
+        if (rawSize == 0 || rawSize > static_cast<quint32>(kBlockSize) ||
+            compressedSize > maxCompressedSize(rawSize)) {
+            return fail(errorMessage, QStringLiteral("Compressed block has an invalid size"));
+        }
+        QByteArray compressed = device->read(compressedSize);
+        if (compressed.size() != static_cast<int>(compressedSize)) {
+            return fail(errorMessage, QStringLiteral("Compressed file is truncated"));
+        }
+        // qUncompress allocates whatever its big-endian length prefix says, so
+        // that prefix must match the already bounded raw size before inflating.
+        if (compressed.size() < 4 || qFromBigEndian<quint32>(compressed.constData()) != rawSize) {
+            return fail(errorMessage, QStringLiteral("Compressed block has an invalid size"));
+        }
+        pending.emplace_back(std::async(std::launch::async,
+                                        [compressed = std::move(compressed)]() { return qUncompress(compressed); }),
+                             static_cast<int>(rawSize));
+        if (!collect(maxPending)) {
+            return fail(errorMessage, QStringLiteral("Compressed block is corrupt"));
+        }
+    }
+    if (!collect(0)) {
+        return fail(errorMessage, QStringLiteral("Compressed block is corrupt"));
+    }
+    return true;
+}
+
+CompressedBlockWriter::CompressedBlockWriter(QIODevice* target)
+    : m_target(target),
+      m_maxPending(workerCount()) {}
+
+// Pending std::async futures wait for their workers when destroyed.
+CompressedBlockWriter::~CompressedBlockWriter() = default;
+
+bool CompressedBlockWriter::open(OpenMode mode) {
+    if (!m_target || (mode & QIODevice::ReadOnly) || !QIODevice::open(mode)) {
+        return false;
+    }
+    m_block.reserve(CompressedGraphFormat::kBlockSize);
+    return writeTarget(encodeHeader());
+}
+
+bool CompressedBlockWriter::isSequential() const {
+    return true;
+}
+
+bool CompressedBlockWriter::finish() {
+    if (!m_block.isEmpty()) {
+        submitBlock();
+    }
+    if (!drain(0)) {
+        return false;
+    }
+    return writeTarget(QByteArray(CompressedGraphFormat::kBlockHeaderSize, '\0'));
+}
+
+qint64 CompressedBlockWriter::readData(char* data, qint64 maxSize) {
+    Q_UNUSED(data);
+    Q_UNUSED(maxSize);
+    return -1;
+}
+
+qint64 CompressedBlockWriter::writeData(const char* data, qint64 size) {
+    if (m_failed) {
+        return -1;
+    }
+    qint64 written = 0;
+    while (written < size) {
+        const qint64 room = CompressedGraphFormat::kBlockSize - m_block.size();
+        const qint64 take = std::min(room, size - written);
+        m_block.append(data + written, static_cast<int>(take));
+        written += take;
+        if (m_block.size() == CompressedGraphFormat::kBlockSize) {
+            submitBlock();
+            if (!drain(m_maxPending)) {
+                return -1;
+            }
+        }
+    }
+    return written;
+}
+
+void CompressedBlockWriter::submitBlock() {
+    QByteArray raw;
+    raw.swap(m_block);
+    m_block.reserve(CompressedGraphFormat::kBlockSize);
+    m_pending.push_back(std::async(std::launch::async, [raw = std::move(raw)]() { return encodeBlock(raw); }));
+}
+
+bool CompressedBlockWriter::drain(size_t maxPending) {
+    while (m_pending.size() > maxPending) {
+        const QByteArray block = m_pending.front().get();
+        m_pending.pop_front();
+        if (!writeTarget(block)) {
+            return false;
+        }
+    }
+    return !m_failed;
+}
+
+bool CompressedBlockWriter::writeTarget(const QByteArray& bytes) {
+    if (m_failed) {
+        return false;
+    }
+    if (m_target->write(bytes) != bytes.size()) {
+        m_failed = true;
+        setErrorString(m_target->errorString());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QString>
+
+#include <deque>
+#include <future>
+
+// Compressed `.edaz` container around the JSON encoding of a document.
+//
+// Layout: a 16-byte header (magic, format version, block size), then blocks
+// of u32 compressed size, u32 raw size and a qCompress() payload, ended by a
+// block with compressed size 0. Blocks are compressed independently so they
+// can be deflated and inflated on worker threads in parallel with the disk
+// and the serializer.
+class CompressedGraphFormat {
+public:
+    static constexpr quint32 kMagic = 0x5A414445;  // "EDAZ"
+    static constexpr quint16 kFormatVersion = 1;
+    static constexpr int kHeaderSize = 16;
+    static constexpr int kBlockHeaderSize = 8;
+    static constexpr int kBlockSize = 1 << 20;
+
+    static bool isCompressedPath(const QString& filePath);
+    static bool hasMagic(const QByteArray& payload);
+    // Reads a whole `.edaz` stream from `device`, inflating each block on a
+    // worker while the next one is read.
+    static bool readPayload(QIODevice* device, QByteArray* payload, QString* errorMessage = nullptr);
+};
+
+// Write-only device producing an `.edaz` stream on `target`. Data is cut into
+// blocks that are compressed on worker threads while the caller keeps
+// writing; compressed blocks reach `target` in order from the calling thread.
+class CompressedBlockWriter : public QIODevice {
+public:
+    explicit CompressedBlockWriter(QIODevice* target);
+    ~CompressedBlockWriter() override;
+
+    // Writes the header; the device cannot be read.
+    bool open(OpenMode mode) override;
+    bool isSequential() const override;
+    // Compresses the buffered tail, waits for every block and appends the end
+    // marker. False if any write to the target failed.
+    bool finish();
+
+protected:
+    qint64 readData(char* data, qint64 maxSize) override;
+    qint64 writeData(const char* data, qint64 size) override;
+
+private:
+    void submitBlock();
+    bool drain(size_t maxPending);
+    bool writeTarget(const QByteArray& bytes);
+
+    QIODevice* m_target = nullptr;
+    QByteArray m_block;
+    std::deque<std::future<QByteArray>> m_pending;
+    size_t m_maxPending = 2;
+    bool m_failed = false;
+};
@@ -0,0 +1,31 @@
+#include "Crc32.h"
+
+#include <array>
+
+namespace {
+std::array<quint32, 256> buildTable() {
+    std::array<quint32, 256> table{};
+    for (quint32 i = 0; i < 256; ++i) {
+        quint32 value = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            value = (value & 1u) ? (value >> 1) ^ 0xEDB88320u : value >> 1;
+        }
+        table[i] = value;
+    }
+    return table;
+}
+}  // namespace
+
+quint32 Crc32::compute(const char* data, qint64 size, quint32 crc) {
+    static const std::array<quint32, 256> table = buildTable();
+    crc = ~crc;
+    const uchar* p = reinterpret_cast<const uchar*>(data);
+    for (qint64 i = 0; i < size; ++i) {
+        crc = table[(crc ^ p[i]) & 0xffu] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+quint32 Crc32::compute(const QByteArray& data, quint32 crc) {
+    return compute(data.constData(), data.size(), crc);
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <QByteArray>
+
+// CRC-32 (IEEE 802.3, reflected polynomial 0xEDB88320), the checksum zlib and
+// PNG use. Pass the previous result as `crc` to checksum data in pieces.
+class Crc32 {
+public:
+    static quint32 compute(const char* data, qint64 size, quint32 crc = 0);
+    static quint32 compute(const QByteArray& data, quint32 crc = 0);
+};
@@ -0,0 +1,192 @@
+#include "DynamicTopologicalOrder.h"
+
+#include <algorithm>
+
+void DynamicTopologicalOrder::clear() {
+    m_vertices.clear();
+    m_nextOrd = 0;
+}
+
+bool DynamicTopologicalOrder::contains(const QString& nodeId) const {
+    return m_vertices.contains(nodeId);
+}
+
+int DynamicTopologicalOrder::nodeCount() const {
+    return m_vertices.size();
+}
+
+void DynamicTopologicalOrder::addNode(const QString& nodeId) {
+    if (m_vertices.contains(nodeId)) {
+        return;
+    }
+    Vertex vertex;
+    vertex.ord = m_nextOrd++;
+    m_vertices.insert(nodeId, vertex);
+}
+
+void DynamicTopologicalOrder::removeNode(const QString& nodeId) {
+    auto it = m_vertices.find(nodeId);
+    if (it == m_vertices.end()) {
+        return;
+    }
+    const Vertex vertex = it.value();
+    m_vertices.erase(it);
+    for (auto outIt = vertex.out.constBegin(); outIt != vertex.out.constEnd(); ++outIt) {
+        auto target = m_vertices.find(outIt.key());
+        if (target != m_vertices.end()) {
+            target->in.remove(nodeId);
+        }
+    }
+    for (auto inIt = vertex.in.constBegin(); inIt != vertex.in.constEnd(); ++inIt) {
+        auto source = m_vertices.find(inIt.key());
+        if (source != m_vertices.end()) {
+            source->out.remove(nodeId);
+        }
+    }
+}
+
+bool DynamicTopologicalOrder::addEdge(const QString& fromId, const QString& toId) {
+    if (fromId == toId) {
+        return false;
+    }
+    addNode(fromId);
+    addNode(toId);
+
+    Vertex& from = m_vertices[fromId];
+    auto existing = from.out.find(toId);
+    if (existing != from.out.end()) {
+        ++existing.value();
+        ++m_vertices[toId].in[fromId];
+        return true;
+    }
+
+    const int lowerBound = position(toId);
+    const int upperBound = from.ord;
+    if (lowerBound < upperBound) {
+        QSet<QString> forward;
+        if (!collectForward(toId, upperBound, fromId, &forward)) {
+            return false;
+        }
+        QSet<QString> backward;
+        collectBackward(fromId, lowerBound, &backward);
+        reorder(backward, forward);
+    }
+
+    m_vertices[fromId].out.insert(toId, 1);
+    m_vertices[toId].in.insert(fromId, 1);
+    return true;
+}
+
+void DynamicTopologicalOrder::removeEdge(const QString& fromId, const QString& toId) {
+    auto from = m_vertices.find(fromId);
+    auto to = m_vertices.find(toId);
+    if (from == m_vertices.end() || to == m_vertices.end()) {
+        return;
+    }
+    auto outIt = from->out.find(toId);
+    if (outIt != from->out.end() && --outIt.value() <= 0) {
+        from->out.erase(outIt);
+    }
+    auto inIt = to->in.find(fromId);
+    if (inIt != to->in.end() && --inIt.value() <= 0) {
+        to->in.erase(inIt);
+    }
+}
+
+bool DynamicTopologicalOrder::wouldCreateCycle(const QString& fromId, const QString& toId) const {
+    if (fromId == toId) {
+        return true;
+    }
+    const auto from = m_vertices.constFind(fromId);
+    const auto to = m_vertices.constFind(toId);
+    if (from == m_vertices.constEnd() || to == m_vertices.constEnd()) {
+        return false;
+    }
+    if (from->out.contains(toId) || to->ord > from->ord) {
+        return false;
+    }
+    QSet<QString> visited;
+    return !collectForward(toId, from->ord, fromId, &visited);
+}
+
+int DynamicTopologicalOrder::position(const QString& nodeId) const {
+    const auto it = m_vertices.constFind(nodeId);
+    return it == m_vertices.constEnd() ? -1 : it->ord;
+}
+
+QVector<QString> DynamicTopologicalOrder::order() const {
+    QVector<QString> ids;
+    ids.reserve(m_vertices.size());
+    for (auto it = m_vertices.constBegin(); it != m_vertices.constEnd(); ++it) {
+        ids.push_back(it.key());
+    }
+    std::sort(ids.begin(), ids.end(), [this](const QString& a, const QString& b) {
+        return position(a) < position(b);
+    });
+    return ids;
+}
+
+bool DynamicTopologicalOrder::collectForward(const QString& startId,
+                                             int upperBound,
+                                             const QString& stopId,
+                                             QSet<QString>* visited) const {
+    QVector<QString> stack{startId};
+    visited->insert(startId);
+    while (!stack.isEmpty()) {
+        const Vertex& vertex = *m_vertices.constFind(stack.takeLast());
+        for (auto it = vertex.out.constBegin(); it != vertex.out.constEnd(); ++it) {
+            if (it.key() == stopId) {
+                return false;
+            }
+            const int ord = m_vertices.value(it.key()).ord;
+            if (ord < upperBound && !visited->contains(it.key())) {
+                visited->insert(it.key());
+                stack.push_back(it.key());
+            }
+        }
+    }
+    return true;
+}
+
+void DynamicTopologicalOrder::collectBackward(const QString& startId, int lowerBound, QSet<QString>* visited) const {
+    QVector<QString> stack{startId};
+    visited->insert(startId);
+    while (!stack.isEmpty()) {
+        const Vertex& vertex = *m_vertices.constFind(stack.takeLast());
+        for (auto it = vertex.in.constBegin(); it != vertex.in.constEnd(); ++it) {
+            const int ord = m_vertices.value(it.key()).ord;
+            if (ord > lowerBound && !visited->contains(it.key())) {
+                visited->insert(it.key());
+                stack.push_back(it.key());
+            }
+        }
+    }
+}
+
+void DynamicTopologicalOrder::reorder(const QSet<QString>& backward, const QSet<QString>& forward) {
+    auto byOrd = [this](const QString& a, const QString& b) {
+        return position(a) < position(b);
+    };
+    QVector<QString> backwardIds(backward.begin(), backward.end());
+    QVector<QString> forwardIds(forward.begin(), forward.end());
+    std::sort(backwardIds.begin(), backwardIds.end(), byOrd);
+    std::sort(forwardIds.begin(), forwardIds.end(), byOrd);
+
+    QVector<int> ords;
+    ords.reserve(backwardIds.size() + forwardIds.size());
+    for (const QString& id : backwardIds) {
+        ords.push_back(position(id));
+    }
+    for (const QString& id : forwardIds) {
+        ords.push_back(position(id));
+    }
+    std::sort(ords.begin(), ords.end());
+
+    int next = 0;
+    for (const QString& id : backwardIds) {
+        m_vertices[id].ord = ords[next++];
+    }
+    for (const QString& id : forwardIds) {
+        m_vertices[id].ord = ords[next++];
+    }
+}
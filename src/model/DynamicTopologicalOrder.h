@@ -0,0 +1,41 @@
+#pragma once
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+// Topological order of a directed graph maintained under edge insertion and
+// removal (Pearce-Kelly). An insertion that violates the current order only
+// searches and reorders the nodes ranked between its endpoints.
+class DynamicTopologicalOrder {
+public:
+    void clear();
+    bool contains(const QString& nodeId) const;
+    int nodeCount() const;
+
+    void addNode(const QString& nodeId);
+    void removeNode(const QString& nodeId);
+    // Returns false and leaves the graph untouched if the edge would close a cycle.
+    bool addEdge(const QString& fromId, const QString& toId);
+    void removeEdge(const QString& fromId, const QString& toId);
+    bool wouldCreateCycle(const QString& fromId, const QString& toId) const;
+
+    // Rank of the node in the current order; ranks are increasing but not contiguous.
+    int position(const QString& nodeId) const;
+    QVector<QString> order() const;
+
+private:
+    struct Vertex {
+        int ord = 0;
+        QHash<QString, int> out;
+        QHash<QString, int> in;
+    };
+
+    bool collectForward(const QString& startId, int upperBound, const QString& stopId, QSet<QString>* visited) const;
+    void collectBackward(const QString& startId, int lowerBound, QSet<QString>* visited) const;
+    void reorder(const QSet<QString>& backward, const QSet<QString>& forward);
+
+    QHash<QString, Vertex> m_vertices;
+    int m_nextOrd = 0;
+};
@@ -0,0 +1,20 @@
+#include "FileSync.h"
+
+#include <QFileDevice>
+
+#if defined(Q_OS_WIN)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+bool FileSync::flushToDisk(QFileDevice* file) {
+    if (!file || !file->flush()) {
+        return false;
+    }
+#if defined(Q_OS_WIN)
+    return ::_commit(file->handle()) == 0;
+#else
+    return ::fsync(file->handle()) == 0;
+#endif
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+class QFileDevice;
+
+class FileSync {
+public:
+    // Flushes Qt's buffer and asks the OS to put the file's data on disk
+    // (fsync / _commit). Returns false if either step fails.
+    static bool flushToDisk(QFileDevice* file);
+};
@@ -0,0 +1,214 @@
+#include "GraphCsr.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+// Below this frontier size thread start-up costs more than the expansion itself.
+constexpr int kParallelFrontierSize = 4096;
+
+using VisitedFlags = std::vector<std::atomic<quint8>>;
+
+void expandRange(const int* frontier,
+                 int begin,
+                 int end,
+                 const int* offsets,
+                 const int* targets,
+                 VisitedFlags* visited,
+                 std::vector<int>* next) {
+    for (int i = begin; i < end; ++i) {
+        const int node = frontier[i];
+        for (int e = offsets[node]; e < offsets[node + 1]; ++e) {
+            const int target = targets[e];
+            if ((*visited)[target].load(std::memory_order_relaxed) == 0 &&
+                (*visited)[target].exchange(1, std::memory_order_relaxed) == 0) {
+                next->push_back(target);
+            }
+        }
+    }
+}
+
+std::vector<int> expandFrontier(const std::vector<int>& frontier,
+                                const QVector<int>& offsets,
+                                const QVector<int>& targets,
+                                VisitedFlags* visited) {
+    std::vector<int> next;
+    const int size = static_cast<int>(frontier.size());
+    const int workerCount = std::min<int>(std::max(1u, std::thread::hardware_concurrency()),
+                                          (size + kParallelFrontierSize - 1) / kParallelFrontierSize);
+    if (workerCount <= 1) {
+        expandRange(frontier.data(), 0, size, offsets.constData(), targets.constData(), visited, &next);
+        return next;
+    }
+
+    std::vector<std::vector<int>> partial(workerCount);
+    std::vector<std::thread> workers;
+    workers.reserve(workerCount);
+    const int chunk = (size + workerCount - 1) / workerCount;
+    for (int w = 0; w < workerCount; ++w) {
+        const int begin = w * chunk;
+        const int end = std::min(size, begin + chunk);
+        workers.emplace_back(expandRange,
+                             frontier.data(),
+                             begin,
+                             end,
+                             offsets.constData(),
+                             targets.constData(),
+                             visited,
+                             &partial[w]);
+    }
+    size_t total = 0;
+    for (int w = 0; w < workerCount; ++w) {
+        workers[w].join();
+        total += partial[w].size();
+    }
+    next.reserve(total);
+    for (const std::vector<int>& part : partial) {
+        next.insert(next.end(), part.begin(), part.end());
+    }
+    return next;
+}
+
+void fillAdjacency(int nodeCount,
+                   const QVector<QPair<int, int>>& edges,
+                   bool outgoing,
+                   QVector<int>* offsets,
+                   QVector<int>* targets) {
+    offsets->fill(0, nodeCount + 1);
+    for (const QPair<int, int>& edge : edges) {
+        ++(*offsets)[(outgoing ? edge.first : edge.second) + 1];
+    }
+    for (int i = 0; i < nodeCount; ++i) {
+        (*offsets)[i + 1] += (*offsets)[i];
+    }
+    targets->resize(edges.size());
+    QVector<int> cursor = *offsets;
+    for (const QPair<int, int>& edge : edges) {
+        const int from = outgoing ? edge.first : edge.second;
+        const int to = outgoing ? edge.second : edge.first;
+        (*targets)[cursor[from]++] = to;
+    }
+}
+}  // namespace
+
+GraphCsr GraphCsr::fromDocument(const GraphDocument& document) {
+    QVector<QString> nodeIds;
+    QVector<QString> nodeTypes;
+    QHash<QString, int> indexById;
+    nodeIds.reserve(document.nodes.size());
+    nodeTypes.reserve(document.nodes.size());
+    indexById.reserve(document.nodes.size());
+    for (const NodeData& node : document.nodes) {
+        if (indexById.contains(node.id)) {
+            continue;
+        }
+        indexById.insert(node.id, nodeIds.size());
+        nodeIds.push_back(node.id);
+        nodeTypes.push_back(node.type);
+    }
+
+    QVector<QPair<int, int>> edges;
+    edges.reserve(document.edges.size());
+    for (const EdgeData& edge : document.edges) {
+        const int from = indexById.value(edge.fromNodeId, -1);
+        const int to = indexById.value(edge.toNodeId, -1);
+        if (from >= 0 && to >= 0) {
+            edges.push_back(qMakePair(from, to));
+        }
+    }
+    return build(nodeIds, nodeTypes, edges);
+}
+
+GraphCsr GraphCsr::build(const QVector<QString>& nodeIds,
+                         const QVector<QString>& nodeTypes,
+                         const QVector<QPair<int, int>>& edges) {
+    GraphCsr csr;
+    csr.m_nodeIds = nodeIds;
+    csr.m_nodeTypes = nodeTypes;
+    csr.m_nodeTypes.resize(nodeIds.size());
+    csr.m_indexById.reserve(nodeIds.size());
+    for (int i = 0; i < nodeIds.size(); ++i) {
+        csr.m_indexById.insert(nodeIds[i], i);
+    }
+
+    QVector<QPair<int, int>> validEdges;
+    validEdges.reserve(edges.size());
+    for (const QPair<int, int>& edge : edges) {
+        if (edge.first >= 0 && edge.first < nodeIds.size() && edge.second >= 0 && edge.second < nodeIds.size()) {
+            validEdges.push_back(edge);
+        }
+    }
+    fillAdjacency(nodeIds.size(), validEdges, true, &csr.m_outOffsets, &csr.m_outTargets);
+    fillAdjacency(nodeIds.size(), validEdges, false, &csr.m_inOffsets, &csr.m_inTargets);
+    return csr;
+}
+
+int GraphCsr::nodeCount() const {
+    return m_nodeIds.size();
+}
+
+int GraphCsr::edgeCount() const {
+    return m_outTargets.size();
+}
+
+int GraphCsr::indexOf(const QString& nodeId) const {
+    return m_indexById.value(nodeId, -1);
+}
+
+QString GraphCsr::nodeId(int index) const {
+    return m_nodeIds.value(index);
+}
+
+QString GraphCsr::nodeType(int index) const {
+    return m_nodeTypes.value(index);
+}
+
+QVector<int> GraphCsr::cone(const QVector<int>& seeds,
+                            Direction direction,
+                            int maxHops,
+                            const QString& typeFilter) const {
+    const QVector<int>& offsets = direction == Direction::FanOut ? m_outOffsets : m_inOffsets;
+    const QVector<int>& targets = direction == Direction::FanOut ? m_outTargets : m_inTargets;
+
+    VisitedFlags visited(m_nodeIds.size());
+    std::vector<int> frontier;
+    for (int seed : seeds) {
+        if (seed >= 0 && seed < m_nodeIds.size() && visited[seed].exchange(1) == 0) {
+            frontier.push_back(seed);
+        }
+    }
+
+    QVector<int> result;
+    for (int hop = 0; !frontier.empty() && (maxHops < 0 || hop < maxHops); ++hop) {
+        frontier = expandFrontier(frontier, offsets, targets, &visited);
+        for (int node : frontier) {
+            if (typeFilter.isEmpty() || m_nodeTypes[node] == typeFilter) {
+                result.push_back(node);
+            }
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+bool GraphCsr::reaches(int from, int to, int maxHops) const {
+    if (from < 0 || to < 0 || from >= m_nodeIds.size() || to >= m_nodeIds.size()) {
+        return false;
+    }
+    VisitedFlags visited(m_nodeIds.size());
+    // A node only reaches itself around a cycle, so it must not count as
+    // visited before the first hop.
+    if (from != to) {
+        visited[from].store(1);
+    }
+    std::vector<int> frontier{from};
+    for (int hop = 0; !frontier.empty() && (maxHops < 0 || hop < maxHops); ++hop) {
+        frontier = expandFrontier(frontier, m_outOffsets, m_outTargets, &visited);
+        if (visited[to].load() != 0) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "GraphDocument.h"
+
+#include <QHash>
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+// Immutable compressed-sparse-row snapshot of node connectivity. Both the
+// outgoing and incoming adjacency are stored so fan-out and fan-in queries
+// walk contiguous arrays; large BFS levels are expanded on worker threads.
+class GraphCsr {
+public:
+    enum class Direction {
+        FanOut,
+        FanIn
+    };
+
+    static GraphCsr fromDocument(const GraphDocument& document);
+    static GraphCsr build(const QVector<QString>& nodeIds,
+                          const QVector<QString>& nodeTypes,
+                          const QVector<QPair<int, int>>& edges);
+
+    int nodeCount() const;
+    int edgeCount() const;
+    int indexOf(const QString& nodeId) const;
+    QString nodeId(int index) const;
+    QString nodeType(int index) const;
+
+    // Nodes reachable from the seeds (seeds excluded) within maxHops edges
+    // (negative means unbounded), sorted by index. A non-empty typeFilter
+    // limits the result to nodes of that type; traversal still passes
+    // through other types.
+    QVector<int> cone(const QVector<int>& seeds,
+                      Direction direction,
+                      int maxHops = -1,
+                      const QString& typeFilter = QString()) const;
+    // A node reaches itself only around a cycle.
+    bool reaches(int from, int to, int maxHops = -1) const;
+
+private:
+    QVector<QString> m_nodeIds;
+    QVector<QString> m_nodeTypes;
+    QHash<QString, int> m_indexById;
+    QVector<int> m_outOffsets;
+    QVector<int> m_outTargets;
+    QVector<int> m_inOffsets;
+    QVector<int> m_inTargets;
+};
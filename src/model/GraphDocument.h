@@ -57,6 +57,7 @@ struct GraphDocument {
     QString edgeBundlePolicy = QStringLiteral("centered");
     QString edgeBundleScope = QStringLiteral("global");
     qreal edgeBundleSpacing = 18.0;
+    bool dagOnly = false;
     QVector<QString> collapsedGroupIds;
     QVector<NodeData> nodes;
     QVector<EdgeData> edges;
@@ -0,0 +1,615 @@
+#include "GraphJournal.h"
+
+#include "BinaryGraphFormat.h"
+#include "Crc32.h"
+#include "FileSync.h"
+
+#include <QDateTime>
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+#include <QtEndian>
+
+#include <algorithm>
+
+namespace {
+constexpr quint32 kClearedFlag = 1u;
+constexpr quint32 kSettingsFlag = 2u;
+
+struct BaseStamp {
+    qint64 size = -1;
+    qint64 modifiedMs = 0;
+};
+
+BaseStamp stampOf(const QString& documentPath) {
+    const QFileInfo info(documentPath);
+    if (!info.exists()) {
+        return BaseStamp();
+    }
+    return BaseStamp{info.size(), info.lastModified().toMSecsSinceEpoch()};
+}
+
+QByteArray encodeHeader(const BaseStamp& stamp) {
+    QByteArray header(GraphJournal::kHeaderSize, '\0');
+    char* p = header.data();
+    qToLittleEndian<quint32>(GraphJournal::kMagic, p);
+    qToLittleEndian<quint16>(GraphJournal::kFormatVersion, p + 4);
+    qToLittleEndian<qint64>(stamp.size, p + 8);
+    qToLittleEndian<qint64>(stamp.modifiedMs, p + 16);
+    return header;
+}
+
+bool headerMatches(const QByteArray& data, const BaseStamp& stamp) {
+    if (data.size() < GraphJournal::kHeaderSize || stamp.size < 0) {
+        return false;
+    }
+    const char* p = data.constData();
+    return qFromLittleEndian<quint32>(p) == GraphJournal::kMagic &&
+           qFromLittleEndian<quint16>(p + 4) == GraphJournal::kFormatVersion &&
+           qFromLittleEndian<qint64>(p + 8) == stamp.size && qFromLittleEndian<qint64>(p + 16) == stamp.modifiedMs;
+}
+
+// Reads the record at *pos and advances past it. Fails on a torn or corrupt
+// record, which is where a valid journal ends.
+bool nextRecord(const QByteArray& data, qint64* pos, QByteArray* payload) {
+    const qint64 size = data.size();
+    if (size - *pos < GraphJournal::kRecordHeaderSize) {
+        return false;
+    }
+    const char* p = data.constData() + *pos;
+    const qint64 payloadSize = qFromLittleEndian<quint32>(p);
+    const quint32 crc = qFromLittleEndian<quint32>(p + 4);
+    if (payloadSize > size - *pos - GraphJournal::kRecordHeaderSize) {
+        return false;
+    }
+    const char* body = p + GraphJournal::kRecordHeaderSize;
+    if (Crc32::compute(body, payloadSize) != crc) {
+        return false;
+    }
+    if (payload) {
+        *payload = QByteArray(body, static_cast<int>(payloadSize));
+    }
+    *pos += GraphJournal::kRecordHeaderSize + payloadSize;
+    return true;
+}
+
+// Offset one past the last intact record.
+qint64 scanRecords(const QByteArray& data, int* recordCount) {
+    qint64 pos = GraphJournal::kHeaderSize;
+    int count = 0;
+    while (nextRecord(data, &pos, nullptr)) {
+        ++count;
+    }
+    if (recordCount) {
+        *recordCount = count;
+    }
+    return pos;
+}
+
+bool readJournal(const QString& documentPath, QByteArray* data, QString* errorMessage) {
+    QFile file(GraphJournal::journalPathFor(documentPath));
+    if (!file.exists()) {
+        if (errorMessage) {
+            *errorMessage = QStringLiteral("No journal for %1").arg(documentPath);
+        }
+        return false;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorMessage) {
+            *errorMessage = QStringLiteral("Cannot open journal: %1").arg(file.errorString());
+        }
+        return false;
+    }
+    *data = file.readAll();
+    if (!headerMatches(*data, stampOf(documentPath))) {
+        if (errorMessage) {
+            *errorMessage = QStringLiteral("Journal does not belong to the saved file");
+        }
+        return false;
+    }
+    return true;
+}
+
+void appendU32(QByteArray* out, quint32 value) {
+    char bytes[4];
+    qToLittleEndian(value, bytes);
+    out->append(bytes, 4);
+}
+
+void appendString(QByteArray* out, const QString& text) {
+    appendU32(out, static_cast<quint32>(text.size()));
+    for (const QChar c : text) {
+        char bytes[2];
+        qToLittleEndian<quint16>(c.unicode(), bytes);
+        out->append(bytes, 2);
+    }
+}
+
+bool readU32(const QByteArray& data, qint64* pos, quint32* value) {
+    if (data.size() - *pos < 4) {
+        return false;
+    }
+    *value = qFromLittleEndian<quint32>(data.constData() + *pos);
+    *pos += 4;
+    return true;
+}
+
+bool readStrings(const QByteArray& data, qint64* pos, quint32 count, QVector<QString>* out) {
+    out->clear();
+    for (quint32 i = 0; i < count; ++i) {
+        quint32 length = 0;
+        if (!readU32(data, pos, &length) || (data.size() - *pos) / 2 < length) {
+            return false;
+        }
+        QString text(static_cast<int>(length), Qt::Uninitialized);
+        const char* p = data.constData() + *pos;
+        for (quint32 c = 0; c < length; ++c) {
+            text[static_cast<int>(c)] = QChar(qFromLittleEndian<quint16>(p + 2 * c));
+        }
+        *pos += 2 * static_cast<qint64>(length);
+        out->push_back(text);
+    }
+    return true;
+}
+
+void copySettings(const GraphDocument& from, GraphDocument* to) {
+    QVector<NodeData> nodes = std::move(to->nodes);
+    QVector<EdgeData> edges = std::move(to->edges);
+    const int schemaVersion = to->schemaVersion;
+    *to = from;
+    to->schemaVersion = schemaVersion;
+    to->nodes = std::move(nodes);
+    to->edges = std::move(edges);
+}
+
+bool sameNode(const NodeData& a, const NodeData& b) {
+    if (a.id != b.id || a.type != b.type || a.name != b.name || a.position != b.position || a.size != b.size ||
+        a.rotationDegrees != b.rotationDegrees || a.z != b.z || a.groupId != b.groupId || a.layerId != b.layerId ||
+        a.ports.size() != b.ports.size() || a.properties.size() != b.properties.size()) {
+        return false;
+    }
+    for (int i = 0; i < a.ports.size(); ++i) {
+        const PortData& p1 = a.ports[i];
+        const PortData& p2 = b.ports[i];
+        if (p1.id != p2.id || p1.name != p2.name || p1.direction != p2.direction) {
+            return false;
+        }
+    }
+    for (int i = 0; i < a.properties.size(); ++i) {
+        const PropertyData& p1 = a.properties[i];
+        const PropertyData& p2 = b.properties[i];
+        if (p1.key != p2.key || p1.type != p2.type || p1.value != p2.value) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool sameEdge(const EdgeData& a, const EdgeData& b) {
+    return a.id == b.id && a.fromNodeId == b.fromNodeId && a.fromPortId == b.fromPortId && a.toNodeId == b.toNodeId &&
+           a.toPortId == b.toPortId;
+}
+
+bool sameSettings(const GraphDocument& a, const GraphDocument& b) {
+    if (a.autoLayoutMode != b.autoLayoutMode || a.autoLayoutXSpacing != b.autoLayoutXSpacing ||
+        a.autoLayoutYSpacing != b.autoLayoutYSpacing || a.activeLayerId != b.activeLayerId ||
+        a.edgeRoutingProfile != b.edgeRoutingProfile || a.edgeBundlePolicy != b.edgeBundlePolicy ||
+        a.edgeBundleScope != b.edgeBundleScope || a.edgeBundleSpacing != b.edgeBundleSpacing || a.dagOnly != b.dagOnly ||
+        a.layers.size() != b.layers.size()) {
+        return false;
+    }
+    for (int i = 0; i < a.layers.size(); ++i) {
+        const LayerData& l1 = a.layers[i];
+        const LayerData& l2 = b.layers[i];
+        if (l1.id != l2.id || l1.name != l2.name || l1.visible != l2.visible || l1.locked != l2.locked) {
+            return false;
+        }
+    }
+    QVector<QString> collapsedA = a.collapsedGroupIds;
+    QVector<QString> collapsedB = b.collapsedGroupIds;
+    std::sort(collapsedA.begin(), collapsedA.end());
+    std::sort(collapsedB.begin(), collapsedB.end());
+    return collapsedA == collapsedB;
+}
+
+// Applies deltas to a document through id indices built once, so replaying a
+// long journal costs the size of its records, not records times document.
+// Removed entities are tombstoned (empty id) and dropped in finish().
+class DocumentPatcher {
+public:
+    explicit DocumentPatcher(GraphDocument* document)
+        : m_document(document) {
+        m_nodeIndex.reserve(document->nodes.size());
+        for (int i = 0; i < document->nodes.size(); ++i) {
+            m_nodeIndex.insert(document->nodes[i].id, i);
+        }
+        m_edgeIndex.reserve(document->edges.size());
+        for (int i = 0; i < document->edges.size(); ++i) {
+            m_edgeIndex.insert(document->edges[i].id, i);
+        }
+    }
+
+    void apply(const GraphDelta& delta) {
+        if (delta.cleared) {
+            m_document->nodes.clear();
+            m_document->edges.clear();
+            m_nodeIndex.clear();
+            m_edgeIndex.clear();
+        }
+        if (delta.hasSettings) {
+            copySettings(delta.settings, m_document);
+        }
+        for (const QString& id : delta.removedNodeIds) {
+            const auto it = m_nodeIndex.find(id);
+            if (it != m_nodeIndex.end()) {
+                m_document->nodes[it.value()].id.clear();
+                m_nodeIndex.erase(it);
+            }
+        }
+        for (const QString& id : delta.removedEdgeIds) {
+            const auto it = m_edgeIndex.find(id);
+            if (it != m_edgeIndex.end()) {
+                m_document->edges[it.value()].id.clear();
+                m_edgeIndex.erase(it);
+            }
+        }
+        for (const NodeData& node : delta.nodes) {
+            const auto it = m_nodeIndex.constFind(node.id);
+            if (it != m_nodeIndex.constEnd()) {
+                m_document->nodes[it.value()] = node;
+            } else {
+                m_nodeIndex.insert(node.id, m_document->nodes.size());
+                m_document->nodes.push_back(node);
+            }
+        }
+        for (const EdgeData& edge : delta.edges) {
+            const auto it = m_edgeIndex.constFind(edge.id);
+            if (it != m_edgeIndex.constEnd()) {
+                m_document->edges[it.value()] = edge;
+            } else {
+                m_edgeIndex.insert(edge.id, m_document->edges.size());
+                m_document->edges.push_back(edge);
+            }
+        }
+    }
+
+    void finish() {
+        QVector<NodeData>& nodes = m_document->nodes;
+        nodes.erase(std::remove_if(nodes.begin(), nodes.end(), [](const NodeData& node) { return node.id.isEmpty(); }),
+                    nodes.end());
+        // Edges of removed nodes are only implied by the node removal.
+        QVector<EdgeData>& edges = m_document->edges;
+        edges.erase(std::remove_if(edges.begin(),
+                                   edges.end(),
+                                   [this](const EdgeData& edge) {
+                                       return edge.id.isEmpty() || !m_nodeIndex.contains(edge.fromNodeId) ||
+                                              !m_nodeIndex.contains(edge.toNodeId);
+                                   }),
+                    edges.end());
+    }
+
+private:
+    GraphDocument* m_document = nullptr;
+    QHash<QString, int> m_nodeIndex;
+    QHash<QString, int> m_edgeIndex;
+};
+}  // namespace
+
+bool GraphChangeSet::isEmpty() const {
+    return nodeIds.isEmpty() && edgeIds.isEmpty() && !settings;
+}
+
+void GraphChangeSet::unite(const GraphChangeSet& other) {
+    nodeIds.unite(other.nodeIds);
+    edgeIds.unite(other.edgeIds);
+    settings = settings || other.settings;
+}
+
+GraphChangeSet GraphChangeSet::between(const GraphDocument& before, const GraphDocument& after) {
+    GraphChangeSet changes;
+    QHash<QString, const NodeData*> beforeNodes;
+    beforeNodes.reserve(before.nodes.size());
+    for (const NodeData& node : before.nodes) {
+        beforeNodes.insert(node.id, &node);
+    }
+    for (const NodeData& node : after.nodes) {
+        const NodeData* previous = beforeNodes.take(node.id);
+        if (!previous || !sameNode(*previous, node)) {
+            changes.nodeIds.insert(node.id);
+        }
+    }
+    for (auto it = beforeNodes.constBegin(); it != beforeNodes.constEnd(); ++it) {
+        changes.nodeIds.insert(it.key());
+    }
+
+    QHash<QString, const EdgeData*> beforeEdges;
+    beforeEdges.reserve(before.edges.size());
+    for (const EdgeData& edge : before.edges) {
+        beforeEdges.insert(edge.id, &edge);
+    }
+    for (const EdgeData& edge : after.edges) {
+        const EdgeData* previous = beforeEdges.take(edge.id);
+        if (!previous || !sameEdge(*previous, edge)) {
+            changes.edgeIds.insert(edge.id);
+        }
+    }
+    for (auto it = beforeEdges.constBegin(); it != beforeEdges.constEnd(); ++it) {
+        changes.edgeIds.insert(it.key());
+    }
+
+    changes.settings = !sameSettings(before, after);
+    return changes;
+}
+
+bool GraphDelta::isEmpty() const {
+    return !cleared && !hasSettings && nodes.isEmpty() && edges.isEmpty() && removedNodeIds.isEmpty() &&
+           removedEdgeIds.isEmpty();
+}
+
+GraphJournal::~GraphJournal() {
+    close();
+}
+
+QString GraphJournal::journalPathFor(const QString& documentPath) {
+    return documentPath + QStringLiteral(".journal");
+}
+
+bool GraphJournal::hasRecoverableEdits(const QString& documentPath) {
+    QByteArray data;
+    if (!readJournal(documentPath, &data, nullptr)) {
+        return false;
+    }
+    int records = 0;
+    scanRecords(data, &records);
+    return records > 0;
+}
+
+bool GraphJournal::replay(const QString& documentPath,
+                          GraphDocument* document,
+                          int* appliedRecords,
+                          QString* errorMessage) {
+    if (appliedRecords) {
+        *appliedRecords = 0;
+    }
+    if (!document) {
+        if (errorMessage) {
+            *errorMessage = QStringLiteral("Document pointer is null");
+        }
+        return false;
+    }
+    QByteArray data;
+    if (!readJournal(documentPath, &data, errorMessage)) {
+        return false;
+    }
+
+    DocumentPatcher patcher(document);
+    qint64 pos = kHeaderSize;
+    QByteArray payload;
+    GraphDelta delta;
+    int applied = 0;
+    while (nextRecord(data, &pos, &payload)) {
+        if (!decodeRecord(payload, &delta, nullptr)) {
+            break;
+        }
+        patcher.apply(delta);
+        ++applied;
+    }
+    patcher.finish();
+    if (appliedRecords) {
+        *appliedRecords = applied;
+    }
+    return true;
+}
+
+void GraphJournal::apply(const GraphDelta& delta, GraphDocument* document) {
+    if (!document) {
+        return;
+    }
+    DocumentPatcher patcher(document);
+    patcher.apply(delta);
+    patcher.finish();
+}
+
+QByteArray GraphJournal::encodeRecord(const GraphDelta& delta) {
+    GraphDocument body = delta.hasSettings ? delta.settings : GraphDocument();
+    body.nodes = delta.nodes;
+    body.edges = delta.edges;
+
+    QByteArray payload;
+    appendU32(&payload, (delta.cleared ? kClearedFlag : 0u) | (delta.hasSettings ? kSettingsFlag : 0u));
+    appendU32(&payload, static_cast<quint32>(delta.removedNodeIds.size()));
+    appendU32(&payload, static_cast<quint32>(delta.removedEdgeIds.size()));
+    for (const QString& id : delta.removedNodeIds) {
+        appendString(&payload, id);
+    }
+    for (const QString& id : delta.removedEdgeIds) {
+        appendString(&payload, id);
+    }
+    payload.append(BinaryGraphFormat::encode(body));
+    return payload;
+}
+
+bool GraphJournal::decodeRecord(const QByteArray& payload, GraphDelta* delta, QString* errorMessage) {
+    if (!delta) {
+        if (errorMessage) {
+            *errorMessage = QStringLiteral("Delta pointer is null");
+        }
+        return false;
+    }
+    qint64 pos = 0;
+    quint32 flags = 0;
+    quint32 removedNodes = 0;
+    quint32 removedEdges = 0;
+    if (!readU32(payload, &pos, &flags) || !readU32(payload, &pos, &removedNodes) ||
+        !readU32(payload, &pos, &removedEdges) || !readStrings(payload, &pos, removedNodes, &delta->removedNodeIds) ||
+        !readStrings(payload, &pos, removedEdges, &delta->removedEdgeIds)) {
+        if (errorMessage) {
+            *errorMessage = QStringLiteral("Journal record is truncated");
+        }
+        return false;
+    }
+    GraphDocument body;
+    if (!BinaryGraphFormat::decode(payload.mid(static_cast<int>(pos)), &body, errorMessage)) {
+        return false;
+    }
+    delta->cleared = (flags & kClearedFlag) != 0;
+    delta->hasSettings = (flags & kSettingsFlag) != 0;
+    delta->nodes = std::move(body.nodes);
+    delta->edges = std::move(body.edges);
+    body.nodes.clear();
+    body.edges.clear();
+    delta->settings = delta->hasSettings ? body : GraphDocument();
+    return true;
+}
+
+bool GraphJournal::open(const QString& documentPath, QString* errorMessage) {
+    close();
+    m_documentPath = documentPath;
+    m_recordCount = 0;
+    m_unsyncedRecords = 0;
+    m_errorString.clear();
+
+    QByteArray existing;
+    qint64 end = 0;
+    if (readJournal(documentPath, &existing, nullptr)) {
+        end = scanRecords(existing, &m_recordCount);
+    }
+    m_file.setFileName(journalPathFor(documentPath));
+    if (end > 0) {
+        if (!m_file.open(QIODevice::ReadWrite | QIODevice::Unbuffered) || !m_file.resize(end) || !m_file.seek(end)) {
+            return fail(QStringLiteral("Cannot open journal: %1").arg(m_file.errorString()), errorMessage);
+        }
+        m_size = end;
+        return true;
+    }
+
+    if (!m_file.open(QIODevice::ReadWrite | QIODevice::Truncate | QIODevice::Unbuffered)) {
+        return fail(QStringLiteral("Cannot create journal: %1").arg(m_file.errorString()), errorMessage);
+    }
+    const QByteArray header = encodeHeader(stampOf(documentPath));
+    if (m_file.write(header) != header.size() || !FileSync::flushToDisk(&m_file)) {
+        return fail(QStringLiteral("Cannot write journal: %1").arg(m_file.errorString()), errorMessage);
+    }
+    m_size = header.size();
+    return true;
+}
+
+bool GraphJournal::isOpen() const {
+    return m_file.isOpen();
+}
+
+QString GraphJournal::documentPath() const {
+    return m_documentPath;
+}
+
+bool GraphJournal::append(const GraphDelta& delta) {
+    if (!m_file.isOpen()) {
+        return false;
+    }
+    const QByteArray payload = encodeRecord(delta);
+    QByteArray record(kRecordHeaderSize, Qt::Uninitialized);
+    qToLittleEndian<quint32>(static_cast<quint32>(payload.size()), record.data());
+    qToLittleEndian<quint32>(Crc32::compute(payload), record.data() + 4);
+    record.append(payload);
+    // One unbuffered write per record: it survives a crash of the process as
+    // soon as it returns, and sync() makes batches of them durable on disk.
+    if (m_file.write(record) != record.size()) {
+        return fail(QStringLiteral("Journal write failed: %1").arg(m_file.errorString()), nullptr);
+    }
+    m_size += record.size();
+    ++m_recordCount;
+    if (++m_unsyncedRecords >= kSyncBatchRecords) {
+        return sync();
+    }
+    return true;
+}
+
+bool GraphJournal::sync() {
+    if (!m_file.isOpen() || m_unsyncedRecords == 0) {
+        return true;
+    }
+    if (!FileSync::flushToDisk(&m_file)) {
+        return fail(QStringLiteral("Journal sync failed: %1").arg(m_file.errorString()), nullptr);
+    }
+    m_unsyncedRecords = 0;
+    return true;
+}
+
+int GraphJournal::unsyncedRecords() const {
+    return m_unsyncedRecords;
+}
+
+int GraphJournal::recordCount() const {
+    return m_recordCount;
+}
+
+qint64 GraphJournal::size() const {
+    return m_size;
+}
+
+bool GraphJournal::rebase(const QString& documentPath, qint64 fromOffset, QString* errorMessage) {
+    if (!m_file.isOpen()) {
+        return open(documentPath, errorMessage);
+    }
+
+    // Records appended after the saved snapshot are not in the new base.
+    fromOffset = qBound<qint64>(kHeaderSize, fromOffset, m_size);
+    if (!m_file.flush() || !m_file.seek(fromOffset)) {
+        return fail(QStringLiteral("Cannot read journal: %1").arg(m_file.errorString()), errorMessage);
+    }
+    const QByteArray tail = m_file.read(m_size - fromOffset);
+    const QString previousPath = m_file.fileName();
+    m_file.close();
+
+    const QString path = journalPathFor(documentPath);
+    QSaveFile out(path);
+    QByteArray rebased = encodeHeader(stampOf(documentPath));
+    rebased.append(tail);
+    if (!out.open(QIODevice::WriteOnly) || out.write(rebased) != rebased.size() || !out.commit()) {
+        return fail(QStringLiteral("Cannot rewrite journal: %1").arg(out.errorString()), errorMessage);
+    }
+    if (previousPath != path) {
+        QFile::remove(previousPath);
+    }
+
+    m_documentPath = documentPath;
+    m_size = scanRecords(rebased, &m_recordCount);
+    m_unsyncedRecords = 0;
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadWrite | QIODevice::Unbuffered) || !m_file.resize(m_size) ||
+        !m_file.seek(m_size)) {
+        return fail(QStringLiteral("Cannot open journal: %1").arg(m_file.errorString()), errorMessage);
+    }
+    return true;
+}
+
+void GraphJournal::discard() {
+    const QString path = m_file.fileName();
+    m_unsyncedRecords = 0;
+    m_file.close();
+    if (!path.isEmpty()) {
+        QFile::remove(path);
+    }
+    m_documentPath.clear();
+    m_size = 0;
+    m_recordCount = 0;
+}
+
+void GraphJournal::close() {
+    if (m_file.isOpen()) {
+        sync();
+        m_file.close();
+    }
+}
+
+QString GraphJournal::errorString() const {
+    return m_errorString;
+}
+
+bool GraphJournal::fail(const QString& message, QString* errorMessage) {
+    m_errorString = message;
+    if (errorMessage) {
+        *errorMessage = message;
+    }
+    return false;
+}
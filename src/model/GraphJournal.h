@@ -0,0 +1,106 @@
+#pragma once
+
+#include "GraphDocument.h"
+
+#include <QByteArray>
+#include <QFile>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+// Ids an edit touched. The journal stores their state after the edit, so the
+// same set describes both applying and undoing a command.
+struct GraphChangeSet {
+    QSet<QString> nodeIds;
+    QSet<QString> edgeIds;
+    bool settings = false;  // layers, active layer, collapsed groups, options
+
+    bool isEmpty() const;
+    void unite(const GraphChangeSet& other);
+    // Entities that differ between two whole documents.
+    static GraphChangeSet between(const GraphDocument& before, const GraphDocument& after);
+};
+
+// One journal record: the after-state of everything an edit touched. Ids in
+// nodes/edges are inserted or replaced, removed ids are dropped.
+struct GraphDelta {
+    bool cleared = false;  // drop every node and edge before applying the rest
+    QVector<NodeData> nodes;
+    QVector<EdgeData> edges;
+    QVector<QString> removedNodeIds;
+    QVector<QString> removedEdgeIds;
+    bool hasSettings = false;
+    GraphDocument settings;  // nodes and edges are unused
+
+    bool isEmpty() const;
+};
+
+// Append-only edit log kept next to a saved document (`<path>.journal`).
+//
+// Layout: a 32-byte header (magic, format version, size and modification time
+// of the base file it extends), then records of u32 payload size, u32 CRC-32
+// and the payload. A payload is u32 flags, the removed node and edge ids, and
+// an `.edab` encoding of the upserted nodes, edges and (optionally) settings.
+// A torn or corrupt tail ends the journal. A journal whose base stamp does not
+// match the file on disk is stale and ignored.
+class GraphJournal {
+public:
+    static constexpr quint32 kMagic = 0x4A414445;  // "EDAJ"
+    static constexpr quint16 kFormatVersion = 1;
+    static constexpr int kHeaderSize = 32;
+    static constexpr int kRecordHeaderSize = 8;
+    // Records written between two fsyncs at most; callers sync sooner on idle.
+    static constexpr int kSyncBatchRecords = 32;
+
+    GraphJournal() = default;
+    ~GraphJournal();
+    GraphJournal(const GraphJournal&) = delete;
+    GraphJournal& operator=(const GraphJournal&) = delete;
+
+    static QString journalPathFor(const QString& documentPath);
+    // True when a journal matching the base file holds at least one record.
+    static bool hasRecoverableEdits(const QString& documentPath);
+    // Applies the journal of documentPath on top of document, which must hold
+    // that file's content. Records after a torn or corrupt one are ignored.
+    static bool replay(const QString& documentPath,
+                       GraphDocument* document,
+                       int* appliedRecords = nullptr,
+                       QString* errorMessage = nullptr);
+    static void apply(const GraphDelta& delta, GraphDocument* document);
+
+    static QByteArray encodeRecord(const GraphDelta& delta);
+    static bool decodeRecord(const QByteArray& payload, GraphDelta* delta, QString* errorMessage = nullptr);
+
+    // Continues a valid journal for documentPath (dropping a torn tail), or
+    // starts an empty one when there is none or it is stale.
+    bool open(const QString& documentPath, QString* errorMessage = nullptr);
+    bool isOpen() const;
+    QString documentPath() const;
+
+    bool append(const GraphDelta& delta);
+    // Flushes and fsyncs records appended since the last sync.
+    bool sync();
+    int unsyncedRecords() const;
+    int recordCount() const;
+    qint64 size() const;
+
+    // After the document was fully saved to documentPath: restamps the journal
+    // for the new base and keeps only the records from `fromOffset` (a size()
+    // taken when the saved snapshot was made). A journal for a different
+    // previous path is removed.
+    bool rebase(const QString& documentPath, qint64 fromOffset, QString* errorMessage = nullptr);
+    // Closes and deletes the journal file, e.g. once edits were saved or discarded.
+    void discard();
+    void close();
+    QString errorString() const;
+
+private:
+    bool fail(const QString& message, QString* errorMessage);
+
+    QFile m_file;
+    QString m_documentPath;
+    qint64 m_size = 0;
+    int m_recordCount = 0;
+    int m_unsyncedRecords = 0;
+    QString m_errorString;
+};
@@ -1,75 +1,92 @@
 #include "GraphSerializer.h"
 
+#include "BinaryGraphFormat.h"
+#include "ChunkedGraphFormat.h"
+#include "CompressedGraphFormat.h"
+#include "JsonChunkScanner.h"
+#include "JsonStreamWriter.h"
+#include "StringAtom.h"
+
 #include <QFile>
 #include <QHash>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QSaveFile>
+#include <QSet>
 
 #include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
 
 namespace {
-QJsonObject toJson(const PortData& port) {
-    QJsonObject o;
-    o[QStringLiteral("id")] = port.id;
-    o[QStringLiteral("name")] = port.name;
-    o[QStringLiteral("direction")] = port.direction;
-    return o;
+// Members are written in QJsonObject's sorted key order so the stream is
+// byte-identical to what QJsonDocument would produce for the same document.
+void writeJson(JsonStreamWriter* writer, const PortData& port) {
+    writer->beginObject();
+    writer->writeMember(QStringLiteral("direction"), port.direction);
+    writer->writeMember(QStringLiteral("id"), port.id);
+    writer->writeMember(QStringLiteral("name"), port.name);
+    writer->endObject();
 }
 
-QJsonObject toJson(const NodeData& node) {
-    QJsonObject o;
-    o[QStringLiteral("id")] = node.id;
-    o[QStringLiteral("type")] = node.type;
-    o[QStringLiteral("name")] = node.name;
-    o[QStringLiteral("x")] = node.position.x();
-    o[QStringLiteral("y")] = node.position.y();
-    o[QStringLiteral("w")] = node.size.width();
-    o[QStringLiteral("h")] = node.size.height();
-    o[QStringLiteral("rotation")] = node.rotationDegrees;
-    o[QStringLiteral("z")] = node.z;
+void writeJson(JsonStreamWriter* writer, const NodeData& node) {
+    writer->beginObject();
     if (!node.groupId.isEmpty()) {
-        o[QStringLiteral("groupId")] = node.groupId;
+        writer->writeMember(QStringLiteral("groupId"), node.groupId);
     }
+    writer->writeMember(QStringLiteral("h"), node.size.height());
+    writer->writeMember(QStringLiteral("id"), node.id);
     if (!node.layerId.isEmpty()) {
-        o[QStringLiteral("layerId")] = node.layerId;
+        writer->writeMember(QStringLiteral("layerId"), node.layerId);
     }
+    writer->writeMember(QStringLiteral("name"), node.name);
 
-    QJsonArray ports;
+    writer->writeKey(QStringLiteral("ports"));
+    writer->beginArray();
     for (const PortData& p : node.ports) {
-        ports.append(toJson(p));
+        writeJson(writer, p);
     }
-    o[QStringLiteral("ports")] = ports;
+    writer->endArray();
 
-    QJsonArray properties;
+    writer->writeKey(QStringLiteral("properties"));
+    writer->beginArray();
     for (const PropertyData& prop : node.properties) {
-        QJsonObject p;
-        p[QStringLiteral("key")] = prop.key;
-        p[QStringLiteral("type")] = prop.type;
-        p[QStringLiteral("value")] = prop.value;
-        properties.append(p);
-    }
-    o[QStringLiteral("properties")] = properties;
-    return o;
+        writer->beginObject();
+        writer->writeMember(QStringLiteral("key"), prop.key);
+        writer->writeMember(QStringLiteral("type"), prop.type);
+        writer->writeMember(QStringLiteral("value"), prop.value);
+        writer->endObject();
+    }
+    writer->endArray();
+
+    writer->writeMember(QStringLiteral("rotation"), node.rotationDegrees);
+    writer->writeMember(QStringLiteral("type"), node.type);
+    writer->writeMember(QStringLiteral("w"), node.size.width());
+    writer->writeMember(QStringLiteral("x"), node.position.x());
+    writer->writeMember(QStringLiteral("y"), node.position.y());
+    writer->writeMember(QStringLiteral("z"), node.z);
+    writer->endObject();
 }
 
-QJsonObject toJson(const LayerData& layer) {
-    QJsonObject o;
-    o[QStringLiteral("id")] = layer.id;
-    o[QStringLiteral("name")] = layer.name;
-    o[QStringLiteral("visible")] = layer.visible;
-    o[QStringLiteral("locked")] = layer.locked;
-    return o;
+void writeJson(JsonStreamWriter* writer, const LayerData& layer) {
+    writer->beginObject();
+    writer->writeMember(QStringLiteral("id"), layer.id);
+    writer->writeMember(QStringLiteral("locked"), layer.locked);
+    writer->writeMember(QStringLiteral("name"), layer.name);
+    writer->writeMember(QStringLiteral("visible"), layer.visible);
+    writer->endObject();
 }
 
-QJsonObject toJson(const EdgeData& edge) {
-    QJsonObject o;
-    o[QStringLiteral("id")] = edge.id;
-    o[QStringLiteral("fromNodeId")] = edge.fromNodeId;
-    o[QStringLiteral("fromPortId")] = edge.fromPortId;
-    o[QStringLiteral("toNodeId")] = edge.toNodeId;
-    o[QStringLiteral("toPortId")] = edge.toPortId;
-    return o;
+void writeJson(JsonStreamWriter* writer, const EdgeData& edge) {
+    writer->beginObject();
+    writer->writeMember(QStringLiteral("fromNodeId"), edge.fromNodeId);
+    writer->writeMember(QStringLiteral("fromPortId"), edge.fromPortId);
+    writer->writeMember(QStringLiteral("id"), edge.id);
+    writer->writeMember(QStringLiteral("toNodeId"), edge.toNodeId);
+    writer->writeMember(QStringLiteral("toPortId"), edge.toPortId);
+    writer->endObject();
 }
 
 bool fromJson(const QJsonObject& o, PortData* out) {
@@ -144,6 +161,170 @@ bool fromJson(const QJsonObject& o, EdgeData* out) {
     return !out->fromNodeId.isEmpty() && !out->toNodeId.isEmpty();
 }
 
+// Repeated strings seen by one decode chunk. Workers fill their own pool
+// without locking; once all chunks are decoded, the calling thread maps each
+// distinct value to one copy for the whole document and the records are
+// pointed at it. Only vocabulary goes to the process-wide atom table; names
+// that belong to the document (types, group and layer ids, port names) are
+// shared within the load and freed with it.
+class StringPool {
+public:
+    void shareVocabulary(QString* text) { share(&m_vocabulary, text); }
+    void shareName(QString* text) { share(&m_names, text); }
+
+    // Replaces every pooled value by its document-wide copy; vocabulary is
+    // interned once per distinct text across all pools merged into shared.
+    void mergeInto(QHash<QString, QString>* sharedVocabulary, QHash<QString, QString>* sharedNames) {
+        merge(&m_vocabulary, sharedVocabulary, true);
+        merge(&m_names, sharedNames, false);
+    }
+
+private:
+    static void share(QHash<QString, QString>* strings, QString* text) {
+        if (text->isEmpty()) {
+            return;
+        }
+        const auto it = strings->constFind(*text);
+        if (it != strings->constEnd()) {
+            *text = it.value();
+            return;
+        }
+        strings->insert(*text, *text);
+    }
+
+    static void merge(QHash<QString, QString>* strings, QHash<QString, QString>* shared, bool intern) {
+        for (auto it = strings->begin(); it != strings->end(); ++it) {
+            auto canonical = shared->constFind(it.key());
+            if (canonical == shared->constEnd()) {
+                canonical = shared->insert(it.key(), intern ? StringAtom::intern(it.key()) : it.value());
+            }
+            it.value() = canonical.value();
+        }
+    }
+
+    QHash<QString, QString> m_vocabulary;
+    QHash<QString, QString> m_names;
+};
+
+void shareStrings(NodeData* node, StringPool* pool) {
+    pool->shareName(&node->type);
+    pool->shareName(&node->groupId);
+    pool->shareName(&node->layerId);
+    for (PortData& port : node->ports) {
+        pool->shareName(&port.name);
+        pool->shareVocabulary(&port.direction);
+    }
+    for (PropertyData& property : node->properties) {
+        pool->shareVocabulary(&property.key);
+        pool->shareVocabulary(&property.type);
+    }
+}
+
+void shareStrings(EdgeData*, StringPool*) {}
+
+// Elements per parallel decode task; small documents end up in one chunk and
+// are decoded on the calling thread.
+constexpr int kElementsPerChunk = 2048;
+
+// Decode workers per load; 0 means one per core.
+std::atomic<int> decodeThreadLimit{0};
+
+// Runs work(chunk) for every chunk, spread over the decode workers and the
+// calling thread.
+template <typename Work>
+void forEachChunk(int chunkCount, const Work& work) {
+    std::atomic<int> nextChunk{0};
+    auto drain = [&]() {
+        for (int chunk = nextChunk++; chunk < chunkCount; chunk = nextChunk++) {
+            work(chunk);
+        }
+    };
+    const int limit = decodeThreadLimit.load();
+    const int threads = limit > 0 ? limit : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const int workerCount = std::min(threads, chunkCount);
+    if (workerCount <= 1) {
+        drain();
+        return;
+    }
+    std::vector<std::thread> workers;
+    workers.reserve(workerCount - 1);
+    for (int w = 1; w < workerCount; ++w) {
+        workers.emplace_back(drain);
+    }
+    drain();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+template <typename Data>
+bool decodeElements(const QByteArray& payload,
+                    const QVector<JsonSpan>& spans,
+                    QVector<Data>* out,
+                    QString* errorMessage) {
+    const int chunkCount = (static_cast<int>(spans.size()) + kElementsPerChunk - 1) / kElementsPerChunk;
+    std::vector<QVector<Data>> decoded(chunkCount);
+    std::vector<StringPool> pools(chunkCount);
+    std::vector<QString> errors(chunkCount);
+
+    forEachChunk(chunkCount, [&](int chunk) {
+        const int first = chunk * kElementsPerChunk;
+        const int last = std::min<int>(spans.size(), first + kElementsPerChunk) - 1;
+        const qint64 begin = spans[first].begin;
+        const qint64 end = spans[last].end;
+        QByteArray text;
+        text.reserve(static_cast<int>(end - begin + 2));
+        text.append('[');
+        text.append(payload.constData() + begin, static_cast<int>(end - begin));
+        text.append(']');
+
+        QJsonParseError parseError;
+        const QJsonDocument json = QJsonDocument::fromJson(text, &parseError);
+        if (parseError.error != QJsonParseError::NoError || !json.isArray()) {
+            errors[chunk] = parseError.errorString();
+            return;
+        }
+        const QJsonArray array = json.array();
+        QVector<Data>& target = decoded[chunk];
+        target.reserve(array.size());
+        for (const QJsonValue& value : array) {
+            Data data;
+            if (fromJson(value.toObject(), &data)) {
+                shareStrings(&data, &pools[chunk]);
+                target.push_back(data);
+            }
+        }
+    });
+
+    int total = 0;
+    for (int chunk = 0; chunk < chunkCount; ++chunk) {
+        if (!errors[chunk].isEmpty()) {
+            if (errorMessage) {
+                *errorMessage = QStringLiteral("Invalid JSON: %1").arg(errors[chunk]);
+            }
+            return false;
+        }
+        total += decoded[chunk].size();
+    }
+
+    QHash<QString, QString> vocabulary;
+    QHash<QString, QString> names;
+    for (StringPool& pool : pools) {
+        pool.mergeInto(&vocabulary, &names);
+    }
+    forEachChunk(chunkCount, [&](int chunk) {
+        for (Data& data : decoded[chunk]) {
+            shareStrings(&data, &pools[chunk]);
+        }
+    });
+
+    out->reserve(out->size() + total);
+    for (const QVector<Data>& part : decoded) {
+        out->append(part);
+    }
+    return true;
+}
+
 bool migrateToCurrent(GraphDocument* document, QString* errorMessage) {
     if (!document) {
         return false;
@@ -245,56 +426,145 @@ bool migrateToCurrent(GraphDocument* document, QString* errorMessage) {
     }
     return false;
 }
-}  // namespace
 
-bool GraphSerializer::saveToFile(const GraphDocument& document, const QString& filePath, QString* errorMessage) {
-    QJsonObject root;
-    root[QStringLiteral("schemaVersion")] = document.schemaVersion;
-    root[QStringLiteral("autoLayoutMode")] = document.autoLayoutMode;
-    root[QStringLiteral("autoLayoutXSpacing")] = document.autoLayoutXSpacing;
-    root[QStringLiteral("autoLayoutYSpacing")] = document.autoLayoutYSpacing;
-    root[QStringLiteral("activeLayerId")] = document.activeLayerId;
-    QJsonArray layers;
-    for (const LayerData& layer : document.layers) {
-        layers.append(toJson(layer));
-    }
-    root[QStringLiteral("layers")] = layers;
-    root[QStringLiteral("edgeRoutingProfile")] = document.edgeRoutingProfile;
-    root[QStringLiteral("edgeBundlePolicy")] = document.edgeBundlePolicy;
-    root[QStringLiteral("edgeBundleScope")] = document.edgeBundleScope;
-    root[QStringLiteral("edgeBundleSpacing")] = document.edgeBundleSpacing;
-    QJsonArray collapsedGroups;
+void writeDocumentJson(JsonStreamWriter* writer, const GraphDocument& document) {
+    writer->beginObject();
+    writer->writeMember(QStringLiteral("activeLayerId"), document.activeLayerId);
+    writer->writeMember(QStringLiteral("autoLayoutMode"), document.autoLayoutMode);
+    writer->writeMember(QStringLiteral("autoLayoutXSpacing"), document.autoLayoutXSpacing);
+    writer->writeMember(QStringLiteral("autoLayoutYSpacing"), document.autoLayoutYSpacing);
+    writer->writeKey(QStringLiteral("collapsedGroups"));
+    writer->beginArray();
     for (const QString& groupId : document.collapsedGroupIds) {
         if (!groupId.isEmpty()) {
-            collapsedGroups.append(groupId);
+            writer->writeString(groupId);
         }
     }
-    root[QStringLiteral("collapsedGroups")] = collapsedGroups;
-
-    QJsonArray nodes;
+    writer->endArray();
+    writer->writeMember(QStringLiteral("dagOnly"), document.dagOnly);
+    writer->writeMember(QStringLiteral("edgeBundlePolicy"), document.edgeBundlePolicy);
+    writer->writeMember(QStringLiteral("edgeBundleScope"), document.edgeBundleScope);
+    writer->writeMember(QStringLiteral("edgeBundleSpacing"), document.edgeBundleSpacing);
+    writer->writeMember(QStringLiteral("edgeRoutingProfile"), document.edgeRoutingProfile);
+    writer->writeKey(QStringLiteral("edges"));
+    writer->beginArray();
+    for (const EdgeData& e : document.edges) {
+        writeJson(writer, e);
+    }
+    writer->endArray();
+    writer->writeKey(QStringLiteral("layers"));
+    writer->beginArray();
+    for (const LayerData& layer : document.layers) {
+        writeJson(writer, layer);
+    }
+    writer->endArray();
+    writer->writeKey(QStringLiteral("nodes"));
+    writer->beginArray();
     for (const NodeData& n : document.nodes) {
-        nodes.append(toJson(n));
+        writeJson(writer, n);
     }
-    root[QStringLiteral("nodes")] = nodes;
+    writer->endArray();
+    writer->writeMember(QStringLiteral("schemaVersion"), document.schemaVersion);
+    writer->endObject();
+}
+}  // namespace
 
-    QJsonArray edges;
-    for (const EdgeData& e : document.edges) {
-        edges.append(toJson(e));
+void GraphSerializer::setDecodeThreadCount(int count) {
+    decodeThreadLimit.store(std::max(0, count));
+}
+
+void GraphSerializer::normalizeSettings(GraphDocument* document) {
+    if (document->autoLayoutMode.compare(QStringLiteral("grid"), Qt::CaseInsensitive) == 0) {
+        document->autoLayoutMode = QStringLiteral("grid");
+    } else {
+        document->autoLayoutMode = QStringLiteral("layered");
+    }
+    document->autoLayoutXSpacing = std::max<qreal>(40.0, document->autoLayoutXSpacing);
+    document->autoLayoutYSpacing = std::max<qreal>(40.0, document->autoLayoutYSpacing);
+    for (LayerData& layer : document->layers) {
+        if (layer.name.isEmpty()) {
+            layer.name = layer.id;
+        }
+    }
+    if (document->edgeRoutingProfile.compare(QStringLiteral("dense"), Qt::CaseInsensitive) == 0) {
+        document->edgeRoutingProfile = QStringLiteral("dense");
+    } else {
+        document->edgeRoutingProfile = QStringLiteral("balanced");
+    }
+    if (document->edgeBundlePolicy.compare(QStringLiteral("directional"), Qt::CaseInsensitive) == 0) {
+        document->edgeBundlePolicy = QStringLiteral("directional");
+    } else {
+        document->edgeBundlePolicy = QStringLiteral("centered");
+    }
+    if (document->edgeBundleScope.compare(QStringLiteral("layer"), Qt::CaseInsensitive) == 0) {
+        document->edgeBundleScope = QStringLiteral("layer");
+    } else if (document->edgeBundleScope.compare(QStringLiteral("group"), Qt::CaseInsensitive) == 0) {
+        document->edgeBundleScope = QStringLiteral("group");
+    } else {
+        document->edgeBundleScope = QStringLiteral("global");
     }
-    root[QStringLiteral("edges")] = edges;
+    document->edgeBundleSpacing = std::max<qreal>(0.0, document->edgeBundleSpacing);
+}
 
-    QFile file(filePath);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+bool GraphSerializer::saveToFile(const GraphDocument& document, const QString& filePath, QString* errorMessage) {
+    // Everything goes to a temporary file next to the target that only
+    // replaces it on commit(), so a failed or interrupted save never leaves a
+    // truncated document behind.
+    if (ChunkedGraphFormat::isChunkedPath(filePath)) {
+        return ChunkedGraphFormat::write(document, filePath, errorMessage);
+    }
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
         if (errorMessage) {
             *errorMessage = QStringLiteral("Cannot open file for write: %1").arg(file.errorString());
         }
         return false;
     }
 
-    const QByteArray payload = QJsonDocument(root).toJson(QJsonDocument::Indented);
-    if (file.write(payload) != payload.size()) {
+    if (CompressedGraphFormat::isCompressedPath(filePath)) {
+        // Indentation would only be compressed away again.
+        CompressedBlockWriter compressor(&file);
+        if (!compressor.open(QIODevice::WriteOnly) ||
+            !writeJson(document, &compressor, JsonStreamWriter::Format::Compact) || !compressor.finish()) {
+            if (errorMessage) {
+                *errorMessage = QStringLiteral("Write failed: %1").arg(compressor.errorString());
+            }
+            file.cancelWriting();
+            return false;
+        }
+    } else if (!BinaryGraphFormat::isBinaryPath(filePath)) {
+        if (!writeJson(document, &file, JsonStreamWriter::Format::Indented, errorMessage)) {
+            file.cancelWriting();
+            return false;
+        }
+    } else {
+        const QByteArray payload = BinaryGraphFormat::encode(document);
+        if (file.write(payload) != payload.size()) {
+            if (errorMessage) {
+                *errorMessage = QStringLiteral("Write failed: %1").arg(file.errorString());
+            }
+            file.cancelWriting();
+            return false;
+        }
+    }
+    if (!file.commit()) {
+        if (errorMessage) {
+            *errorMessage = QStringLiteral("Cannot replace file: %1").arg(file.errorString());
+        }
+        return false;
+    }
+    return true;
+}
+
+bool GraphSerializer::writeJson(const GraphDocument& document,
+                                QIODevice* device,
+                                JsonStreamWriter::Format format,
+                                QString* errorMessage) {
+    JsonStreamWriter writer(device, format);
+    writeDocumentJson(&writer, document);
+    if (!writer.flush()) {
         if (errorMessage) {
-            *errorMessage = QStringLiteral("Write failed: %1").arg(file.errorString());
+            *errorMessage = QStringLiteral("Write failed: %1").arg(writer.errorString());
         }
         return false;
     }
@@ -309,6 +579,14 @@ bool GraphSerializer::loadFromFile(GraphDocument* document, const QString& fileP
         return false;
     }
 
+    if (ChunkedGraphFormat::isChunkedPath(filePath)) {
+        if (!ChunkedGraphFormat::read(filePath, document, errorMessage)) {
+            return false;
+        }
+        normalizeSettings(document);
+        return migrateToCurrent(document, errorMessage);
+    }
+
     QFile file(filePath);
     if (!file.open(QIODevice::ReadOnly)) {
         if (errorMessage) {
@@ -317,63 +595,75 @@ bool GraphSerializer::loadFromFile(GraphDocument* document, const QString& fileP
         return false;
     }
 
-    const QByteArray payload = file.readAll();
-    QJsonParseError parseError;
-    const QJsonDocument json = QJsonDocument::fromJson(payload, &parseError);
-    if (parseError.error != QJsonParseError::NoError || !json.isObject()) {
-        if (errorMessage) {
-            *errorMessage = QStringLiteral("Invalid JSON: %1").arg(parseError.errorString());
+    QByteArray payload;
+    if (CompressedGraphFormat::isCompressedPath(filePath)) {
+        // Blocks are inflated on workers while the following ones are read.
+        if (!CompressedGraphFormat::readPayload(&file, &payload, errorMessage)) {
+            return false;
+        }
+    } else {
+        payload = file.readAll();
+    }
+    if (BinaryGraphFormat::isBinaryPath(filePath)) {
+        if (!BinaryGraphFormat::decode(payload, document, errorMessage)) {
+            return false;
+        }
+        normalizeSettings(document);
+        return migrateToCurrent(document, errorMessage);
+    }
+
+    // Fast path: locate the node/edge elements without a DOM and decode them
+    // in parallel chunks. Anything the scanner cannot vouch for takes the
+    // plain QJsonDocument path, which also produces the error message.
+    QJsonObject root;
+    QVector<JsonSpan> nodeSpans;
+    QVector<JsonSpan> edgeSpans;
+    bool chunked = false;
+    JsonChunkScanner scanner({QByteArrayLiteral("nodes"), QByteArrayLiteral("edges")});
+    if (scanner.scan(payload)) {
+        QJsonParseError skeletonError;
+        const QJsonDocument skeleton = QJsonDocument::fromJson(scanner.skeleton(), &skeletonError);
+        if (skeletonError.error == QJsonParseError::NoError && skeleton.isObject()) {
+            root = skeleton.object();
+            chunked = !root.contains(QStringLiteral("nodes")) && !root.contains(QStringLiteral("edges"));
+            nodeSpans = scanner.elements(QByteArrayLiteral("nodes"));
+            edgeSpans = scanner.elements(QByteArrayLiteral("edges"));
         }
-        return false;
+    }
+    if (!chunked) {
+        QJsonParseError parseError;
+        const QJsonDocument json = QJsonDocument::fromJson(payload, &parseError);
+        if (parseError.error != QJsonParseError::NoError || !json.isObject()) {
+            if (errorMessage) {
+                *errorMessage = QStringLiteral("Invalid JSON: %1").arg(parseError.errorString());
+            }
+            return false;
+        }
+        root = json.object();
     }
 
-    const QJsonObject root = json.object();
     if (root.contains(QStringLiteral("schemaVersion"))) {
         document->schemaVersion = root.value(QStringLiteral("schemaVersion")).toInt(1);
     } else {
         document->schemaVersion = 1;
     }
     document->autoLayoutMode = root.value(QStringLiteral("autoLayoutMode")).toString(QStringLiteral("layered"));
-    if (document->autoLayoutMode.compare(QStringLiteral("grid"), Qt::CaseInsensitive) == 0) {
-        document->autoLayoutMode = QStringLiteral("grid");
-    } else {
-        document->autoLayoutMode = QStringLiteral("layered");
-    }
-    document->autoLayoutXSpacing = std::max(40.0, root.value(QStringLiteral("autoLayoutXSpacing")).toDouble(240.0));
-    document->autoLayoutYSpacing = std::max(40.0, root.value(QStringLiteral("autoLayoutYSpacing")).toDouble(140.0));
+    document->autoLayoutXSpacing = root.value(QStringLiteral("autoLayoutXSpacing")).toDouble(240.0);
+    document->autoLayoutYSpacing = root.value(QStringLiteral("autoLayoutYSpacing")).toDouble(140.0);
     document->layers.clear();
     const QJsonArray layers = root.value(QStringLiteral("layers")).toArray();
     for (const QJsonValue& value : layers) {
         LayerData layer;
         if (fromJson(value.toObject(), &layer)) {
-            if (layer.name.isEmpty()) {
-                layer.name = layer.id;
-            }
             document->layers.push_back(layer);
         }
     }
     document->activeLayerId = root.value(QStringLiteral("activeLayerId")).toString();
     document->edgeRoutingProfile = root.value(QStringLiteral("edgeRoutingProfile")).toString(QStringLiteral("balanced"));
-    if (document->edgeRoutingProfile.compare(QStringLiteral("dense"), Qt::CaseInsensitive) == 0) {
-        document->edgeRoutingProfile = QStringLiteral("dense");
-    } else {
-        document->edgeRoutingProfile = QStringLiteral("balanced");
-    }
     document->edgeBundlePolicy = root.value(QStringLiteral("edgeBundlePolicy")).toString(QStringLiteral("centered"));
-    if (document->edgeBundlePolicy.compare(QStringLiteral("directional"), Qt::CaseInsensitive) == 0) {
-        document->edgeBundlePolicy = QStringLiteral("directional");
-    } else {
-        document->edgeBundlePolicy = QStringLiteral("centered");
-    }
     document->edgeBundleScope = root.value(QStringLiteral("edgeBundleScope")).toString(QStringLiteral("global"));
-    if (document->edgeBundleScope.compare(QStringLiteral("layer"), Qt::CaseInsensitive) == 0) {
-        document->edgeBundleScope = QStringLiteral("layer");
-    } else if (document->edgeBundleScope.compare(QStringLiteral("group"), Qt::CaseInsensitive) == 0) {
-        document->edgeBundleScope = QStringLiteral("group");
-    } else {
-        document->edgeBundleScope = QStringLiteral("global");
-    }
-    document->edgeBundleSpacing = std::max(0.0, root.value(QStringLiteral("edgeBundleSpacing")).toDouble(18.0));
+    document->edgeBundleSpacing = root.value(QStringLiteral("edgeBundleSpacing")).toDouble(18.0);
+    document->dagOnly = root.value(QStringLiteral("dagOnly")).toBool(false);
     document->collapsedGroupIds.clear();
     const QJsonArray collapsedGroups = root.value(QStringLiteral("collapsedGroups")).toArray();
     for (const QJsonValue& value : collapsedGroups) {
@@ -385,21 +675,54 @@ bool GraphSerializer::loadFromFile(GraphDocument* document, const QString& fileP
     document->nodes.clear();
     document->edges.clear();
 
-    const QJsonArray nodes = root.value(QStringLiteral("nodes")).toArray();
-    for (const QJsonValue& value : nodes) {
-        NodeData node;
-        if (fromJson(value.toObject(), &node)) {
-            document->nodes.append(node);
+    if (chunked) {
+        if (!decodeElements(payload, nodeSpans, &document->nodes, errorMessage) ||
+            !decodeElements(payload, edgeSpans, &document->edges, errorMessage)) {
+            return false;
+        }
+    } else {
+        StringPool pool;
+        const QJsonArray nodes = root.value(QStringLiteral("nodes")).toArray();
+        for (const QJsonValue& value : nodes) {
+            NodeData node;
+            if (fromJson(value.toObject(), &node)) {
+                shareStrings(&node, &pool);
+                document->nodes.append(node);
+            }
+        }
+        QHash<QString, QString> vocabulary;
+        QHash<QString, QString> names;
+        pool.mergeInto(&vocabulary, &names);
+        for (NodeData& node : document->nodes) {
+            shareStrings(&node, &pool);
+        }
+        const QJsonArray edges = root.value(QStringLiteral("edges")).toArray();
+        for (const QJsonValue& value : edges) {
+            EdgeData edge;
+            if (fromJson(value.toObject(), &edge)) {
+                document->edges.append(edge);
+            }
         }
     }
 
-    const QJsonArray edges = root.value(QStringLiteral("edges")).toArray();
-    for (const QJsonValue& value : edges) {
-        EdgeData edge;
-        if (fromJson(value.toObject(), &edge)) {
-            document->edges.append(edge);
+    // Node ids are unique, so they are not pooled at all; edges
+    // just reuse the node's buffer instead of holding two more copies each.
+    QSet<QString> nodeIds;
+    nodeIds.reserve(document->nodes.size());
+    for (const NodeData& node : document->nodes) {
+        nodeIds.insert(node.id);
+    }
+    auto shareNodeId = [&nodeIds](QString* id) {
+        const auto it = nodeIds.constFind(*id);
+        if (it != nodeIds.constEnd()) {
+            *id = *it;
         }
+    };
+    for (EdgeData& edge : document->edges) {
+        shareNodeId(&edge.fromNodeId);
+        shareNodeId(&edge.toNodeId);
     }
 
+    normalizeSettings(document);
     return migrateToCurrent(document, errorMessage);
 }
@@ -1,11 +1,26 @@
 #pragma once
 
 #include "GraphDocument.h"
+#include "JsonStreamWriter.h"
 
 #include <QString>
 
 class GraphSerializer {
 public:
+    static constexpr int kCurrentSchemaVersion = 1;
+
+    // Writes through QSaveFile: the target is replaced atomically on success.
+    // Safe to call from a worker thread on a document copy.
     static bool saveToFile(const GraphDocument& document, const QString& filePath, QString* errorMessage = nullptr);
     static bool loadFromFile(GraphDocument* document, const QString& filePath, QString* errorMessage = nullptr);
+    // Streams the document as JSON; memory use is bounded by the writer's buffer.
+    static bool writeJson(const GraphDocument& document,
+                          QIODevice* device,
+                          JsonStreamWriter::Format format = JsonStreamWriter::Format::Indented,
+                          QString* errorMessage = nullptr);
+    // Workers used to decode node and edge chunks on load; 0 (the default)
+    // uses one per core. Meant for benchmarks.
+    static void setDecodeThreadCount(int count);
+    // Folds free-form settings read from disk onto the supported values.
+    static void normalizeSettings(GraphDocument* document);
 };
@@ -0,0 +1,200 @@
+#include "JsonChunkScanner.h"
+
+#include <cstring>
+
+namespace {
+bool isWhitespace(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+bool endsScalar(char c) {
+    return c == ',' || c == '}' || c == ']' || isWhitespace(c);
+}
+}  // namespace
+
+JsonChunkScanner::JsonChunkScanner(const QList<QByteArray>& splitArrayKeys)
+    : m_splitKeys(splitArrayKeys) {}
+
+bool JsonChunkScanner::scan(const QByteArray& json) {
+    m_json = json;
+    m_members.clear();
+    m_elements.clear();
+    m_errorString.clear();
+
+    const char* data = m_json.constData();
+    const qint64 size = m_json.size();
+    qint64 pos = skipWhitespace(0);
+    if (pos >= size || data[pos] != '{') {
+        return fail(pos, "expected '{' at document start");
+    }
+    pos = skipWhitespace(pos + 1);
+    if (pos < size && data[pos] == '}') {
+        pos = skipWhitespace(pos + 1);
+        return pos == size || fail(pos, "trailing data after document");
+    }
+
+    while (true) {
+        if (pos >= size || data[pos] != '"') {
+            return fail(pos, "expected member name");
+        }
+        const JsonSpan key{pos, skipString(pos)};
+        if (key.end < 0) {
+            return fail(pos, "unterminated string");
+        }
+        pos = skipWhitespace(key.end);
+        if (pos >= size || data[pos] != ':') {
+            return fail(pos, "expected ':'");
+        }
+        pos = skipWhitespace(pos + 1);
+
+        const QByteArray name = QByteArray::fromRawData(data + key.begin + 1, static_cast<int>(key.end - key.begin - 2));
+        const bool split = pos < size && data[pos] == '[' && m_splitKeys.contains(name);
+        if (split) {
+            QVector<JsonSpan> elements;
+            pos = skipWhitespace(pos + 1);
+            if (pos < size && data[pos] == ']') {
+                ++pos;
+            } else {
+                while (true) {
+                    const qint64 end = skipValue(pos);
+                    if (end < 0) {
+                        return fail(pos, "malformed array element");
+                    }
+                    elements.push_back(JsonSpan{pos, end});
+                    pos = skipWhitespace(end);
+                    if (pos < size && data[pos] == ',') {
+                        pos = skipWhitespace(pos + 1);
+                        continue;
+                    }
+                    if (pos < size && data[pos] == ']') {
+                        ++pos;
+                        break;
+                    }
+                    return fail(pos, "expected ',' or ']'");
+                }
+            }
+            m_elements.insert(QByteArray(name.constData(), name.size()), elements);
+        } else {
+            const qint64 end = skipValue(pos);
+            if (end < 0) {
+                return fail(pos, "malformed value");
+            }
+            m_members.push_back(qMakePair(key, JsonSpan{pos, end}));
+            pos = end;
+        }
+
+        pos = skipWhitespace(pos);
+        if (pos < size && data[pos] == ',') {
+            pos = skipWhitespace(pos + 1);
+            continue;
+        }
+        if (pos < size && data[pos] == '}') {
+            pos = skipWhitespace(pos + 1);
+            return pos == size || fail(pos, "trailing data after document");
+        }
+        return fail(pos, "expected ',' or '}'");
+    }
+}
+
+QString JsonChunkScanner::errorString() const {
+    return m_errorString;
+}
+
+const QVector<QPair<JsonSpan, JsonSpan>>& JsonChunkScanner::members() const {
+    return m_members;
+}
+
+QVector<JsonSpan> JsonChunkScanner::elements(const QByteArray& key) const {
+    return m_elements.value(key);
+}
+
+QByteArray JsonChunkScanner::skeleton() const {
+    QByteArray out;
+    out.append('{');
+    const char* data = m_json.constData();
+    for (int i = 0; i < m_members.size(); ++i) {
+        if (i > 0) {
+            out.append(',');
+        }
+        const JsonSpan& key = m_members[i].first;
+        const JsonSpan& value = m_members[i].second;
+        out.append(data + key.begin, static_cast<int>(key.end - key.begin));
+        out.append(':');
+        out.append(data + value.begin, static_cast<int>(value.end - value.begin));
+    }
+    out.append('}');
+    return out;
+}
+
+bool JsonChunkScanner::fail(qint64 offset, const char* what) {
+    m_errorString = QStringLiteral("%1 at offset %2").arg(QString::fromLatin1(what)).arg(offset);
+    return false;
+}
+
+qint64 JsonChunkScanner::skipWhitespace(qint64 pos) const {
+    const char* data = m_json.constData();
+    const qint64 size = m_json.size();
+    while (pos < size && isWhitespace(data[pos])) {
+        ++pos;
+    }
+    return pos;
+}
+
+qint64 JsonChunkScanner::skipString(qint64 pos) const {
+    const char* data = m_json.constData();
+    const qint64 size = m_json.size();
+    for (qint64 i = pos + 1; i < size;) {
+        // Jump straight to the next quote and only then look back for escapes.
+        const void* quote = std::memchr(data + i, '"', static_cast<size_t>(size - i));
+        if (!quote) {
+            return -1;
+        }
+        const qint64 at = static_cast<const char*>(quote) - data;
+        qint64 backslashes = 0;
+        while (at - 1 - backslashes > pos && data[at - 1 - backslashes] == '\\') {
+            ++backslashes;
+        }
+        if (backslashes % 2 == 0) {
+            return at + 1;
+        }
+        i = at + 1;
+    }
+    return -1;
+}
+
+qint64 JsonChunkScanner::skipValue(qint64 pos) const {
+    const char* data = m_json.constData();
+    const qint64 size = m_json.size();
+    if (pos >= size) {
+        return -1;
+    }
+    const char c = data[pos];
+    if (c == '"') {
+        return skipString(pos);
+    }
+    if (c == '{' || c == '[') {
+        int depth = 0;
+        for (qint64 i = pos; i < size; ++i) {
+            const char ch = data[i];
+            if (ch == '"') {
+                const qint64 end = skipString(i);
+                if (end < 0) {
+                    return -1;
+                }
+                i = end - 1;
+            } else if (ch == '{' || ch == '[') {
+                ++depth;
+            } else if (ch == '}' || ch == ']') {
+                if (--depth == 0) {
+                    return i + 1;
+                }
+            }
+        }
+        return -1;
+    }
+    qint64 end = pos;
+    while (end < size && !endsScalar(data[end])) {
+        ++end;
+    }
+    return end > pos ? end : -1;
+}
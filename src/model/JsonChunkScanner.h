@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+struct JsonSpan {
+    qint64 begin = 0;
+    qint64 end = 0;  // one past the last byte
+};
+
+// Single forward pass over a UTF-8 JSON document whose root is an object.
+// Records the byte span of every root member value and, for the requested
+// array members, the span of each array element, without building a DOM.
+// Only the structure is checked (strings, brackets, separators); element
+// contents are validated later by whoever parses the spans. Spans index
+// into the scanned array, which the scanner keeps a (shared) reference to.
+class JsonChunkScanner {
+public:
+    explicit JsonChunkScanner(const QList<QByteArray>& splitArrayKeys = {});
+
+    bool scan(const QByteArray& json);
+    QString errorString() const;
+
+    // Root members in document order, excluding the split arrays.
+    const QVector<QPair<JsonSpan, JsonSpan>>& members() const;  // (quoted key, value)
+    QVector<JsonSpan> elements(const QByteArray& key) const;
+
+    // Root object rebuilt from members(), i.e. everything but the split arrays.
+    QByteArray skeleton() const;
+
+private:
+    bool fail(qint64 offset, const char* what);
+    qint64 skipWhitespace(qint64 pos) const;
+    qint64 skipString(qint64 pos) const;
+    qint64 skipValue(qint64 pos) const;
+
+    QByteArray m_json;
+    QList<QByteArray> m_splitKeys;
+    QVector<QPair<JsonSpan, JsonSpan>> m_members;
+    QHash<QByteArray, QVector<JsonSpan>> m_elements;
+    QString m_errorString;
+};
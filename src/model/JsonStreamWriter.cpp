@@ -0,0 +1,240 @@
+#include "JsonStreamWriter.h"
+
+#include <QIODevice>
+#include <QLocale>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+char hexDigit(uint value) {
+    return static_cast<char>(value < 10 ? '0' + value : 'a' + value - 10);
+}
+
+void appendUnicodeEscape(QByteArray* out, char16_t unit) {
+    out->append('\\');
+    out->append('u');
+    out->append(hexDigit((unit >> 12) & 0xf));
+    out->append(hexDigit((unit >> 8) & 0xf));
+    out->append(hexDigit((unit >> 4) & 0xf));
+    out->append(hexDigit(unit & 0xf));
+}
+}  // namespace
+
+JsonStreamWriter::JsonStreamWriter(QIODevice* device, Format format, int bufferSize)
+    : m_device(device),
+      m_format(format),
+      m_bufferSize(std::max(256, bufferSize)) {
+    m_buffer.reserve(m_bufferSize + 256);
+}
+
+JsonStreamWriter::~JsonStreamWriter() {
+    flush();
+}
+
+void JsonStreamWriter::beginObject() {
+    openScope('{');
+}
+
+void JsonStreamWriter::endObject() {
+    closeScope('}');
+}
+
+void JsonStreamWriter::beginArray() {
+    openScope('[');
+}
+
+void JsonStreamWriter::endArray() {
+    closeScope(']');
+}
+
+void JsonStreamWriter::writeKey(const QString& key) {
+    beginValue();
+    m_buffer.append('"');
+    appendEscaped(key);
+    m_buffer.append(m_format == Format::Compact ? "\":" : "\": ");
+    m_afterKey = true;
+}
+
+void JsonStreamWriter::writeString(const QString& value) {
+    beginValue();
+    m_buffer.append('"');
+    appendEscaped(value);
+    m_buffer.append('"');
+    maybeFlush();
+}
+
+void JsonStreamWriter::writeDouble(double value) {
+    beginValue();
+    // Mirrors QJsonValue: integral doubles are stored (and printed) as
+    // integers, and non-finite values have no JSON spelling.
+    if (std::trunc(value) == value && std::fabs(value) < 9007199254740992.0) {
+        m_buffer.append(QByteArray::number(static_cast<qint64>(value)));
+    } else if (std::isfinite(value)) {
+        m_buffer.append(QByteArray::number(value, 'g', QLocale::FloatingPointShortest));
+    } else {
+        m_buffer.append("null");
+    }
+    maybeFlush();
+}
+
+void JsonStreamWriter::writeInt(qint64 value) {
+    beginValue();
+    m_buffer.append(QByteArray::number(value));
+    maybeFlush();
+}
+
+void JsonStreamWriter::writeBool(bool value) {
+    beginValue();
+    m_buffer.append(value ? "true" : "false");
+    maybeFlush();
+}
+
+void JsonStreamWriter::writeMember(const QString& key, const QString& value) {
+    writeKey(key);
+    writeString(value);
+}
+
+void JsonStreamWriter::writeMember(const QString& key, double value) {
+    writeKey(key);
+    writeDouble(value);
+}
+
+void JsonStreamWriter::writeMember(const QString& key, int value) {
+    writeKey(key);
+    writeInt(value);
+}
+
+void JsonStreamWriter::writeMember(const QString& key, bool value) {
+    writeKey(key);
+    writeBool(value);
+}
+
+bool JsonStreamWriter::flush() {
+    if (!m_failed && !m_buffer.isEmpty()) {
+        if (!m_device || m_device->write(m_buffer) != m_buffer.size()) {
+            m_failed = true;
+            m_errorString = m_device ? m_device->errorString() : QStringLiteral("No output device");
+        }
+    }
+    m_buffer.resize(0);  // keeps the reserved capacity
+    return !m_failed;
+}
+
+bool JsonStreamWriter::hasError() const {
+    return m_failed;
+}
+
+QString JsonStreamWriter::errorString() const {
+    return m_errorString;
+}
+
+void JsonStreamWriter::beginValue() {
+    if (m_afterKey) {
+        m_afterKey = false;
+        return;
+    }
+    if (m_scopes.isEmpty()) {
+        return;
+    }
+    Scope& scope = m_scopes.last();
+    if (scope.count > 0) {
+        m_buffer.append(m_format == Format::Compact ? "," : ",\n");
+    }
+    ++scope.count;
+    writeIndent(static_cast<int>(m_scopes.size()));
+}
+
+void JsonStreamWriter::openScope(char opener) {
+    beginValue();
+    m_buffer.append(opener);
+    if (m_format == Format::Indented) {
+        m_buffer.append('\n');
+    }
+    m_scopes.push_back(Scope());
+}
+
+void JsonStreamWriter::closeScope(char closer) {
+    if (m_scopes.isEmpty()) {
+        return;
+    }
+    const Scope scope = m_scopes.takeLast();
+    if (m_format == Format::Indented && scope.count > 0) {
+        m_buffer.append('\n');
+    }
+    writeIndent(static_cast<int>(m_scopes.size()));
+    m_buffer.append(closer);
+    if (m_scopes.isEmpty() && m_format == Format::Indented) {
+        m_buffer.append('\n');
+    }
+    maybeFlush();
+}
+
+void JsonStreamWriter::writeIndent(int level) {
+    if (m_format == Format::Indented && level > 0) {
+        m_buffer.append(4 * level, ' ');
+    }
+}
+
+void JsonStreamWriter::appendEscaped(const QString& text) {
+    const char16_t* src = reinterpret_cast<const char16_t*>(text.constData());
+    const char16_t* const end = src + text.size();
+    while (src != end) {
+        const char16_t unit = *src++;
+        if (unit < 0x80) {
+            if (unit >= 0x20 && unit != u'"' && unit != u'\\') {
+                m_buffer.append(static_cast<char>(unit));
+                continue;
+            }
+            switch (unit) {
+            case u'"':
+                m_buffer.append("\\\"");
+                break;
+            case u'\\':
+                m_buffer.append("\\\\");
+                break;
+            case u'\b':
+                m_buffer.append("\\b");
+                break;
+            case u'\f':
+                m_buffer.append("\\f");
+                break;
+            case u'\n':
+                m_buffer.append("\\n");
+                break;
+            case u'\r':
+                m_buffer.append("\\r");
+                break;
+            case u'\t':
+                m_buffer.append("\\t");
+                break;
+            default:
+                appendUnicodeEscape(&m_buffer, unit);
+                break;
+            }
+        } else if (unit < 0x800) {
+            m_buffer.append(static_cast<char>(0xc0 | (unit >> 6)));
+            m_buffer.append(static_cast<char>(0x80 | (unit & 0x3f)));
+        } else if (QChar::isHighSurrogate(unit) && src != end && QChar::isLowSurrogate(*src)) {
+            const uint codePoint = QChar::surrogateToUcs4(unit, *src++);
+            m_buffer.append(static_cast<char>(0xf0 | (codePoint >> 18)));
+            m_buffer.append(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3f)));
+            m_buffer.append(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f)));
+            m_buffer.append(static_cast<char>(0x80 | (codePoint & 0x3f)));
+        } else if (QChar::isSurrogate(unit)) {
+            // Unpaired surrogates cannot be encoded as UTF-8; QJsonDocument
+            // falls back to a \u escape for them as well.
+            appendUnicodeEscape(&m_buffer, unit);
+        } else {
+            m_buffer.append(static_cast<char>(0xe0 | (unit >> 12)));
+            m_buffer.append(static_cast<char>(0x80 | ((unit >> 6) & 0x3f)));
+            m_buffer.append(static_cast<char>(0x80 | (unit & 0x3f)));
+        }
+    }
+}
+
+void JsonStreamWriter::maybeFlush() {
+    if (m_buffer.size() >= m_bufferSize) {
+        flush();
+    }
+}
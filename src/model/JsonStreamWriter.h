@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+class QIODevice;
+
+// Incremental JSON writer that reproduces QJsonDocument::toJson() byte for
+// byte (both Indented and Compact), provided object members are written in
+// the sorted key order QJsonObject uses. Output is staged in a fixed-size
+// buffer and flushed to the device whenever it fills, so memory use does not
+// grow with the document.
+class JsonStreamWriter {
+public:
+    enum class Format {
+        Indented,
+        Compact
+    };
+
+    static constexpr int kDefaultBufferSize = 64 * 1024;
+
+    explicit JsonStreamWriter(QIODevice* device, Format format = Format::Indented, int bufferSize = kDefaultBufferSize);
+    ~JsonStreamWriter();
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+    void writeKey(const QString& key);
+
+    void writeString(const QString& value);
+    void writeDouble(double value);
+    void writeInt(qint64 value);
+    void writeBool(bool value);
+
+    void writeMember(const QString& key, const QString& value);
+    void writeMember(const QString& key, double value);
+    void writeMember(const QString& key, int value);
+    void writeMember(const QString& key, bool value);
+
+    // Writes out whatever is buffered. Returns false once any write failed.
+    bool flush();
+    bool hasError() const;
+    QString errorString() const;
+
+private:
+    struct Scope {
+        int count = 0;
+    };
+
+    void beginValue();
+    void openScope(char opener);
+    void closeScope(char closer);
+    void writeIndent(int level);
+    void appendEscaped(const QString& text);
+    void maybeFlush();
+
+    QIODevice* m_device = nullptr;
+    Format m_format = Format::Indented;
+    int m_bufferSize = kDefaultBufferSize;
+    QByteArray m_buffer;
+    QVector<Scope> m_scopes;
+    bool m_afterKey = false;
+    bool m_failed = false;
+    QString m_errorString;
+};
@@ -0,0 +1,1280 @@
+#include "NetlistFormats.h"
+
+#include "ComponentCatalog.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+#include <QSet>
+#include <QStringList>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+#include <utility>
+
+namespace {
+constexpr qint64 kReadChunkSize = 64 * 1024;
+const QString kNodeListSuffix = QStringLiteral(".nodes.csv");
+
+bool fail(QString* errorMessage, const QString& message) {
+    if (errorMessage) {
+        *errorMessage = message;
+    }
+    return false;
+}
+
+QByteArray number(qreal value) {
+    return QByteArray::number(value, 'g', 15);
+}
+
+// Builds the document while a file is parsed. Nodes are keyed by the name the
+// file uses; document ids are assigned in order of first appearance.
+class NetlistBuilder {
+public:
+    NetlistBuilder(GraphDocument* document, const NetlistImportOptions& options)
+        : m_document(document),
+          m_options(options) {}
+
+    int node(const QString& key, bool* created = nullptr) {
+        const auto it = m_nodeIndex.constFind(key);
+        if (created) {
+            *created = it == m_nodeIndex.constEnd();
+        }
+        if (it != m_nodeIndex.constEnd()) {
+            return it.value();
+        }
+        const int index = m_document->nodes.size();
+        NodeData node;
+        node.id = QStringLiteral("N_%1").arg(index + 1);
+        node.type = ComponentCatalog::instance().fallback().typeName;
+        node.name = key;
+        node.size = ComponentCatalog::instance().fallback().size;
+        m_document->nodes.push_back(node);
+        m_positioned.push_back(false);
+        m_nodeIndex.insert(key, index);
+        return index;
+    }
+
+    NodeData& nodeAt(int index) { return m_document->nodes[index]; }
+
+    void setType(int index, const QString& type) {
+        if (type.isEmpty()) {
+            return;
+        }
+        NodeData& node = m_document->nodes[index];
+        node.type = type;
+        const ComponentSpec* spec = ComponentCatalog::instance().find(type);
+        node.size = spec ? spec->size : ComponentCatalog::instance().fallback().size;
+    }
+
+    void setPosition(int index, const QPointF& position) {
+        m_document->nodes[index].position = position;
+        m_positioned[index] = true;
+    }
+
+    void setProperty(int index, const QString& key, const QString& value) {
+        QVector<PropertyData>& properties = m_document->nodes[index].properties;
+        for (PropertyData& property : properties) {
+            if (property.key == key) {
+                property.value = value;
+                return;
+            }
+        }
+        properties.push_back(PropertyData{key, QStringLiteral("string"), value});
+    }
+
+    // Applies a node attribute named the way GraphML and DOT files usually do.
+    void setAttribute(int index, const QString& key, const QString& value) {
+        const QString name = key.toLower();
+        if (name == QStringLiteral("name") || name == QStringLiteral("label")) {
+            nodeAt(index).name = value;
+        } else if (name == QStringLiteral("type")) {
+            setType(index, value);
+        } else {
+            setProperty(index, key, value);
+        }
+    }
+
+    // Self-loops and repeats of an earlier edge between the same named ports
+    // are dropped and counted; the editor cannot represent either. An edge
+    // without a target port name is never a repeat, as it gets its own input.
+    void addEdge(const QString& fromKey, const QString& fromPort, const QString& toKey, const QString& toPort) {
+        const int from = node(fromKey);
+        const int to = node(toKey);
+        if (from == to) {
+            ++m_report.skippedSelfLoops;
+            return;
+        }
+        if (!toPort.isEmpty()) {
+            const QChar separator(0x1F);
+            const QString pairKey = QString::number(from) + separator + fromPort + separator +
+                                    QString::number(to) + separator + toPort;
+            if (m_edgeKeys.contains(pairKey)) {
+                ++m_report.skippedDuplicates;
+                return;
+            }
+            m_edgeKeys.insert(pairKey);
+        }
+        EdgeData edge;
+        edge.id = QStringLiteral("E_%1").arg(m_document->edges.size() + 1);
+        edge.fromNodeId = m_document->nodes[from].id;
+        edge.fromPortId = portId(from, fromPort.isEmpty() ? QStringLiteral("out") : fromPort, true);
+        edge.toNodeId = m_document->nodes[to].id;
+        edge.toPortId = toPort.isEmpty() ? newInputPortId(to) : portId(to, toPort, false);
+        m_document->edges.push_back(edge);
+        if (m_options.autoLayout) {
+            m_edgeEnds.push_back(qMakePair(from, to));
+        }
+    }
+
+    const NetlistImportReport& report() const { return m_report; }
+
+    void finish() {
+        if (m_options.autoLayout) {
+            applyLayeredLayout();
+        } else {
+            placeUnpositioned();
+        }
+    }
+
+private:
+    QString portId(int nodeIndex, const QString& name, bool output) {
+        const QString key = QString::number(nodeIndex) + (output ? QLatin1Char('>') : QLatin1Char('<')) + name;
+        const auto it = m_portIds.constFind(key);
+        if (it != m_portIds.constEnd()) {
+            return it.value();
+        }
+        const QString id = QStringLiteral("P_%1").arg(++m_portCount);
+        m_document->nodes[nodeIndex].ports.push_back(
+            PortData{id, name, output ? QStringLiteral("output") : QStringLiteral("input")});
+        m_portIds.insert(key, id);
+        return id;
+    }
+
+    // Inputs take one connection each, so every edge without a target port
+    // name gets its own `in<k>`, skipping names the file already used.
+    QString newInputPortId(int nodeIndex) {
+        const QString prefix = QString::number(nodeIndex) + QLatin1Char('<');
+        QString name;
+        do {
+            name = QStringLiteral("in%1").arg(++m_unnamedInputs[nodeIndex]);
+        } while (m_portIds.contains(prefix + name));
+        return portId(nodeIndex, name, false);
+    }
+
+    // Longest-path layering over the edges, as a compact adjacency array so
+    // million-edge imports stay cheap. Nodes left on cycles go after the rest.
+    void applyLayeredLayout() {
+        const int count = m_document->nodes.size();
+        QVector<int> offsets(count + 1, 0);
+        QVector<int> inDegree(count, 0);
+        for (const auto& ends : m_edgeEnds) {
+            ++offsets[ends.first + 1];
+            ++inDegree[ends.second];
+        }
+        for (int i = 0; i < count; ++i) {
+            offsets[i + 1] += offsets[i];
+        }
+        QVector<int> targets(m_edgeEnds.size());
+        QVector<int> fill = offsets;
+        for (const auto& ends : m_edgeEnds) {
+            targets[fill[ends.first]++] = ends.second;
+        }
+        m_edgeEnds.clear();
+        m_edgeEnds.squeeze();
+
+        QVector<int> layer(count, 0);
+        QVector<int> queue;
+        queue.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            if (inDegree[i] == 0) {
+                queue.push_back(i);
+            }
+        }
+        int maxLayer = 0;
+        for (int head = 0; head < queue.size(); ++head) {
+            const int from = queue[head];
+            maxLayer = std::max(maxLayer, layer[from]);
+            for (int e = offsets[from]; e < offsets[from + 1]; ++e) {
+                const int to = targets[e];
+                layer[to] = std::max(layer[to], layer[from] + 1);
+                if (--inDegree[to] == 0) {
+                    queue.push_back(to);
+                }
+            }
+        }
+        if (queue.size() < count) {
+            for (int i = 0; i < count; ++i) {
+                if (inDegree[i] > 0) {
+                    layer[i] = maxLayer + 1;
+                }
+            }
+        }
+
+        QVector<int> rows(count + 1, 0);
+        for (int i = 0; i < count; ++i) {
+            NodeData& node = m_document->nodes[i];
+            node.position = QPointF(layer[i] * m_options.xSpacing, rows[layer[i]]++ * m_options.ySpacing);
+        }
+    }
+
+    // Unplaced nodes go on a square grid below the ones the file positioned.
+    void placeUnpositioned() {
+        int unplaced = 0;
+        qreal top = 0.0;
+        bool anyPlaced = false;
+        for (int i = 0; i < m_positioned.size(); ++i) {
+            if (m_positioned[i]) {
+                const NodeData& node = m_document->nodes[i];
+                const qreal bottom = node.position.y() + node.size.height();
+                top = anyPlaced ? std::max(top, bottom) : bottom;
+                anyPlaced = true;
+            } else {
+                ++unplaced;
+            }
+        }
+        if (unplaced == 0) {
+            return;
+        }
+        if (anyPlaced) {
+            top += m_options.ySpacing;
+        }
+        const int columns = std::max(1, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(unplaced)))));
+        int slot = 0;
+        for (int i = 0; i < m_positioned.size(); ++i) {
+            if (!m_positioned[i]) {
+                m_document->nodes[i].position =
+                    QPointF((slot % columns) * m_options.xSpacing, top + (slot / columns) * m_options.ySpacing);
+                ++slot;
+            }
+        }
+    }
+
+    GraphDocument* m_document = nullptr;
+    NetlistImportOptions m_options;
+    QHash<QString, int> m_nodeIndex;
+    QHash<QString, QString> m_portIds;
+    QHash<int, int> m_unnamedInputs;
+    QSet<QString> m_edgeKeys;
+    NetlistImportReport m_report;
+    QVector<bool> m_positioned;
+    QVector<QPair<int, int>> m_edgeEnds;
+    int m_portCount = 0;
+};
+
+// Reads one record. Quoted fields may hold commas, doubled quotes and line
+// breaks; fields are trimmed. Returns false at the end of the input.
+bool readCsvRecord(QIODevice* device, QVector<QString>* fields, int* line) {
+    fields->clear();
+    QByteArray text = device->readLine();
+    if (text.isEmpty()) {
+        return false;
+    }
+    ++*line;
+    QByteArray field;
+    bool quoted = false;
+    int i = 0;
+    while (true) {
+        if (i >= text.size()) {
+            if (!quoted) {
+                break;
+            }
+            text = device->readLine();
+            if (text.isEmpty()) {
+                break;
+            }
+            ++*line;
+            i = 0;
+            continue;
+        }
+        const char c = text.at(i++);
+        if (quoted) {
+            if (c != '"') {
+                field.append(c);
+            } else if (i < text.size() && text.at(i) == '"') {
+                field.append('"');
+                ++i;
+            } else {
+                quoted = false;
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            fields->push_back(QString::fromUtf8(field).trimmed());
+            field.clear();
+        } else if (c != '\n' && c != '\r') {
+            field.append(c);
+        }
+    }
+    fields->push_back(QString::fromUtf8(field).trimmed());
+    return true;
+}
+
+bool isBlankRecord(const QVector<QString>& fields) {
+    return fields.size() == 1 && fields.front().isEmpty();
+}
+
+// Index of the first header column named any of `names`, or -1.
+int csvColumn(const QVector<QString>& header, std::initializer_list<const char*> names) {
+    for (const char* name : names) {
+        const int index = header.indexOf(QString::fromLatin1(name));
+        if (index >= 0) {
+            return index;
+        }
+    }
+    return -1;
+}
+
+QString csvValue(const QVector<QString>& fields, int column) {
+    return column >= 0 && column < fields.size() ? fields.at(column) : QString();
+}
+
+bool readCsvHeader(QIODevice* device, QVector<QString>* header, int* line) {
+    if (!readCsvRecord(device, header, line)) {
+        return false;
+    }
+    if (!header->isEmpty() && header->front().startsWith(QChar(0xFEFF))) {
+        (*header)[0].remove(0, 1);
+    }
+    return true;
+}
+
+QVector<QString> lowerCased(const QVector<QString>& header) {
+    QVector<QString> lowered;
+    lowered.reserve(header.size());
+    for (const QString& name : header) {
+        lowered.push_back(name.toLower());
+    }
+    return lowered;
+}
+
+bool readCsvNodes(const QString& filePath, NetlistBuilder* builder, QString* errorMessage) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail(errorMessage, QStringLiteral("Cannot open file: %1").arg(filePath));
+    }
+    QVector<QString> header;
+    int line = 0;
+    if (!readCsvHeader(&file, &header, &line)) {
+        return true;
+    }
+    const QVector<QString> columns = lowerCased(header);
+    const int idColumn = csvColumn(columns, {"id"});
+    if (idColumn < 0) {
+        return fail(errorMessage, QStringLiteral("%1: node list needs an 'id' column").arg(filePath));
+    }
+    const int nameColumn = csvColumn(columns, {"name", "label"});
+    const int typeColumn = csvColumn(columns, {"type"});
+    const int xColumn = csvColumn(columns, {"x"});
+    const int yColumn = csvColumn(columns, {"y"});
+
+    QVector<QString> fields;
+    while (readCsvRecord(&file, &fields, &line)) {
+        if (isBlankRecord(fields)) {
+            continue;
+        }
+        const QString key = csvValue(fields, idColumn);
+        if (key.isEmpty()) {
+            return fail(errorMessage, QStringLiteral("%1:%2: node without id").arg(filePath).arg(line));
+        }
+        const int index = builder->node(key);
+        const QString name = csvValue(fields, nameColumn);
+        if (!name.isEmpty()) {
+            builder->nodeAt(index).name = name;
+        }
+        builder->setType(index, csvValue(fields, typeColumn));
+        bool xOk = false;
+        bool yOk = false;
+        const qreal x = csvValue(fields, xColumn).toDouble(&xOk);
+        const qreal y = csvValue(fields, yColumn).toDouble(&yOk);
+        if (xOk && yOk) {
+            builder->setPosition(index, QPointF(x, y));
+        }
+        for (int column = 0; column < fields.size() && column < header.size(); ++column) {
+            if (column == idColumn || column == nameColumn || column == typeColumn || column == xColumn ||
+                column == yColumn || fields.at(column).isEmpty()) {
+                continue;
+            }
+            builder->setProperty(index, header.at(column), fields.at(column));
+        }
+    }
+    return true;
+}
+
+bool readCsvEdges(const QString& filePath, NetlistBuilder* builder, QString* errorMessage) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail(errorMessage, QStringLiteral("Cannot open file: %1").arg(filePath));
+    }
+    QVector<QString> header;
+    int line = 0;
+    if (!readCsvHeader(&file, &header, &line)) {
+        return true;
+    }
+    const QVector<QString> columns = lowerCased(header);
+    const int sourceColumn = csvColumn(columns, {"source", "from"});
+    const int targetColumn = csvColumn(columns, {"target", "to"});
+    if (sourceColumn < 0 || targetColumn < 0) {
+        return fail(errorMessage, QStringLiteral("%1: edge list needs 'source' and 'target' columns").arg(filePath));
+    }
+    const int sourcePortColumn = csvColumn(columns, {"source_port", "from_port"});
+    const int targetPortColumn = csvColumn(columns, {"target_port", "to_port"});
+
+    QVector<QString> fields;
+    while (readCsvRecord(&file, &fields, &line)) {
+        if (isBlankRecord(fields)) {
+            continue;
+        }
+        const QString source = csvValue(fields, sourceColumn);
+        const QString target = csvValue(fields, targetColumn);
+        if (source.isEmpty() || target.isEmpty()) {
+            return fail(errorMessage,
+                        QStringLiteral("%1:%2: edge needs a source and a target").arg(filePath).arg(line));
+        }
+        builder->addEdge(source, csvValue(fields, sourcePortColumn), target, csvValue(fields, targetPortColumn));
+    }
+    return true;
+}
+
+bool isNodeListPath(const QString& filePath) {
+    return filePath.endsWith(kNodeListSuffix, Qt::CaseInsensitive);
+}
+
+QString edgeListPathFor(const QString& nodeListPath) {
+    return nodeListPath.left(nodeListPath.size() - kNodeListSuffix.size()) + QStringLiteral(".csv");
+}
+
+bool importCsv(const QString& filePath, NetlistBuilder* builder, QString* errorMessage) {
+    const QString edgesPath = isNodeListPath(filePath) ? edgeListPathFor(filePath) : filePath;
+    const QString nodesPath = NetlistFormats::csvNodeListPath(edgesPath);
+    if (QFileInfo::exists(nodesPath) && !readCsvNodes(nodesPath, builder, errorMessage)) {
+        return false;
+    }
+    if (!QFileInfo::exists(edgesPath)) {
+        if (isNodeListPath(filePath)) {
+            return true;
+        }
+        return fail(errorMessage, QStringLiteral("Cannot open file: %1").arg(edgesPath));
+    }
+    return readCsvEdges(edgesPath, builder, errorMessage);
+}
+
+QByteArray csvField(const QString& value) {
+    QByteArray bytes = value.toUtf8();
+    const bool needsQuotes = bytes.contains(',') || bytes.contains('"') || bytes.contains('\n') ||
+                             bytes.contains('\r') || value != value.trimmed();
+    if (!needsQuotes) {
+        return bytes;
+    }
+    bytes.replace("\"", "\"\"");
+    return '"' + bytes + '"';
+}
+
+QString propertyValue(const NodeData& node, const QString& key) {
+    for (const PropertyData& property : node.properties) {
+        if (property.key == key) {
+            return property.value;
+        }
+    }
+    return QString();
+}
+
+// Ports are exported by name; keyed by node id and port id.
+QHash<QString, QString> portNames(const GraphDocument& document) {
+    QHash<QString, QString> names;
+    for (const NodeData& node : document.nodes) {
+        for (const PortData& port : node.ports) {
+            names.insert(node.id + QLatin1Char('/') + port.id, port.name.isEmpty() ? port.id : port.name);
+        }
+    }
+    return names;
+}
+
+QString portName(const QHash<QString, QString>& names, const QString& nodeId, const QString& portId) {
+    return names.value(nodeId + QLatin1Char('/') + portId, portId);
+}
+
+// Names that already have their own column or attribute on export.
+bool isReservedKey(const QString& key) {
+    static const QSet<QString> reserved = {QStringLiteral("id"), QStringLiteral("name"), QStringLiteral("label"),
+                                           QStringLiteral("type"), QStringLiteral("x"), QStringLiteral("y"),
+                                           QStringLiteral("pos")};
+    return reserved.contains(key.toLower());
+}
+
+// Property keys across all nodes, sorted.
+QStringList propertyKeys(const GraphDocument& document) {
+    QSet<QString> keys;
+    for (const NodeData& node : document.nodes) {
+        for (const PropertyData& property : node.properties) {
+            if (!isReservedKey(property.key)) {
+                keys.insert(property.key);
+            }
+        }
+    }
+    QStringList sorted = keys.values();
+    std::sort(sorted.begin(), sorted.end());
+    return sorted;
+}
+
+bool commitFile(QSaveFile* file, QString* errorMessage) {
+    if (!file->commit()) {
+        return fail(errorMessage, QStringLiteral("Write failed: %1").arg(file->errorString()));
+    }
+    return true;
+}
+
+bool exportCsv(const GraphDocument& document, const QString& filePath, QString* errorMessage) {
+    const QString edgesPath = isNodeListPath(filePath) ? edgeListPathFor(filePath) : filePath;
+    const QStringList keys = propertyKeys(document);
+
+    QSaveFile nodes(NetlistFormats::csvNodeListPath(edgesPath));
+    if (!nodes.open(QIODevice::WriteOnly)) {
+        return fail(errorMessage, QStringLiteral("Cannot write file: %1").arg(nodes.fileName()));
+    }
+    QByteArray record = "id,name,type,x,y";
+    for (const QString& key : keys) {
+        record += ',' + csvField(key);
+    }
+    nodes.write(record + '\n');
+    for (const NodeData& node : document.nodes) {
+        record = csvField(node.id) + ',' + csvField(node.name) + ',' + csvField(node.type) + ',' +
+                 number(node.position.x()) + ',' + number(node.position.y());
+        for (const QString& key : keys) {
+            record += ',' + csvField(propertyValue(node, key));
+        }
+        nodes.write(record + '\n');
+    }
+
+    QSaveFile edges(edgesPath);
+    if (!edges.open(QIODevice::WriteOnly)) {
+        return fail(errorMessage, QStringLiteral("Cannot write file: %1").arg(edgesPath));
+    }
+    const QHash<QString, QString> ports = portNames(document);
+    edges.write("source,source_port,target,target_port\n");
+    for (const EdgeData& edge : document.edges) {
+        edges.write(csvField(edge.fromNodeId) + ',' + csvField(portName(ports, edge.fromNodeId, edge.fromPortId)) +
+                    ',' + csvField(edge.toNodeId) + ',' + csvField(portName(ports, edge.toNodeId, edge.toPortId)) +
+                    '\n');
+    }
+    return commitFile(&nodes, errorMessage) && commitFile(&edges, errorMessage);
+}
+
+bool importGraphMl(const QString& filePath, NetlistBuilder* builder, QString* errorMessage) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail(errorMessage, QStringLiteral("Cannot open file: %1").arg(filePath));
+    }
+    QXmlStreamReader xml(&file);
+    QHash<QString, QString> keyNames;
+    int current = -1;
+    QString x;
+    QString y;
+    while (!xml.atEnd()) {
+        const QXmlStreamReader::TokenType token = xml.readNext();
+        if (token == QXmlStreamReader::EndElement && xml.name() == QLatin1String("node") && current >= 0) {
+            bool xOk = false;
+            bool yOk = false;
+            const QPointF position(x.toDouble(&xOk), y.toDouble(&yOk));
+            if (xOk && yOk) {
+                builder->setPosition(current, position);
+            }
+            current = -1;
+            continue;
+        }
+        if (token != QXmlStreamReader::StartElement) {
+            continue;
+        }
+        const QXmlStreamAttributes attributes = xml.attributes();
+        if (xml.name() == QLatin1String("key")) {
+            const QString scope = attributes.value(QStringLiteral("for")).toString();
+            if (scope.isEmpty() || scope == QStringLiteral("node") || scope == QStringLiteral("all")) {
+                const QString id = attributes.value(QStringLiteral("id")).toString();
+                const QString name = attributes.value(QStringLiteral("attr.name")).toString();
+                keyNames.insert(id, name.isEmpty() ? id : name);
+            }
+        } else if (xml.name() == QLatin1String("node")) {
+            const QString id = attributes.value(QStringLiteral("id")).toString();
+            if (id.isEmpty()) {
+                return fail(errorMessage, QStringLiteral("%1:%2: node without id").arg(filePath).arg(xml.lineNumber()));
+            }
+            current = builder->node(id);
+            x.clear();
+            y.clear();
+        } else if (xml.name() == QLatin1String("data") && current >= 0) {
+            const auto it = keyNames.constFind(attributes.value(QStringLiteral("key")).toString());
+            if (it == keyNames.constEnd()) {
+                xml.skipCurrentElement();
+                continue;
+            }
+            const QString value = xml.readElementText(QXmlStreamReader::SkipChildElements).trimmed();
+            if (it.value() == QStringLiteral("x")) {
+                x = value;
+            } else if (it.value() == QStringLiteral("y")) {
+                y = value;
+            } else {
+                builder->setAttribute(current, it.value(), value);
+            }
+        } else if (xml.name() == QLatin1String("edge")) {
+            const QString source = attributes.value(QStringLiteral("source")).toString();
+            const QString target = attributes.value(QStringLiteral("target")).toString();
+            if (source.isEmpty() || target.isEmpty()) {
+                return fail(errorMessage, QStringLiteral("%1:%2: edge needs a source and a target")
+                                              .arg(filePath)
+                                              .arg(xml.lineNumber()));
+            }
+            builder->addEdge(source,
+                             attributes.value(QStringLiteral("sourceport")).toString(),
+                             target,
+                             attributes.value(QStringLiteral("targetport")).toString());
+        }
+    }
+    if (xml.hasError()) {
+        return fail(errorMessage,
+                    QStringLiteral("%1:%2: %3").arg(filePath).arg(xml.lineNumber()).arg(xml.errorString()));
+    }
+    return true;
+}
+
+void writeGraphMlKey(QXmlStreamWriter* xml, const QString& id, const QString& name, const QString& type) {
+    xml->writeEmptyElement(QStringLiteral("key"));
+    xml->writeAttribute(QStringLiteral("id"), id);
+    xml->writeAttribute(QStringLiteral("for"), QStringLiteral("node"));
+    xml->writeAttribute(QStringLiteral("attr.name"), name);
+    xml->writeAttribute(QStringLiteral("attr.type"), type);
+}
+
+void writeGraphMlData(QXmlStreamWriter* xml, const QString& key, const QString& value) {
+    xml->writeStartElement(QStringLiteral("data"));
+    xml->writeAttribute(QStringLiteral("key"), key);
+    xml->writeCharacters(value);
+    xml->writeEndElement();
+}
+
+bool exportGraphMl(const GraphDocument& document, const QString& filePath, QString* errorMessage) {
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return fail(errorMessage, QStringLiteral("Cannot write file: %1").arg(filePath));
+    }
+    const QStringList keys = propertyKeys(document);
+    QXmlStreamWriter xml(&file);
+    xml.setAutoFormatting(true);
+    xml.writeStartDocument();
+    xml.writeStartElement(QStringLiteral("graphml"));
+    xml.writeDefaultNamespace(QStringLiteral("http://graphml.graphdrawing.org/xmlns"));
+    writeGraphMlKey(&xml, QStringLiteral("name"), QStringLiteral("name"), QStringLiteral("string"));
+    writeGraphMlKey(&xml, QStringLiteral("type"), QStringLiteral("type"), QStringLiteral("string"));
+    writeGraphMlKey(&xml, QStringLiteral("x"), QStringLiteral("x"), QStringLiteral("double"));
+    writeGraphMlKey(&xml, QStringLiteral("y"), QStringLiteral("y"), QStringLiteral("double"));
+    for (int i = 0; i < keys.size(); ++i) {
+        writeGraphMlKey(&xml, QStringLiteral("p%1").arg(i), keys.at(i), QStringLiteral("string"));
+    }
+
+    xml.writeStartElement(QStringLiteral("graph"));
+    xml.writeAttribute(QStringLiteral("id"), QStringLiteral("G"));
+    xml.writeAttribute(QStringLiteral("edgedefault"), QStringLiteral("directed"));
+    for (const NodeData& node : document.nodes) {
+        xml.writeStartElement(QStringLiteral("node"));
+        xml.writeAttribute(QStringLiteral("id"), node.id);
+        writeGraphMlData(&xml, QStringLiteral("name"), node.name);
+        writeGraphMlData(&xml, QStringLiteral("type"), node.type);
+        writeGraphMlData(&xml, QStringLiteral("x"), QString::fromLatin1(number(node.position.x())));
+        writeGraphMlData(&xml, QStringLiteral("y"), QString::fromLatin1(number(node.position.y())));
+        for (int i = 0; i < keys.size(); ++i) {
+            const QString value = propertyValue(node, keys.at(i));
+            if (!value.isEmpty()) {
+                writeGraphMlData(&xml, QStringLiteral("p%1").arg(i), value);
+            }
+        }
+        for (const PortData& port : node.ports) {
+            xml.writeEmptyElement(QStringLiteral("port"));
+            xml.writeAttribute(QStringLiteral("name"), port.name.isEmpty() ? port.id : port.name);
+        }
+        xml.writeEndElement();
+    }
+    const QHash<QString, QString> ports = portNames(document);
+    for (const EdgeData& edge : document.edges) {
+        xml.writeEmptyElement(QStringLiteral("edge"));
+        xml.writeAttribute(QStringLiteral("id"), edge.id);
+        xml.writeAttribute(QStringLiteral("source"), edge.fromNodeId);
+        xml.writeAttribute(QStringLiteral("target"), edge.toNodeId);
+        xml.writeAttribute(QStringLiteral("sourceport"), portName(ports, edge.fromNodeId, edge.fromPortId));
+        xml.writeAttribute(QStringLiteral("targetport"), portName(ports, edge.toNodeId, edge.toPortId));
+    }
+    xml.writeEndElement();
+    xml.writeEndElement();
+    xml.writeEndDocument();
+    if (xml.hasError()) {
+        return fail(errorMessage, QStringLiteral("Write failed: %1").arg(file.errorString()));
+    }
+    return commitFile(&file, errorMessage);
+}
+
+// Tokenizer reading the file in fixed-size chunks. Handles the three kinds of
+// comments, `#` preprocessor lines, quoted strings with `+` concatenation and
+// `\` line continuation, and HTML strings.
+class DotLexer {
+public:
+    enum class Kind {
+        End,
+        Id,
+        Punct,
+        EdgeOp,
+        Error
+    };
+
+    struct Token {
+        Kind kind = Kind::End;
+        QString text;
+        char punct = 0;
+        bool quoted = false;
+    };
+
+    explicit DotLexer(QIODevice* device)
+        : m_device(device) {}
+
+    int line() const { return m_line; }
+
+    Token next() {
+        Token token;
+        if (!skipSpaceAndComments()) {
+            token.kind = Kind::Error;
+            token.text = QStringLiteral("unterminated comment");
+            return token;
+        }
+        const int c = peek();
+        if (c < 0) {
+            return token;
+        }
+        if (c == '"') {
+            return quotedString();
+        }
+        if (c == '<') {
+            return htmlString();
+        }
+        if (c == '-' && (peek(1) == '>' || peek(1) == '-')) {
+            token.kind = Kind::EdgeOp;
+            get();
+            token.text = get() == '>' ? QStringLiteral("->") : QStringLiteral("--");
+            return token;
+        }
+        if (c == '{' || c == '}' || c == '[' || c == ']' || c == '=' || c == ';' || c == ',' || c == ':') {
+            token.kind = Kind::Punct;
+            token.punct = static_cast<char>(get());
+            return token;
+        }
+        QByteArray text;
+        if (isIdStart(c)) {
+            while (isIdStart(peek()) || isDigit(peek())) {
+                text.append(static_cast<char>(get()));
+            }
+        } else if (c == '-' || c == '.' || isDigit(c)) {
+            text.append(static_cast<char>(get()));
+            while (isDigit(peek()) || peek() == '.') {
+                text.append(static_cast<char>(get()));
+            }
+        } else {
+            token.kind = Kind::Error;
+            token.text = QStringLiteral("unexpected character '%1'").arg(QChar(c));
+            return token;
+        }
+        token.kind = Kind::Id;
+        token.text = QString::fromUtf8(text);
+        return token;
+    }
+
+private:
+    static bool isIdStart(int c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c >= 0x80;
+    }
+
+    static bool isDigit(int c) { return c >= '0' && c <= '9'; }
+
+    // Character `ahead` positions past the cursor, or -1 past the end.
+    int peek(int ahead = 0) {
+        if (m_pos + ahead >= m_buffer.size() && !m_atEnd) {
+            m_buffer = m_buffer.mid(m_pos) + m_device->read(kReadChunkSize);
+            m_pos = 0;
+            m_atEnd = m_device->atEnd();
+        }
+        return m_pos + ahead < m_buffer.size() ? static_cast<unsigned char>(m_buffer.at(m_pos + ahead)) : -1;
+    }
+
+    int get() {
+        const int c = peek();
+        if (c >= 0) {
+            ++m_pos;
+            if (c == '\n') {
+                ++m_line;
+                m_lineStart = true;
+            } else if (c != ' ' && c != '\t' && c != '\r') {
+                m_lineStart = false;
+            }
+        }
+        return c;
+    }
+
+    bool skipSpaceAndComments() {
+        while (true) {
+            const int c = peek();
+            if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+                get();
+            } else if (c == '#' && m_lineStart) {
+                skipLine();
+            } else if (c == '/' && peek(1) == '/') {
+                skipLine();
+            } else if (c == '/' && peek(1) == '*') {
+                get();
+                get();
+                while (!(peek() == '*' && peek(1) == '/')) {
+                    if (get() < 0) {
+                        return false;
+                    }
+                }
+                get();
+                get();
+            } else {
+                return true;
+            }
+        }
+    }
+
+    void skipLine() {
+        while (peek() >= 0 && peek() != '\n') {
+            get();
+        }
+    }
+
+    Token quotedString() {
+        Token token;
+        token.kind = Kind::Id;
+        token.quoted = true;
+        QByteArray text;
+        while (true) {
+            get();
+            while (true) {
+                const int c = get();
+                if (c < 0) {
+                    token.kind = Kind::Error;
+                    token.text = QStringLiteral("unterminated string");
+                    return token;
+                }
+                if (c == '"') {
+                    break;
+                }
+                if (c == '\\' && peek() == '"') {
+                    text.append(static_cast<char>(get()));
+                } else if (c == '\\' && peek() == '\n') {
+                    get();
+                } else if (c == '\\' && peek() == '\r' && peek(1) == '\n') {
+                    get();
+                    get();
+                } else {
+                    text.append(static_cast<char>(c));
+                }
+            }
+            if (!skipSpaceAndComments() || peek() != '+') {
+                break;
+            }
+            get();
+            if (!skipSpaceAndComments() || peek() != '"') {
+                token.kind = Kind::Error;
+                token.text = QStringLiteral("'+' must join two quoted strings");
+                return token;
+            }
+        }
+        token.text = QString::fromUtf8(text);
+        return token;
+    }
+
+    Token htmlString() {
+        Token token;
+        token.kind = Kind::Id;
+        token.quoted = true;
+        QByteArray text;
+        get();
+        int depth = 1;
+        while (true) {
+            const int c = get();
+            if (c < 0) {
+                token.kind = Kind::Error;
+                token.text = QStringLiteral("unterminated HTML string");
+                return token;
+            }
+            if (c == '<') {
+                ++depth;
+            } else if (c == '>' && --depth == 0) {
+                break;
+            }
+            text.append(static_cast<char>(c));
+        }
+        token.text = QString::fromUtf8(text);
+        return token;
+    }
+
+    QIODevice* m_device = nullptr;
+    QByteArray m_buffer;
+    int m_pos = 0;
+    int m_line = 1;
+    bool m_lineStart = true;
+    bool m_atEnd = false;
+};
+
+bool isKeyword(const DotLexer::Token& token, const char* keyword) {
+    return token.kind == DotLexer::Kind::Id && !token.quoted &&
+           token.text.compare(QLatin1String(keyword), Qt::CaseInsensitive) == 0;
+}
+
+bool isPunct(const DotLexer::Token& token, char punct) {
+    return token.kind == DotLexer::Kind::Punct && token.punct == punct;
+}
+
+class DotParser {
+public:
+    DotParser(QIODevice* device, NetlistBuilder* builder, const QString& filePath)
+        : m_lexer(device),
+          m_builder(builder),
+          m_filePath(filePath) {}
+
+    // Flattens subgraphs into the one document; graph and edge attributes
+    // other than ports are ignored.
+    bool parse(QString* errorMessage) {
+        advance();
+        if (isKeyword(m_token, "strict")) {
+            advance();
+        }
+        if (!isKeyword(m_token, "graph") && !isKeyword(m_token, "digraph")) {
+            return error(errorMessage, QStringLiteral("expected 'graph' or 'digraph'"));
+        }
+        advance();
+        if (m_token.kind == DotLexer::Kind::Id) {
+            advance();
+        }
+        if (!isPunct(m_token, '{')) {
+            return error(errorMessage, QStringLiteral("expected '{'"));
+        }
+        advance();
+        int depth = 1;
+        while (depth > 0) {
+            if (m_token.kind == DotLexer::Kind::Error) {
+                return error(errorMessage, m_token.text);
+            }
+            if (m_token.kind == DotLexer::Kind::End) {
+                return error(errorMessage, QStringLiteral("unexpected end of file"));
+            }
+            if (isPunct(m_token, '}')) {
+                --depth;
+                advance();
+            } else if (isPunct(m_token, '{')) {
+                ++depth;
+                advance();
+            } else if (isPunct(m_token, ';') || isPunct(m_token, ',')) {
+                advance();
+            } else if (isKeyword(m_token, "subgraph")) {
+                advance();
+                if (m_token.kind == DotLexer::Kind::Id) {
+                    advance();
+                }
+                if (!isPunct(m_token, '{')) {
+                    return error(errorMessage, QStringLiteral("expected '{' after subgraph"));
+                }
+            } else if (isKeyword(m_token, "graph") || isKeyword(m_token, "node") || isKeyword(m_token, "edge")) {
+                const bool nodeDefaults = isKeyword(m_token, "node");
+                advance();
+                QHash<QString, QString> attributes;
+                if (!parseAttributes(&attributes, errorMessage)) {
+                    return false;
+                }
+                if (nodeDefaults) {
+                    for (auto it = attributes.constBegin(); it != attributes.constEnd(); ++it) {
+                        m_nodeDefaults.insert(it.key(), it.value());
+                    }
+                }
+            } else if (m_token.kind == DotLexer::Kind::Id) {
+                if (!parseStatement(errorMessage)) {
+                    return false;
+                }
+            } else {
+                return error(errorMessage, QStringLiteral("unexpected token"));
+            }
+        }
+        return true;
+    }
+
+private:
+    struct Endpoint {
+        QString node;
+        QString port;
+    };
+
+    void advance() { m_token = m_lexer.next(); }
+
+    bool error(QString* errorMessage, const QString& message) {
+        return fail(errorMessage, QStringLiteral("%1:%2: %3").arg(m_filePath).arg(m_lexer.line()).arg(message));
+    }
+
+    // Reads `[a=b, c=d][...]` lists when present.
+    bool parseAttributes(QHash<QString, QString>* attributes, QString* errorMessage) {
+        while (isPunct(m_token, '[')) {
+            advance();
+            while (!isPunct(m_token, ']')) {
+                if (isPunct(m_token, ',') || isPunct(m_token, ';')) {
+                    advance();
+                    continue;
+                }
+                if (m_token.kind == DotLexer::Kind::Error) {
+                    return error(errorMessage, m_token.text);
+                }
+                if (m_token.kind != DotLexer::Kind::Id) {
+                    return error(errorMessage, QStringLiteral("expected attribute name"));
+                }
+                const QString key = m_token.text;
+                advance();
+                if (!isPunct(m_token, '=')) {
+                    attributes->insert(key, QStringLiteral("true"));
+                    continue;
+                }
+                advance();
+                if (m_token.kind != DotLexer::Kind::Id) {
+                    return error(errorMessage, QStringLiteral("expected value for attribute '%1'").arg(key));
+                }
+                attributes->insert(key, m_token.text);
+                advance();
+            }
+            advance();
+        }
+        return true;
+    }
+
+    // Node id with an optional `:port[:compass]` suffix.
+    bool parseEndpoint(Endpoint* endpoint, QString* errorMessage) {
+        if (isPunct(m_token, '{')) {
+            return error(errorMessage, QStringLiteral("subgraphs as edge endpoints are not supported"));
+        }
+        if (m_token.kind != DotLexer::Kind::Id) {
+            return error(errorMessage, QStringLiteral("expected node id"));
+        }
+        endpoint->node = m_token.text;
+        advance();
+        if (isPunct(m_token, ':')) {
+            advance();
+            if (m_token.kind != DotLexer::Kind::Id) {
+                return error(errorMessage, QStringLiteral("expected port name"));
+            }
+            endpoint->port = m_token.text;
+            advance();
+            if (isPunct(m_token, ':')) {
+                advance();
+                advance();
+            }
+        }
+        return true;
+    }
+
+    int declareNode(const QString& key) {
+        bool created = false;
+        const int index = m_builder->node(key, &created);
+        if (created) {
+            for (auto it = m_nodeDefaults.constBegin(); it != m_nodeDefaults.constEnd(); ++it) {
+                applyNodeAttribute(index, it.key(), it.value());
+            }
+        }
+        return index;
+    }
+
+    void applyNodeAttribute(int index, const QString& key, const QString& value) {
+        if (key == QStringLiteral("label") && value == QStringLiteral("\\N")) {
+            return;
+        }
+        if (key == QStringLiteral("pos")) {
+            // Graphviz points with y growing upwards; a trailing '!' pins the node.
+            const QStringList parts = QString(value).remove(QLatin1Char('!')).split(QLatin1Char(','));
+            bool xOk = false;
+            bool yOk = false;
+            const qreal x = parts.value(0).toDouble(&xOk);
+            const qreal y = parts.value(1).toDouble(&yOk);
+            if (parts.size() >= 2 && xOk && yOk) {
+                m_builder->setPosition(index, QPointF(x, -y));
+            }
+            return;
+        }
+        m_builder->setAttribute(index, key, value);
+    }
+
+    // `ID = ID`, a node statement or an edge chain `a -> b -> c [attrs]`.
+    bool parseStatement(QString* errorMessage) {
+        Endpoint first;
+        if (!parseEndpoint(&first, errorMessage)) {
+            return false;
+        }
+        if (isPunct(m_token, '=') && first.port.isEmpty()) {
+            advance();
+            advance();
+            return true;
+        }
+        if (m_token.kind != DotLexer::Kind::EdgeOp) {
+            const int index = declareNode(first.node);
+            QHash<QString, QString> attributes;
+            if (!parseAttributes(&attributes, errorMessage)) {
+                return false;
+            }
+            for (auto it = attributes.constBegin(); it != attributes.constEnd(); ++it) {
+                applyNodeAttribute(index, it.key(), it.value());
+            }
+            return true;
+        }
+
+        QVector<Endpoint> chain{first};
+        while (m_token.kind == DotLexer::Kind::EdgeOp) {
+            advance();
+            Endpoint next;
+            if (!parseEndpoint(&next, errorMessage)) {
+                return false;
+            }
+            chain.push_back(next);
+        }
+        QHash<QString, QString> attributes;
+        if (!parseAttributes(&attributes, errorMessage)) {
+            return false;
+        }
+        const QString tailPort = attributes.value(QStringLiteral("tailport"));
+        const QString headPort = attributes.value(QStringLiteral("headport"));
+        for (const Endpoint& endpoint : chain) {
+            declareNode(endpoint.node);
+        }
+        for (int i = 1; i < chain.size(); ++i) {
+            const Endpoint& from = chain.at(i - 1);
+            const Endpoint& to = chain.at(i);
+            m_builder->addEdge(from.node, from.port.isEmpty() ? tailPort : from.port, to.node,
+                               to.port.isEmpty() ? headPort : to.port);
+        }
+        return true;
+    }
+
+    DotLexer m_lexer;
+    DotLexer::Token m_token;
+    NetlistBuilder* m_builder = nullptr;
+    QString m_filePath;
+    QHash<QString, QString> m_nodeDefaults;
+};
+
+bool importDot(const QString& filePath, NetlistBuilder* builder, QString* errorMessage) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail(errorMessage, QStringLiteral("Cannot open file: %1").arg(filePath));
+    }
+    DotParser parser(&file, builder, filePath);
+    return parser.parse(errorMessage);
+}
+
+QByteArray dotId(const QString& value) {
+    QByteArray bytes = value.toUtf8();
+    bytes.replace("\"", "\\\"");
+    return '"' + bytes + '"';
+}
+
+bool exportDot(const GraphDocument& document, const QString& filePath, QString* errorMessage) {
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return fail(errorMessage, QStringLiteral("Cannot write file: %1").arg(filePath));
+    }
+    file.write("digraph " + dotId(QFileInfo(filePath).completeBaseName()) + " {\n");
+    for (const NodeData& node : document.nodes) {
+        QByteArray line = "  " + dotId(node.id) + " [label=" + dotId(node.name) + ", type=" + dotId(node.type) +
+                          ", pos=\"" + number(node.position.x()) + ',' + number(-node.position.y()) + '"';
+        for (const PropertyData& property : node.properties) {
+            if (isReservedKey(property.key)) {
+                continue;
+            }
+            line += ", " + dotId(property.key) + '=' + dotId(property.value);
+        }
+        file.write(line + "];\n");
+    }
+    const QHash<QString, QString> ports = portNames(document);
+    for (const EdgeData& edge : document.edges) {
+        file.write("  " + dotId(edge.fromNodeId) + ':' + dotId(portName(ports, edge.fromNodeId, edge.fromPortId)) +
+                   " -> " + dotId(edge.toNodeId) + ':' + dotId(portName(ports, edge.toNodeId, edge.toPortId)) + ";\n");
+    }
+    file.write("}\n");
+    return commitFile(&file, errorMessage);
+}
+}  // namespace
+
+NetlistFormats::Format NetlistFormats::formatForPath(const QString& filePath) {
+    const QString suffix = QFileInfo(filePath).suffix().toLower();
+    if (suffix == QStringLiteral("csv")) {
+        return Format::Csv;
+    }
+    if (suffix == QStringLiteral("graphml")) {
+        return Format::GraphMl;
+    }
+    if (suffix == QStringLiteral("dot") || suffix == QStringLiteral("gv")) {
+        return Format::Dot;
+    }
+    return Format::Unknown;
+}
+
+bool NetlistFormats::isNetlistPath(const QString& filePath) {
+    return formatForPath(filePath) != Format::Unknown;
+}
+
+QString NetlistFormats::csvNodeListPath(const QString& edgeListPath) {
+    const QFileInfo info(edgeListPath);
+    return info.dir().filePath(info.completeBaseName() + kNodeListSuffix);
+}
+
+bool NetlistFormats::importFile(const QString& filePath,
+                                GraphDocument* document,
+                                const NetlistImportOptions& options,
+                                QString* errorMessage,
+                                NetlistImportReport* report) {
+    if (!document) {
+        return fail(errorMessage, QStringLiteral("Document output pointer is null"));
+    }
+    GraphDocument imported;
+    NetlistBuilder builder(&imported, options);
+    bool ok = false;
+    switch (formatForPath(filePath)) {
+    case Format::Csv:
+        ok = importCsv(filePath, &builder, errorMessage);
+        break;
+    case Format::GraphMl:
+        ok = importGraphMl(filePath, &builder, errorMessage);
+        break;
+    case Format::Dot:
+        ok = importDot(filePath, &builder, errorMessage);
+        break;
+    case Format::Unknown:
+        return fail(errorMessage, QStringLiteral("Unsupported netlist format: %1").arg(filePath));
+    }
+    if (!ok) {
+        return false;
+    }
+    builder.finish();
+    if (report) {
+        *report = builder.report();
+    }
+    imported.autoLayoutXSpacing = options.xSpacing;
+    imported.autoLayoutYSpacing = options.ySpacing;
+    *document = std::move(imported);
+    return true;
+}
+
+bool NetlistFormats::exportFile(const GraphDocument& document, const QString& filePath, QString* errorMessage) {
+    switch (formatForPath(filePath)) {
+    case Format::Csv:
+        return exportCsv(document, filePath, errorMessage);
+    case Format::GraphMl:
+        return exportGraphMl(document, filePath, errorMessage);
+    case Format::Dot:
+        return exportDot(document, filePath, errorMessage);
+    case Format::Unknown:
+        break;
+    }
+    return fail(errorMessage, QStringLiteral("Unsupported netlist format: %1").arg(filePath));
+}
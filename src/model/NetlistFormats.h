@@ -0,0 +1,57 @@
+#pragma once
+
+#include "GraphDocument.h"
+
+#include <QString>
+
+struct NetlistImportOptions {
+    // Layered placement along edge direction; otherwise nodes keep the
+    // positions given in the file and the rest are placed on a grid.
+    bool autoLayout = false;
+    qreal xSpacing = 240.0;
+    qreal ySpacing = 140.0;
+};
+
+// Edges an import left out.
+struct NetlistImportReport {
+    int skippedSelfLoops = 0;
+    int skippedDuplicates = 0;
+};
+
+// Netlist interchange with other tools: CSV node/edge lists, GraphML and
+// Graphviz DOT.
+//
+// Files are parsed as a stream, so apart from the document being built and
+// the map from file node names to document ids, memory use does not grow
+// with the input. Imported nodes get fresh `N_<k>` ids and keep the file's
+// name as their `name`; ports are created per node on first use by an edge.
+// Unnamed sources share one `out` port, while each edge without a target port
+// name gets its own `in1`, `in2`, ... since an input takes one connection.
+// Self-loops and repeated edges between the same named ports are skipped.
+//
+// CSV: an edge list `<base>.csv` with `source` and `target` columns and
+// optional `source_port`/`target_port`, plus an optional node list
+// `<base>.nodes.csv` with an `id` column and optional `name`, `type`, `x` and
+// `y`. Other node-list columns become string properties.
+class NetlistFormats {
+public:
+    enum class Format {
+        Unknown,
+        Csv,
+        GraphMl,
+        Dot
+    };
+
+    static Format formatForPath(const QString& filePath);
+    static bool isNetlistPath(const QString& filePath);
+    // Node list belonging to an edge list `<base>.csv`.
+    static QString csvNodeListPath(const QString& edgeListPath);
+
+    static bool importFile(const QString& filePath,
+                           GraphDocument* document,
+                           const NetlistImportOptions& options,
+                           QString* errorMessage = nullptr,
+                           NetlistImportReport* report = nullptr);
+    // Ports are written by name; nodes, positions and properties round-trip.
+    static bool exportFile(const GraphDocument& document, const QString& filePath, QString* errorMessage = nullptr);
+};
@@ -0,0 +1,197 @@
+#include "NodeSearchIndex.h"
+
+#include <QPair>
+
+#include <algorithm>
+
+namespace {
+constexpr int kGramSize = 3;
+
+// Three UTF-16 code units packed into one key, so postings and the grams of
+// a query are plain integers rather than three-character strings.
+void collectTrigrams(const QString& folded, QSet<quint64>* grams) {
+    const QChar* text = folded.constData();
+    for (int i = 0; i + kGramSize <= folded.size(); ++i) {
+        grams->insert((quint64(text[i].unicode()) << 32) | (quint64(text[i + 1].unicode()) << 16) |
+                      quint64(text[i + 2].unicode()));
+    }
+}
+}  // namespace
+
+void NodeSearchIndex::clear() {
+    m_entries.clear();
+    m_freeSlots.clear();
+    m_slotById.clear();
+    m_postings.clear();
+}
+
+void NodeSearchIndex::upsert(const QString& nodeId,
+                             const QString& displayName,
+                             const QString& typeName,
+                             const QStringList& propertyValues) {
+    remove(nodeId);
+
+    Entry entry;
+    entry.nodeId = nodeId;
+    entry.displayName = displayName;
+    entry.typeName = typeName;
+    entry.foldedName = displayName.toLower();
+    entry.foldedType = typeName.toLower();
+    for (const QString& value : propertyValues) {
+        if (!value.isEmpty()) {
+            entry.foldedValues.push_back(value.toLower());
+        }
+    }
+    entry.alive = true;
+
+    int slot = -1;
+    if (!m_freeSlots.isEmpty()) {
+        slot = m_freeSlots.takeLast();
+        m_entries[slot] = entry;
+    } else {
+        slot = m_entries.size();
+        m_entries.push_back(entry);
+    }
+    m_slotById.insert(nodeId, slot);
+    for (const quint64 gram : trigramsOf(entry)) {
+        m_postings[gram].insert(slot);
+    }
+}
+
+void NodeSearchIndex::remove(const QString& nodeId) {
+    const auto it = m_slotById.find(nodeId);
+    if (it == m_slotById.end()) {
+        return;
+    }
+    const int slot = it.value();
+    m_slotById.erase(it);
+    Entry& entry = m_entries[slot];
+    for (const quint64 gram : trigramsOf(entry)) {
+        auto posting = m_postings.find(gram);
+        if (posting == m_postings.end()) {
+            continue;
+        }
+        posting->remove(slot);
+        if (posting->isEmpty()) {
+            m_postings.erase(posting);
+        }
+    }
+    entry = Entry();
+    m_freeSlots.push_back(slot);
+}
+
+bool NodeSearchIndex::contains(const QString& nodeId) const {
+    return m_slotById.contains(nodeId);
+}
+
+int NodeSearchIndex::size() const {
+    return m_slotById.size();
+}
+
+QVector<NodeSearchHit> NodeSearchIndex::search(const QString& query, int limit) const {
+    const QString folded = query.trimmed().toLower();
+    if (folded.isEmpty() || limit <= 0) {
+        return {};
+    }
+
+    QVector<QPair<int, int>> ranked;  // (score, slot)
+    auto consider = [this, &folded, &ranked](int slot) {
+        const int score = matchScore(m_entries[slot], folded);
+        if (score >= 0) {
+            ranked.push_back(qMakePair(score, slot));
+        }
+    };
+
+    if (folded.size() >= kGramSize) {
+        QSet<quint64> grams;
+        collectTrigrams(folded, &grams);
+        QVector<const QSet<int>*> postings;
+        postings.reserve(grams.size());
+        for (const quint64 gram : grams) {
+            const auto it = m_postings.constFind(gram);
+            if (it == m_postings.constEnd()) {
+                return {};
+            }
+            postings.push_back(&it.value());
+        }
+        std::sort(postings.begin(), postings.end(), [](const QSet<int>* a, const QSet<int>* b) {
+            return a->size() < b->size();
+        });
+        for (int slot : *postings.first()) {
+            bool inAll = true;
+            for (int i = 1; i < postings.size() && inAll; ++i) {
+                inAll = postings[i]->contains(slot);
+            }
+            if (inAll) {
+                consider(slot);
+            }
+        }
+    } else {
+        for (int slot = 0; slot < m_entries.size(); ++slot) {
+            if (m_entries[slot].alive) {
+                consider(slot);
+            }
+        }
+    }
+
+    auto less = [this](const QPair<int, int>& a, const QPair<int, int>& b) {
+        if (a.first != b.first) {
+            return a.first < b.first;
+        }
+        const Entry& lhs = m_entries[a.second];
+        const Entry& rhs = m_entries[b.second];
+        if (lhs.displayName.size() != rhs.displayName.size()) {
+            return lhs.displayName.size() < rhs.displayName.size();
+        }
+        return lhs.nodeId < rhs.nodeId;
+    };
+    const int count = std::min<int>(limit, ranked.size());
+    std::partial_sort(ranked.begin(), ranked.begin() + count, ranked.end(), less);
+
+    QVector<NodeSearchHit> hits;
+    hits.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const Entry& entry = m_entries[ranked[i].second];
+        NodeSearchHit hit;
+        hit.nodeId = entry.nodeId;
+        hit.displayName = entry.displayName;
+        hit.typeName = entry.typeName;
+        hit.score = ranked[i].first;
+        hits.push_back(hit);
+    }
+    return hits;
+}
+
+QSet<quint64> NodeSearchIndex::trigramsOf(const Entry& entry) {
+    QSet<quint64> grams;
+    collectTrigrams(entry.foldedName, &grams);
+    collectTrigrams(entry.foldedType, &grams);
+    for (const QString& value : entry.foldedValues) {
+        collectTrigrams(value, &grams);
+    }
+    return grams;
+}
+
+int NodeSearchIndex::matchScore(const Entry& entry, const QString& foldedQuery) const {
+    if (entry.foldedName == foldedQuery) {
+        return 0;
+    }
+    if (entry.foldedName.startsWith(foldedQuery)) {
+        return 1;
+    }
+    if (entry.foldedName.contains(foldedQuery)) {
+        return 2;
+    }
+    if (entry.foldedType == foldedQuery) {
+        return 3;
+    }
+    if (entry.foldedType.contains(foldedQuery)) {
+        return 4;
+    }
+    for (const QString& value : entry.foldedValues) {
+        if (value.contains(foldedQuery)) {
+            return 5;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+struct NodeSearchHit {
+    QString nodeId;
+    QString displayName;
+    QString typeName;
+    int score = 0;  // lower ranks first
+};
+
+// Case-insensitive substring search over node names, types and property
+// values. Queries of three or more characters intersect trigram postings and
+// only verify the surviving candidates; shorter queries scan all entries.
+// Entries keep only their folded text; a removal recomputes the trigrams to
+// unlink from the postings.
+class NodeSearchIndex {
+public:
+    void clear();
+    void upsert(const QString& nodeId,
+                const QString& displayName,
+                const QString& typeName,
+                const QStringList& propertyValues);
+    void remove(const QString& nodeId);
+    bool contains(const QString& nodeId) const;
+    int size() const;
+
+    QVector<NodeSearchHit> search(const QString& query, int limit = 50) const;
+
+private:
+    struct Entry {
+        QString nodeId;
+        QString displayName;
+        QString typeName;
+        QString foldedName;
+        QString foldedType;
+        QStringList foldedValues;
+        bool alive = false;
+    };
+
+    static QSet<quint64> trigramsOf(const Entry& entry);
+    int matchScore(const Entry& entry, const QString& foldedQuery) const;
+
+    QVector<Entry> m_entries;
+    QVector<int> m_freeSlots;
+    QHash<QString, int> m_slotById;
+    QHash<quint64, QSet<int>> m_postings;
+};
@@ -0,0 +1,295 @@
+#include "PropertyStore.h"
+
+#include <QLocale>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
+
+namespace {
+PropertyKind kindForTypeName(const QString& typeName) {
+    if (typeName == QStringLiteral("bool")) {
+        return PropertyKind::Bool;
+    }
+    if (typeName == QStringLiteral("int")) {
+        return PropertyKind::Int;
+    }
+    if (typeName == QStringLiteral("double")) {
+        return PropertyKind::Double;
+    }
+    return PropertyKind::String;
+}
+
+QString layoutSignature(const QVector<PropertyData>& layout) {
+    QString signature;
+    for (const PropertyData& property : layout) {
+        signature += property.key;
+        signature += QLatin1Char('\x1f');
+        signature += property.type;
+        signature += QLatin1Char('\x1e');
+    }
+    return signature;
+}
+}  // namespace
+
+const PropertySchema* PropertySchema::intern(const QVector<PropertyData>& layout) {
+    if (layout.isEmpty()) {
+        return empty();
+    }
+    static QMutex mutex;
+    static QHash<QString, const PropertySchema*> schemas;
+    // Schemas are never freed, so each thread keeps the ones it has seen and
+    // only takes the lock for a layout new to it.
+    thread_local QHash<QString, const PropertySchema*> seen;
+
+    const QString signature = layoutSignature(layout);
+    if (const PropertySchema* known = seen.value(signature, nullptr)) {
+        return known;
+    }
+    QMutexLocker locker(&mutex);
+    if (const PropertySchema* existing = schemas.value(signature, nullptr)) {
+        seen.insert(signature, existing);
+        return existing;
+    }
+    auto* schema = new PropertySchema();
+    for (const PropertyData& property : layout) {
+        schema->m_slotByKey.insert(property.key, schema->m_keys.size());
+        schema->m_keys.push_back(property.key);
+        schema->m_typeNames.push_back(property.type.isEmpty() ? QStringLiteral("string") : property.type);
+        schema->m_kinds.push_back(kindForTypeName(property.type));
+    }
+    schemas.insert(signature, schema);
+    seen.insert(signature, schema);
+    return schema;
+}
+
+const PropertySchema* PropertySchema::empty() {
+    static const PropertySchema schema;
+    return &schema;
+}
+
+int PropertySchema::size() const {
+    return m_keys.size();
+}
+
+int PropertySchema::slotOf(const QString& key) const {
+    return m_slotByKey.value(key, -1);
+}
+
+const QString& PropertySchema::key(int slot) const {
+    return m_keys[slot];
+}
+
+const QString& PropertySchema::typeName(int slot) const {
+    return m_typeNames[slot];
+}
+
+PropertyKind PropertySchema::kind(int slot) const {
+    return m_kinds[slot];
+}
+
+void PropertyStore::assign(const QVector<PropertyData>& properties) {
+    QVector<PropertyData> layout;
+    layout.reserve(properties.size());
+    QVector<const PropertyData*> unique;
+    unique.reserve(properties.size());
+    QSet<QString> seen;
+    for (const PropertyData& property : properties) {
+        if (seen.contains(property.key)) {
+            continue;
+        }
+        seen.insert(property.key);
+        layout.push_back(PropertyData{property.key, property.type, QString()});
+        unique.push_back(&property);
+    }
+
+    m_schema = PropertySchema::intern(layout);
+    m_values = QVector<Value>(m_schema->size());
+    m_strings.clear();
+    for (int slot = 0; slot < unique.size(); ++slot) {
+        store(slot, unique[slot]->value);
+    }
+}
+
+QVector<PropertyData> PropertyStore::toPropertyData() const {
+    QVector<PropertyData> properties;
+    properties.reserve(m_values.size());
+    for (int slot = 0; slot < m_values.size(); ++slot) {
+        properties.push_back(PropertyData{m_schema->key(slot), m_schema->typeName(slot), textAt(slot)});
+    }
+    return properties;
+}
+
+QStringList PropertyStore::textValues() const {
+    QStringList values;
+    values.reserve(m_values.size());
+    for (int slot = 0; slot < m_values.size(); ++slot) {
+        values.push_back(textAt(slot));
+    }
+    return values;
+}
+
+const PropertySchema* PropertyStore::schema() const {
+    return m_schema;
+}
+
+int PropertyStore::size() const {
+    return m_values.size();
+}
+
+bool PropertyStore::contains(const QString& key) const {
+    return m_schema->slotOf(key) >= 0;
+}
+
+QString PropertyStore::typeName(const QString& key) const {
+    const int slot = m_schema->slotOf(key);
+    return slot < 0 ? QStringLiteral("string") : m_schema->typeName(slot);
+}
+
+QString PropertyStore::text(const QString& key) const {
+    const int slot = m_schema->slotOf(key);
+    return slot < 0 ? QString() : textAt(slot);
+}
+
+bool PropertyStore::setText(const QString& key, const QString& text) {
+    const int slot = m_schema->slotOf(key);
+    if (slot < 0) {
+        return false;
+    }
+    const Value previous = m_values[slot];
+    const QString previousText = m_strings.value(slot);
+    store(slot, text);
+    const Value& current = m_values[slot];
+    bool changed = true;
+    if (current.kind == previous.kind) {
+        switch (current.kind) {
+        case PropertyKind::Bool:
+            changed = current.b != previous.b;
+            break;
+        case PropertyKind::Int:
+            changed = current.i != previous.i;
+            break;
+        case PropertyKind::Double:
+            changed = current.d != previous.d;
+            break;
+        case PropertyKind::String:
+            changed = m_strings.value(slot) != previousText;
+            break;
+        }
+    }
+    if (!changed) {
+        // Same value spelled differently: keep the text it already had.
+        m_values[slot] = previous;
+        if (slot < m_strings.size()) {
+            m_strings[slot] = previousText;
+        }
+    }
+    return changed;
+}
+
+bool PropertyStore::boolValue(const QString& key, bool fallback) const {
+    const int slot = m_schema->slotOf(key);
+    return slot >= 0 && m_values[slot].kind == PropertyKind::Bool ? m_values[slot].b : fallback;
+}
+
+qint64 PropertyStore::intValue(const QString& key, qint64 fallback) const {
+    const int slot = m_schema->slotOf(key);
+    return slot >= 0 && m_values[slot].kind == PropertyKind::Int ? m_values[slot].i : fallback;
+}
+
+double PropertyStore::doubleValue(const QString& key, double fallback) const {
+    const int slot = m_schema->slotOf(key);
+    if (slot < 0) {
+        return fallback;
+    }
+    if (m_values[slot].kind == PropertyKind::Double) {
+        return m_values[slot].d;
+    }
+    if (m_values[slot].kind == PropertyKind::Int) {
+        return static_cast<double>(m_values[slot].i);
+    }
+    return fallback;
+}
+
+QString PropertyStore::formatDouble(double value) {
+    QString text = QString::number(value, 'g', QLocale::FloatingPointShortest);
+    bool plainDigits = true;
+    for (const QChar ch : text) {
+        if (!ch.isDigit() && ch != QLatin1Char('-')) {
+            plainDigits = false;
+            break;
+        }
+    }
+    // Keep integral doubles recognizable as doubles ("1.0", not "1").
+    if (plainDigits) {
+        text += QStringLiteral(".0");
+    }
+    return text;
+}
+
+void PropertyStore::store(int slot, const QString& text) {
+    Value value;
+    bool ok = false;
+    switch (m_schema->kind(slot)) {
+    case PropertyKind::Bool: {
+        const QString folded = text.trimmed().toLower();
+        if (folded == QStringLiteral("true") || folded == QStringLiteral("1")) {
+            value.kind = PropertyKind::Bool;
+            value.b = true;
+            ok = true;
+        } else if (folded == QStringLiteral("false") || folded == QStringLiteral("0")) {
+            value.kind = PropertyKind::Bool;
+            value.b = false;
+            ok = true;
+        }
+        break;
+    }
+    case PropertyKind::Int:
+        value.i = text.trimmed().toLongLong(&ok);
+        value.kind = PropertyKind::Int;
+        break;
+    case PropertyKind::Double:
+        value.d = text.trimmed().toDouble(&ok);
+        value.kind = PropertyKind::Double;
+        break;
+    case PropertyKind::String:
+        break;
+    }
+
+    if (!ok) {
+        value = Value();
+        value.kind = PropertyKind::String;
+    } else {
+        value.verbatim = canonicalText(value) != text;
+    }
+    if (value.kind == PropertyKind::String || value.verbatim) {
+        if (m_strings.size() <= slot) {
+            m_strings.resize(slot + 1);
+        }
+        m_strings[slot] = text;
+    } else if (slot < m_strings.size()) {
+        m_strings[slot].clear();
+    }
+    m_values[slot] = value;
+}
+
+QString PropertyStore::textAt(int slot) const {
+    const Value& value = m_values[slot];
+    if (value.kind == PropertyKind::String || value.verbatim) {
+        return m_strings.value(slot);
+    }
+    return canonicalText(value);
+}
+
+QString PropertyStore::canonicalText(const Value& value) {
+    switch (value.kind) {
+    case PropertyKind::Bool:
+        return value.b ? QStringLiteral("true") : QStringLiteral("false");
+    case PropertyKind::Int:
+        return QString::number(value.i);
+    case PropertyKind::Double:
+        return formatDouble(value.d);
+    case PropertyKind::String:
+        break;
+    }
+    return QString();
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "GraphDocument.h"
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+enum class PropertyKind : quint8 {
+    Bool,
+    Int,
+    Double,
+    String
+};
+
+// Key/type layout shared by every node with the same property signature
+// (in practice one per component type). Instances are interned and live for
+// the whole process, so nodes only hold a pointer.
+class PropertySchema {
+public:
+    static const PropertySchema* intern(const QVector<PropertyData>& layout);
+    static const PropertySchema* empty();
+
+    int size() const;
+    int slotOf(const QString& key) const;
+    const QString& key(int slot) const;
+    const QString& typeName(int slot) const;
+    PropertyKind kind(int slot) const;
+
+private:
+    QVector<QString> m_keys;
+    QVector<QString> m_typeNames;
+    QVector<PropertyKind> m_kinds;
+    QHash<QString, int> m_slotByKey;
+};
+
+// Typed property values laid out by a PropertySchema. Values are parsed once
+// on assignment; text is produced only when serializing or showing the UI.
+// A value that does not parse as its declared type is kept verbatim, and so
+// is the text of a typed value written differently from its canonical form
+// ("0.80", "3" for a double, "1" for a bool) until an edit changes the value.
+class PropertyStore {
+public:
+    void assign(const QVector<PropertyData>& properties);
+    QVector<PropertyData> toPropertyData() const;
+    QStringList textValues() const;
+
+    const PropertySchema* schema() const;
+    int size() const;
+    bool contains(const QString& key) const;
+    QString typeName(const QString& key) const;
+    QString text(const QString& key) const;
+    bool setText(const QString& key, const QString& text);
+
+    bool boolValue(const QString& key, bool fallback = false) const;
+    qint64 intValue(const QString& key, qint64 fallback = 0) const;
+    double doubleValue(const QString& key, double fallback = 0.0) const;
+
+    static QString formatDouble(double value);
+
+private:
+    struct Value {
+        PropertyKind kind = PropertyKind::String;
+        bool verbatim = false;  // typed, but the source text is kept in m_strings
+        union {
+            bool b;
+            qint64 i;
+            double d;
+        };
+
+        Value()
+            : i(0) {}
+    };
+
+    void store(int slot, const QString& text);
+    QString textAt(int slot) const;
+    static QString canonicalText(const Value& value);
+
+    const PropertySchema* m_schema = PropertySchema::empty();
+    QVector<Value> m_values;
+    QVector<QString> m_strings;  // indexed by slot, sized up to the last slot with kept text
+};
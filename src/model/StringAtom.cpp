@@ -0,0 +1,132 @@
+#include "StringAtom.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <atomic>
+
+namespace {
+// Texts live in fixed-size pages that are never moved or freed, and ids are
+// found through an open-addressing table of atomic slots, so readers neither
+// lock nor see a half-written entry: a slot is only published after the text
+// it points at is written.
+constexpr int kPageBits = 10;
+constexpr int kPageSize = 1 << kPageBits;
+constexpr int kMaxAtoms = StringAtom::kCapacity;
+constexpr int kMaxPages = kMaxAtoms / kPageSize;
+// Twice the capacity keeps probe sequences short when the table is full.
+constexpr int kSlotCount = 2 * kMaxAtoms;
+
+struct AtomTable {
+    QMutex mutex;  // serializes inserts
+    std::atomic<QString*> pages[kMaxPages] = {};
+    std::atomic<int> slots[kSlotCount] = {};  // atom id, 0 when free
+    std::atomic<int> size{0};
+
+    AtomTable() {
+        pages[0].store(new QString[kPageSize], std::memory_order_relaxed);
+        size.store(1, std::memory_order_release);  // id 0 is the empty string
+    }
+};
+
+AtomTable& table() {
+    static AtomTable instance;
+    return instance;
+}
+
+const QString& textAt(int id) {
+    const QString* page = table().pages[id >> kPageBits].load(std::memory_order_acquire);
+    return page[id & (kPageSize - 1)];
+}
+
+// Id of text, or -slot - 1 for the free slot where it would go.
+int probe(const QString& text) {
+    const AtomTable& atoms = table();
+    int slot = static_cast<int>(qHash(text) & (kSlotCount - 1));
+    for (;;) {
+        const int id = atoms.slots[slot].load(std::memory_order_acquire);
+        if (id == 0) {
+            return -slot - 1;
+        }
+        if (textAt(id) == text) {
+            return id;
+        }
+        slot = (slot + 1) & (kSlotCount - 1);
+    }
+}
+
+// 0 for the empty string, -1 when the table is full and text is not in it.
+int lookupOrInsert(const QString& text) {
+    if (text.isEmpty()) {
+        return 0;
+    }
+    const int found = probe(text);
+    if (found > 0) {
+        return found;
+    }
+    AtomTable& atoms = table();
+    QMutexLocker locker(&atoms.mutex);
+    const int result = probe(text);  // another thread may have added it
+    if (result > 0) {
+        return result;
+    }
+    const int id = atoms.size.load(std::memory_order_relaxed);
+    if (id >= kMaxAtoms) {
+        return -1;
+    }
+    const int pageIndex = id >> kPageBits;
+    QString* page = atoms.pages[pageIndex].load(std::memory_order_relaxed);
+    if (!page) {
+        page = new QString[kPageSize];
+        atoms.pages[pageIndex].store(page, std::memory_order_release);
+    }
+    page[id & (kPageSize - 1)] = text;
+    atoms.size.store(id + 1, std::memory_order_release);
+    atoms.slots[-result - 1].store(id, std::memory_order_release);
+    return id;
+}
+}  // namespace
+
+StringAtom::StringAtom(const QString& text)
+    : m_id(lookupOrInsert(text)) {
+    if (m_id < 0) {
+        m_text = text;
+    }
+}
+
+QString StringAtom::intern(const QString& text) {
+    return StringAtom(text).toString();
+}
+
+bool StringAtom::find(const QString& text, StringAtom* atom) {
+    const int id = text.isEmpty() ? 0 : probe(text);
+    if (id < 0) {
+        return false;
+    }
+    if (atom) {
+        atom->m_id = id;
+        atom->m_text.clear();
+    }
+    return true;
+}
+
+int StringAtom::tableSize() {
+    return table().size.load(std::memory_order_acquire);
+}
+
+int StringAtom::id() const {
+    return m_id;
+}
+
+bool StringAtom::isEmpty() const {
+    return m_id == 0;
+}
+
+bool StringAtom::isInterned() const {
+    return m_id >= 0;
+}
+
+const QString& StringAtom::toString() const {
+    return m_id < 0 ? m_text : textAt(m_id);
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QString>
+
+// Handle to a string in a process-wide intern table. Meant for bounded
+// vocabulary only (port directions, property types and keys): two interned
+// atoms are equal iff their ids are equal, and every atom of the same text
+// shares one QString buffer. Per-document names such as node types, group and
+// layer ids stay plain QStrings. Entries are never released, so lookups read
+// the table without locking. Once kCapacity texts are in the table, new texts
+// get an atom that carries its own copy instead of an id.
+class StringAtom {
+public:
+    static constexpr int kCapacity = 1 << 14;
+
+    StringAtom() = default;
+    explicit StringAtom(const QString& text);
+
+    // Shared copy of text from the table; use when a QString field should not
+    // carry its own buffer.
+    static QString intern(const QString& text);
+    // Existing atom for text, without adding it to the table.
+    static bool find(const QString& text, StringAtom* atom);
+    static int tableSize();
+
+    // -1 for an atom the full table could not take.
+    int id() const;
+    bool isEmpty() const;
+    bool isInterned() const;
+    const QString& toString() const;
+
+    friend bool operator==(const StringAtom& lhs, const StringAtom& rhs) {
+        return lhs.m_id == rhs.m_id && (lhs.m_id >= 0 || lhs.m_text == rhs.m_text);
+    }
+    friend bool operator!=(const StringAtom& lhs, const StringAtom& rhs) {
+        return !(lhs == rhs);
+    }
+
+private:
+    int m_id = 0;  // 0 is the empty string
+    QString m_text;  // only for atoms that are not in the table
+};
@@ -165,8 +165,8 @@ void LayerPanel::setScene(EditorScene* scene) {
     }
     m_scene = scene;
     if (m_scene) {
-        connect(m_scene, &EditorScene::graphChanged, this, &LayerPanel::refresh);
         connect(m_scene, &EditorScene::layerStateChanged, this, &LayerPanel::refresh);
+        connect(m_scene, &EditorScene::layerNodeCountChanged, this, &LayerPanel::updateLayerCount);
     }
     refresh();
 }
@@ -183,6 +183,7 @@ void LayerPanel::refresh() {
 
     m_table->clearContents();
     m_table->setRowCount(0);
+    m_rowByLayerId.clear();
 
     if (!m_scene) {
         m_updating = false;
@@ -215,6 +216,7 @@ void LayerPanel::refresh() {
         auto* nameItem = new QTableWidgetItem(layer.name);
         nameItem->setData(Qt::UserRole, layer.id);
         m_table->setItem(row, 3, nameItem);
+        m_rowByLayerId.insert(layer.id, row);
 
         auto* countItem = new QTableWidgetItem(QString::number(m_scene->layerNodeCount(layer.id)));
         countItem->setFlags(countItem->flags() & ~Qt::ItemIsEditable);
@@ -236,6 +238,18 @@ void LayerPanel::refresh() {
     m_updating = false;
 }
 
+void LayerPanel::updateLayerCount(const QString& layerId, int count) {
+    const int row = m_rowByLayerId.value(layerId, -1);
+    QTableWidgetItem* countItem = (row >= 0) ? m_table->item(row, 4) : nullptr;
+    if (!countItem) {
+        return;
+    }
+    m_updating = true;
+    const QSignalBlocker blocker(m_table);
+    countItem->setText(QString::number(count));
+    m_updating = false;
+}
+
 QString LayerPanel::layerIdAtRow(int row) const {
     if (row < 0 || row >= m_table->rowCount()) {
         return QString();
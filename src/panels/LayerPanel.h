@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QHash>
 #include <QWidget>
 
 class EditorScene;
@@ -17,6 +18,7 @@ public:
 
 private:
     void refresh();
+    void updateLayerCount(const QString& layerId, int count);
     QString layerIdAtRow(int row) const;
     int currentLayerRow() const;
 
@@ -28,5 +30,6 @@ private:
     QPushButton* m_downButton = nullptr;
     QPushButton* m_activeButton = nullptr;
     QPushButton* m_moveSelectionButton = nullptr;
+    QHash<QString, int> m_rowByLayerId;
     bool m_updating = false;
 };
@@ -0,0 +1,576 @@
+#include "ProjectTreeModel.h"
+
+#include "items/NodeItem.h"
+#include "scene/EditorScene.h"
+
+#include <QtGlobal>
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+template <typename EntryT>
+void addChildEntry(EntryT* parent, EntryT* child) {
+    child->parent = parent;
+    child->row = parent->children.size();
+    parent->children.push_back(child);
+}
+
+}  // namespace
+
+ProjectTreeModel::Entry::~Entry() {
+    if (kind == EntryKind::Layer && !populated) {
+        qDeleteAll(groupsById);
+    }
+    qDeleteAll(children);
+}
+
+ProjectTreeModel::ProjectTreeModel(QObject* parent)
+    : QAbstractItemModel(parent) {
+    rebuild();
+}
+
+ProjectTreeModel::~ProjectTreeModel() {
+    delete m_root;
+}
+
+void ProjectTreeModel::setScene(EditorScene* scene) {
+    if (m_scene) {
+        disconnect(m_scene, nullptr, this, nullptr);
+    }
+    m_scene = scene;
+    if (m_scene) {
+        connect(m_scene, &EditorScene::nodeAdded, this, &ProjectTreeModel::onNodeAdded);
+        connect(m_scene, &EditorScene::nodeAboutToBeRemoved, this, &ProjectTreeModel::onNodeAboutToBeRemoved);
+        connect(m_scene, &EditorScene::nodeRenamed, this, &ProjectTreeModel::onNodeRenamed);
+        connect(m_scene, &EditorScene::nodeMembershipChanged, this, &ProjectTreeModel::onNodeMembershipChanged);
+        connect(m_scene, &EditorScene::layerStateChanged, this, &ProjectTreeModel::onLayerStateChanged);
+        connect(m_scene, &EditorScene::graphReset, this, &ProjectTreeModel::rebuild);
+    }
+    rebuild();
+}
+
+EditorScene* ProjectTreeModel::scene() const {
+    return m_scene;
+}
+
+QModelIndex ProjectTreeModel::index(int row, int column, const QModelIndex& parent) const {
+    if (column != 0 || row < 0) {
+        return QModelIndex();
+    }
+    const Entry* parentEntry = entryFor(parent);
+    if (!parentEntry || row >= parentEntry->children.size()) {
+        return QModelIndex();
+    }
+    return createIndex(row, 0, parentEntry->children[row]);
+}
+
+QModelIndex ProjectTreeModel::parent(const QModelIndex& child) const {
+    if (!child.isValid()) {
+        return QModelIndex();
+    }
+    const Entry* entry = entryFor(child);
+    return indexFor(entry ? entry->parent : nullptr);
+}
+
+int ProjectTreeModel::rowCount(const QModelIndex& parent) const {
+    if (parent.column() > 0) {
+        return 0;
+    }
+    const Entry* entry = entryFor(parent);
+    return entry ? entry->children.size() : 0;
+}
+
+int ProjectTreeModel::columnCount(const QModelIndex& parent) const {
+    Q_UNUSED(parent);
+    return 1;
+}
+
+bool ProjectTreeModel::hasChildren(const QModelIndex& parent) const {
+    const Entry* entry = entryFor(parent);
+    if (!entry) {
+        return false;
+    }
+    switch (entry->kind) {
+    case EntryKind::Layer:
+        return !entry->children.isEmpty() || entry->pendingCount > 0 || !entry->groupsById.isEmpty();
+    case EntryKind::Group:
+        return !entry->children.isEmpty() || entry->pendingCount > 0;
+    case EntryKind::Node:
+        return false;
+    default:
+        return !entry->children.isEmpty();
+    }
+}
+
+bool ProjectTreeModel::canFetchMore(const QModelIndex& parent) const {
+    const Entry* entry = entryFor(parent);
+    if (!entry) {
+        return false;
+    }
+    if (entry->kind == EntryKind::Layer) {
+        return !entry->populated || entry->pendingCount > 0;
+    }
+    if (entry->kind == EntryKind::Group) {
+        return entry->pendingCount > 0;
+    }
+    return false;
+}
+
+void ProjectTreeModel::fetchMore(const QModelIndex& parent) {
+    Entry* entry = entryFor(parent);
+    if (!entry || (entry->kind != EntryKind::Layer && entry->kind != EntryKind::Group)) {
+        return;
+    }
+    if (entry->kind == EntryKind::Layer && !entry->populated) {
+        populateLayer(entry);
+    }
+    exposePending(entry, FetchBatchSize);
+}
+
+QVariant ProjectTreeModel::data(const QModelIndex& index, int role) const {
+    const Entry* entry = index.isValid() ? entryFor(index) : nullptr;
+    if (!entry) {
+        return QVariant();
+    }
+    if (role == Qt::DisplayRole) {
+        switch (entry->kind) {
+        case EntryKind::Group:
+            return QStringLiteral("Group %1").arg(entry->id);
+        case EntryKind::Node: {
+            if (const NodeItem* node = m_scene ? m_scene->nodeById(entry->id) : nullptr) {
+                return QStringLiteral("%1 (%2)").arg(node->displayName(), entry->id);
+            }
+            const NodeData* record = m_scene ? m_scene->unloadedNode(entry->id) : nullptr;
+            return record ? QStringLiteral("%1 (%2)").arg(record->name, entry->id) : entry->id;
+        }
+        default:
+            return entry->label;
+        }
+    }
+    if (role == Qt::UserRole && entry->kind == EntryKind::Node) {
+        return entry->id;
+    }
+    return QVariant();
+}
+
+Qt::ItemFlags ProjectTreeModel::flags(const QModelIndex& index) const {
+    if (!index.isValid()) {
+        return Qt::NoItemFlags;
+    }
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+}
+
+QModelIndex ProjectTreeModel::projectIndex() const {
+    return indexFor(m_project);
+}
+
+QModelIndex ProjectTreeModel::nodesFolderIndex() const {
+    return indexFor(m_folder);
+}
+
+QModelIndex ProjectTreeModel::indexForNode(const QString& nodeId) {
+    if (Entry* entry = m_nodeEntries.value(nodeId, nullptr)) {
+        return indexFor(entry);
+    }
+    Entry* container = m_nodeContainers.value(nodeId, nullptr);
+    if (!container) {
+        return QModelIndex();
+    }
+    Entry* layer = (container->kind == EntryKind::Group) ? container->parent : container;
+    if (!layer->populated) {
+        populateLayer(layer);
+    }
+    // Only the requested row is built; the rows before it stay pending.
+    if (takePending(container, nodeId)) {
+        appendNodeRow(container, nodeId);
+    }
+    return indexFor(m_nodeEntries.value(nodeId, nullptr));
+}
+
+QModelIndex ProjectTreeModel::indexForLayer(const QString& layerId) const {
+    return indexFor(m_layerEntries.value(layerId, nullptr));
+}
+
+ProjectTreeModel::EntryKind ProjectTreeModel::kindOf(const QModelIndex& index) const {
+    const Entry* entry = entryFor(index);
+    return entry ? entry->kind : EntryKind::Root;
+}
+
+bool ProjectTreeModel::isNodeMaterialized(const QString& nodeId) const {
+    return m_nodeEntries.contains(nodeId);
+}
+
+int ProjectTreeModel::materializedNodeCount() const {
+    return m_nodeEntries.size();
+}
+
+void ProjectTreeModel::rebuild() {
+    beginResetModel();
+
+    delete m_root;
+    m_layerEntries.clear();
+    m_nodeEntries.clear();
+    m_nodeContainers.clear();
+    m_pendingSlots.clear();
+
+    m_root = new Entry();
+    m_project = new Entry();
+    m_project->kind = EntryKind::Project;
+    m_project->label = QStringLiteral("RCP_SH0005");
+    addChildEntry(m_root, m_project);
+    m_folder = new Entry();
+    m_folder->kind = EntryKind::Folder;
+    m_folder->label = QStringLiteral("Graph Nodes");
+    addChildEntry(m_project, m_folder);
+
+    if (m_scene) {
+        auto addLayer = [this](const QString& layerId, const QString& label) {
+            auto* layer = new Entry();
+            layer->kind = EntryKind::Layer;
+            layer->id = layerId;
+            layer->label = label;
+            addChildEntry(m_folder, layer);
+            m_layerEntries.insert(layerId, layer);
+            return layer;
+        };
+
+        const QVector<LayerData> layerList = m_scene->layers();
+        for (const LayerData& layerData : layerList) {
+            addLayer(layerData.id, layerData.name);
+        }
+
+        // Nodes of a lazily loaded document without items are listed too.
+        struct NodeRef {
+            QString id;
+            QString layerId;
+            QString groupId;
+        };
+        const QList<NodeItem*> items = m_scene->nodeItems();
+        const QVector<QString> unloadedIds = m_scene->unloadedNodeIds();
+        QVector<NodeRef> nodes;
+        nodes.reserve(items.size() + unloadedIds.size());
+        for (const NodeItem* node : items) {
+            nodes.push_back(NodeRef{node->nodeId(), node->layerId(), node->groupId()});
+        }
+        for (const QString& nodeId : unloadedIds) {
+            const NodeData* record = m_scene->unloadedNode(nodeId);
+            nodes.push_back(NodeRef{nodeId, record->layerId, record->groupId});
+        }
+        std::sort(nodes.begin(), nodes.end(), [](const NodeRef& a, const NodeRef& b) { return a.id < b.id; });
+        m_nodeContainers.reserve(nodes.size());
+        m_pendingSlots.reserve(nodes.size());
+        for (const NodeRef& node : nodes) {
+            Entry* layer = m_layerEntries.value(node.layerId, nullptr);
+            if (!layer) {
+                layer = addLayer(node.layerId, node.layerId);
+            }
+            Entry* container = layer;
+            if (!node.groupId.isEmpty()) {
+                container = layer->groupsById.value(node.groupId, nullptr);
+                if (!container) {
+                    container = new Entry();
+                    container->kind = EntryKind::Group;
+                    container->id = node.groupId;
+                    container->parent = layer;
+                    layer->groupsById.insert(node.groupId, container);
+                }
+            }
+            pushPending(container, node.id);
+            m_nodeContainers.insert(node.id, container);
+        }
+    }
+
+    endResetModel();
+}
+
+void ProjectTreeModel::onNodeAdded(const QString& nodeId) {
+    attachNode(nodeId);
+}
+
+void ProjectTreeModel::onNodeAboutToBeRemoved(const QString& nodeId) {
+    detachNode(nodeId);
+}
+
+void ProjectTreeModel::onNodeRenamed(const QString& nodeId) {
+    const Entry* entry = m_nodeEntries.value(nodeId, nullptr);
+    if (!entry) {
+        return;
+    }
+    const QModelIndex idx = indexFor(entry);
+    emit dataChanged(idx, idx, {Qt::DisplayRole});
+}
+
+void ProjectTreeModel::onNodeMembershipChanged(const QString& nodeId) {
+    detachNode(nodeId);
+    attachNode(nodeId);
+}
+
+void ProjectTreeModel::onLayerStateChanged() {
+    if (!m_scene) {
+        return;
+    }
+    const QVector<LayerData> layerList = m_scene->layers();
+    bool sameLayout = layerList.size() == m_folder->children.size();
+    for (int i = 0; sameLayout && i < layerList.size(); ++i) {
+        sameLayout = m_folder->children[i]->id == layerList[i].id;
+    }
+    if (!sameLayout) {
+        rebuild();
+        return;
+    }
+    for (int i = 0; i < layerList.size(); ++i) {
+        Entry* layer = m_folder->children[i];
+        if (layer->label != layerList[i].name) {
+            layer->label = layerList[i].name;
+            const QModelIndex idx = indexFor(layer);
+            emit dataChanged(idx, idx, {Qt::DisplayRole});
+        }
+    }
+}
+
+ProjectTreeModel::Entry* ProjectTreeModel::entryFor(const QModelIndex& index) const {
+    if (!index.isValid()) {
+        return m_root;
+    }
+    return static_cast<Entry*>(index.internalPointer());
+}
+
+QModelIndex ProjectTreeModel::indexFor(const Entry* entry) const {
+    if (!entry || entry == m_root) {
+        return QModelIndex();
+    }
+    return createIndex(rowOf(entry), 0, const_cast<Entry*>(entry));
+}
+
+// Removals only shift later children down, so a stale row overstates the
+// index and the entry lies between firstStaleRow and its old row. Deleting a
+// run of rows thus renumbers each sibling once instead of once per removal.
+int ProjectTreeModel::rowOf(const Entry* entry) const {
+    Entry* parent = entry->parent;
+    if (!parent || parent->firstStaleRow < 0 || entry->row < parent->firstStaleRow) {
+        return entry->row;
+    }
+    const QVector<Entry*>& siblings = parent->children;
+    int i = parent->firstStaleRow;
+    for (; i < siblings.size(); ++i) {
+        siblings[i]->row = i;
+        if (siblings[i] == entry) {
+            break;
+        }
+    }
+    parent->firstStaleRow = i + 1 < siblings.size() ? i + 1 : -1;
+    return entry->row;
+}
+
+bool ProjectTreeModel::isExposed(const Entry* entry) const {
+    if (entry->kind == EntryKind::Group) {
+        return entry->parent && entry->parent->populated;
+    }
+    return true;
+}
+
+bool ProjectTreeModel::acceptsDirectRows(const Entry* container) const {
+    if (!isExposed(container) || container->pendingCount > 0) {
+        return false;
+    }
+    return container->kind != EntryKind::Layer || container->populated;
+}
+
+ProjectTreeModel::Entry* ProjectTreeModel::ensureLayerEntry(const QString& layerId) {
+    if (Entry* layer = m_layerEntries.value(layerId, nullptr)) {
+        return layer;
+    }
+    auto* layer = new Entry();
+    layer->kind = EntryKind::Layer;
+    layer->id = layerId;
+    layer->label = layerLabel(layerId);
+    appendChildRow(m_folder, layer);
+    m_layerEntries.insert(layerId, layer);
+    return layer;
+}
+
+ProjectTreeModel::Entry* ProjectTreeModel::ensureGroupEntry(Entry* layer, const QString& groupId) {
+    if (Entry* group = layer->groupsById.value(groupId, nullptr)) {
+        return group;
+    }
+    auto* group = new Entry();
+    group->kind = EntryKind::Group;
+    group->id = groupId;
+    layer->groupsById.insert(groupId, group);
+    if (layer->populated) {
+        appendChildRow(layer, group);
+    } else {
+        group->parent = layer;
+    }
+    return group;
+}
+
+void ProjectTreeModel::populateLayer(Entry* layer) {
+    if (layer->populated) {
+        return;
+    }
+    QVector<Entry*> groups;
+    groups.reserve(layer->groupsById.size());
+    for (Entry* group : layer->groupsById) {
+        groups.push_back(group);
+    }
+    std::sort(groups.begin(), groups.end(), [](const Entry* a, const Entry* b) { return a->id < b->id; });
+
+    if (groups.isEmpty()) {
+        layer->populated = true;
+        return;
+    }
+    const int first = layer->children.size();
+    beginInsertRows(indexFor(layer), first, first + groups.size() - 1);
+    for (Entry* group : groups) {
+        addChildEntry(layer, group);
+    }
+    layer->populated = true;
+    endInsertRows();
+}
+
+void ProjectTreeModel::exposePending(Entry* container, int count) {
+    count = qMin(count, container->pendingCount);
+    if (count <= 0) {
+        return;
+    }
+    const int first = container->children.size();
+    beginInsertRows(indexFor(container), first, first + count - 1);
+    container->children.reserve(first + count);
+    for (int added = 0; added < count;) {
+        QString nodeId = std::move(container->pendingNodeIds[container->pendingHead++]);
+        if (nodeId.isEmpty()) {
+            continue;
+        }
+        m_pendingSlots.remove(nodeId);
+        auto* entry = new Entry();
+        entry->kind = EntryKind::Node;
+        entry->id = std::move(nodeId);
+        addChildEntry(container, entry);
+        m_nodeEntries.insert(entry->id, entry);
+        ++added;
+    }
+    container->pendingCount -= count;
+    compactPending(container);
+    endInsertRows();
+}
+
+void ProjectTreeModel::pushPending(Entry* container, const QString& nodeId) {
+    m_pendingSlots.insert(nodeId, container->pendingNodeIds.size());
+    container->pendingNodeIds.push_back(nodeId);
+    ++container->pendingCount;
+}
+
+bool ProjectTreeModel::takePending(Entry* container, const QString& nodeId) {
+    const int slot = m_pendingSlots.value(nodeId, -1);
+    if (slot < container->pendingHead || slot >= container->pendingNodeIds.size() ||
+        container->pendingNodeIds[slot] != nodeId) {
+        return false;
+    }
+    m_pendingSlots.remove(nodeId);
+    container->pendingNodeIds[slot].clear();
+    --container->pendingCount;
+    compactPending(container);
+    return true;
+}
+
+// Drops consumed and emptied slots once they outnumber the live ones, so
+// fetching and removal stay amortized O(1) per id.
+void ProjectTreeModel::compactPending(Entry* container) {
+    QVector<QString>& pending = container->pendingNodeIds;
+    if (container->pendingCount == 0) {
+        pending.clear();
+        container->pendingHead = 0;
+        return;
+    }
+    const int dead = pending.size() - container->pendingCount;
+    if (dead <= FetchBatchSize || dead <= container->pendingCount) {
+        return;
+    }
+    QVector<QString> live;
+    live.reserve(container->pendingCount);
+    for (int i = container->pendingHead; i < pending.size(); ++i) {
+        if (!pending[i].isEmpty()) {
+            m_pendingSlots.insert(pending[i], live.size());
+            live.push_back(std::move(pending[i]));
+        }
+    }
+    pending.swap(live);
+    container->pendingHead = 0;
+}
+
+void ProjectTreeModel::appendNodeRow(Entry* container, const QString& nodeId) {
+    auto* entry = new Entry();
+    entry->kind = EntryKind::Node;
+    entry->id = nodeId;
+    appendChildRow(container, entry);
+    m_nodeEntries.insert(nodeId, entry);
+}
+
+void ProjectTreeModel::appendChildRow(Entry* parent, Entry* child) {
+    const int row = parent->children.size();
+    beginInsertRows(indexFor(parent), row, row);
+    addChildEntry(parent, child);
+    endInsertRows();
+}
+
+void ProjectTreeModel::removeChildRow(Entry* parent, int row) {
+    beginRemoveRows(indexFor(parent), row, row);
+    Entry* child = parent->children.takeAt(row);
+    if (row < parent->children.size() && (parent->firstStaleRow < 0 || row < parent->firstStaleRow)) {
+        parent->firstStaleRow = row;
+    }
+    endRemoveRows();
+    delete child;
+}
+
+void ProjectTreeModel::attachNode(const QString& nodeId) {
+    const NodeItem* node = m_scene ? m_scene->nodeById(nodeId) : nullptr;
+    if (!node || m_nodeContainers.contains(nodeId)) {
+        return;
+    }
+    Entry* layer = ensureLayerEntry(node->layerId());
+    Entry* container = node->groupId().isEmpty() ? layer : ensureGroupEntry(layer, node->groupId());
+    m_nodeContainers.insert(nodeId, container);
+
+    if (acceptsDirectRows(container)) {
+        appendNodeRow(container, nodeId);
+        return;
+    }
+
+    pushPending(container, nodeId);
+    if (container->pendingCount == 1 && isExposed(container)) {
+        const QModelIndex idx = indexFor(container);
+        emit dataChanged(idx, idx);
+    }
+}
+
+void ProjectTreeModel::detachNode(const QString& nodeId) {
+    Entry* container = m_nodeContainers.take(nodeId);
+    if (!container) {
+        return;
+    }
+    if (Entry* entry = m_nodeEntries.take(nodeId)) {
+        removeChildRow(container, rowOf(entry));
+    } else {
+        takePending(container, nodeId);
+    }
+
+    if (container->kind != EntryKind::Group || !container->children.isEmpty() || container->pendingCount > 0) {
+        return;
+    }
+    Entry* layer = container->parent;
+    layer->groupsById.remove(container->id);
+    if (layer->populated) {
+        removeChildRow(layer, rowOf(container));
+    } else {
+        delete container;
+    }
+}
+
+QString ProjectTreeModel::layerLabel(const QString& layerId) const {
+    const LayerData* layer = m_scene ? m_scene->findLayerById(layerId) : nullptr;
+    return layer ? layer->name : layerId;
+}
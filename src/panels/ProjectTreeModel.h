@@ -0,0 +1,108 @@
+#pragma once
+
+#include <QAbstractItemModel>
+#include <QHash>
+#include <QPointer>
+#include <QString>
+#include <QVector>
+
+class EditorScene;
+
+class ProjectTreeModel : public QAbstractItemModel {
+    Q_OBJECT
+
+public:
+    enum class EntryKind {
+        Root,
+        Project,
+        Folder,
+        Layer,
+        Group,
+        Node
+    };
+
+    static constexpr int FetchBatchSize = 256;
+
+    explicit ProjectTreeModel(QObject* parent = nullptr);
+    ~ProjectTreeModel() override;
+
+    void setScene(EditorScene* scene);
+    EditorScene* scene() const;
+
+    QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex& child) const override;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    bool hasChildren(const QModelIndex& parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+    QModelIndex projectIndex() const;
+    QModelIndex nodesFolderIndex() const;
+    QModelIndex indexForNode(const QString& nodeId);
+    QModelIndex indexForLayer(const QString& layerId) const;
+    EntryKind kindOf(const QModelIndex& index) const;
+    bool isNodeMaterialized(const QString& nodeId) const;
+    int materializedNodeCount() const;
+
+private:
+    struct Entry {
+        EntryKind kind = EntryKind::Root;
+        QString id;
+        QString label;
+        Entry* parent = nullptr;
+        // Index in parent->children; see firstStaleRow.
+        int row = 0;
+        QVector<Entry*> children;
+        // Children from this index on may carry the row they had before a
+        // removal; rowOf() renumbers them when one is asked for.
+        int firstStaleRow = -1;
+        // Node ids without a row yet, consumed from pendingHead. Ids removed
+        // or exposed out of order leave an empty slot until compaction.
+        QVector<QString> pendingNodeIds;
+        int pendingHead = 0;
+        int pendingCount = 0;
+        QHash<QString, Entry*> groupsById;
+        bool populated = false;
+
+        ~Entry();
+    };
+
+    void rebuild();
+    void onNodeAdded(const QString& nodeId);
+    void onNodeAboutToBeRemoved(const QString& nodeId);
+    void onNodeRenamed(const QString& nodeId);
+    void onNodeMembershipChanged(const QString& nodeId);
+    void onLayerStateChanged();
+
+    Entry* entryFor(const QModelIndex& index) const;
+    QModelIndex indexFor(const Entry* entry) const;
+    int rowOf(const Entry* entry) const;
+    bool isExposed(const Entry* entry) const;
+    bool acceptsDirectRows(const Entry* container) const;
+    Entry* ensureLayerEntry(const QString& layerId);
+    Entry* ensureGroupEntry(Entry* layer, const QString& groupId);
+    void populateLayer(Entry* layer);
+    void exposePending(Entry* container, int count);
+    void pushPending(Entry* container, const QString& nodeId);
+    bool takePending(Entry* container, const QString& nodeId);
+    void compactPending(Entry* container);
+    void appendNodeRow(Entry* container, const QString& nodeId);
+    void appendChildRow(Entry* parent, Entry* child);
+    void removeChildRow(Entry* parent, int row);
+    void attachNode(const QString& nodeId);
+    void detachNode(const QString& nodeId);
+    QString layerLabel(const QString& layerId) const;
+
+    QPointer<EditorScene> m_scene;
+    Entry* m_root = nullptr;
+    Entry* m_project = nullptr;
+    Entry* m_folder = nullptr;
+    QHash<QString, Entry*> m_layerEntries;
+    QHash<QString, Entry*> m_nodeEntries;
+    QHash<QString, Entry*> m_nodeContainers;
+    // Slot of each pending node id in its container's pendingNodeIds.
+    QHash<QString, int> m_pendingSlots;
+};
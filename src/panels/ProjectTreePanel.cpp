@@ -1,86 +1,53 @@
 #include "ProjectTreePanel.h"
 
-#include "items/NodeItem.h"
-#include "scene/EditorScene.h"
+#include "panels/ProjectTreeModel.h"
 
 #include <QSignalBlocker>
-#include <QTreeWidget>
+#include <QTreeView>
 #include <QVBoxLayout>
 
-#include <algorithm>
-
 ProjectTreePanel::ProjectTreePanel(QWidget* parent)
     : QWidget(parent) {
-    m_tree = new QTreeWidget(this);
-    m_tree->setHeaderHidden(true);
-
-    QTreeWidgetItem* projectRoot = new QTreeWidgetItem(QStringList() << QStringLiteral("RCP_SH0005"));
-    m_graphNodesRoot = new QTreeWidgetItem(QStringList() << QStringLiteral("Graph Nodes"));
-    projectRoot->addChild(m_graphNodesRoot);
-    m_tree->addTopLevelItem(projectRoot);
-    projectRoot->setExpanded(true);
-    m_graphNodesRoot->setExpanded(true);
+    m_model = new ProjectTreeModel(this);
+    m_view = new QTreeView(this);
+    m_view->setHeaderHidden(true);
+    m_view->setUniformRowHeights(true);
+    m_view->setModel(m_model);
+    expandStaticRows();
 
     auto* layout = new QVBoxLayout(this);
     layout->setContentsMargins(0, 0, 0, 0);
     layout->setSpacing(0);
-    layout->addWidget(m_tree);
+    layout->addWidget(m_view);
 
-    connect(m_tree, &QTreeWidget::itemClicked, this, [this](QTreeWidgetItem* item) {
-        if (!item) {
-            return;
-        }
-        const QString nodeId = item->data(0, Qt::UserRole).toString();
+    connect(m_model, &QAbstractItemModel::modelReset, this, &ProjectTreePanel::expandStaticRows);
+    connect(m_view, &QTreeView::clicked, this, [this](const QModelIndex& index) {
+        const QString nodeId = index.data(Qt::UserRole).toString();
         if (!nodeId.isEmpty()) {
             emit nodeSelected(nodeId);
         }
     });
 }
 
-void ProjectTreePanel::rebuildFromScene(EditorScene* scene) {
-    const QList<QTreeWidgetItem*> oldChildren = m_graphNodesRoot->takeChildren();
-    for (QTreeWidgetItem* child : oldChildren) {
-        delete child;
-    }
-    if (!scene) {
-        return;
-    }
-
-    QVector<NodeItem*> nodes;
-    for (QGraphicsItem* item : scene->items()) {
-        if (NodeItem* node = dynamic_cast<NodeItem*>(item)) {
-            nodes.push_back(node);
-        }
-    }
-    std::sort(nodes.begin(), nodes.end(), [](const NodeItem* a, const NodeItem* b) { return a->nodeId() < b->nodeId(); });
-
-    for (NodeItem* node : nodes) {
-        QTreeWidgetItem* child =
-            new QTreeWidgetItem(QStringList() << QStringLiteral("%1 (%2)").arg(node->displayName(), node->nodeId()));
-        child->setData(0, Qt::UserRole, node->nodeId());
-        m_graphNodesRoot->addChild(child);
-    }
-    m_graphNodesRoot->setExpanded(true);
+void ProjectTreePanel::setScene(EditorScene* scene) {
+    m_model->setScene(scene);
 }
 
 void ProjectTreePanel::selectNode(const QString& nodeId) {
-    QTreeWidgetItem* item = findTreeItemByNodeId(nodeId);
-    if (!item) {
+    const QModelIndex index = m_model->indexForNode(nodeId);
+    if (!index.isValid()) {
         return;
     }
-    const QSignalBlocker blocker(m_tree);
-    m_tree->setCurrentItem(item);
+    const QSignalBlocker blocker(m_view);
+    m_view->setCurrentIndex(index);
+    m_view->scrollTo(index);
 }
 
-QTreeWidgetItem* ProjectTreePanel::findTreeItemByNodeId(const QString& nodeId) const {
-    if (!m_graphNodesRoot || nodeId.isEmpty()) {
-        return nullptr;
-    }
-    for (int i = 0; i < m_graphNodesRoot->childCount(); ++i) {
-        QTreeWidgetItem* child = m_graphNodesRoot->child(i);
-        if (child && child->data(0, Qt::UserRole).toString() == nodeId) {
-            return child;
-        }
-    }
-    return nullptr;
+ProjectTreeModel* ProjectTreePanel::model() const {
+    return m_model;
+}
+
+void ProjectTreePanel::expandStaticRows() {
+    m_view->expand(m_model->projectIndex());
+    m_view->expand(m_model->nodesFolderIndex());
 }
@@ -2,9 +2,9 @@
 
 #include <QWidget>
 
-class QTreeWidget;
-class QTreeWidgetItem;
+class QTreeView;
 class EditorScene;
+class ProjectTreeModel;
 
 class ProjectTreePanel : public QWidget {
     Q_OBJECT
@@ -12,15 +12,16 @@ class ProjectTreePanel : public QWidget {
 public:
     explicit ProjectTreePanel(QWidget* parent = nullptr);
 
-    void rebuildFromScene(EditorScene* scene);
+    void setScene(EditorScene* scene);
     void selectNode(const QString& nodeId);
+    ProjectTreeModel* model() const;
 
 signals:
     void nodeSelected(const QString& nodeId);
 
 private:
-    QTreeWidgetItem* findTreeItemByNodeId(const QString& nodeId) const;
+    void expandStaticRows();
 
-    QTreeWidget* m_tree = nullptr;
-    QTreeWidgetItem* m_graphNodesRoot = nullptr;
+    QTreeView* m_view = nullptr;
+    ProjectTreeModel* m_model = nullptr;
 };
@@ -1,7 +1,10 @@
 #include "PropertyPanel.h"
 
 #include <QAbstractItemView>
+#include <QComboBox>
+#include <QHBoxLayout>
 #include <QHeaderView>
+#include <QLabel>
 #include <QTableWidget>
 #include <QVBoxLayout>
 
@@ -15,12 +18,32 @@ PropertyPanel::PropertyPanel(QWidget* parent)
     m_table->setShowGrid(false);
     m_table->setEditTriggers(QAbstractItemView::DoubleClicked | QAbstractItemView::EditKeyPressed);
 
+    m_scopeCombo = new QComboBox(this);
+    m_scopeCombo->addItem(QStringLiteral("This Node"), static_cast<int>(ApplyScope::Node));
+    m_scopeCombo->addItem(QStringLiteral("Selection"), static_cast<int>(ApplyScope::Selection));
+    m_scopeCombo->addItem(QStringLiteral("All Of Same Type"), static_cast<int>(ApplyScope::SameType));
+
+    auto* scopeLayout = new QHBoxLayout();
+    scopeLayout->setContentsMargins(4, 2, 4, 2);
+    scopeLayout->setSpacing(6);
+    scopeLayout->addWidget(new QLabel(QStringLiteral("Apply edits to"), this));
+    scopeLayout->addWidget(m_scopeCombo, 1);
+
     auto* layout = new QVBoxLayout(this);
     layout->setContentsMargins(0, 0, 0, 0);
     layout->setSpacing(0);
+    layout->addLayout(scopeLayout);
     layout->addWidget(m_table);
 }
 
 QTableWidget* PropertyPanel::table() const {
     return m_table;
 }
+
+PropertyPanel::ApplyScope PropertyPanel::applyScope() const {
+    return static_cast<ApplyScope>(m_scopeCombo->currentData().toInt());
+}
+
+void PropertyPanel::setApplyScope(ApplyScope scope) {
+    m_scopeCombo->setCurrentIndex(m_scopeCombo->findData(static_cast<int>(scope)));
+}
@@ -2,16 +2,26 @@
 
 #include <QWidget>
 
+class QComboBox;
 class QTableWidget;
 
 class PropertyPanel : public QWidget {
     Q_OBJECT
 
 public:
+    enum class ApplyScope {
+        Node,
+        Selection,
+        SameType
+    };
+
     explicit PropertyPanel(QWidget* parent = nullptr);
 
     QTableWidget* table() const;
+    ApplyScope applyScope() const;
+    void setApplyScope(ApplyScope scope);
 
 private:
     QTableWidget* m_table = nullptr;
+    QComboBox* m_scopeCombo = nullptr;
 };
@@ -0,0 +1,88 @@
+#include "SearchPanel.h"
+
+#include "scene/EditorScene.h"
+
+#include <QLineEdit>
+#include <QListWidget>
+#include <QListWidgetItem>
+#include <QTimer>
+#include <QVBoxLayout>
+
+SearchPanel::SearchPanel(QWidget* parent)
+    : QWidget(parent) {
+    m_queryEdit = new QLineEdit(this);
+    m_queryEdit->setPlaceholderText(QStringLiteral("Search name, type or property value"));
+    m_queryEdit->setClearButtonEnabled(true);
+    m_resultList = new QListWidget(this);
+    m_resultList->setUniformItemSizes(true);
+    m_refreshTimer = new QTimer(this);
+    m_refreshTimer->setSingleShot(true);
+    m_refreshTimer->setInterval(RefreshDelayMs);
+
+    auto* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->setSpacing(4);
+    layout->addWidget(m_queryEdit);
+    layout->addWidget(m_resultList);
+
+    connect(m_queryEdit, &QLineEdit::textChanged, this, &SearchPanel::refresh);
+    connect(m_queryEdit, &QLineEdit::returnPressed, this, [this]() {
+        if (m_resultList->count() > 0) {
+            m_resultList->setCurrentRow(0);
+            emit nodeSelected(m_resultList->item(0)->data(Qt::UserRole).toString());
+        }
+    });
+    connect(m_refreshTimer, &QTimer::timeout, this, &SearchPanel::refresh);
+    connect(m_resultList, &QListWidget::itemClicked, this, [this](QListWidgetItem* item) {
+        emit nodeSelected(item->data(Qt::UserRole).toString());
+    });
+}
+
+void SearchPanel::setScene(EditorScene* scene) {
+    if (m_scene == scene) {
+        return;
+    }
+    if (m_scene) {
+        disconnect(m_scene, nullptr, this, nullptr);
+    }
+    m_scene = scene;
+    if (m_scene) {
+        connect(m_scene, &EditorScene::graphChanged, this, &SearchPanel::scheduleRefresh);
+        connect(m_scene, &EditorScene::graphReset, this, &SearchPanel::refresh);
+    }
+    refresh();
+}
+
+void SearchPanel::focusQuery() {
+    m_queryEdit->setFocus();
+    m_queryEdit->selectAll();
+}
+
+QLineEdit* SearchPanel::queryEdit() const {
+    return m_queryEdit;
+}
+
+QListWidget* SearchPanel::resultList() const {
+    return m_resultList;
+}
+
+// Edits and drags emit graphChanged in bursts; results follow once they settle.
+void SearchPanel::scheduleRefresh() {
+    if (!m_queryEdit->text().trimmed().isEmpty()) {
+        m_refreshTimer->start();
+    }
+}
+
+void SearchPanel::refresh() {
+    m_refreshTimer->stop();
+    m_resultList->clear();
+    if (!m_scene) {
+        return;
+    }
+    const QVector<NodeSearchHit> hits = m_scene->searchNodes(m_queryEdit->text(), ResultLimit);
+    for (const NodeSearchHit& hit : hits) {
+        auto* item = new QListWidgetItem(QStringLiteral("%1  [%2]").arg(hit.displayName, hit.typeName), m_resultList);
+        item->setData(Qt::UserRole, hit.nodeId);
+        item->setToolTip(hit.nodeId);
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <QPointer>
+#include <QWidget>
+
+class EditorScene;
+class QLineEdit;
+class QListWidget;
+class QTimer;
+
+class SearchPanel : public QWidget {
+    Q_OBJECT
+
+public:
+    static constexpr int ResultLimit = 200;
+    static constexpr int RefreshDelayMs = 150;
+
+    explicit SearchPanel(QWidget* parent = nullptr);
+
+    void setScene(EditorScene* scene);
+    void focusQuery();
+    QLineEdit* queryEdit() const;
+    QListWidget* resultList() const;
+
+signals:
+    void nodeSelected(const QString& nodeId);
+
+private:
+    void scheduleRefresh();
+    void refresh();
+
+    QPointer<EditorScene> m_scene;
+    QLineEdit* m_queryEdit = nullptr;
+    QListWidget* m_resultList = nullptr;
+    QTimer* m_refreshTimer = nullptr;
+};
@@ -0,0 +1,108 @@
+#include "EdgeBundleIndex.h"
+
+#include "items/NodeItem.h"
+#include "items/PortItem.h"
+
+namespace {
+template <typename Key>
+void removeFromBucket(QHash<Key, QSet<NodeItem*>>* buckets, const Key& key, NodeItem* node) {
+    auto it = buckets->find(key);
+    if (it == buckets->end()) {
+        return;
+    }
+    it.value().remove(node);
+    if (it.value().isEmpty()) {
+        buckets->erase(it);
+    }
+}
+}  // namespace
+
+void EdgeBundleIndex::clear() {
+    m_keys.clear();
+    m_columns.clear();
+    m_rows.clear();
+    m_groups.clear();
+}
+
+void EdgeBundleIndex::insertNode(NodeItem* node) {
+    if (!node || m_keys.contains(node)) {
+        return;
+    }
+    const NodeKeys keys = keysFor(node);
+    m_keys.insert(node, keys);
+    file(node, keys);
+}
+
+void EdgeBundleIndex::removeNode(NodeItem* node) {
+    auto it = m_keys.find(node);
+    if (it == m_keys.end()) {
+        return;
+    }
+    unfile(node, it.value());
+    m_keys.erase(it);
+}
+
+void EdgeBundleIndex::nodeChanged(NodeItem* node) {
+    auto it = m_keys.find(node);
+    if (it == m_keys.end()) {
+        return;
+    }
+    const NodeKeys keys = keysFor(node);
+    if (keys.column == it->column && keys.row == it->row && keys.group == it->group) {
+        return;
+    }
+    unfile(node, it.value());
+    it.value() = keys;
+    file(node, keys);
+}
+
+QVector<const EdgeItem*> EdgeBundleIndex::bundleCandidates(const EdgeItem* edge) const {
+    QVector<const EdgeItem*> candidates;
+    if (!edge || !edge->sourcePort() || !edge->targetPort()) {
+        return candidates;
+    }
+    const NodeItem* sourceNode = edge->sourcePort()->ownerNode();
+    const NodeItem* targetNode = edge->targetPort()->ownerNode();
+    if (!sourceNode || !targetNode) {
+        return candidates;
+    }
+
+    QSet<NodeItem*> nodes;
+    if (edge->bundleScope() == EdgeBundleScope::PerGroup) {
+        nodes = m_groups.value(EdgeItem::bundleGroupKey(sourceNode));
+    } else {
+        const bool horizontal = EdgeItem::isBundleHorizontal(sourceNode, targetNode);
+        const int bucket = EdgeItem::bundleLayerBucket(sourceNode, horizontal);
+        nodes = horizontal ? m_columns.value(bucket) : m_rows.value(bucket);
+    }
+    for (auto it = nodes.constBegin(); it != nodes.constEnd(); ++it) {
+        for (const PortItem* port : (*it)->outputPorts()) {
+            for (const EdgeItem* other : port->edges()) {
+                if (other->scene() == edge->scene()) {
+                    candidates.push_back(other);
+                }
+            }
+        }
+    }
+    return candidates;
+}
+
+EdgeBundleIndex::NodeKeys EdgeBundleIndex::keysFor(const NodeItem* node) {
+    NodeKeys keys;
+    keys.column = EdgeItem::bundleLayerBucket(node, true);
+    keys.row = EdgeItem::bundleLayerBucket(node, false);
+    keys.group = EdgeItem::bundleGroupKey(node);
+    return keys;
+}
+
+void EdgeBundleIndex::file(NodeItem* node, const NodeKeys& keys) {
+    m_columns[keys.column].insert(node);
+    m_rows[keys.row].insert(node);
+    m_groups[keys.group].insert(node);
+}
+
+void EdgeBundleIndex::unfile(NodeItem* node, const NodeKeys& keys) {
+    removeFromBucket(&m_columns, keys.column, node);
+    removeFromBucket(&m_rows, keys.row, node);
+    removeFromBucket(&m_groups, keys.group, node);
+}
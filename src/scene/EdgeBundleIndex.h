@@ -0,0 +1,38 @@
+#pragma once
+
+#include "items/EdgeItem.h"
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+// Nodes filed by the keys the PerLayer and PerGroup bundle scopes compare:
+// layer buckets along both axes and the group key. An edge's candidates are
+// the outgoing edges of the nodes sharing its source's key, so a reroute
+// costs the size of that bucket instead of a scan over the whole scene.
+class EdgeBundleIndex : public EdgeBundleLookup {
+public:
+    void clear();
+    void insertNode(NodeItem* node);
+    void removeNode(NodeItem* node);
+
+    void nodeChanged(NodeItem* node) override;
+    QVector<const EdgeItem*> bundleCandidates(const EdgeItem* edge) const override;
+
+private:
+    struct NodeKeys {
+        int column = 0;
+        int row = 0;
+        QString group;
+    };
+
+    static NodeKeys keysFor(const NodeItem* node);
+    void file(NodeItem* node, const NodeKeys& keys);
+    void unfile(NodeItem* node, const NodeKeys& keys);
+
+    QHash<NodeItem*, NodeKeys> m_keys;
+    QHash<int, QSet<NodeItem*>> m_columns;
+    QHash<int, QSet<NodeItem*>> m_rows;
+    QHash<QString, QSet<NodeItem*>> m_groups;
+};
@@ -1,14 +1,21 @@
 #include "EditorScene.h"
 
 #include "commands/DocumentStateCommand.h"
+#include "commands/GraphEditCommands.h"
+#include "commands/JournaledCommand.h"
+#include "commands/LayerGroupCommands.h"
 #include "commands/NodeEditCommands.h"
 #include "items/EdgeItem.h"
 #include "items/NodeItem.h"
 #include "items/PortItem.h"
+#include "model/BinaryGraphView.h"
+#include "model/ChunkedGraphFormat.h"
 #include "model/ComponentCatalog.h"
+#include "model/GraphSerializer.h"
 
 #include <algorithm>
 #include <cmath>
+#include <utility>
 
 #include <QGraphicsSceneMouseEvent>
 #include <QGraphicsSceneContextMenuEvent>
@@ -23,10 +30,22 @@
 #include <QPen>
 #include <QRegularExpression>
 #include <QSet>
+#include <QSignalBlocker>
 #include <QtGlobal>
 #include <QUndoStack>
 
 namespace {
+// Obstacle padding used by EdgeItem routing plus one routing grid step.
+constexpr qreal kRouteCorridorPadding = 34.0;
+
+// Canonical order used by toDocument(), so saved output is stable.
+void sortNodeParts(NodeData* node) {
+    std::sort(node->ports.begin(), node->ports.end(), [](const PortData& a, const PortData& b) { return a.id < b.id; });
+    std::sort(node->properties.begin(),
+              node->properties.end(),
+              [](const PropertyData& a, const PropertyData& b) { return a.key < b.key; });
+}
+
 bool areDocumentsEquivalent(const GraphDocument& a, const GraphDocument& b) {
     if (a.nodes.size() != b.nodes.size() || a.edges.size() != b.edges.size()) {
         return false;
@@ -44,6 +63,9 @@ bool areDocumentsEquivalent(const GraphDocument& a, const GraphDocument& b) {
         !qFuzzyCompare(a.edgeBundleSpacing + 1.0, b.edgeBundleSpacing + 1.0)) {
         return false;
     }
+    if (a.dagOnly != b.dagOnly) {
+        return false;
+    }
     if (a.collapsedGroupIds.size() != b.collapsedGroupIds.size()) {
         return false;
     }
@@ -104,12 +126,31 @@ bool areDocumentsEquivalent(const GraphDocument& a, const GraphDocument& b) {
     }
     return true;
 }
+
+void collectCommandChanges(const QUndoCommand* command, GraphChangeSet* changes) {
+    if (!command) {
+        return;
+    }
+    if (const auto* journaled = dynamic_cast<const JournaledCommand*>(command)) {
+        journaled->collectChanges(changes);
+    }
+    for (int i = 0; i < command->childCount(); ++i) {
+        collectCommandChanges(command->child(i), changes);
+    }
+}
 }  // namespace
 
 EditorScene::EditorScene(QObject* parent)
     : QGraphicsScene(parent) {
     ensureLayerModel();
     connect(this, &QGraphicsScene::selectionChanged, this, &EditorScene::onSelectionChangedInternal);
+    connect(this, &QGraphicsScene::selectionChanged, this, [this]() {
+        if (!m_applyingSelection) {
+            m_pendingSelection.clear();
+        }
+    });
+    connect(this, &EditorScene::graphChanged, this, &EditorScene::invalidateGraphSnapshot);
+    connect(this, &EditorScene::editCommitted, this, &EditorScene::invalidateGraphSnapshot);
 }
 
 EditorScene::~EditorScene() {
@@ -127,9 +168,9 @@ NodeItem* EditorScene::createNode(const QString& typeName, const QPointF& sceneP
     node->setFlag(QGraphicsItem::ItemIsMovable, !isLayerLocked(node->layerId()));
     node->setFlag(QGraphicsItem::ItemIsSelectable, !isLayerLocked(node->layerId()));
     addItem(node);
+    registerNode(node);
     refreshCollapsedVisibility();
     emit graphChanged();
-    emit layerStateChanged();
     return node;
 }
 
@@ -160,17 +201,8 @@ NodeItem* EditorScene::createNodeFromData(const NodeData& nodeData) {
     node->setFlag(QGraphicsItem::ItemIsMovable, !isLayerLocked(node->layerId()));
     node->setFlag(QGraphicsItem::ItemIsSelectable, !isLayerLocked(node->layerId()));
     addItem(node);
-
-    updateCounterFromId(nodeData.id, &m_nodeCounter);
-    if (!nodeData.groupId.isEmpty()) {
-        updateCounterFromId(nodeData.groupId, &m_groupCounter);
-    }
-    if (!node->layerId().isEmpty()) {
-        updateCounterFromId(node->layerId(), &m_layerCounter);
-    }
-    for (const PortData& port : nodeData.ports) {
-        updateCounterFromId(port.id, &m_portCounter);
-    }
+    registerNode(node);
+    updateCountersFromData(nodeData);
     return node;
 }
 
@@ -185,52 +217,62 @@ EdgeItem* EditorScene::createEdge(PortItem* outputPort, PortItem* inputPort) {
         return nullptr;
     }
 
-    EdgeItem* edge = new EdgeItem(nextEdgeId(), outputPort);
-    edge->setRoutingMode(m_edgeRoutingMode);
-    edge->setRoutingProfile(m_edgeRoutingProfile);
-    edge->setBundlePolicy(m_edgeBundlePolicy);
-    edge->setBundleScope(m_edgeBundleScope);
-    edge->setBundleSpacing(m_edgeBundleSpacing);
-    edge->setTargetPort(inputPort);
-    addItem(edge);
-    const NodeItem* sourceNode = outputPort->ownerNode();
-    const NodeItem* targetNode = inputPort->ownerNode();
-    if (sourceNode && targetNode) {
-        for (QGraphicsItem* item : items()) {
-            if (EdgeItem* existing = dynamic_cast<EdgeItem*>(item)) {
-                if (!existing->sourcePort() || !existing->targetPort()) {
-                    continue;
-                }
-                const NodeItem* existingSource = existing->sourcePort()->ownerNode();
-                const NodeItem* existingTarget = existing->targetPort()->ownerNode();
-                if (!existingSource || !existingTarget) {
-                    continue;
-                }
-                if (existingSource->nodeId() == sourceNode->nodeId() && existingTarget->nodeId() == targetNode->nodeId()) {
-                    existing->updatePath();
-                }
-            }
-        }
-    }
+    EdgeItem* edge = addEdgeInternal(nextEdgeId(), outputPort, inputPort);
     emit graphChanged();
     return edge;
 }
 
 EdgeItem* EditorScene::createEdgeWithUndo(PortItem* outputPort, PortItem* inputPort) {
-    const GraphDocument before = toDocument();
     EdgeItem* edge = createEdge(outputPort, inputPort);
     if (!edge || !m_undoStack) {
         return edge;
     }
-    const GraphDocument after = toDocument();
-    if (!areDocumentsEquivalent(before, after)) {
-        m_undoStack->push(new DocumentStateCommand(this, before, after, QStringLiteral("Connect"), true));
-    }
+    m_undoStack->push(new ConnectEdgesCommand(this, {edgeDataFor(edge)}, true));
     return edge;
 }
 
+QVector<EdgeItem*> EditorScene::connectMany(const QVector<QPair<PortItem*, PortItem*>>& connections) {
+    QVector<EdgeItem*> created;
+    created.reserve(connections.size());
+    QSet<EdgeItem*> reroutes;
+    for (const auto& connection : connections) {
+        PortItem* outputPort = connection.first;
+        PortItem* inputPort = connection.second;
+        if (outputPort && outputPort->direction() == PortDirection::Input) {
+            std::swap(outputPort, inputPort);
+        }
+        if (!canConnect(outputPort, inputPort)) {
+            continue;
+        }
+        created.push_back(addEdgeInternal(nextEdgeId(), outputPort, inputPort, &reroutes));
+    }
+    // One pass once every edge is in place, instead of rerouting a growing
+    // bundle after each connection.
+    for (auto it = reroutes.constBegin(); it != reroutes.constEnd(); ++it) {
+        (*it)->updatePath();
+    }
+    if (!created.isEmpty()) {
+        emit graphChanged();
+    }
+    return created;
+}
+
+QVector<EdgeItem*> EditorScene::connectManyWithUndo(const QVector<QPair<PortItem*, PortItem*>>& connections) {
+    const QVector<EdgeItem*> created = connectMany(connections);
+    if (created.isEmpty() || !m_undoStack) {
+        return created;
+    }
+    QVector<EdgeData> edges;
+    edges.reserve(created.size());
+    for (const EdgeItem* edge : created) {
+        edges.push_back(edgeDataFor(edge));
+    }
+    m_undoStack->push(new ConnectEdgesCommand(this, edges, true));
+    return created;
+}
+
 bool EditorScene::renameNodeWithUndo(const QString& nodeId, const QString& newName) {
-    NodeItem* target = findNodeByIdInternal(nodeId);
+    NodeItem* target = loadNode(nodeId);
     if (!target || target->displayName() == newName) {
         return false;
     }
@@ -247,7 +289,7 @@ bool EditorScene::renameNodeWithUndo(const QString& nodeId, const QString& newNa
 }
 
 bool EditorScene::moveNodeWithUndo(const QString& nodeId, const QPointF& newPos) {
-    NodeItem* target = findNodeByIdInternal(nodeId);
+    NodeItem* target = loadNode(nodeId);
     if (!target) {
         return false;
     }
@@ -268,8 +310,33 @@ bool EditorScene::moveNodeWithUndo(const QString& nodeId, const QPointF& newPos)
     return true;
 }
 
+bool EditorScene::moveNodesWithUndo(const QHash<QString, QPointF>& scenePositions) {
+    QHash<QString, QPointF> before;
+    QHash<QString, QPointF> after;
+    for (auto it = scenePositions.constBegin(); it != scenePositions.constEnd(); ++it) {
+        NodeItem* node = loadNode(it.key());
+        if (!node) {
+            continue;
+        }
+        const QPointF snapped = snapPoint(it.value());
+        if (node->scenePos() == snapped) {
+            continue;
+        }
+        before.insert(it.key(), node->scenePos());
+        after.insert(it.key(), snapped);
+    }
+    if (after.isEmpty() || !applyNodeScenePositionsInternal(after, true)) {
+        return false;
+    }
+
+    if (m_undoStack) {
+        m_undoStack->push(new MultiNodeMoveCommand(this, before, after, true));
+    }
+    return true;
+}
+
 bool EditorScene::setNodePropertyWithUndo(const QString& nodeId, const QString& key, const QString& value) {
-    NodeItem* target = findNodeByIdInternal(nodeId);
+    NodeItem* target = loadNode(nodeId);
     if (!target) {
         return false;
     }
@@ -284,12 +351,81 @@ bool EditorScene::setNodePropertyWithUndo(const QString& nodeId, const QString&
     }
 
     if (m_undoStack) {
-        m_undoStack->push(new NodePropertyCommand(this, nodeId, key, oldValue, value, true));
+        m_undoStack->push(new NodePropertyCommand(this, nodeId, key, oldValue, target->propertyValue(key), true));
     }
     return true;
 }
 
+int EditorScene::setNodesPropertyWithUndo(const QVector<QString>& nodeIds, const QString& key, const QString& value) {
+    QHash<QString, QString> before;
+    QHash<QString, QString> after;
+    before.reserve(nodeIds.size());
+    after.reserve(nodeIds.size());
+    // Unloaded nodes are edited as records; their tiles are not built.
+    QString current;
+    for (const QString& nodeId : nodeIds) {
+        if (before.contains(nodeId) || !nodePropertyText(nodeId, key, &current)) {
+            continue;
+        }
+        before.insert(nodeId, current);
+        after.insert(nodeId, value);
+    }
+    if (after.isEmpty()) {
+        return 0;
+    }
+
+    const int changed = applyNodePropertyValuesInternal(key, after, true);
+    if (changed == 0) {
+        return 0;
+    }
+    // Keep only nodes whose value actually changed so undo restores exactly those.
+    for (auto it = before.begin(); it != before.end();) {
+        if (nodePropertyText(it.key(), key, &current) && current == it.value()) {
+            it = before.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (m_undoStack) {
+        m_undoStack->push(new MultiNodePropertyCommand(this, key, before, value, true));
+    }
+    return changed;
+}
+
+int EditorScene::setSelectionPropertyWithUndo(const QString& key, const QString& value) {
+    const QVector<NodeItem*> selectedNodes = collectSelectedNodes();
+    QVector<QString> nodeIds;
+    nodeIds.reserve(selectedNodes.size());
+    for (const NodeItem* node : selectedNodes) {
+        nodeIds.push_back(node->nodeId());
+    }
+    for (const QString& nodeId : m_pendingSelection) {
+        nodeIds.push_back(nodeId);
+    }
+    return setNodesPropertyWithUndo(nodeIds, key, value);
+}
+
+int EditorScene::setTypePropertyWithUndo(const QString& typeName, const QString& key, const QString& value) {
+    QVector<QString> nodeIds;
+    for (auto it = m_nodesById.constBegin(); it != m_nodesById.constEnd(); ++it) {
+        if (it.value()->typeName() == typeName) {
+            nodeIds.push_back(it.key());
+        }
+    }
+    for (auto tile = m_unloadedTiles.constBegin(); tile != m_unloadedTiles.constEnd(); ++tile) {
+        for (const NodeData& record : tile.value()) {
+            if (record.type == typeName) {
+                nodeIds.push_back(record.id);
+            }
+        }
+    }
+    return setNodesPropertyWithUndo(nodeIds, key, value);
+}
+
 bool EditorScene::autoLayoutWithUndo(bool selectedOnly) {
+    if (!selectedOnly) {
+        loadAllTiles();
+    }
     const QVector<NodeItem*> layoutNodes = collectLayoutNodes(selectedOnly);
     if (layoutNodes.size() < 2) {
         return false;
@@ -353,177 +489,75 @@ bool EditorScene::rotateSelectionWithUndo(qreal deltaDegrees) {
 }
 
 bool EditorScene::bringSelectionToFrontWithUndo() {
-    const QVector<NodeItem*> selectedNodes = collectSelectedNodes();
-    if (selectedNodes.isEmpty()) {
+    QVector<NodeItem*> ordered = collectSelectedNodes();
+    if (ordered.isEmpty()) {
         return false;
     }
-
-    const GraphDocument before = toDocument();
-    qreal maxZ = 1.0;
-    for (QGraphicsItem* item : items()) {
-        if (NodeItem* node = dynamic_cast<NodeItem*>(item)) {
-            maxZ = std::max(maxZ, node->zValue());
-        }
-    }
-
-    QVector<NodeItem*> ordered = selectedNodes;
     std::sort(ordered.begin(), ordered.end(), [](const NodeItem* a, const NodeItem* b) { return a->zValue() < b->zValue(); });
 
-    bool changed = false;
+    const qreal maxZ = m_nodeZCounts.isEmpty() ? 1.0 : std::max<qreal>(1.0, m_nodeZCounts.lastKey());
+    QHash<QString, qreal> zValues;
     qreal next = maxZ + 1.0;
     for (NodeItem* node : ordered) {
-        if (!node) {
-            continue;
-        }
-        if (qFuzzyCompare(node->zValue() + 1.0, next + 1.0)) {
+        if (node) {
+            zValues.insert(node->nodeId(), next);
             next += 1.0;
-            continue;
         }
-        node->setZValue(next);
-        next += 1.0;
-        changed = true;
-    }
-
-    if (!changed) {
-        return false;
-    }
-
-    emit graphChanged();
-    if (!m_undoStack) {
-        return true;
-    }
-
-    const GraphDocument after = toDocument();
-    if (!areDocumentsEquivalent(before, after)) {
-        m_undoStack->push(new DocumentStateCommand(this, before, after, QStringLiteral("Bring To Front"), true));
     }
-    return true;
+    return applyZOrderWithUndo(zValues, QStringLiteral("Bring To Front"));
 }
 
 bool EditorScene::sendSelectionToBackWithUndo() {
-    const QVector<NodeItem*> selectedNodes = collectSelectedNodes();
-    if (selectedNodes.isEmpty()) {
+    QVector<NodeItem*> ordered = collectSelectedNodes();
+    if (ordered.isEmpty()) {
         return false;
     }
-
-    const GraphDocument before = toDocument();
-    qreal minZ = 1.0;
-    bool initialized = false;
-    for (QGraphicsItem* item : items()) {
-        if (NodeItem* node = dynamic_cast<NodeItem*>(item)) {
-            minZ = initialized ? std::min(minZ, node->zValue()) : node->zValue();
-            initialized = true;
-        }
-    }
-
-    QVector<NodeItem*> ordered = selectedNodes;
     std::sort(ordered.begin(), ordered.end(), [](const NodeItem* a, const NodeItem* b) { return a->zValue() < b->zValue(); });
 
-    bool changed = false;
+    const qreal minZ = m_nodeZCounts.isEmpty() ? 1.0 : m_nodeZCounts.firstKey();
+    QHash<QString, qreal> zValues;
     qreal next = minZ - static_cast<qreal>(ordered.size());
     for (NodeItem* node : ordered) {
-        if (!node) {
-            continue;
-        }
-        if (qFuzzyCompare(node->zValue() + 1.0, next + 1.0)) {
+        if (node) {
+            zValues.insert(node->nodeId(), next);
             next += 1.0;
-            continue;
         }
-        node->setZValue(next);
-        next += 1.0;
-        changed = true;
-    }
-
-    if (!changed) {
-        return false;
-    }
-
-    emit graphChanged();
-    if (!m_undoStack) {
-        return true;
-    }
-
-    const GraphDocument after = toDocument();
-    if (!areDocumentsEquivalent(before, after)) {
-        m_undoStack->push(new DocumentStateCommand(this, before, after, QStringLiteral("Send To Back"), true));
     }
-    return true;
+    return applyZOrderWithUndo(zValues, QStringLiteral("Send To Back"));
 }
 
 bool EditorScene::bringSelectionForwardWithUndo() {
-    const QVector<NodeItem*> selectedNodes = collectSelectedNodes();
-    if (selectedNodes.isEmpty()) {
-        return false;
-    }
-
-    const GraphDocument before = toDocument();
-    QVector<NodeItem*> ordered = selectedNodes;
-    std::sort(ordered.begin(), ordered.end(), [](const NodeItem* a, const NodeItem* b) { return a->zValue() > b->zValue(); });
-
-    bool changed = false;
-    for (NodeItem* node : ordered) {
-        if (!node) {
-            continue;
-        }
-        const qreal next = node->zValue() + 1.0;
-        if (qFuzzyCompare(node->zValue() + 1.0, next + 1.0)) {
-            continue;
+    QHash<QString, qreal> zValues;
+    for (NodeItem* node : collectSelectedNodes()) {
+        if (node) {
+            zValues.insert(node->nodeId(), node->zValue() + 1.0);
         }
-        node->setZValue(next);
-        changed = true;
-    }
-
-    if (!changed) {
-        return false;
-    }
-
-    emit graphChanged();
-    if (!m_undoStack) {
-        return true;
-    }
-
-    const GraphDocument after = toDocument();
-    if (!areDocumentsEquivalent(before, after)) {
-        m_undoStack->push(new DocumentStateCommand(this, before, after, QStringLiteral("Bring Forward"), true));
     }
-    return true;
+    return applyZOrderWithUndo(zValues, QStringLiteral("Bring Forward"));
 }
 
 bool EditorScene::sendSelectionBackwardWithUndo() {
-    const QVector<NodeItem*> selectedNodes = collectSelectedNodes();
-    if (selectedNodes.isEmpty()) {
-        return false;
+    QHash<QString, qreal> zValues;
+    for (NodeItem* node : collectSelectedNodes()) {
+        if (node) {
+            zValues.insert(node->nodeId(), node->zValue() - 1.0);
+        }
     }
+    return applyZOrderWithUndo(zValues, QStringLiteral("Send Backward"));
+}
 
-    const GraphDocument before = toDocument();
-    QVector<NodeItem*> ordered = selectedNodes;
-    std::sort(ordered.begin(), ordered.end(), [](const NodeItem* a, const NodeItem* b) { return a->zValue() < b->zValue(); });
-
-    bool changed = false;
-    for (NodeItem* node : ordered) {
-        if (!node) {
-            continue;
-        }
-        const qreal next = node->zValue() - 1.0;
-        if (qFuzzyCompare(node->zValue() + 1.0, next + 1.0)) {
-            continue;
+bool EditorScene::applyZOrderWithUndo(const QHash<QString, qreal>& zValues, const QString& text) {
+    QHash<QString, qreal> before;
+    for (auto it = zValues.constBegin(); it != zValues.constEnd(); ++it) {
+        if (const NodeItem* node = nodeById(it.key())) {
+            before.insert(it.key(), node->zValue());
         }
-        node->setZValue(next);
-        changed = true;
     }
-
-    if (!changed) {
+    if (!applyNodeZValuesInternal(zValues, true)) {
         return false;
     }
-
-    emit graphChanged();
-    if (!m_undoStack) {
-        return true;
-    }
-
-    const GraphDocument after = toDocument();
-    if (!areDocumentsEquivalent(before, after)) {
-        m_undoStack->push(new DocumentStateCommand(this, before, after, QStringLiteral("Send Backward"), true));
+    if (m_undoStack) {
+        m_undoStack->push(new NodeZOrderCommand(this, before, zValues, text, true));
     }
     return true;
 }
@@ -577,45 +611,21 @@ bool EditorScene::renameLayerWithUndo(const QString& layerId, const QString& nam
 }
 
 bool EditorScene::setLayerVisibleWithUndo(const QString& layerId, bool visible) {
-    LayerData* layer = findLayerByIdMutable(layerId);
-    if (!layer || layer->visible == visible) {
+    if (!applyLayerFlagInternal(layerId, LayerFlag::Visible, visible)) {
         return false;
     }
-
-    const GraphDocument before = toDocument();
-    layer->visible = visible;
-    refreshCollapsedVisibility();
-    onSelectionChangedInternal();
-    emit graphChanged();
-    emit layerStateChanged();
-
     if (m_undoStack) {
-        const GraphDocument after = toDocument();
-        if (!areDocumentsEquivalent(before, after)) {
-            m_undoStack->push(new DocumentStateCommand(this, before, after, QStringLiteral("Layer Visibility"), true));
-        }
+        m_undoStack->push(new LayerFlagCommand(this, layerId, LayerFlag::Visible, !visible, visible, true));
     }
     return true;
 }
 
 bool EditorScene::setLayerLockedWithUndo(const QString& layerId, bool locked) {
-    LayerData* layer = findLayerByIdMutable(layerId);
-    if (!layer || layer->locked == locked) {
+    if (!applyLayerFlagInternal(layerId, LayerFlag::Locked, locked)) {
         return false;
     }
-
-    const GraphDocument before = toDocument();
-    layer->locked = locked;
-    refreshCollapsedVisibility();
-    onSelectionChangedInternal();
-    emit graphChanged();
-    emit layerStateChanged();
-
     if (m_undoStack) {
-        const GraphDocument after = toDocument();
-        if (!areDocumentsEquivalent(before, after)) {
-            m_undoStack->push(new DocumentStateCommand(this, before, after, QStringLiteral("Layer Lock"), true));
-        }
+        m_undoStack->push(new LayerFlagCommand(this, layerId, LayerFlag::Locked, !locked, locked, true));
     }
     return true;
 }
@@ -676,13 +686,20 @@ bool EditorScene::deleteLayerWithUndo(const QString& layerId) {
     const QString fallbackLayerId = m_layers[fallbackIndex].id;
 
     const GraphDocument before = toDocument();
-    for (QGraphicsItem* item : items()) {
-        NodeItem* node = dynamic_cast<NodeItem*>(item);
-        if (!node || node->layerId() != layerId) {
-            continue;
-        }
+    const QSet<NodeItem*> members = m_layerMembers.value(layerId);
+    for (NodeItem* node : members) {
         node->setLayerId(fallbackLayerId);
     }
+    if (const int unloaded = m_unloadedLayerCounts.take(layerId)) {
+        for (auto tile = m_unloadedTiles.begin(); tile != m_unloadedTiles.end(); ++tile) {
+            for (NodeData& record : tile.value()) {
+                if (record.layerId == layerId) {
+                    record.layerId = fallbackLayerId;
+                }
+            }
+        }
+        m_unloadedLayerCounts[fallbackLayerId] += unloaded;
+    }
     m_layers.removeAt(index);
     if (m_activeLayerId == layerId) {
         m_activeLayerId = fallbackLayerId;
@@ -781,7 +798,7 @@ bool EditorScene::groupSelectionWithUndo() {
         }
     }
 
-    rebuildNodeGroups();
+    syncNodeGroups(QSet<QString>{groupId});
     clearSelection();
     if (QGraphicsItemGroup* groupItem = m_nodeGroups.value(groupId, nullptr)) {
         groupItem->setSelected(true);
@@ -813,23 +830,19 @@ bool EditorScene::ungroupSelectionWithUndo() {
 
     const GraphDocument before = toDocument();
     bool changed = false;
-    for (QGraphicsItem* item : items()) {
-        NodeItem* node = dynamic_cast<NodeItem*>(item);
-        if (!node || !targetGroupIds.contains(node->groupId())) {
-            continue;
-        }
-        node->setGroupId(QString());
-        changed = true;
-    }
     for (const QString& groupId : targetGroupIds) {
+        const QSet<NodeItem*> members = m_groupMembers.value(groupId);
+        for (NodeItem* node : members) {
+            node->setGroupId(QString());
+            changed = true;
+        }
         m_collapsedGroups.remove(groupId);
     }
     if (!changed) {
         return false;
     }
 
-    rebuildNodeGroups();
-    refreshCollapsedVisibility();
+    syncNodeGroups(targetGroupIds);
     emit graphChanged();
     onSelectionChangedInternal();
 
@@ -859,20 +872,11 @@ bool EditorScene::collapseSelectionWithUndo() {
         return false;
     }
 
-    const GraphDocument before = toDocument();
-    for (const QString& groupId : toCollapse) {
-        m_collapsedGroups.insert(groupId);
-    }
-    refreshCollapsedVisibility();
-    emit graphChanged();
-    onSelectionChangedInternal();
-
-    if (!m_undoStack) {
-        return true;
+    if (!applyGroupCollapsedInternal(toCollapse, true)) {
+        return false;
     }
-    const GraphDocument after = toDocument();
-    if (!areDocumentsEquivalent(before, after)) {
-        m_undoStack->push(new DocumentStateCommand(this, before, after, QStringLiteral("Collapse Group"), true));
+    if (m_undoStack) {
+        m_undoStack->push(new GroupCollapseCommand(this, toCollapse, true, true));
     }
     return true;
 }
@@ -893,20 +897,11 @@ bool EditorScene::expandSelectionWithUndo() {
         return false;
     }
 
-    const GraphDocument before = toDocument();
-    for (const QString& groupId : toExpand) {
-        m_collapsedGroups.remove(groupId);
-    }
-    refreshCollapsedVisibility();
-    emit graphChanged();
-    onSelectionChangedInternal();
-
-    if (!m_undoStack) {
-        return true;
+    if (!applyGroupCollapsedInternal(toExpand, false)) {
+        return false;
     }
-    const GraphDocument after = toDocument();
-    if (!areDocumentsEquivalent(before, after)) {
-        m_undoStack->push(new DocumentStateCommand(this, before, after, QStringLiteral("Expand Group"), true));
+    if (m_undoStack) {
+        m_undoStack->push(new GroupCollapseCommand(this, toExpand, false, true));
     }
     return true;
 }
@@ -916,24 +911,13 @@ bool EditorScene::toggleGroupCollapsedByIdWithUndo(const QString& groupId) {
         return false;
     }
 
-    const GraphDocument before = toDocument();
     const bool willCollapse = !m_collapsedGroups.contains(groupId);
-    if (willCollapse) {
-        m_collapsedGroups.insert(groupId);
-    } else {
-        m_collapsedGroups.remove(groupId);
-    }
-    refreshCollapsedVisibility();
-    emit graphChanged();
-    onSelectionChangedInternal();
-
-    if (!m_undoStack) {
-        return true;
+    const QSet<QString> groupIds{groupId};
+    if (!applyGroupCollapsedInternal(groupIds, willCollapse)) {
+        return false;
     }
-    const GraphDocument after = toDocument();
-    if (!areDocumentsEquivalent(before, after)) {
-        m_undoStack->push(new DocumentStateCommand(
-            this, before, after, willCollapse ? QStringLiteral("Collapse Group") : QStringLiteral("Expand Group"), true));
+    if (m_undoStack) {
+        m_undoStack->push(new GroupCollapseCommand(this, groupIds, willCollapse, true));
     }
     return true;
 }
@@ -945,77 +929,76 @@ void EditorScene::deleteSelectionWithUndo() {
         return;
     }
 
-    const GraphDocument before = toDocument();
-
-    QSet<QString> deletedNodeIds;
+    QSet<QString> nodeIds;
+    QSet<EdgeItem*> edges;
+    QSet<QString> affectedGroupIds;
+    QVector<NodeData> nodeData;
     for (NodeItem* node : selectedNodes) {
-        if (node) {
-            deletedNodeIds.insert(node->nodeId());
+        if (!node || nodeIds.contains(node->nodeId())) {
+            continue;
         }
-    }
-
-    QSet<QGraphicsItem*> toDelete;
-    for (QGraphicsItem* item : items()) {
-        if (EdgeItem* edge = dynamic_cast<EdgeItem*>(item)) {
-            if (!edge->sourcePort() || !edge->targetPort()) {
-                continue;
-            }
-            const NodeItem* fromNode = edge->sourcePort()->ownerNode();
-            const NodeItem* toNode = edge->targetPort()->ownerNode();
-            if ((fromNode && deletedNodeIds.contains(fromNode->nodeId())) ||
-                (toNode && deletedNodeIds.contains(toNode->nodeId())) || edge->isSelected()) {
-                toDelete.insert(edge);
-            }
+        nodeIds.insert(node->nodeId());
+        nodeData.push_back(nodeDataFor(node));
+        loadIncidentEdges(node->nodeId());
+        collectIncidentEdges(node, &edges);
+        if (!node->groupId().isEmpty()) {
+            affectedGroupIds.insert(node->groupId());
         }
     }
-    for (NodeItem* node : selectedNodes) {
-        if (node) {
-            toDelete.insert(node);
+    for (QGraphicsItem* item : selected) {
+        EdgeItem* edge = dynamic_cast<EdgeItem*>(item);
+        if (edge && m_edgesById.value(edge->edgeId(), nullptr) == edge) {
+            edges.insert(edge);
         }
     }
+    if (nodeIds.isEmpty() && edges.isEmpty()) {
+        return;
+    }
 
-    const QList<QGraphicsItem*> toDeleteList = toDelete.values();
-    for (QGraphicsItem* item : toDeleteList) {
-        if (NodeItem* node = dynamic_cast<NodeItem*>(item)) {
-            m_nodeGroups.remove(node->groupId());
+    QSet<QString> edgeIds;
+    QVector<EdgeData> edgeData;
+    for (EdgeItem* edge : edges) {
+        if (edge->sourcePort() && edge->targetPort()) {
+            edgeIds.insert(edge->edgeId());
+            edgeData.push_back(edgeDataFor(edge));
         }
     }
-    for (QGraphicsItem* item : toDelete) {
-        removeItem(item);
-        delete item;
-    }
-    for (QGraphicsItem* item : items()) {
-        if (EdgeItem* existing = dynamic_cast<EdgeItem*>(item)) {
-            existing->updatePath();
+
+    QHash<QString, QString> survivorGroupIds;
+    QSet<QString> collapsedGroupIds;
+    for (const QString& groupId : affectedGroupIds) {
+        const QSet<NodeItem*> members = m_groupMembers.value(groupId);
+        for (NodeItem* member : members) {
+            if (!nodeIds.contains(member->nodeId())) {
+                survivorGroupIds.insert(member->nodeId(), groupId);
+            }
+        }
+        if (m_collapsedGroups.contains(groupId)) {
+            collapsedGroupIds.insert(groupId);
         }
     }
 
-    rebuildNodeGroups();
-
-    emit graphChanged();
-
-    if (!m_undoStack) {
+    if (!applyDeleteInternal(nodeIds, edgeIds, true) || !m_undoStack) {
         return;
     }
-    const GraphDocument after = toDocument();
-    if (!areDocumentsEquivalent(before, after)) {
-        m_undoStack->push(new DocumentStateCommand(this, before, after, QStringLiteral("Delete"), true));
-    }
+    m_undoStack->push(new DeleteItemsCommand(this, nodeData, edgeData, survivorGroupIds, collapsedGroupIds, true));
 }
 
 EdgeItem* EditorScene::createEdgeFromData(const EdgeData& edgeData) {
-    PortItem* outPort = nullptr;
-    PortItem* inPort = nullptr;
+    PortItem* outPort = findPort(edgeData.fromNodeId, edgeData.fromPortId);
+    PortItem* inPort = findPort(edgeData.toNodeId, edgeData.toPortId);
 
-    for (QGraphicsItem* item : items()) {
-        PortItem* port = dynamic_cast<PortItem*>(item);
-        if (!port) {
-            continue;
-        }
-        if (port->portId() == edgeData.fromPortId) {
-            outPort = port;
-        } else if (port->portId() == edgeData.toPortId) {
-            inPort = port;
+    if (!outPort || !inPort) {
+        for (QGraphicsItem* item : items()) {
+            PortItem* port = dynamic_cast<PortItem*>(item);
+            if (!port) {
+                continue;
+            }
+            if (port->portId() == edgeData.fromPortId) {
+                outPort = port;
+            } else if (port->portId() == edgeData.toPortId) {
+                inPort = port;
+            }
         }
     }
 
@@ -1023,33 +1006,7 @@ EdgeItem* EditorScene::createEdgeFromData(const EdgeData& edgeData) {
         return nullptr;
     }
 
-    EdgeItem* edge = new EdgeItem(edgeData.id, outPort);
-    edge->setRoutingMode(m_edgeRoutingMode);
-    edge->setRoutingProfile(m_edgeRoutingProfile);
-    edge->setBundlePolicy(m_edgeBundlePolicy);
-    edge->setBundleScope(m_edgeBundleScope);
-    edge->setBundleSpacing(m_edgeBundleSpacing);
-    edge->setTargetPort(inPort);
-    addItem(edge);
-    const NodeItem* sourceNode = outPort->ownerNode();
-    const NodeItem* targetNode = inPort->ownerNode();
-    if (sourceNode && targetNode) {
-        for (QGraphicsItem* item : items()) {
-            if (EdgeItem* existing = dynamic_cast<EdgeItem*>(item)) {
-                if (!existing->sourcePort() || !existing->targetPort()) {
-                    continue;
-                }
-                const NodeItem* existingSource = existing->sourcePort()->ownerNode();
-                const NodeItem* existingTarget = existing->targetPort()->ownerNode();
-                if (!existingSource || !existingTarget) {
-                    continue;
-                }
-                if (existingSource->nodeId() == sourceNode->nodeId() && existingTarget->nodeId() == targetNode->nodeId()) {
-                    existing->updatePath();
-                }
-            }
-        }
-    }
+    EdgeItem* edge = addEdgeInternal(edgeData.id, outPort, inPort);
     updateCounterFromId(edgeData.id, &m_edgeCounter);
     return edge;
 }
@@ -1066,6 +1023,26 @@ void EditorScene::clearGraph() {
 
     clearNodeGroups();
 
+    m_nodesById.clear();
+    m_edgesById.clear();
+    m_portPairEdgeCounts.clear();
+    m_inputPortEdgeCounts.clear();
+    m_nodeZCounts.clear();
+    m_topologicalOrder.clear();
+    m_searchIndex.clear();
+    m_bundleIndex.clear();
+    m_layerMembers.clear();
+    m_groupMembers.clear();
+    m_lazyLoaded = false;
+    m_unloadedTiles.clear();
+    m_unloadedNodeTiles.clear();
+    m_unloadedEdges.clear();
+    m_unloadedEdgesByNode.clear();
+    m_loadedTiles.clear();
+    m_loadedNodeTiles.clear();
+    m_unloadedLayerCounts.clear();
+    m_pendingSelection.clear();
+    invalidateGraphSnapshot();
     clear();
     m_nodeCounter = 1;
     m_portCounter = 1;
@@ -1076,11 +1053,171 @@ void EditorScene::clearGraph() {
     m_layers.clear();
     m_activeLayerId.clear();
     ensureLayerModel();
+    if (!m_bulkLoading) {
+        emit graphReset();
+    }
     emit graphChanged();
     emit layerStateChanged();
 }
 
 GraphDocument EditorScene::toDocument() const {
+    GraphDocument doc = documentSettings();
+
+    doc.nodes.reserve(nodeCount());
+    for (auto it = m_nodesById.constBegin(); it != m_nodesById.constEnd(); ++it) {
+        doc.nodes.append(nodeDataFor(it.value()));
+    }
+    for (auto tile = m_unloadedTiles.constBegin(); tile != m_unloadedTiles.constEnd(); ++tile) {
+        for (const NodeData& record : tile.value()) {
+            doc.nodes.append(record);
+        }
+    }
+    doc.edges.reserve(edgeCount());
+    for (auto it = m_edgesById.constBegin(); it != m_edgesById.constEnd(); ++it) {
+        const EdgeItem* edge = it.value();
+        if (edge->sourcePort() && edge->targetPort()) {
+            doc.edges.append(edgeDataFor(edge));
+        }
+    }
+    for (auto it = m_unloadedEdges.constBegin(); it != m_unloadedEdges.constEnd(); ++it) {
+        doc.edges.append(it.value());
+    }
+
+    std::sort(doc.nodes.begin(), doc.nodes.end(), [](const NodeData& a, const NodeData& b) { return a.id < b.id; });
+    std::sort(doc.edges.begin(), doc.edges.end(), [](const EdgeData& a, const EdgeData& b) { return a.id < b.id; });
+    for (NodeData& node : doc.nodes) {
+        sortNodeParts(&node);
+    }
+    return doc;
+}
+
+GraphDelta EditorScene::deltaFor(const GraphChangeSet& changes) const {
+    GraphDelta delta;
+    for (const QString& nodeId : changes.nodeIds) {
+        const NodeItem* node = m_nodesById.value(nodeId, nullptr);
+        if (node) {
+            delta.nodes.append(nodeDataFor(node));
+            sortNodeParts(&delta.nodes.last());
+        } else if (const NodeData* record = unloadedNode(nodeId)) {
+            delta.nodes.append(*record);
+            sortNodeParts(&delta.nodes.last());
+        } else {
+            delta.removedNodeIds.append(nodeId);
+        }
+    }
+    for (const QString& edgeId : changes.edgeIds) {
+        const EdgeItem* edge = m_edgesById.value(edgeId, nullptr);
+        const auto unloaded = m_unloadedEdges.constFind(edgeId);
+        if (edge && edge->sourcePort() && edge->targetPort()) {
+            delta.edges.append(edgeDataFor(edge));
+        } else if (!edge && unloaded != m_unloadedEdges.constEnd()) {
+            delta.edges.append(unloaded.value());
+        } else {
+            delta.removedEdgeIds.append(edgeId);
+        }
+    }
+    if (changes.settings) {
+        delta.hasSettings = true;
+        delta.settings = documentSettings();
+    }
+    return delta;
+}
+
+GraphChangeSet EditorScene::takeUnsavedChanges() {
+    GraphChangeSet changes = std::move(m_unsavedChanges);
+    m_unsavedChanges = GraphChangeSet();
+    m_fullSaveRequired = false;
+    return changes;
+}
+
+void EditorScene::restoreUnsavedChanges(const GraphChangeSet& changes, bool fullSaveRequired) {
+    m_unsavedChanges.unite(changes);
+    m_fullSaveRequired = m_fullSaveRequired || fullSaveRequired;
+}
+
+bool EditorScene::fullSaveRequired() const {
+    return m_fullSaveRequired;
+}
+
+void EditorScene::requireFullSave() {
+    m_fullSaveRequired = true;
+}
+
+QSet<quint64> EditorScene::chunkTilesOf(const GraphChangeSet& changes) const {
+    QSet<quint64> tiles;
+    quint64 tile = 0;
+    for (const QString& nodeId : changes.nodeIds) {
+        if (nodeTile(nodeId, &tile)) {
+            tiles.insert(tile);
+        }
+    }
+    for (const QString& edgeId : changes.edgeIds) {
+        const EdgeItem* edge = m_edgesById.value(edgeId, nullptr);
+        const NodeItem* source = (edge && edge->sourcePort()) ? edge->sourcePort()->ownerNode() : nullptr;
+        const QString sourceId = source ? source->nodeId() : m_unloadedEdges.value(edgeId).fromNodeId;
+        if (!sourceId.isEmpty() && nodeTile(sourceId, &tile)) {
+            tiles.insert(tile);
+        }
+    }
+    return tiles;
+}
+
+QHash<quint64, GraphDocument> EditorScene::chunkTileContents(const QSet<quint64>& tiles) const {
+    // Only the requested tiles are visited: their node items and records, the
+    // edges leaving those nodes, and the parked edges leaving them.
+    QHash<quint64, GraphDocument> contents;
+    contents.reserve(tiles.size());
+    for (const quint64 tile : tiles) {
+        GraphDocument& content = contents[tile];
+        QVector<QString> nodeIds;
+        const auto loaded = m_loadedTiles.constFind(tile);
+        if (loaded != m_loadedTiles.constEnd()) {
+            for (const NodeItem* node : loaded.value()) {
+                content.nodes.append(nodeDataFor(node));
+                nodeIds.push_back(node->nodeId());
+                for (const PortItem* port : node->outputPorts()) {
+                    for (const EdgeItem* edge : port->edges()) {
+                        if (edge->targetPort() && m_edgesById.value(edge->edgeId(), nullptr) == edge) {
+                            content.edges.append(edgeDataFor(edge));
+                        }
+                    }
+                }
+            }
+        }
+        const auto records = m_unloadedTiles.constFind(tile);
+        if (records != m_unloadedTiles.constEnd()) {
+            for (const NodeData& record : records.value()) {
+                content.nodes.append(record);
+                nodeIds.push_back(record.id);
+            }
+        }
+        for (const QString& nodeId : nodeIds) {
+            const QList<QString> edgeIds = m_unloadedEdgesByNode.values(nodeId);
+            for (const QString& edgeId : edgeIds) {
+                const auto edge = m_unloadedEdges.constFind(edgeId);
+                if (edge != m_unloadedEdges.constEnd() && edge->fromNodeId == nodeId) {
+                    content.edges.append(edge.value());
+                }
+            }
+        }
+    }
+
+    // Same order as toDocument(), so a tile's bytes only change with its content.
+    for (GraphDocument& content : contents) {
+        std::sort(content.nodes.begin(), content.nodes.end(), [](const NodeData& a, const NodeData& b) {
+            return a.id < b.id;
+        });
+        std::sort(content.edges.begin(), content.edges.end(), [](const EdgeData& a, const EdgeData& b) {
+            return a.id < b.id;
+        });
+        for (NodeData& node : content.nodes) {
+            sortNodeParts(&node);
+        }
+    }
+    return contents;
+}
+
+GraphDocument EditorScene::documentSettings() const {
     GraphDocument doc;
     doc.schemaVersion = 1;
     doc.autoLayoutMode = (m_autoLayoutMode == AutoLayoutMode::Grid) ? QStringLiteral("grid") : QStringLiteral("layered");
@@ -1098,72 +1235,70 @@ GraphDocument EditorScene::toDocument() const {
         doc.edgeBundleScope = QStringLiteral("global");
     }
     doc.edgeBundleSpacing = m_edgeBundleSpacing;
+    doc.dagOnly = m_dagEnforced;
     doc.layers = m_layers;
     doc.activeLayerId = m_activeLayerId;
     doc.collapsedGroupIds = m_collapsedGroups.values().toVector();
+    std::sort(doc.collapsedGroupIds.begin(), doc.collapsedGroupIds.end());
+    return doc;
+}
 
-    for (QGraphicsItem* item : items()) {
-        if (NodeItem* node = dynamic_cast<NodeItem*>(item)) {
-            NodeData nodeData;
-            nodeData.id = node->nodeId();
-            nodeData.type = node->typeName();
-            nodeData.name = node->displayName();
-            nodeData.position = node->scenePos();
-            nodeData.size = node->nodeSize();
-            nodeData.rotationDegrees = node->rotation();
-            nodeData.z = node->zValue();
-            nodeData.groupId = node->groupId();
-            nodeData.layerId = node->layerId();
-
-            for (PortItem* port : node->inputPorts()) {
-                PortData p;
-                p.id = port->portId();
-                p.name = port->portName();
-                p.direction = QStringLiteral("input");
-                nodeData.ports.append(p);
-            }
-            for (PortItem* port : node->outputPorts()) {
-                PortData p;
-                p.id = port->portId();
-                p.name = port->portName();
-                p.direction = QStringLiteral("output");
-                nodeData.ports.append(p);
-            }
-            nodeData.properties = node->properties();
-            doc.nodes.append(nodeData);
+bool EditorScene::fromDocument(const GraphDocument& document) {
+    beginDocumentLoad(document);
+    m_lazyLoaded = useLazyLoad(document.nodes.size(), document.dagOnly);
+    for (const NodeData& node : document.nodes) {
+        if (!loadNodeRecord(node, m_lazyLoaded)) {
+            m_bulkLoading = false;
+            emit graphReset();
+            return false;
         }
     }
-
-    for (QGraphicsItem* item : items()) {
-        if (EdgeItem* edge = dynamic_cast<EdgeItem*>(item)) {
-            if (!edge->sourcePort() || !edge->targetPort()) {
-                continue;
-            }
-            EdgeData e;
-            e.id = edge->edgeId();
-            e.fromNodeId = edge->sourcePort()->ownerNode() ? edge->sourcePort()->ownerNode()->nodeId() : QString();
-            e.fromPortId = edge->sourcePort()->portId();
-            e.toNodeId = edge->targetPort()->ownerNode() ? edge->targetPort()->ownerNode()->nodeId() : QString();
-            e.toPortId = edge->targetPort()->portId();
-            doc.edges.append(e);
-        }
+    for (const EdgeData& edge : document.edges) {
+        loadEdgeRecord(edge, m_lazyLoaded);
     }
+    finishDocumentLoad(document.dagOnly);
+    return true;
+}
 
-    std::sort(doc.nodes.begin(), doc.nodes.end(), [](const NodeData& a, const NodeData& b) { return a.id < b.id; });
-    std::sort(doc.edges.begin(), doc.edges.end(), [](const EdgeData& a, const EdgeData& b) { return a.id < b.id; });
-    for (NodeData& node : doc.nodes) {
-        std::sort(node.ports.begin(), node.ports.end(), [](const PortData& a, const PortData& b) { return a.id < b.id; });
-        std::sort(node.properties.begin(),
-                  node.properties.end(),
-                  [](const PropertyData& a, const PropertyData& b) { return a.key < b.key; });
+bool EditorScene::fromBinaryView(const BinaryGraphView& view) {
+    if (!view.isOpen()) {
+        return false;
     }
-    std::sort(doc.collapsedGroupIds.begin(), doc.collapsedGroupIds.end());
+    // Same folding loadFromFile applies (e.g. unnamed layers take their id).
+    GraphDocument settings = view.settings();
+    GraphSerializer::normalizeSettings(&settings);
+    beginDocumentLoad(settings);
+    m_lazyLoaded = useLazyLoad(view.nodeCount(), settings.dagOnly);
 
-    return doc;
+    // One node or edge is materialized at a time; the records themselves stay
+    // in the mapped file.
+    NodeData node;
+    for (int i = 0; i < view.nodeCount(); ++i) {
+        view.readNode(i, &node);
+        if (node.id.isEmpty()) {
+            continue;
+        }
+        if (!loadNodeRecord(node, m_lazyLoaded)) {
+            m_bulkLoading = false;
+            emit graphReset();
+            return false;
+        }
+    }
+    EdgeData edge;
+    for (int i = 0; i < view.edgeCount(); ++i) {
+        view.readEdge(i, &edge);
+        if (!edge.fromNodeId.isEmpty() && !edge.toNodeId.isEmpty()) {
+            loadEdgeRecord(edge, m_lazyLoaded);
+        }
+    }
+    finishDocumentLoad(settings.dagOnly);
+    return true;
 }
 
-bool EditorScene::fromDocument(const GraphDocument& document) {
+void EditorScene::beginDocumentLoad(const GraphDocument& document) {
+    m_bulkLoading = true;
     clearGraph();
+    m_dagEnforced = false;
     m_layers = document.layers;
     m_activeLayerId = document.activeLayerId;
     ensureLayerModel();
@@ -1190,86 +1325,513 @@ bool EditorScene::fromDocument(const GraphDocument& document) {
     }
     m_edgeBundleSpacing = std::max<qreal>(0.0, document.edgeBundleSpacing);
     m_collapsedGroups = QSet<QString>(document.collapsedGroupIds.begin(), document.collapsedGroupIds.end());
+}
 
-    for (const NodeData& node : document.nodes) {
-        if (!createNodeFromData(node)) {
-            return false;
-        }
-    }
-    for (const EdgeData& edge : document.edges) {
-        createEdgeFromData(edge);
-    }
-
+void EditorScene::finishDocumentLoad(bool dagOnly) {
     sanitizeNodeLayers();
     rebuildNodeGroups();
     refreshCollapsedVisibility();
+    m_dagEnforced = dagOnly && rebuildTopologicalOrder();
+    m_bulkLoading = false;
+    if (dagOnly && !m_dagEnforced) {
+        emit dagEnforcedChanged(false);
+    }
+    if (m_lazyLoaded) {
+        // The view must be able to scroll to nodes that have no item yet.
+        QRectF bounds = sceneRect();
+        for (auto tile = m_unloadedTiles.constBegin(); tile != m_unloadedTiles.constEnd(); ++tile) {
+            for (const NodeData& record : tile.value()) {
+                bounds |= QRectF(record.position, record.size);
+            }
+        }
+        setSceneRect(bounds);
+        setViewportRect(m_viewportRect);
+    }
 
+    emit graphReset();
     emit graphChanged();
     emit layerStateChanged();
-    return true;
 }
 
-void EditorScene::setSnapToGrid(bool enabled) {
-    m_snapToGrid = enabled;
+void EditorScene::setLazyLoadThreshold(int nodeCount) {
+    m_lazyLoadThreshold = std::max(0, nodeCount);
 }
 
-bool EditorScene::snapToGrid() const {
-    return m_snapToGrid;
+int EditorScene::lazyLoadThreshold() const {
+    return m_lazyLoadThreshold;
 }
 
-int EditorScene::gridSize() const {
-    return 20;
+bool EditorScene::isLazyLoaded() const {
+    return m_lazyLoaded;
 }
 
-void EditorScene::setUndoStack(QUndoStack* stack) {
-    m_undoStack = stack;
+int EditorScene::loadedNodeCount() const {
+    return m_nodesById.size();
 }
 
-void EditorScene::setInteractionMode(InteractionMode mode) {
-    m_mode = mode;
-    if (m_mode != InteractionMode::Connect && m_previewEdge) {
-        removeItem(m_previewEdge);
-        delete m_previewEdge;
-        m_previewEdge = nullptr;
-        m_pendingPort = nullptr;
-        emit connectionStateChanged(false);
+void EditorScene::setViewportRect(const QRectF& sceneRect) {
+    m_viewportRect = sceneRect;
+    if (!m_lazyLoaded || sceneRect.isEmpty()) {
+        return;
+    }
+    constexpr qreal kTile = ChunkedGraphFormat::kTileSize;
+    // Tiles are built half a tile ahead of the view but only released once
+    // they are a tile and a half away, so small pans do not thrash.
+    const QRectF wanted = sceneRect.adjusted(-kTile * 0.5, -kTile * 0.5, kTile * 0.5, kTile * 0.5);
+    const QRectF keep = sceneRect.adjusted(-kTile * 1.5, -kTile * 1.5, kTile * 1.5, kTile * 1.5);
+
+    // Items an ongoing drag or connection holds on to must survive.
+    // Loaded items are compared tile by tile, not node by node.
+    if (!m_draggingGroup && !m_previewEdge && !mouseGrabberItem()) {
+        QVector<NodeItem*> released;
+        for (auto tile = m_loadedTiles.constBegin(); tile != m_loadedTiles.constEnd(); ++tile) {
+            if (keep.intersects(ChunkedGraphFormat::tileBounds(tile.key()))) {
+                continue;
+            }
+            for (NodeItem* node : tile.value()) {
+                if (canUnloadNode(node)) {
+                    released.push_back(node);
+                }
+            }
+        }
+        for (NodeItem* node : released) {
+            unloadNode(node);
+        }
     }
-}
 
-InteractionMode EditorScene::interactionMode() const {
-    return m_mode;
+    const qint64 left = static_cast<qint64>(std::floor(wanted.left() / kTile));
+    const qint64 right = static_cast<qint64>(std::floor(wanted.right() / kTile));
+    const qint64 top = static_cast<qint64>(std::floor(wanted.top() / kTile));
+    const qint64 bottom = static_cast<qint64>(std::floor(wanted.bottom() / kTile));
+    QVector<quint64> tiles;
+    if ((right - left + 1) * (bottom - top + 1) <= m_unloadedTiles.size()) {
+        for (qint64 tx = left; tx <= right; ++tx) {
+            for (qint64 ty = top; ty <= bottom; ++ty) {
+                const quint64 tile = ChunkedGraphFormat::tileKey(QPointF((tx + 0.5) * kTile, (ty + 0.5) * kTile));
+                if (m_unloadedTiles.contains(tile)) {
+                    tiles.push_back(tile);
+                }
+            }
+        }
+    } else {
+        for (auto it = m_unloadedTiles.constBegin(); it != m_unloadedTiles.constEnd(); ++it) {
+            if (wanted.intersects(ChunkedGraphFormat::tileBounds(it.key()))) {
+                tiles.push_back(it.key());
+            }
+        }
+    }
+    for (const quint64 tile : tiles) {
+        loadTile(tile);
+    }
 }
 
-void EditorScene::setPlacementType(const QString& typeName) {
-    m_placementType = typeName;
+NodeItem* EditorScene::loadNode(const QString& nodeId) {
+    if (NodeItem* node = m_nodesById.value(nodeId, nullptr)) {
+        return node;
+    }
+    quint64 tile = 0;
+    if (!nodeTile(nodeId, &tile)) {
+        return nullptr;
+    }
+    loadTile(tile);
+    return m_nodesById.value(nodeId, nullptr);
 }
 
-void EditorScene::setEdgeRoutingMode(EdgeRoutingMode mode) {
-    if (m_edgeRoutingMode == mode) {
+void EditorScene::loadAllTiles() {
+    if (!m_lazyLoaded) {
         return;
     }
-    m_edgeRoutingMode = mode;
-    for (QGraphicsItem* item : items()) {
-        if (EdgeItem* edge = dynamic_cast<EdgeItem*>(item)) {
-            edge->setRoutingMode(mode);
-        }
+    const QList<quint64> tiles = m_unloadedTiles.keys();
+    for (const quint64 tile : tiles) {
+        loadTile(tile);
     }
-    emit graphChanged();
+    m_lazyLoaded = false;
 }
 
-EdgeRoutingMode EditorScene::edgeRoutingMode() const {
-    return m_edgeRoutingMode;
+QVector<QString> EditorScene::unloadedNodeIds() const {
+    QVector<QString> nodeIds;
+    nodeIds.reserve(m_unloadedNodeTiles.size());
+    for (auto it = m_unloadedNodeTiles.constBegin(); it != m_unloadedNodeTiles.constEnd(); ++it) {
+        nodeIds.push_back(it.key());
+    }
+    return nodeIds;
 }
 
-void EditorScene::setEdgeRoutingProfile(EdgeRoutingProfile profile) {
-    if (m_edgeRoutingProfile == profile) {
+bool EditorScene::nodePropertyText(const QString& nodeId, const QString& key, QString* value) const {
+    if (const NodeItem* node = m_nodesById.value(nodeId, nullptr)) {
+        if (!node->propertyStore().contains(key)) {
+            return false;
+        }
+        *value = node->propertyValue(key);
+        return true;
+    }
+    if (const NodeData* record = unloadedNode(nodeId)) {
+        for (const PropertyData& property : record->properties) {
+            if (property.key == key) {
+                *value = property.value;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool EditorScene::setUnloadedNodeProperty(const QString& nodeId, const QString& key, const QString& value) {
+    const auto tile = m_unloadedNodeTiles.constFind(nodeId);
+    if (tile == m_unloadedNodeTiles.constEnd()) {
+        return false;
+    }
+    auto records = m_unloadedTiles.find(tile.value());
+    if (records == m_unloadedTiles.end()) {
+        return false;
+    }
+    auto record = records->find(nodeId);
+    if (record == records->end()) {
+        return false;
+    }
+    for (PropertyData& property : record->properties) {
+        if (property.key != key) {
+            continue;
+        }
+        // Same parsing and change test as the node's PropertyStore would apply.
+        PropertyStore store;
+        store.assign({property});
+        if (!store.setText(key, value)) {
+            return false;
+        }
+        property.value = store.text(key);
+        QStringList values;
+        values.reserve(record->properties.size());
+        for (const PropertyData& each : record->properties) {
+            values.push_back(each.value);
+        }
+        m_searchIndex.upsert(record->id, record->name, record->type, values);
+        return true;
+    }
+    return false;
+}
+
+const NodeData* EditorScene::unloadedNode(const QString& nodeId) const {
+    const auto tile = m_unloadedNodeTiles.constFind(nodeId);
+    if (tile == m_unloadedNodeTiles.constEnd()) {
+        return nullptr;
+    }
+    const auto records = m_unloadedTiles.constFind(tile.value());
+    if (records == m_unloadedTiles.constEnd()) {
+        return nullptr;
+    }
+    const auto record = records->constFind(nodeId);
+    return record == records->constEnd() ? nullptr : &record.value();
+}
+
+bool EditorScene::useLazyLoad(int nodeCount, bool dagOnly) const {
+    // Cycle checks need every edge registered, so DAG documents load eagerly.
+    return m_lazyLoadThreshold > 0 && nodeCount >= m_lazyLoadThreshold && !dagOnly;
+}
+
+bool EditorScene::loadNodeRecord(const NodeData& nodeData, bool lazy) {
+    if (!lazy || !nodeData.groupId.isEmpty()) {
+        return createNodeFromData(nodeData) != nullptr;
+    }
+    NodeData record = nodeData;
+    if (record.layerId.isEmpty() || !findLayerById(record.layerId)) {
+        record.layerId = m_activeLayerId;
+    }
+    updateCountersFromData(record);
+    QStringList values;
+    values.reserve(record.properties.size());
+    for (const PropertyData& property : record.properties) {
+        values.push_back(property.value);
+    }
+    m_searchIndex.upsert(record.id, record.name, record.type, values);
+    parkNode(record);
+    return true;
+}
+
+void EditorScene::loadEdgeRecord(const EdgeData& edgeData, bool lazy) {
+    const bool fromLoaded = m_nodesById.contains(edgeData.fromNodeId);
+    const bool toLoaded = m_nodesById.contains(edgeData.toNodeId);
+    if (!lazy || (fromLoaded && toLoaded)) {
+        createEdgeFromData(edgeData);
         return;
     }
-    m_edgeRoutingProfile = profile;
-    for (QGraphicsItem* item : items()) {
-        if (EdgeItem* edge = dynamic_cast<EdgeItem*>(item)) {
-            edge->setRoutingProfile(profile);
+    if ((fromLoaded || m_unloadedNodeTiles.contains(edgeData.fromNodeId)) &&
+        (toLoaded || m_unloadedNodeTiles.contains(edgeData.toNodeId))) {
+        updateCounterFromId(edgeData.id, &m_edgeCounter);
+        parkEdge(edgeData);
+    }
+}
+
+void EditorScene::updateCountersFromData(const NodeData& nodeData) {
+    updateCounterFromId(nodeData.id, &m_nodeCounter);
+    if (!nodeData.groupId.isEmpty()) {
+        updateCounterFromId(nodeData.groupId, &m_groupCounter);
+    }
+    if (!nodeData.layerId.isEmpty()) {
+        updateCounterFromId(nodeData.layerId, &m_layerCounter);
+    }
+    for (const PortData& port : nodeData.ports) {
+        updateCounterFromId(port.id, &m_portCounter);
+    }
+}
+
+void EditorScene::parkNode(const NodeData& nodeData) {
+    const quint64 tile = ChunkedGraphFormat::tileKey(nodeData.position);
+    m_unloadedTiles[tile].insert(nodeData.id, nodeData);
+    m_unloadedNodeTiles.insert(nodeData.id, tile);
+    ++m_unloadedLayerCounts[nodeData.layerId];
+    addZValue(nodeData.z);
+}
+
+void EditorScene::parkEdge(const EdgeData& edgeData) {
+    if (m_unloadedEdges.contains(edgeData.id)) {
+        return;
+    }
+    m_unloadedEdges.insert(edgeData.id, edgeData);
+    m_unloadedEdgesByNode.insert(edgeData.fromNodeId, edgeData.id);
+    if (edgeData.toNodeId != edgeData.fromNodeId) {
+        m_unloadedEdgesByNode.insert(edgeData.toNodeId, edgeData.id);
+    }
+}
+
+EdgeData EditorScene::unparkEdge(const QString& edgeId) {
+    const EdgeData edgeData = m_unloadedEdges.take(edgeId);
+    m_unloadedEdgesByNode.remove(edgeData.fromNodeId, edgeId);
+    m_unloadedEdgesByNode.remove(edgeData.toNodeId, edgeId);
+    return edgeData;
+}
+
+void EditorScene::loadTile(quint64 tile) {
+    const QHash<QString, NodeData> records = m_unloadedTiles.take(tile);
+    if (records.isEmpty()) {
+        return;
+    }
+    m_swappingTiles = true;
+    QVector<NodeItem*> nodes;
+    nodes.reserve(records.size());
+    for (const NodeData& record : records) {
+        m_unloadedNodeTiles.remove(record.id);
+        removeZValue(record.z);
+        auto count = m_unloadedLayerCounts.find(record.layerId);
+        if (count != m_unloadedLayerCounts.end() && --count.value() <= 0) {
+            m_unloadedLayerCounts.erase(count);
+        }
+        if (NodeItem* node = createNodeFromData(record)) {
+            refreshNodeVisibility(node);
+            nodes.push_back(node);
+        }
+    }
+    for (const NodeItem* node : nodes) {
+        const QList<QString> edgeIds = m_unloadedEdgesByNode.values(node->nodeId());
+        for (const QString& edgeId : edgeIds) {
+            const auto edge = m_unloadedEdges.constFind(edgeId);
+            if (edge == m_unloadedEdges.constEnd() || !m_nodesById.contains(edge->fromNodeId) ||
+                !m_nodesById.contains(edge->toNodeId)) {
+                continue;
+            }
+            refreshEdgeVisibility(createEdgeFromData(unparkEdge(edgeId)));
+        }
+    }
+    m_swappingTiles = false;
+    if (!m_pendingSelection.isEmpty()) {
+        applyPendingSelection(nodes);
+    }
+}
+
+void EditorScene::applyPendingSelection(const QVector<NodeItem*>& nodes) {
+    QVector<NodeItem*> selected;
+    for (NodeItem* node : nodes) {
+        if (m_pendingSelection.remove(node->nodeId())) {
+            selected.push_back(node);
+        }
+    }
+    if (selected.isEmpty()) {
+        return;
+    }
+    m_applyingSelection = true;
+    for (NodeItem* node : selected) {
+        node->setSelected(true);
+    }
+    if (m_pendingSelectionEdges) {
+        for (const NodeItem* node : selected) {
+            QSet<EdgeItem*> edges;
+            collectIncidentEdges(node, &edges);
+            for (EdgeItem* edge : edges) {
+                if (edge->sourcePort() && edge->targetPort() && edge->sourcePort()->ownerNode()->isSelected() &&
+                    edge->targetPort()->ownerNode()->isSelected()) {
+                    edge->setSelected(true);
+                }
+            }
+        }
+    }
+    m_applyingSelection = false;
+}
+
+void EditorScene::invalidateGraphSnapshot() {
+    m_graphSnapshotValid = false;
+    m_graphSnapshot = GraphCsr();
+}
+
+bool EditorScene::canUnloadNode(const NodeItem* node) const {
+    if (node->isSelected() || !node->groupId().isEmpty() || m_nodeDragStartPositions.contains(node->nodeId())) {
+        return false;
+    }
+    if (m_pendingPort && m_pendingPort->ownerNode() == node) {
+        return false;
+    }
+    QSet<EdgeItem*> edges;
+    collectIncidentEdges(node, &edges);
+    for (const EdgeItem* edge : edges) {
+        if (edge->isSelected()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void EditorScene::unloadNode(NodeItem* node) {
+    m_swappingTiles = true;
+    QSet<EdgeItem*> edges;
+    collectIncidentEdges(node, &edges);
+    for (EdgeItem* edge : edges) {
+        if (edge->sourcePort() && edge->targetPort()) {
+            parkEdge(edgeDataFor(edge));
         }
+        unregisterEdge(edge);
+        removeItem(edge);
+        delete edge;
+    }
+    const NodeData record = nodeDataFor(node);
+    unregisterNode(node);
+    removeItem(node);
+    delete node;
+    parkNode(record);
+    m_swappingTiles = false;
+}
+
+EdgeItem* EditorScene::loadEdge(const QString& edgeId) {
+    if (EdgeItem* edge = m_edgesById.value(edgeId, nullptr)) {
+        return edge;
+    }
+    const auto it = m_unloadedEdges.constFind(edgeId);
+    if (it == m_unloadedEdges.constEnd()) {
+        return nullptr;
+    }
+    const QString fromNodeId = it->fromNodeId;
+    const QString toNodeId = it->toNodeId;
+    loadNode(fromNodeId);
+    loadNode(toNodeId);
+    return m_edgesById.value(edgeId, nullptr);
+}
+
+void EditorScene::loadIncidentEdges(const QString& nodeId) {
+    const QList<QString> edgeIds = m_unloadedEdgesByNode.values(nodeId);
+    for (const QString& edgeId : edgeIds) {
+        loadEdge(edgeId);
+    }
+}
+
+bool EditorScene::nodeTile(const QString& nodeId, quint64* tile) const {
+    if (const NodeItem* node = m_nodesById.value(nodeId, nullptr)) {
+        *tile = ChunkedGraphFormat::tileKey(node->scenePos());
+        return true;
+    }
+    const auto it = m_unloadedNodeTiles.constFind(nodeId);
+    if (it == m_unloadedNodeTiles.constEnd()) {
+        return false;
+    }
+    *tile = it.value();
+    return true;
+}
+
+void EditorScene::setSnapToGrid(bool enabled) {
+    m_snapToGrid = enabled;
+}
+
+bool EditorScene::snapToGrid() const {
+    return m_snapToGrid;
+}
+
+int EditorScene::gridSize() const {
+    return 20;
+}
+
+void EditorScene::setUndoStack(QUndoStack* stack) {
+    if (m_undoStack) {
+        disconnect(m_undoStack, &QUndoStack::indexChanged, this, &EditorScene::onUndoIndexChanged);
+    }
+    m_undoStack = stack;
+    m_undoIndex = stack ? stack->index() : 0;
+    if (stack) {
+        connect(stack, &QUndoStack::indexChanged, this, &EditorScene::onUndoIndexChanged);
+    }
+}
+
+void EditorScene::onUndoIndexChanged(int index) {
+    const int previous = m_undoIndex;
+    m_undoIndex = index;
+    if (!m_undoStack) {
+        return;
+    }
+
+    // Commands between the two indices were applied or undone; a push that
+    // merged into the top command leaves the index where it was.
+    const int from = (previous == index) ? index - 1 : std::min(previous, index);
+    const int to = std::min(std::max(previous, index), m_undoStack->count());
+    GraphChangeSet changes;
+    for (int c = std::max(0, from); c < to; ++c) {
+        collectCommandChanges(m_undoStack->command(c), &changes);
+    }
+    if (!changes.isEmpty()) {
+        m_unsavedChanges.unite(changes);
+        emit editCommitted(changes);
+    }
+}
+
+void EditorScene::setInteractionMode(InteractionMode mode) {
+    m_mode = mode;
+    if (m_mode != InteractionMode::Connect && m_previewEdge) {
+        removeItem(m_previewEdge);
+        delete m_previewEdge;
+        m_previewEdge = nullptr;
+        m_pendingPort = nullptr;
+        emit connectionStateChanged(false);
+    }
+}
+
+InteractionMode EditorScene::interactionMode() const {
+    return m_mode;
+}
+
+void EditorScene::setPlacementType(const QString& typeName) {
+    m_placementType = typeName;
+}
+
+void EditorScene::setEdgeRoutingMode(EdgeRoutingMode mode) {
+    if (m_edgeRoutingMode == mode) {
+        return;
+    }
+    m_edgeRoutingMode = mode;
+    for (auto it = m_edgesById.constBegin(); it != m_edgesById.constEnd(); ++it) {
+        it.value()->setRoutingMode(mode);
+    }
+    if (m_previewEdge) {
+        m_previewEdge->setRoutingMode(mode);
+    }
+    emit graphChanged();
+}
+
+EdgeRoutingMode EditorScene::edgeRoutingMode() const {
+    return m_edgeRoutingMode;
+}
+
+void EditorScene::setEdgeRoutingProfile(EdgeRoutingProfile profile) {
+    if (m_edgeRoutingProfile == profile) {
+        return;
+    }
+    m_edgeRoutingProfile = profile;
+    for (auto it = m_edgesById.constBegin(); it != m_edgesById.constEnd(); ++it) {
+        it.value()->setRoutingProfile(profile);
     }
     emit graphChanged();
 }
@@ -1283,10 +1845,8 @@ void EditorScene::setEdgeBundlePolicy(EdgeBundlePolicy policy) {
         return;
     }
     m_edgeBundlePolicy = policy;
-    for (QGraphicsItem* item : items()) {
-        if (EdgeItem* edge = dynamic_cast<EdgeItem*>(item)) {
-            edge->setBundlePolicy(policy);
-        }
+    for (auto it = m_edgesById.constBegin(); it != m_edgesById.constEnd(); ++it) {
+        it.value()->setBundlePolicy(policy);
     }
     emit graphChanged();
 }
@@ -1300,10 +1860,8 @@ void EditorScene::setEdgeBundleScope(EdgeBundleScope scope) {
         return;
     }
     m_edgeBundleScope = scope;
-    for (QGraphicsItem* item : items()) {
-        if (EdgeItem* edge = dynamic_cast<EdgeItem*>(item)) {
-            edge->setBundleScope(scope);
-        }
+    for (auto it = m_edgesById.constBegin(); it != m_edgesById.constEnd(); ++it) {
+        it.value()->setBundleScope(scope);
     }
     emit graphChanged();
 }
@@ -1318,10 +1876,8 @@ void EditorScene::setEdgeBundleSpacing(qreal spacing) {
         return;
     }
     m_edgeBundleSpacing = clamped;
-    for (QGraphicsItem* item : items()) {
-        if (EdgeItem* edge = dynamic_cast<EdgeItem*>(item)) {
-            edge->setBundleSpacing(clamped);
-        }
+    for (auto it = m_edgesById.constBegin(); it != m_edgesById.constEnd(); ++it) {
+        it.value()->setBundleSpacing(clamped);
     }
     emit graphChanged();
 }
@@ -1330,6 +1886,143 @@ qreal EditorScene::edgeBundleSpacing() const {
     return m_edgeBundleSpacing;
 }
 
+GraphCsr EditorScene::graphSnapshot() const {
+    // Tile swaps keep ids and connectivity, so only edits invalidate this.
+    if (m_graphSnapshotValid) {
+        return m_graphSnapshot;
+    }
+    QVector<QString> nodeIds;
+    QVector<QString> nodeTypes;
+    QHash<const NodeItem*, int> indexByNode;
+    QHash<QString, int> indexByUnloadedId;
+    nodeIds.reserve(nodeCount());
+    nodeTypes.reserve(nodeCount());
+    indexByNode.reserve(m_nodesById.size());
+    indexByUnloadedId.reserve(m_unloadedNodeTiles.size());
+    for (auto it = m_nodesById.constBegin(); it != m_nodesById.constEnd(); ++it) {
+        indexByNode.insert(it.value(), nodeIds.size());
+        nodeIds.push_back(it.key());
+        nodeTypes.push_back(it.value()->typeName());
+    }
+    for (auto tile = m_unloadedTiles.constBegin(); tile != m_unloadedTiles.constEnd(); ++tile) {
+        for (const NodeData& record : tile.value()) {
+            indexByUnloadedId.insert(record.id, nodeIds.size());
+            nodeIds.push_back(record.id);
+            nodeTypes.push_back(record.type);
+        }
+    }
+
+    QVector<QPair<int, int>> edges;
+    edges.reserve(edgeCount());
+    for (auto it = m_edgesById.constBegin(); it != m_edgesById.constEnd(); ++it) {
+        const EdgeItem* edge = it.value();
+        if (!edge->sourcePort() || !edge->targetPort()) {
+            continue;
+        }
+        const int from = indexByNode.value(edge->sourcePort()->ownerNode(), -1);
+        const int to = indexByNode.value(edge->targetPort()->ownerNode(), -1);
+        if (from >= 0 && to >= 0) {
+            edges.push_back(qMakePair(from, to));
+        }
+    }
+    auto indexOf = [this, &indexByNode, &indexByUnloadedId](const QString& nodeId) {
+        const NodeItem* node = m_nodesById.value(nodeId, nullptr);
+        return node ? indexByNode.value(node, -1) : indexByUnloadedId.value(nodeId, -1);
+    };
+    for (auto it = m_unloadedEdges.constBegin(); it != m_unloadedEdges.constEnd(); ++it) {
+        const int from = indexOf(it->fromNodeId);
+        const int to = indexOf(it->toNodeId);
+        if (from >= 0 && to >= 0) {
+            edges.push_back(qMakePair(from, to));
+        }
+    }
+    m_graphSnapshot = GraphCsr::build(nodeIds, nodeTypes, edges);
+    m_graphSnapshotValid = true;
+    return m_graphSnapshot;
+}
+
+QVector<NodeSearchHit> EditorScene::searchNodes(const QString& query, int limit) const {
+    return m_searchIndex.search(query, limit);
+}
+
+int EditorScene::selectConeFromSelection(GraphCsr::Direction direction, int maxHops, const QString& typeFilter) {
+    const QVector<NodeItem*> selectedNodes = collectSelectedNodes();
+    if (selectedNodes.isEmpty() && m_pendingSelection.isEmpty()) {
+        return 0;
+    }
+
+    const GraphCsr csr = graphSnapshot();
+    QVector<int> seeds;
+    seeds.reserve(selectedNodes.size() + m_pendingSelection.size());
+    for (const NodeItem* node : selectedNodes) {
+        seeds.push_back(csr.indexOf(node->nodeId()));
+    }
+    for (const QString& nodeId : m_pendingSelection) {
+        seeds.push_back(csr.indexOf(nodeId));
+    }
+    const QVector<int> cone = csr.cone(seeds, direction, maxHops, typeFilter);
+
+    QSet<NodeItem*> highlighted;
+    QSet<QString> pending = m_pendingSelection;
+    highlighted.reserve(cone.size() + selectedNodes.size());
+    for (int index : cone) {
+        const QString nodeId = csr.nodeId(index);
+        if (NodeItem* node = m_nodesById.value(nodeId, nullptr)) {
+            highlighted.insert(node);
+        } else {
+            pending.insert(nodeId);
+        }
+    }
+    const int coneSize = highlighted.size() + pending.size() - m_pendingSelection.size();
+    for (NodeItem* node : selectedNodes) {
+        highlighted.insert(node);
+    }
+
+    {
+        const QSignalBlocker blocker(this);
+        for (NodeItem* node : highlighted) {
+            node->setSelected(true);
+            if (!typeFilter.isEmpty()) {
+                continue;
+            }
+            for (const PortItem* port : node->outputPorts()) {
+                for (EdgeItem* edge : port->edges()) {
+                    if (edge->targetPort() && highlighted.contains(edge->targetPort()->ownerNode())) {
+                        edge->setSelected(true);
+                    }
+                }
+            }
+        }
+    }
+    emit selectionChanged();
+    m_pendingSelection = pending;
+    m_pendingSelectionEdges = typeFilter.isEmpty();
+    return coneSize;
+}
+
+bool EditorScene::setDagEnforced(bool enforced) {
+    if (m_dagEnforced == enforced) {
+        return true;
+    }
+    if (enforced) {
+        loadAllTiles();
+    }
+    if (enforced && !rebuildTopologicalOrder()) {
+        return false;
+    }
+    if (!enforced) {
+        m_topologicalOrder.clear();
+    }
+    m_dagEnforced = enforced;
+    emit dagEnforcedChanged(enforced);
+    emit graphChanged();
+    return true;
+}
+
+bool EditorScene::dagEnforced() const {
+    return m_dagEnforced;
+}
+
 void EditorScene::setAutoLayoutMode(AutoLayoutMode mode) {
     if (m_autoLayoutMode == mode) {
         return;
@@ -1371,18 +2064,29 @@ QString EditorScene::activeLayerId() const {
     return m_activeLayerId;
 }
 
+NodeItem* EditorScene::nodeById(const QString& nodeId) const {
+    return m_nodesById.value(nodeId, nullptr);
+}
+
+QList<NodeItem*> EditorScene::nodeItems() const {
+    return m_nodesById.values();
+}
+
+int EditorScene::nodeCount() const {
+    return m_nodesById.size() + m_unloadedNodeTiles.size();
+}
+
+EdgeItem* EditorScene::edgeById(const QString& edgeId) const {
+    return m_edgesById.value(edgeId, nullptr);
+}
+
+int EditorScene::edgeCount() const {
+    return m_edgesById.size() + m_unloadedEdges.size();
+}
+
 int EditorScene::layerNodeCount(const QString& layerId) const {
-    if (layerId.isEmpty()) {
-        return 0;
-    }
-    int count = 0;
-    for (QGraphicsItem* item : items()) {
-        const NodeItem* node = dynamic_cast<const NodeItem*>(item);
-        if (node && node->layerId() == layerId) {
-            ++count;
-        }
-    }
-    return count;
+    const auto it = m_layerMembers.constFind(layerId);
+    return (it == m_layerMembers.constEnd() ? 0 : it->size()) + m_unloadedLayerCounts.value(layerId, 0);
 }
 
 void EditorScene::mousePressEvent(QGraphicsSceneMouseEvent* event) {
@@ -1413,10 +2117,6 @@ void EditorScene::mousePressEvent(QGraphicsSceneMouseEvent* event) {
         if (QGraphicsItemGroup* group = owningGroupItem(itemAt(event->scenePos(), viewTransform))) {
             m_draggingGroup = group;
             m_draggingGroupStartPos = group->scenePos();
-            if (m_undoStack) {
-                m_draggingGroupBefore = toDocument();
-                m_draggingGroupTracked = true;
-            }
         }
     }
 
@@ -1426,13 +2126,32 @@ void EditorScene::mousePressEvent(QGraphicsSceneMouseEvent* event) {
         return;
     }
     QGraphicsScene::mousePressEvent(event);
-}
+
+    m_nodeDragStartPositions.clear();
+    m_nodeDragEdges.clear();
+    if (event->button() == Qt::LeftButton && !m_draggingGroup && !m_pendingPort) {
+        beginNodeDrag();
+    }
+}
 
 void EditorScene::mouseMoveEvent(QGraphicsSceneMouseEvent* event) {
     if (m_previewEdge) {
         m_previewEdge->setPreviewEnd(event->scenePos());
     }
+    if (m_draggingGroup && !m_draggingGroupTracked && (event->buttons() & Qt::LeftButton)) {
+        beginGroupDrag();
+    }
+    if (m_nodeDragStartPositions.isEmpty()) {
+        QGraphicsScene::mouseMoveEvent(event);
+        return;
+    }
+
+    setNodeDragEdgeUpdatesSuspended(true);
     QGraphicsScene::mouseMoveEvent(event);
+    setNodeDragEdgeUpdatesSuspended(false);
+    for (EdgeItem* edge : m_nodeDragEdges) {
+        edge->updatePath();
+    }
 }
 
 void EditorScene::mouseReleaseEvent(QGraphicsSceneMouseEvent* event) {
@@ -1446,20 +2165,17 @@ void EditorScene::mouseReleaseEvent(QGraphicsSceneMouseEvent* event) {
     }
 
     if (event->button() == Qt::LeftButton && m_draggingGroup) {
-        const bool moved = m_draggingGroup->scenePos() != m_draggingGroupStartPos;
-        if (moved) {
-            emit graphChanged();
-            if (m_undoStack && m_draggingGroupTracked) {
-                const GraphDocument after = toDocument();
-                if (!areDocumentsEquivalent(m_draggingGroupBefore, after)) {
-                    m_undoStack->push(
-                        new DocumentStateCommand(this, m_draggingGroupBefore, after, QStringLiteral("Move Group"), true));
-                }
-            }
-        }
+        finishGroupDrag();
     }
     m_draggingGroup = nullptr;
     m_draggingGroupTracked = false;
+    m_draggingGroupStartPositions.clear();
+
+    if (event->button() == Qt::LeftButton && !connectionHandled) {
+        finishNodeDrag();
+    }
+    m_nodeDragStartPositions.clear();
+    m_nodeDragEdges.clear();
 
     if (connectionHandled) {
         return;
@@ -1591,23 +2307,126 @@ void EditorScene::onSelectionChangedInternal() {
     emit selectionInfoChanged(QString(), QString(), QString(), QPointF(), 0, 0);
 }
 
-void EditorScene::onNodeDragFinished(NodeItem* node, const QPointF& oldPos, const QPointF& newPos) {
-    if (!node) {
+void EditorScene::onNodeDisplayNameChanged(NodeItem* node) {
+    if (!isRegisteredNode(node)) {
         return;
     }
-    const QPointF snapped = snapPoint(newPos);
-    if (oldPos == snapped) {
+    indexNodeForSearch(node);
+    if (!m_bulkLoading) {
+        emit nodeRenamed(node->nodeId());
+    }
+}
+
+void EditorScene::onNodeGroupIdChanged(NodeItem* node, const QString& previousGroupId) {
+    if (!isRegisteredNode(node)) {
         return;
     }
+    removeGroupMember(node, previousGroupId);
+    addGroupMember(node, node->groupId());
+    if (!m_bulkLoading) {
+        emit nodeMembershipChanged(node->nodeId());
+    }
+}
 
-    if (node->pos() != snapped) {
-        applyNodePositionInternal(node->nodeId(), snapped, true);
-    } else {
-        emit graphChanged();
+void EditorScene::onNodeLayerIdChanged(NodeItem* node, const QString& previousLayerId) {
+    if (!isRegisteredNode(node)) {
+        return;
+    }
+    removeLayerMember(node, previousLayerId);
+    addLayerMember(node, node->layerId());
+    if (!m_bulkLoading) {
+        emit nodeMembershipChanged(node->nodeId());
+    }
+}
+
+void EditorScene::onNodeZValueChanged(NodeItem* node, qreal previousZ) {
+    if (!isRegisteredNode(node)) {
+        return;
+    }
+    removeZValue(previousZ);
+    addZValue(node->zValue());
+}
+
+void EditorScene::onNodeMoved(NodeItem* node) {
+    if (m_loadedNodeTiles.contains(node)) {
+        trackNodeTile(node);
+    }
+}
+
+void EditorScene::beginNodeDrag() {
+    const QList<QGraphicsItem*> selected = selectedItems();
+    for (QGraphicsItem* item : selected) {
+        auto* node = dynamic_cast<NodeItem*>(item);
+        if (!node || !(node->flags() & QGraphicsItem::ItemIsMovable)) {
+            continue;
+        }
+        m_nodeDragStartPositions.insert(node->nodeId(), node->scenePos());
+        collectIncidentEdges(node, &m_nodeDragEdges);
+    }
+}
+
+void EditorScene::beginGroupDrag() {
+    m_draggingGroupStartPositions.clear();
+    m_draggingGroupTracked = true;
+    const QList<QGraphicsItem*> children = m_draggingGroup->childItems();
+    for (QGraphicsItem* child : children) {
+        if (const NodeItem* node = dynamic_cast<const NodeItem*>(child)) {
+            m_draggingGroupStartPositions.insert(node->nodeId(), node->scenePos());
+        }
+    }
+}
+
+void EditorScene::finishGroupDrag() {
+    if (m_draggingGroup->scenePos() == m_draggingGroupStartPos) {
+        return;
+    }
+    emit graphChanged();
+    if (!m_undoStack || !m_draggingGroupTracked) {
+        return;
     }
 
+    QHash<QString, QPointF> after;
+    for (auto it = m_draggingGroupStartPositions.constBegin(); it != m_draggingGroupStartPositions.constEnd(); ++it) {
+        if (const NodeItem* node = nodeById(it.key())) {
+            after.insert(it.key(), node->scenePos());
+        }
+    }
+    auto* command = new MultiNodeMoveCommand(this, m_draggingGroupStartPositions, after, true);
+    command->setText(QStringLiteral("Move Group"));
+    m_undoStack->push(command);
+}
+
+void EditorScene::finishNodeDrag() {
+    QHash<QString, QPointF> before;
+    QHash<QString, QPointF> after;
+    for (auto it = m_nodeDragStartPositions.constBegin(); it != m_nodeDragStartPositions.constEnd(); ++it) {
+        NodeItem* node = nodeById(it.key());
+        if (!node) {
+            continue;
+        }
+        const QPointF snapped = snapPoint(node->scenePos());
+        if (snapped == it.value()) {
+            continue;
+        }
+        before.insert(it.key(), it.value());
+        after.insert(it.key(), snapped);
+    }
+    if (after.isEmpty()) {
+        return;
+    }
+
+    applyNodeScenePositionsInternal(after, false);
+    emit graphChanged();
     if (m_undoStack) {
-        m_undoStack->push(new NodeMoveCommand(this, node->nodeId(), oldPos, snapped, true));
+        m_undoStack->push(new MultiNodeMoveCommand(this, before, after, true));
+    }
+}
+
+void EditorScene::setNodeDragEdgeUpdatesSuspended(bool suspended) {
+    for (auto it = m_nodeDragStartPositions.constBegin(); it != m_nodeDragStartPositions.constEnd(); ++it) {
+        if (NodeItem* node = nodeById(it.key())) {
+            node->setEdgeUpdatesSuspended(suspended);
+        }
     }
 }
 
@@ -1697,52 +2516,498 @@ bool EditorScene::isLayerLocked(const QString& layerId) const {
 void EditorScene::sanitizeNodeLayers() {
     ensureLayerModel();
     const QString fallback = m_activeLayerId;
-    for (QGraphicsItem* item : items()) {
-        NodeItem* node = dynamic_cast<NodeItem*>(item);
-        if (!node) {
+    const QList<QString> memberLayerIds = m_layerMembers.keys();
+    for (const QString& layerId : memberLayerIds) {
+        if (!layerId.isEmpty() && findLayerById(layerId)) {
             continue;
         }
-        if (node->layerId().isEmpty() || !findLayerById(node->layerId())) {
+        const QSet<NodeItem*> members = m_layerMembers.value(layerId);
+        for (NodeItem* node : members) {
             node->setLayerId(fallback);
         }
     }
-}
-
-NodeItem* EditorScene::findNodeByIdInternal(const QString& nodeId) const {
-    if (nodeId.isEmpty()) {
-        return nullptr;
+}
+
+void EditorScene::registerNode(NodeItem* node) {
+    if (!node) {
+        return;
+    }
+    m_nodesById.insert(node->nodeId(), node);
+    addZValue(node->zValue());
+    if (!m_swappingTiles) {
+        indexNodeForSearch(node);  // unloaded nodes stay indexed
+        invalidateGraphSnapshot();
+    }
+    if (m_dagEnforced) {
+        m_topologicalOrder.addNode(node->nodeId());
+    }
+    addLayerMember(node, node->layerId());
+    addGroupMember(node, node->groupId());
+    m_bundleIndex.insertNode(node);
+    node->setBundleLookup(&m_bundleIndex);
+    trackNodeTile(node);
+    if (!m_bulkLoading && !m_swappingTiles) {
+        emit nodeAdded(node->nodeId());
+    }
+}
+
+void EditorScene::unregisterNode(NodeItem* node) {
+    if (!isRegisteredNode(node)) {
+        return;
+    }
+    if (!m_bulkLoading && !m_swappingTiles) {
+        emit nodeAboutToBeRemoved(node->nodeId());
+    }
+    m_nodesById.remove(node->nodeId());
+    removeZValue(node->zValue());
+    if (!m_swappingTiles) {
+        m_searchIndex.remove(node->nodeId());
+        invalidateGraphSnapshot();
+    }
+    if (m_dagEnforced) {
+        m_topologicalOrder.removeNode(node->nodeId());
+    }
+    removeLayerMember(node, node->layerId());
+    removeGroupMember(node, node->groupId());
+    node->setBundleLookup(nullptr);
+    m_bundleIndex.removeNode(node);
+    untrackNodeTile(node);
+}
+
+void EditorScene::trackNodeTile(NodeItem* node) {
+    const quint64 tile = ChunkedGraphFormat::tileKey(node->scenePos());
+    const auto previous = m_loadedNodeTiles.constFind(node);
+    if (previous != m_loadedNodeTiles.constEnd() && previous.value() == tile) {
+        return;
+    }
+    untrackNodeTile(node);
+    m_loadedNodeTiles.insert(node, tile);
+    m_loadedTiles[tile].insert(node);
+}
+
+void EditorScene::untrackNodeTile(NodeItem* node) {
+    const auto tile = m_loadedNodeTiles.find(node);
+    if (tile == m_loadedNodeTiles.end()) {
+        return;
+    }
+    auto members = m_loadedTiles.find(tile.value());
+    if (members != m_loadedTiles.end()) {
+        members->remove(node);
+        if (members->isEmpty()) {
+            m_loadedTiles.erase(members);
+        }
+    }
+    m_loadedNodeTiles.erase(tile);
+}
+
+void EditorScene::indexNodeForSearch(const NodeItem* node) {
+    m_searchIndex.upsert(node->nodeId(), node->displayName(), node->typeName(), node->propertyStore().textValues());
+}
+
+bool EditorScene::isRegisteredNode(const NodeItem* node) const {
+    return node && m_nodesById.value(node->nodeId(), nullptr) == node;
+}
+
+EdgeItem* EditorScene::addEdgeInternal(const QString& edgeId,
+                                       PortItem* outputPort,
+                                       PortItem* inputPort,
+                                       QSet<EdgeItem*>* deferredReroutes) {
+    EdgeItem* edge = new EdgeItem(edgeId, outputPort);
+    edge->setRoutingMode(m_edgeRoutingMode);
+    edge->setRoutingProfile(m_edgeRoutingProfile);
+    edge->setBundlePolicy(m_edgeBundlePolicy);
+    edge->setBundleScope(m_edgeBundleScope);
+    edge->setBundleSpacing(m_edgeBundleSpacing);
+    edge->setTargetPort(inputPort);
+    addItem(edge);
+    registerEdge(edge);
+    const NodeItem* sourceNode = outputPort->ownerNode();
+    const NodeItem* targetNode = inputPort->ownerNode();
+    if (sourceNode && targetNode) {
+        for (const PortItem* port : sourceNode->outputPorts()) {
+            for (EdgeItem* existing : port->edges()) {
+                if (!existing->targetPort() || existing->targetPort()->ownerNode() != targetNode) {
+                    continue;
+                }
+                if (deferredReroutes) {
+                    deferredReroutes->insert(existing);
+                } else {
+                    existing->updatePath();
+                }
+            }
+        }
+    }
+    return edge;
+}
+
+void EditorScene::registerEdge(EdgeItem* edge) {
+    if (!edge) {
+        return;
+    }
+    m_edgesById.insert(edge->edgeId(), edge);
+    if (!m_swappingTiles) {
+        invalidateGraphSnapshot();
+    }
+    if (edge->sourcePort() && edge->targetPort()) {
+        ++m_portPairEdgeCounts[qMakePair(edge->sourcePort(), edge->targetPort())];
+        ++m_inputPortEdgeCounts[edge->targetPort()];
+        const NodeItem* sourceNode = edge->sourcePort()->ownerNode();
+        const NodeItem* targetNode = edge->targetPort()->ownerNode();
+        if (m_dagEnforced && sourceNode && targetNode &&
+            !m_topologicalOrder.addEdge(sourceNode->nodeId(), targetNode->nodeId())) {
+            // Edges restored from outside canConnect (e.g. a stale document) can break the DAG.
+            m_dagEnforced = false;
+            m_topologicalOrder.clear();
+            emit dagEnforcedChanged(false);
+        }
+    }
+}
+
+void EditorScene::unregisterEdge(EdgeItem* edge) {
+    if (!edge || m_edgesById.value(edge->edgeId(), nullptr) != edge) {
+        return;
+    }
+    m_edgesById.remove(edge->edgeId());
+    if (!m_swappingTiles) {
+        invalidateGraphSnapshot();
+    }
+    if (!edge->sourcePort() || !edge->targetPort()) {
+        return;
+    }
+    const QPair<PortItem*, PortItem*> pair = qMakePair(edge->sourcePort(), edge->targetPort());
+    auto pairIt = m_portPairEdgeCounts.find(pair);
+    if (pairIt != m_portPairEdgeCounts.end() && --pairIt.value() <= 0) {
+        m_portPairEdgeCounts.erase(pairIt);
+    }
+    auto inputIt = m_inputPortEdgeCounts.find(edge->targetPort());
+    if (inputIt != m_inputPortEdgeCounts.end() && --inputIt.value() <= 0) {
+        m_inputPortEdgeCounts.erase(inputIt);
+    }
+    const NodeItem* sourceNode = edge->sourcePort()->ownerNode();
+    const NodeItem* targetNode = edge->targetPort()->ownerNode();
+    if (m_dagEnforced && sourceNode && targetNode) {
+        m_topologicalOrder.removeEdge(sourceNode->nodeId(), targetNode->nodeId());
+    }
+}
+
+bool EditorScene::rebuildTopologicalOrder() {
+    m_topologicalOrder.clear();
+    for (auto it = m_nodesById.constBegin(); it != m_nodesById.constEnd(); ++it) {
+        m_topologicalOrder.addNode(it.key());
+    }
+    for (auto it = m_edgesById.constBegin(); it != m_edgesById.constEnd(); ++it) {
+        const EdgeItem* edge = it.value();
+        if (!edge->sourcePort() || !edge->targetPort()) {
+            continue;
+        }
+        const NodeItem* sourceNode = edge->sourcePort()->ownerNode();
+        const NodeItem* targetNode = edge->targetPort()->ownerNode();
+        if (sourceNode && targetNode &&
+            !m_topologicalOrder.addEdge(sourceNode->nodeId(), targetNode->nodeId())) {
+            m_topologicalOrder.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+PortItem* EditorScene::findPort(const QString& nodeId, const QString& portId) const {
+    const NodeItem* node = nodeById(nodeId);
+    if (!node) {
+        return nullptr;
+    }
+    for (PortItem* port : node->inputPorts()) {
+        if (port->portId() == portId) {
+            return port;
+        }
+    }
+    for (PortItem* port : node->outputPorts()) {
+        if (port->portId() == portId) {
+            return port;
+        }
+    }
+    return nullptr;
+}
+
+NodeData EditorScene::nodeDataFor(const NodeItem* node) const {
+    NodeData nodeData;
+    nodeData.id = node->nodeId();
+    nodeData.type = node->typeName();
+    nodeData.name = node->displayName();
+    nodeData.position = node->scenePos();
+    nodeData.size = node->nodeSize();
+    nodeData.rotationDegrees = node->rotation();
+    nodeData.z = node->zValue();
+    nodeData.groupId = node->groupId();
+    nodeData.layerId = node->layerId();
+
+    for (PortItem* port : node->inputPorts()) {
+        PortData p;
+        p.id = port->portId();
+        p.name = port->portName();
+        p.direction = QStringLiteral("input");
+        nodeData.ports.append(p);
+    }
+    for (PortItem* port : node->outputPorts()) {
+        PortData p;
+        p.id = port->portId();
+        p.name = port->portName();
+        p.direction = QStringLiteral("output");
+        nodeData.ports.append(p);
+    }
+    nodeData.properties = node->properties();
+    return nodeData;
+}
+
+EdgeData EditorScene::edgeDataFor(const EdgeItem* edge) const {
+    EdgeData e;
+    e.id = edge->edgeId();
+    e.fromNodeId = edge->sourcePort()->ownerNode() ? edge->sourcePort()->ownerNode()->nodeId() : QString();
+    e.fromPortId = edge->sourcePort()->portId();
+    e.toNodeId = edge->targetPort()->ownerNode() ? edge->targetPort()->ownerNode()->nodeId() : QString();
+    e.toPortId = edge->targetPort()->portId();
+    return e;
+}
+
+void EditorScene::addLayerMember(NodeItem* node, const QString& layerId) {
+    QSet<NodeItem*>& members = m_layerMembers[layerId];
+    members.insert(node);
+    if (!m_bulkLoading && !m_swappingTiles) {
+        emit layerNodeCountChanged(layerId, layerNodeCount(layerId));
+    }
+}
+
+void EditorScene::addZValue(qreal z) {
+    ++m_nodeZCounts[z];
+}
+
+void EditorScene::removeZValue(qreal z) {
+    auto it = m_nodeZCounts.find(z);
+    if (it == m_nodeZCounts.end()) {
+        return;
+    }
+    if (--it.value() <= 0) {
+        m_nodeZCounts.erase(it);
+    }
+}
+
+void EditorScene::addGroupMember(NodeItem* node, const QString& groupId) {
+    if (!groupId.isEmpty()) {
+        m_groupMembers[groupId].insert(node);
+    }
+}
+
+void EditorScene::removeGroupMember(NodeItem* node, const QString& groupId) {
+    auto it = m_groupMembers.find(groupId);
+    if (it == m_groupMembers.end()) {
+        return;
+    }
+    it->remove(node);
+    if (it->isEmpty()) {
+        m_groupMembers.erase(it);
+    }
+}
+
+void EditorScene::removeLayerMember(NodeItem* node, const QString& layerId) {
+    auto it = m_layerMembers.find(layerId);
+    if (it == m_layerMembers.end() || !it->remove(node)) {
+        return;
+    }
+    const int count = it->size();
+    if (count == 0) {
+        m_layerMembers.erase(it);
+    }
+    if (!m_bulkLoading && !m_swappingTiles) {
+        emit layerNodeCountChanged(layerId, layerNodeCount(layerId));
+    }
+}
+
+bool EditorScene::applyLayerFlagInternal(const QString& layerId, LayerFlag flag, bool value) {
+    LayerData* layer = findLayerByIdMutable(layerId);
+    if (!layer) {
+        return false;
+    }
+    bool& target = (flag == LayerFlag::Visible) ? layer->visible : layer->locked;
+    if (target == value) {
+        return false;
+    }
+    target = value;
+    refreshLayerVisibility(layerId);
+    onSelectionChangedInternal();
+    emit graphChanged();
+    emit layerStateChanged();
+    return true;
+}
+
+bool EditorScene::applyGroupCollapsedInternal(const QSet<QString>& groupIds, bool collapsed) {
+    QSet<QString> changed;
+    for (const QString& groupId : groupIds) {
+        if (!m_nodeGroups.contains(groupId) || m_collapsedGroups.contains(groupId) == collapsed) {
+            continue;
+        }
+        if (collapsed) {
+            m_collapsedGroups.insert(groupId);
+        } else {
+            m_collapsedGroups.remove(groupId);
+        }
+        changed.insert(groupId);
+    }
+    if (changed.isEmpty()) {
+        return false;
+    }
+    refreshGroupVisibility(changed);
+    emit graphChanged();
+    onSelectionChangedInternal();
+    return true;
+}
+
+bool EditorScene::applyNodeRenameInternal(const QString& nodeId, const QString& newName, bool emitGraphChangedFlag) {
+    NodeItem* target = loadNode(nodeId);
+    if (!target || target->displayName() == newName) {
+        return false;
+    }
+    target->setDisplayName(newName);
+    if (emitGraphChangedFlag) {
+        emit graphChanged();
+    }
+    if (target->isSelected()) {
+        onSelectionChangedInternal();
+    }
+    return true;
+}
+
+bool EditorScene::applyNodePositionInternal(const QString& nodeId, const QPointF& newPos, bool emitGraphChangedFlag) {
+    NodeItem* target = loadNode(nodeId);
+    if (!target || target->pos() == newPos) {
+        return false;
+    }
+    target->setPos(newPos);
+    if (emitGraphChangedFlag) {
+        emit graphChanged();
+    }
+    if (target->isSelected()) {
+        onSelectionChangedInternal();
+    }
+    return true;
+}
+
+bool EditorScene::applyNodeZValuesInternal(const QHash<QString, qreal>& zValues, bool emitGraphChangedFlag) {
+    bool changed = false;
+    for (auto it = zValues.constBegin(); it != zValues.constEnd(); ++it) {
+        NodeItem* node = loadNode(it.key());
+        if (!node || qFuzzyCompare(node->zValue() + 1.0, it.value() + 1.0)) {
+            continue;
+        }
+        node->setZValue(it.value());
+        changed = true;
+    }
+    if (changed && emitGraphChangedFlag) {
+        emit graphChanged();
+    }
+    return changed;
+}
+
+bool EditorScene::applyNodeScenePositionsInternal(const QHash<QString, QPointF>& scenePositions,
+                                                  bool emitGraphChangedFlag) {
+    // A group whose members all shift by one offset is translated as a unit so its frame follows.
+    QHash<QString, QPointF> groupOffsets;
+    QSet<QString> partialGroupIds;
+    for (auto it = scenePositions.constBegin(); it != scenePositions.constEnd(); ++it) {
+        const NodeItem* node = loadNode(it.key());
+        if (!node || !m_nodeGroups.contains(node->groupId())) {
+            continue;
+        }
+        const QPointF offset = it.value() - node->scenePos();
+        const auto found = groupOffsets.constFind(node->groupId());
+        if (found == groupOffsets.constEnd()) {
+            groupOffsets.insert(node->groupId(), offset);
+        } else if ((found.value() - offset).manhattanLength() > 0.01) {
+            partialGroupIds.insert(node->groupId());
+        }
+    }
+
+    QVector<NodeItem*> moved;
+    moved.reserve(scenePositions.size());
+    QSet<QString> translatedGroupIds;
+    for (auto it = groupOffsets.constBegin(); it != groupOffsets.constEnd(); ++it) {
+        if (partialGroupIds.contains(it.key())) {
+            continue;
+        }
+        const QSet<NodeItem*> members = m_groupMembers.value(it.key());
+        bool complete = true;
+        for (const NodeItem* member : members) {
+            complete = complete && scenePositions.contains(member->nodeId());
+        }
+        if (!complete) {
+            partialGroupIds.insert(it.key());
+            continue;
+        }
+        translatedGroupIds.insert(it.key());
+        if (it.value().manhattanLength() <= 0.01) {
+            continue;
+        }
+        for (NodeItem* member : members) {
+            member->setEdgeUpdatesSuspended(true);
+        }
+        m_nodeGroups.value(it.key())->moveBy(it.value().x(), it.value().y());
+        for (NodeItem* member : members) {
+            member->setEdgeUpdatesSuspended(false);
+            moved.push_back(member);
+        }
+    }
+
+    for (auto it = scenePositions.constBegin(); it != scenePositions.constEnd(); ++it) {
+        NodeItem* node = loadNode(it.key());
+        if (!node || translatedGroupIds.contains(node->groupId())) {
+            continue;
+        }
+        const QGraphicsItem* parent = node->parentItem();
+        const QPointF localPos = parent ? parent->mapFromScene(it.value()) : it.value();
+        if (node->pos() == localPos) {
+            continue;
+        }
+        node->setEdgeUpdatesSuspended(true);
+        node->setPos(localPos);
+        node->setEdgeUpdatesSuspended(false);
+        moved.push_back(node);
+    }
+    if (moved.isEmpty()) {
+        return false;
     }
-    for (QGraphicsItem* item : items()) {
-        if (NodeItem* node = dynamic_cast<NodeItem*>(item)) {
-            if (node->nodeId() == nodeId) {
-                return node;
-            }
-        }
+    if (!partialGroupIds.isEmpty()) {
+        syncNodeGroups(partialGroupIds);
     }
-    return nullptr;
-}
 
-bool EditorScene::applyNodeRenameInternal(const QString& nodeId, const QString& newName, bool emitGraphChangedFlag) {
-    NodeItem* target = findNodeByIdInternal(nodeId);
-    if (!target || target->displayName() == newName) {
-        return false;
+    QSet<EdgeItem*> edges;
+    bool selectionMoved = false;
+    for (NodeItem* node : moved) {
+        collectIncidentEdges(node, &edges);
+        selectionMoved = selectionMoved || node->isSelected();
     }
-    target->setDisplayName(newName);
+    for (EdgeItem* edge : edges) {
+        edge->updatePath();
+    }
+
     if (emitGraphChangedFlag) {
         emit graphChanged();
     }
-    if (target->isSelected()) {
+    if (selectionMoved) {
         onSelectionChangedInternal();
     }
     return true;
 }
 
-bool EditorScene::applyNodePositionInternal(const QString& nodeId, const QPointF& newPos, bool emitGraphChangedFlag) {
-    NodeItem* target = findNodeByIdInternal(nodeId);
-    if (!target || target->pos() == newPos) {
+bool EditorScene::applyNodePropertyInternal(const QString& nodeId,
+                                            const QString& key,
+                                            const QString& value,
+                                            bool emitGraphChangedFlag) {
+    NodeItem* target = loadNode(nodeId);
+    if (!target || !target->setPropertyValue(key, value)) {
         return false;
     }
-    target->setPos(newPos);
+    if (isRegisteredNode(target)) {
+        indexNodeForSearch(target);
+    }
     if (emitGraphChangedFlag) {
         emit graphChanged();
     }
@@ -1752,21 +3017,36 @@ bool EditorScene::applyNodePositionInternal(const QString& nodeId, const QPointF
     return true;
 }
 
-bool EditorScene::applyNodePropertyInternal(const QString& nodeId,
-                                            const QString& key,
-                                            const QString& value,
-                                            bool emitGraphChangedFlag) {
-    NodeItem* target = findNodeByIdInternal(nodeId);
-    if (!target || !target->setPropertyValue(key, value)) {
-        return false;
+int EditorScene::applyNodePropertyValuesInternal(const QString& key,
+                                                 const QHash<QString, QString>& values,
+                                                 bool emitGraphChangedFlag) {
+    int changed = 0;
+    bool selectionTouched = false;
+    for (auto it = values.constBegin(); it != values.constEnd(); ++it) {
+        NodeItem* target = m_nodesById.value(it.key(), nullptr);
+        if (!target) {
+            if (setUnloadedNodeProperty(it.key(), key, it.value())) {
+                ++changed;
+            }
+            continue;
+        }
+        if (!target->setPropertyValue(key, it.value())) {
+            continue;
+        }
+        indexNodeForSearch(target);
+        selectionTouched = selectionTouched || target->isSelected();
+        ++changed;
+    }
+    if (changed == 0) {
+        return 0;
     }
     if (emitGraphChangedFlag) {
         emit graphChanged();
     }
-    if (target->isSelected()) {
+    if (selectionTouched) {
         onSelectionChangedInternal();
     }
-    return true;
+    return changed;
 }
 
 QPointF EditorScene::snapPoint(const QPointF& p) const {
@@ -1803,34 +3083,35 @@ bool EditorScene::canConnect(PortItem* a, PortItem* b) const {
     if (inputPortHasConnection(inputPort)) {
         return false;
     }
+    const NodeItem* sourceNode = outputPort->ownerNode();
+    const NodeItem* targetNode = inputPort->ownerNode();
+    if (m_dagEnforced && sourceNode && targetNode &&
+        m_topologicalOrder.wouldCreateCycle(sourceNode->nodeId(), targetNode->nodeId())) {
+        return false;
+    }
     return true;
 }
 
 bool EditorScene::hasEdgeBetweenPorts(PortItem* outputPort, PortItem* inputPort) const {
-    if (!outputPort || !inputPort) {
-        return false;
-    }
-
-    for (QGraphicsItem* item : items()) {
-        if (EdgeItem* edge = dynamic_cast<EdgeItem*>(item)) {
-            if (edge->sourcePort() == outputPort && edge->targetPort() == inputPort) {
-                return true;
-            }
-        }
-    }
-    return false;
+    return outputPort && inputPort && m_portPairEdgeCounts.contains(qMakePair(outputPort, inputPort));
 }
 
 bool EditorScene::inputPortHasConnection(PortItem* inputPort) const {
     if (!inputPort) {
         return false;
     }
-
-    for (QGraphicsItem* item : items()) {
-        if (EdgeItem* edge = dynamic_cast<EdgeItem*>(item)) {
-            if (edge->targetPort() == inputPort && edge->sourcePort()) {
-                return true;
-            }
+    if (m_inputPortEdgeCounts.contains(inputPort)) {
+        return true;
+    }
+    const NodeItem* owner = inputPort->ownerNode();
+    if (!owner) {
+        return false;
+    }
+    const QList<QString> edgeIds = m_unloadedEdgesByNode.values(owner->nodeId());
+    for (const QString& edgeId : edgeIds) {
+        const EdgeData edge = m_unloadedEdges.value(edgeId);
+        if (edge.toNodeId == owner->nodeId() && edge.toPortId == inputPort->portId()) {
+            return true;
         }
     }
     return false;
@@ -1903,23 +3184,10 @@ QVector<NodeItem*> EditorScene::collectLayoutNodes(bool selectedOnly) const {
 }
 
 void EditorScene::clearNodeGroups() {
-    const QList<QGraphicsItemGroup*> groups = m_nodeGroups.values();
-    for (QGraphicsItemGroup* group : groups) {
-        if (!group) {
-            continue;
-        }
-        const QList<QGraphicsItem*> children = group->childItems();
-        for (QGraphicsItem* child : children) {
-            if (dynamic_cast<NodeItem*>(child)) {
-                child->setParentItem(nullptr);
-            }
-        }
-        if (group->scene() == this) {
-            removeItem(group);
-        }
-        delete group;
+    const QList<QString> groupIds = m_nodeGroups.keys();
+    for (const QString& groupId : groupIds) {
+        removeGroupItem(groupId);
     }
-    m_nodeGroups.clear();
     m_draggingGroup = nullptr;
     m_draggingGroupTracked = false;
 }
@@ -1927,111 +3195,156 @@ void EditorScene::clearNodeGroups() {
 void EditorScene::rebuildNodeGroups() {
     clearNodeGroups();
 
-    QHash<QString, QVector<NodeItem*>> groupedNodes;
-    for (QGraphicsItem* item : items()) {
-        NodeItem* node = dynamic_cast<NodeItem*>(item);
-        if (!node || node->groupId().isEmpty()) {
-            continue;
+    const QList<QString> groupIds = m_groupMembers.keys();
+    syncNodeGroups(QSet<QString>(groupIds.begin(), groupIds.end()));
+
+    for (auto it = m_collapsedGroups.begin(); it != m_collapsedGroups.end();) {
+        if (!m_nodeGroups.contains(*it)) {
+            it = m_collapsedGroups.erase(it);
+        } else {
+            ++it;
         }
-        groupedNodes[node->groupId()].push_back(node);
     }
+}
 
-    QSet<QString> validGroupIds;
-    for (auto it = groupedNodes.begin(); it != groupedNodes.end();) {
-        if (it.value().size() < 2) {
-            for (NodeItem* node : it.value()) {
-                if (node) {
-                    node->setGroupId(QString());
-                }
+void EditorScene::syncNodeGroups(const QSet<QString>& groupIds) {
+    QSet<QString> liveGroupIds;
+    QSet<NodeItem*> releasedNodes;
+    for (const QString& groupId : groupIds) {
+        if (groupId.isEmpty()) {
+            continue;
+        }
+        const QList<NodeItem*> previousChildren = removeGroupItem(groupId);
+        for (NodeItem* node : previousChildren) {
+            releasedNodes.insert(node);
+        }
+
+        const QSet<NodeItem*> members = m_groupMembers.value(groupId);
+        if (members.size() < 2) {
+            for (NodeItem* node : members) {
+                node->setGroupId(QString());
+                releasedNodes.insert(node);
             }
-            it = groupedNodes.erase(it);
+            m_collapsedGroups.remove(groupId);
             continue;
         }
-        validGroupIds.insert(it.key());
-        std::sort(it.value().begin(), it.value().end(), [](const NodeItem* a, const NodeItem* b) {
-            return a->nodeId() < b->nodeId();
-        });
-        ++it;
+        createGroupItem(groupId, members);
+        liveGroupIds.insert(groupId);
     }
 
-    for (auto it = m_collapsedGroups.begin(); it != m_collapsedGroups.end();) {
-        if (!validGroupIds.contains(*it)) {
-            it = m_collapsedGroups.erase(it);
-        } else {
-            ++it;
+    QSet<EdgeItem*> edges;
+    for (NodeItem* node : releasedNodes) {
+        if (!node->groupId().isEmpty() && liveGroupIds.contains(node->groupId())) {
+            continue;
         }
+        refreshNodeVisibility(node);
+        collectIncidentEdges(node, &edges);
     }
-
-    for (auto it = groupedNodes.begin(); it != groupedNodes.end(); ++it) {
-        const QString& groupId = it.key();
-        const QVector<NodeItem*>& nodes = it.value();
-        QList<QGraphicsItem*> members;
-        members.reserve(nodes.size());
-        for (NodeItem* node : nodes) {
-            members.push_back(node);
-        }
-
-        QGraphicsItemGroup* group = createItemGroup(members);
-        group->setHandlesChildEvents(false);
-        group->setFlag(QGraphicsItem::ItemIsSelectable, true);
-        group->setFlag(QGraphicsItem::ItemIsMovable, true);
-        group->setData(0, groupId);
-        group->setData(1, groupId);
-
-        const QRectF contentBounds = group->childrenBoundingRect();
-        const QRectF frameRect = contentBounds.adjusted(-14.0, -28.0, 14.0, 14.0);
-
-        auto* frame = new QGraphicsRectItem(frameRect, group);
-        frame->setPen(QPen(QColor(80, 120, 190), 1.2, Qt::DashLine));
-        frame->setBrush(QColor(170, 195, 235, 24));
-        frame->setAcceptedMouseButtons(Qt::NoButton);
-        frame->setFlag(QGraphicsItem::ItemIsSelectable, false);
-        frame->setFlag(QGraphicsItem::ItemIsMovable, false);
-        frame->setZValue(-1000.0);
-        frame->setData(0, QStringLiteral("group_frame"));
-
-        auto* title = new QGraphicsSimpleTextItem(QStringLiteral("Group %1").arg(groupId), group);
-        title->setBrush(QColor(64, 94, 146));
-        title->setPos(frameRect.left() + 8.0, frameRect.top() + 4.0);
-        title->setAcceptedMouseButtons(Qt::NoButton);
-        title->setFlag(QGraphicsItem::ItemIsSelectable, false);
-        title->setFlag(QGraphicsItem::ItemIsMovable, false);
-        title->setZValue(-999.0);
-        title->setData(0, QStringLiteral("group_title"));
-
-        const QRectF toggleRect(frameRect.right() - 22.0, frameRect.top() + 4.0, 14.0, 14.0);
-        auto* toggle = new QGraphicsRectItem(toggleRect, group);
-        toggle->setPen(QPen(QColor(70, 110, 176), 1.0));
-        toggle->setBrush(QColor(238, 245, 255, 220));
-        toggle->setFlag(QGraphicsItem::ItemIsSelectable, false);
-        toggle->setFlag(QGraphicsItem::ItemIsMovable, false);
-        toggle->setData(0, QStringLiteral("group_toggle"));
-        toggle->setData(1, groupId);
-        toggle->setZValue(-998.0);
-
-        auto* toggleText = new QGraphicsSimpleTextItem(QStringLiteral("-"), group);
-        toggleText->setBrush(QColor(56, 88, 146));
-        toggleText->setPos(toggleRect.left() + 4.0, toggleRect.top() - 1.0);
-        toggleText->setAcceptedMouseButtons(Qt::NoButton);
-        toggleText->setFlag(QGraphicsItem::ItemIsSelectable, false);
-        toggleText->setFlag(QGraphicsItem::ItemIsMovable, false);
-        toggleText->setData(0, QStringLiteral("group_toggle_text"));
-        toggleText->setData(1, groupId);
-        toggleText->setZValue(-997.0);
-
-        m_nodeGroups.insert(groupId, group);
-        updateCounterFromId(groupId, &m_groupCounter);
+    for (EdgeItem* edge : edges) {
+        refreshEdgeVisibility(edge);
     }
+    refreshGroupVisibility(liveGroupIds);
+}
 
-    refreshCollapsedVisibility();
+QGraphicsItemGroup* EditorScene::createGroupItem(const QString& groupId, const QSet<NodeItem*>& nodeSet) {
+    QVector<NodeItem*> nodes(nodeSet.begin(), nodeSet.end());
+    std::sort(nodes.begin(), nodes.end(), [](const NodeItem* a, const NodeItem* b) {
+        return a->nodeId() < b->nodeId();
+    });
+    QList<QGraphicsItem*> members;
+    members.reserve(nodes.size());
+    for (NodeItem* node : nodes) {
+        members.push_back(node);
+    }
+
+    QGraphicsItemGroup* group = createItemGroup(members);
+    group->setHandlesChildEvents(false);
+    group->setFlag(QGraphicsItem::ItemIsSelectable, true);
+    group->setFlag(QGraphicsItem::ItemIsMovable, true);
+    group->setData(0, groupId);
+    group->setData(1, groupId);
+
+    const QRectF contentBounds = group->childrenBoundingRect();
+    const QRectF frameRect = contentBounds.adjusted(-14.0, -28.0, 14.0, 14.0);
+
+    auto* frame = new QGraphicsRectItem(frameRect, group);
+    frame->setPen(QPen(QColor(80, 120, 190), 1.2, Qt::DashLine));
+    frame->setBrush(QColor(170, 195, 235, 24));
+    frame->setAcceptedMouseButtons(Qt::NoButton);
+    frame->setFlag(QGraphicsItem::ItemIsSelectable, false);
+    frame->setFlag(QGraphicsItem::ItemIsMovable, false);
+    frame->setZValue(-1000.0);
+    frame->setData(0, QStringLiteral("group_frame"));
+
+    auto* title = new QGraphicsSimpleTextItem(QStringLiteral("Group %1").arg(groupId), group);
+    title->setBrush(QColor(64, 94, 146));
+    title->setPos(frameRect.left() + 8.0, frameRect.top() + 4.0);
+    title->setAcceptedMouseButtons(Qt::NoButton);
+    title->setFlag(QGraphicsItem::ItemIsSelectable, false);
+    title->setFlag(QGraphicsItem::ItemIsMovable, false);
+    title->setZValue(-999.0);
+    title->setData(0, QStringLiteral("group_title"));
+
+    const QRectF toggleRect(frameRect.right() - 22.0, frameRect.top() + 4.0, 14.0, 14.0);
+    auto* toggle = new QGraphicsRectItem(toggleRect, group);
+    toggle->setPen(QPen(QColor(70, 110, 176), 1.0));
+    toggle->setBrush(QColor(238, 245, 255, 220));
+    toggle->setFlag(QGraphicsItem::ItemIsSelectable, false);
+    toggle->setFlag(QGraphicsItem::ItemIsMovable, false);
+    toggle->setData(0, QStringLiteral("group_toggle"));
+    toggle->setData(1, groupId);
+    toggle->setZValue(-998.0);
+
+    auto* toggleText = new QGraphicsSimpleTextItem(QStringLiteral("-"), group);
+    toggleText->setBrush(QColor(56, 88, 146));
+    toggleText->setPos(toggleRect.left() + 4.0, toggleRect.top() - 1.0);
+    toggleText->setAcceptedMouseButtons(Qt::NoButton);
+    toggleText->setFlag(QGraphicsItem::ItemIsSelectable, false);
+    toggleText->setFlag(QGraphicsItem::ItemIsMovable, false);
+    toggleText->setData(0, QStringLiteral("group_toggle_text"));
+    toggleText->setData(1, groupId);
+    toggleText->setZValue(-997.0);
+
+    m_nodeGroups.insert(groupId, group);
+    updateCounterFromId(groupId, &m_groupCounter);
+    return group;
+}
+
+QList<NodeItem*> EditorScene::removeGroupItem(const QString& groupId) {
+    QList<NodeItem*> releasedNodes;
+    QGraphicsItemGroup* group = m_nodeGroups.take(groupId);
+    if (!group) {
+        return releasedNodes;
+    }
+    if (m_draggingGroup == group) {
+        m_draggingGroup = nullptr;
+        m_draggingGroupTracked = false;
+    }
+    const QList<QGraphicsItem*> children = group->childItems();
+    for (QGraphicsItem* child : children) {
+        NodeItem* node = dynamic_cast<NodeItem*>(child);
+        if (!node) {
+            continue;
+        }
+        const QPointF scenePosition = node->scenePos();
+        node->setParentItem(nullptr);
+        if (node->pos() != scenePosition) {
+            node->setPos(scenePosition);
+        }
+        releasedNodes.push_back(node);
+    }
+    if (group->scene() == this) {
+        removeItem(group);
+    }
+    delete group;
+    return releasedNodes;
 }
 
 QGraphicsItemGroup* EditorScene::owningGroupItem(QGraphicsItem* item) const {
     QGraphicsItem* cursor = item;
-    const QList<QGraphicsItemGroup*> groups = m_nodeGroups.values();
     while (cursor) {
         if (QGraphicsItemGroup* group = dynamic_cast<QGraphicsItemGroup*>(cursor)) {
-            if (groups.contains(group)) {
+            if (m_nodeGroups.value(group->data(0).toString(), nullptr) == group) {
                 return group;
             }
         }
@@ -2043,7 +3356,6 @@ QGraphicsItemGroup* EditorScene::owningGroupItem(QGraphicsItem* item) const {
 QSet<QString> EditorScene::collectSelectedGroupIds() const {
     QSet<QString> groupIds;
     const QList<QGraphicsItem*> selected = selectedItems();
-    const QList<QGraphicsItemGroup*> knownGroups = m_nodeGroups.values();
     for (QGraphicsItem* item : selected) {
         if (NodeItem* node = dynamic_cast<NodeItem*>(item)) {
             if (!node->groupId().isEmpty()) {
@@ -2052,11 +3364,9 @@ QSet<QString> EditorScene::collectSelectedGroupIds() const {
             continue;
         }
         if (QGraphicsItemGroup* group = dynamic_cast<QGraphicsItemGroup*>(item)) {
-            if (knownGroups.contains(group)) {
-                const QString groupId = group->data(0).toString();
-                if (!groupId.isEmpty()) {
-                    groupIds.insert(groupId);
-                }
+            const QString groupId = group->data(0).toString();
+            if (!groupId.isEmpty() && m_nodeGroups.value(groupId, nullptr) == group) {
+                groupIds.insert(groupId);
             }
         }
     }
@@ -2066,133 +3376,365 @@ QSet<QString> EditorScene::collectSelectedGroupIds() const {
 void EditorScene::refreshCollapsedVisibility() {
     ensureLayerModel();
     sanitizeNodeLayers();
-    QHash<QString, QPointF> collapsedGroupCenters;
-    QHash<QString, bool> groupLayerVisible;
-    QHash<QString, bool> groupHasLockedNode;
+    for (auto it = m_nodesById.constBegin(); it != m_nodesById.constEnd(); ++it) {
+        refreshNodeVisibility(it.value());
+    }
     for (QGraphicsItem* item : items()) {
-        NodeItem* node = dynamic_cast<NodeItem*>(item);
-        if (!node) {
-            continue;
-        }
-        const bool layerVisible = isLayerVisible(node->layerId());
-        const bool layerLocked = isLayerLocked(node->layerId());
-        const bool collapsed = !node->groupId().isEmpty() && m_collapsedGroups.contains(node->groupId());
-        const bool visible = layerVisible && !collapsed;
-        node->setVisible(visible);
-        node->setFlag(QGraphicsItem::ItemIsMovable, !layerLocked);
-        node->setFlag(QGraphicsItem::ItemIsSelectable, !layerLocked);
-        if ((collapsed || layerLocked || !layerVisible) && node->isSelected()) {
-            node->setSelected(false);
+        if (EdgeItem* edge = dynamic_cast<EdgeItem*>(item)) {
+            refreshEdgeVisibility(edge);
         }
+    }
+    const QList<QString> groupIds = m_nodeGroups.keys();
+    for (const QString& groupId : groupIds) {
+        refreshGroupDecoration(groupId);
+    }
+}
+
+void EditorScene::refreshLayerVisibility(const QString& layerId) {
+    const QSet<NodeItem*> members = m_layerMembers.value(layerId);
+    QSet<EdgeItem*> edges;
+    QSet<QString> groupIds;
+    for (NodeItem* node : members) {
+        refreshNodeVisibility(node);
+        collectIncidentEdges(node, &edges);
         if (!node->groupId().isEmpty()) {
-            if (!groupLayerVisible.contains(node->groupId())) {
-                groupLayerVisible.insert(node->groupId(), false);
-            }
-            groupLayerVisible[node->groupId()] = groupLayerVisible.value(node->groupId()) || layerVisible;
+            groupIds.insert(node->groupId());
+        }
+    }
+    for (EdgeItem* edge : edges) {
+        refreshEdgeVisibility(edge);
+    }
+    for (const QString& groupId : groupIds) {
+        refreshGroupDecoration(groupId);
+    }
+}
+
+void EditorScene::refreshGroupVisibility(const QSet<QString>& groupIds) {
+    QSet<EdgeItem*> edges;
+    for (const QString& groupId : groupIds) {
+        const QSet<NodeItem*> members = m_groupMembers.value(groupId);
+        for (NodeItem* node : members) {
+            refreshNodeVisibility(node);
+            collectIncidentEdges(node, &edges);
+        }
+    }
+    for (EdgeItem* edge : edges) {
+        refreshEdgeVisibility(edge);
+    }
+    for (const QString& groupId : groupIds) {
+        refreshGroupDecoration(groupId);
+    }
+}
+
+void EditorScene::refreshNodeVisibility(NodeItem* node) {
+    const bool layerVisible = isLayerVisible(node->layerId());
+    const bool layerLocked = isLayerLocked(node->layerId());
+    const bool collapsed = !node->groupId().isEmpty() && m_collapsedGroups.contains(node->groupId());
+    node->setVisible(layerVisible && !collapsed);
+    node->setFlag(QGraphicsItem::ItemIsMovable, !layerLocked);
+    node->setFlag(QGraphicsItem::ItemIsSelectable, !layerLocked);
+    if ((collapsed || layerLocked || !layerVisible) && node->isSelected()) {
+        node->setSelected(false);
+    }
+}
+
+void EditorScene::refreshEdgeVisibility(EdgeItem* edge) {
+    if (!edge || !edge->sourcePort() || !edge->targetPort()) {
+        return;
+    }
+    const NodeItem* sourceNode = edge->sourcePort()->ownerNode();
+    const NodeItem* targetNode = edge->targetPort()->ownerNode();
+    if (!sourceNode || !targetNode) {
+        return;
+    }
+    const QString sourceGroupId = sourceNode->groupId();
+    const QString targetGroupId = targetNode->groupId();
+    const bool sourceLayerVisible = isLayerVisible(sourceNode->layerId());
+    const bool targetLayerVisible = isLayerVisible(targetNode->layerId());
+    const bool sourceCollapsed = !sourceGroupId.isEmpty() && m_collapsedGroups.contains(sourceGroupId);
+    const bool targetCollapsed = !targetGroupId.isEmpty() && m_collapsedGroups.contains(targetGroupId);
+    const bool hiddenByLayer = !sourceLayerVisible || !targetLayerVisible;
+    const bool hiddenByCollapsedGroup = sourceCollapsed && targetCollapsed && sourceGroupId == targetGroupId;
+    const bool hidden = hiddenByLayer || hiddenByCollapsedGroup;
+
+    edge->setVisible(!hidden);
+    if (hidden && edge->isSelected()) {
+        edge->setSelected(false);
+    }
+    if (hidden) {
+        edge->setPassthrough(false);
+        edge->clearEndpointOverrides();
+        return;
+    }
+
+    if (sourceCollapsed) {
+        edge->setSourceEndpointOverride(collapsedGroupAnchor(sourceGroupId, sourceNode));
+    } else {
+        edge->clearSourceEndpointOverride();
+    }
+
+    if (targetCollapsed) {
+        edge->setTargetEndpointOverride(collapsedGroupAnchor(targetGroupId, targetNode));
+    } else {
+        edge->clearTargetEndpointOverride();
+    }
 
-            if (!groupHasLockedNode.contains(node->groupId())) {
-                groupHasLockedNode.insert(node->groupId(), false);
+    edge->setPassthrough(sourceCollapsed || targetCollapsed);
+}
+
+void EditorScene::refreshGroupDecoration(const QString& groupId) {
+    QGraphicsItemGroup* group = m_nodeGroups.value(groupId, nullptr);
+    if (!group) {
+        return;
+    }
+    const QSet<NodeItem*> members = m_groupMembers.value(groupId);
+    bool visible = members.isEmpty();
+    bool hasLockedNode = false;
+    for (const NodeItem* node : members) {
+        visible = visible || isLayerVisible(node->layerId());
+        hasLockedNode = hasLockedNode || isLayerLocked(node->layerId());
+    }
+    group->setVisible(visible);
+    group->setFlag(QGraphicsItem::ItemIsMovable, !hasLockedNode);
+    if (!visible && group->isSelected()) {
+        group->setSelected(false);
+    }
+    const bool collapsed = m_collapsedGroups.contains(groupId);
+    const QList<QGraphicsItem*> children = group->childItems();
+    for (QGraphicsItem* child : children) {
+        const QString tag = child->data(0).toString();
+        if (tag == QStringLiteral("group_frame")) {
+            if (QGraphicsRectItem* frame = dynamic_cast<QGraphicsRectItem*>(child)) {
+                frame->setPen(QPen(collapsed ? QColor(32, 92, 182) : QColor(80, 120, 190),
+                                   collapsed ? 1.6 : 1.2,
+                                   Qt::DashLine));
+                frame->setBrush(collapsed ? QColor(145, 181, 233, 52) : QColor(170, 195, 235, 24));
+            }
+        } else if (tag == QStringLiteral("group_title")) {
+            if (QGraphicsSimpleTextItem* title = dynamic_cast<QGraphicsSimpleTextItem*>(child)) {
+                title->setText(collapsed ? QStringLiteral("Group %1 (collapsed)").arg(groupId)
+                                         : QStringLiteral("Group %1").arg(groupId));
+            }
+        } else if (tag == QStringLiteral("group_toggle")) {
+            if (QGraphicsRectItem* toggle = dynamic_cast<QGraphicsRectItem*>(child)) {
+                toggle->setPen(QPen(collapsed ? QColor(44, 104, 188) : QColor(70, 110, 176), 1.0));
+                toggle->setBrush(collapsed ? QColor(225, 237, 255, 240) : QColor(238, 245, 255, 220));
+            }
+        } else if (tag == QStringLiteral("group_toggle_text")) {
+            if (QGraphicsSimpleTextItem* text = dynamic_cast<QGraphicsSimpleTextItem*>(child)) {
+                text->setText(collapsed ? QStringLiteral("+") : QStringLiteral("-"));
             }
-            groupHasLockedNode[node->groupId()] = groupHasLockedNode.value(node->groupId()) || layerLocked;
         }
-        if (collapsed) {
-            if (!collapsedGroupCenters.contains(node->groupId())) {
-                if (QGraphicsItemGroup* group = m_nodeGroups.value(node->groupId(), nullptr)) {
-                    collapsedGroupCenters.insert(node->groupId(), group->sceneBoundingRect().center());
-                } else {
-                    collapsedGroupCenters.insert(node->groupId(), node->sceneBoundingRect().center());
+    }
+}
+
+void EditorScene::collectIncidentEdges(const NodeItem* node, QSet<EdgeItem*>* edges) const {
+    if (!node || !edges) {
+        return;
+    }
+    for (const PortItem* port : node->inputPorts()) {
+        for (EdgeItem* edge : port->edges()) {
+            edges->insert(edge);
+        }
+    }
+    for (const PortItem* port : node->outputPorts()) {
+        for (EdgeItem* edge : port->edges()) {
+            edges->insert(edge);
+        }
+    }
+}
+
+void EditorScene::collectBundleSiblings(const EdgeItem* edge, QSet<EdgeItem*>* edges) const {
+    if (!edge || !edges || !edge->sourcePort() || !edge->targetPort()) {
+        return;
+    }
+    if (edge->bundleScope() == EdgeBundleScope::Global) {
+        const NodeItem* sourceNode = edge->sourcePort()->ownerNode();
+        if (!sourceNode) {
+            return;
+        }
+        for (const PortItem* port : sourceNode->outputPorts()) {
+            for (EdgeItem* other : port->edges()) {
+                if (other != edge && other->isBundleSiblingOf(edge)) {
+                    edges->insert(other);
                 }
             }
         }
+        return;
+    }
+    // Layer and group bundles come from the nodes sharing the source's bucket.
+    const QVector<const EdgeItem*> candidates = m_bundleIndex.bundleCandidates(edge);
+    for (const EdgeItem* candidate : candidates) {
+        EdgeItem* other = m_edgesById.value(candidate->edgeId(), nullptr);
+        if (other && other != edge && other->isBundleSiblingOf(edge)) {
+            edges->insert(other);
+        }
     }
+}
 
-    for (QGraphicsItem* item : items()) {
+void EditorScene::collectCorridorEdges(const QRectF& sceneRect, QSet<EdgeItem*>* edges) const {
+    if (!edges || m_edgeRoutingMode != EdgeRoutingMode::ObstacleAvoiding) {
+        return;
+    }
+    const QRectF corridor =
+        sceneRect.adjusted(-kRouteCorridorPadding, -kRouteCorridorPadding, kRouteCorridorPadding, kRouteCorridorPadding);
+    const QList<QGraphicsItem*> hits = items(corridor, Qt::IntersectsItemBoundingRect);
+    for (QGraphicsItem* item : hits) {
         EdgeItem* edge = dynamic_cast<EdgeItem*>(item);
-        if (!edge || !edge->sourcePort() || !edge->targetPort()) {
-            continue;
+        if (edge && m_edgesById.value(edge->edgeId(), nullptr) == edge) {
+            edges->insert(edge);
         }
-        const NodeItem* sourceNode = edge->sourcePort()->ownerNode();
-        const NodeItem* targetNode = edge->targetPort()->ownerNode();
-        if (!sourceNode || !targetNode) {
+    }
+}
+
+bool EditorScene::applyDeleteInternal(const QSet<QString>& nodeIds, const QSet<QString>& edgeIds, bool emitGraphChangedFlag) {
+    QVector<NodeItem*> nodes;
+    QSet<EdgeItem*> edges;
+    QSet<QString> affectedGroupIds;
+    for (const QString& nodeId : nodeIds) {
+        NodeItem* node = loadNode(nodeId);
+        if (!node) {
             continue;
         }
-        const QString sourceGroupId = sourceNode->groupId();
-        const QString targetGroupId = targetNode->groupId();
-        const bool sourceLayerVisible = isLayerVisible(sourceNode->layerId());
-        const bool targetLayerVisible = isLayerVisible(targetNode->layerId());
-        const bool sourceCollapsed = !sourceGroupId.isEmpty() && m_collapsedGroups.contains(sourceGroupId);
-        const bool targetCollapsed = !targetGroupId.isEmpty() && m_collapsedGroups.contains(targetGroupId);
-        const bool hiddenByLayer = !sourceLayerVisible || !targetLayerVisible;
-        const bool hiddenByCollapsedGroup = sourceCollapsed && targetCollapsed && sourceGroupId == targetGroupId;
-        const bool hidden = hiddenByLayer || hiddenByCollapsedGroup;
-
-        edge->setVisible(!hidden);
-        if (hidden && edge->isSelected()) {
-            edge->setSelected(false);
-        }
-        if (hidden) {
-            edge->setPassthrough(false);
-            edge->clearEndpointOverrides();
-            continue;
+        loadIncidentEdges(nodeId);
+        nodes.push_back(node);
+        collectIncidentEdges(node, &edges);
+        if (!node->groupId().isEmpty()) {
+            affectedGroupIds.insert(node->groupId());
         }
-
-        if (sourceCollapsed) {
-            const QPointF sourceAnchor = collapsedGroupCenters.value(sourceGroupId, sourceNode->sceneBoundingRect().center());
-            edge->setSourceEndpointOverride(sourceAnchor);
-        } else {
-            edge->clearSourceEndpointOverride();
+    }
+    for (const QString& edgeId : edgeIds) {
+        if (EdgeItem* edge = loadEdge(edgeId)) {
+            edges.insert(edge);
         }
+    }
+    if (nodes.isEmpty() && edges.isEmpty()) {
+        return false;
+    }
 
-        if (targetCollapsed) {
-            const QPointF targetAnchor = collapsedGroupCenters.value(targetGroupId, targetNode->sceneBoundingRect().center());
-            edge->setTargetEndpointOverride(targetAnchor);
-        } else {
-            edge->clearTargetEndpointOverride();
+    QSet<EdgeItem*> reroute;
+    for (EdgeItem* edge : edges) {
+        collectBundleSiblings(edge, &reroute);
+    }
+    for (NodeItem* node : nodes) {
+        collectCorridorEdges(node->sceneBoundingRect(), &reroute);
+    }
+
+    QSet<NodeItem*> survivors;
+    for (const QString& groupId : affectedGroupIds) {
+        survivors.unite(m_groupMembers.value(groupId));
+    }
+    for (NodeItem* node : nodes) {
+        survivors.remove(node);
+        unregisterNode(node);
+    }
+    for (EdgeItem* edge : edges) {
+        reroute.remove(edge);
+        unregisterEdge(edge);
+        removeItem(edge);
+        delete edge;
+    }
+    for (NodeItem* node : nodes) {
+        removeItem(node);
+        delete node;
+    }
+
+    syncNodeGroups(affectedGroupIds);
+    for (NodeItem* node : survivors) {
+        if (!node->groupId().isEmpty()) {
+            continue;
         }
+        QSet<EdgeItem*> released;
+        collectIncidentEdges(node, &released);
+        for (EdgeItem* edge : released) {
+            reroute.insert(edge);
+            collectBundleSiblings(edge, &reroute);
+        }
+    }
+    for (EdgeItem* edge : reroute) {
+        edge->updatePath();
+    }
 
-        edge->setPassthrough(sourceCollapsed || targetCollapsed);
+    if (emitGraphChangedFlag) {
+        emit graphChanged();
     }
+    return true;
+}
 
-    for (auto it = m_nodeGroups.constBegin(); it != m_nodeGroups.constEnd(); ++it) {
-        const QString& groupId = it.key();
-        QGraphicsItemGroup* group = it.value();
-        if (!group) {
+bool EditorScene::applyRestoreInternal(const QVector<NodeData>& nodes,
+                                       const QVector<EdgeData>& edges,
+                                       const QHash<QString, QString>& survivorGroupIds,
+                                       const QSet<QString>& collapsedGroupIds,
+                                       bool emitGraphChangedFlag) {
+    QVector<NodeItem*> restoredNodes;
+    QSet<QString> affectedGroupIds;
+    for (const NodeData& nodeData : nodes) {
+        if (loadNode(nodeData.id)) {
             continue;
         }
-        const bool visible = groupLayerVisible.value(groupId, true);
-        group->setVisible(visible);
-        group->setFlag(QGraphicsItem::ItemIsMovable, !groupHasLockedNode.value(groupId, false));
-        if (!visible && group->isSelected()) {
-            group->setSelected(false);
-        }
-        const bool collapsed = m_collapsedGroups.contains(groupId);
-        const QList<QGraphicsItem*> children = group->childItems();
-        for (QGraphicsItem* child : children) {
-            const QString tag = child->data(0).toString();
-            if (tag == QStringLiteral("group_frame")) {
-                if (QGraphicsRectItem* frame = dynamic_cast<QGraphicsRectItem*>(child)) {
-                    frame->setPen(QPen(collapsed ? QColor(32, 92, 182) : QColor(80, 120, 190),
-                                       collapsed ? 1.6 : 1.2,
-                                       Qt::DashLine));
-                    frame->setBrush(collapsed ? QColor(145, 181, 233, 52) : QColor(170, 195, 235, 24));
-                }
-            } else if (tag == QStringLiteral("group_title")) {
-                if (QGraphicsSimpleTextItem* title = dynamic_cast<QGraphicsSimpleTextItem*>(child)) {
-                    title->setText(collapsed ? QStringLiteral("Group %1 (collapsed)").arg(groupId)
-                                             : QStringLiteral("Group %1").arg(groupId));
-                }
-            } else if (tag == QStringLiteral("group_toggle")) {
-                if (QGraphicsRectItem* toggle = dynamic_cast<QGraphicsRectItem*>(child)) {
-                    toggle->setPen(QPen(collapsed ? QColor(44, 104, 188) : QColor(70, 110, 176), 1.0));
-                    toggle->setBrush(collapsed ? QColor(225, 237, 255, 240) : QColor(238, 245, 255, 220));
-                }
-            } else if (tag == QStringLiteral("group_toggle_text")) {
-                if (QGraphicsSimpleTextItem* text = dynamic_cast<QGraphicsSimpleTextItem*>(child)) {
-                    text->setText(collapsed ? QStringLiteral("+") : QStringLiteral("-"));
-                }
+        if (NodeItem* node = createNodeFromData(nodeData)) {
+            restoredNodes.push_back(node);
+            if (!node->groupId().isEmpty()) {
+                affectedGroupIds.insert(node->groupId());
             }
         }
     }
+    for (auto it = survivorGroupIds.constBegin(); it != survivorGroupIds.constEnd(); ++it) {
+        if (NodeItem* node = loadNode(it.key())) {
+            node->setGroupId(it.value());
+            affectedGroupIds.insert(it.value());
+        }
+    }
+    for (const QString& groupId : collapsedGroupIds) {
+        m_collapsedGroups.insert(groupId);
+    }
+
+    QVector<EdgeItem*> restoredEdges;
+    for (const EdgeData& edgeData : edges) {
+        if (loadEdge(edgeData.id)) {
+            continue;
+        }
+        loadNode(edgeData.fromNodeId);
+        loadNode(edgeData.toNodeId);
+        if (EdgeItem* edge = createEdgeFromData(edgeData)) {
+            restoredEdges.push_back(edge);
+        }
+    }
+    if (restoredNodes.isEmpty() && restoredEdges.isEmpty() && affectedGroupIds.isEmpty()) {
+        return false;
+    }
+
+    syncNodeGroups(affectedGroupIds);
+    QSet<EdgeItem*> reroute;
+    for (NodeItem* node : restoredNodes) {
+        if (node->groupId().isEmpty()) {
+            refreshNodeVisibility(node);
+        }
+        collectCorridorEdges(node->sceneBoundingRect(), &reroute);
+    }
+    for (EdgeItem* edge : restoredEdges) {
+        refreshEdgeVisibility(edge);
+        reroute.insert(edge);
+        collectBundleSiblings(edge, &reroute);
+    }
+    for (auto it = survivorGroupIds.constBegin(); it != survivorGroupIds.constEnd(); ++it) {
+        collectIncidentEdges(nodeById(it.key()), &reroute);
+    }
+    for (EdgeItem* edge : reroute) {
+        edge->updatePath();
+    }
+
+    if (emitGraphChangedFlag) {
+        emit graphChanged();
+    }
+    return true;
+}
+
+QPointF EditorScene::collapsedGroupAnchor(const QString& groupId, const NodeItem* fallbackNode) const {
+    if (const QGraphicsItemGroup* group = m_nodeGroups.value(groupId, nullptr)) {
+        return group->sceneBoundingRect().center();
+    }
+    return fallbackNode->sceneBoundingRect().center();
 }
 
 bool EditorScene::applyAutoLayout(const QVector<NodeItem*>& nodes) {
@@ -2243,9 +3785,9 @@ bool EditorScene::applyLayeredAutoLayout(const QVector<NodeItem*>& nodes, qreal
     QVector<int> indegree(nodes.size(), 0);
     QSet<quint64> edgeDedup;
 
-    for (QGraphicsItem* item : items()) {
-        EdgeItem* edge = dynamic_cast<EdgeItem*>(item);
-        if (!edge || !edge->sourcePort() || !edge->targetPort()) {
+    for (auto it = m_edgesById.constBegin(); it != m_edgesById.constEnd(); ++it) {
+        const EdgeItem* edge = it.value();
+        if (!edge->sourcePort() || !edge->targetPort()) {
             continue;
         }
         NodeItem* fromNode = edge->sourcePort()->ownerNode();
@@ -2282,33 +3824,52 @@ bool EditorScene::applyLayeredAutoLayout(const QVector<NodeItem*>& nodes, qreal
         return nodes[lhs]->nodeId() < nodes[rhs]->nodeId();
     };
 
-    QVector<int> frontier;
-    frontier.reserve(nodes.size());
-    for (int i = 0; i < indegree.size(); ++i) {
-        if (indegree[i] == 0) {
-            frontier.push_back(i);
-        }
-    }
-    std::sort(frontier.begin(), frontier.end(), compareNodeOrder);
-
     QVector<int> layer(nodes.size(), 0);
     QVector<bool> processed(nodes.size(), false);
-
-    int head = 0;
     int processedCount = 0;
-    while (head < frontier.size()) {
-        const int current = frontier[head++];
-        if (processed[current]) {
-            continue;
+
+    if (m_dagEnforced) {
+        // The maintained order is already topological, so relax longest paths along it directly.
+        QVector<int> ordered;
+        ordered.reserve(nodeIndex.size());
+        for (auto it = nodeIndex.constBegin(); it != nodeIndex.constEnd(); ++it) {
+            ordered.push_back(it.value());
+        }
+        std::sort(ordered.begin(), ordered.end(), [this, &nodes](int lhs, int rhs) {
+            return m_topologicalOrder.position(nodes[lhs]->nodeId()) < m_topologicalOrder.position(nodes[rhs]->nodeId());
+        });
+        for (int current : ordered) {
+            processed[current] = true;
+            ++processedCount;
+            for (int next : outgoing[current]) {
+                layer[next] = std::max(layer[next], layer[current] + 1);
+            }
+        }
+    } else {
+        QVector<int> frontier;
+        frontier.reserve(nodes.size());
+        for (int i = 0; i < indegree.size(); ++i) {
+            if (indegree[i] == 0) {
+                frontier.push_back(i);
+            }
         }
-        processed[current] = true;
-        ++processedCount;
+        std::sort(frontier.begin(), frontier.end(), compareNodeOrder);
 
-        for (int next : outgoing[current]) {
-            layer[next] = std::max(layer[next], layer[current] + 1);
-            --indegree[next];
-            if (indegree[next] == 0) {
-                frontier.push_back(next);
+        int head = 0;
+        while (head < frontier.size()) {
+            const int current = frontier[head++];
+            if (processed[current]) {
+                continue;
+            }
+            processed[current] = true;
+            ++processedCount;
+
+            for (int next : outgoing[current]) {
+                layer[next] = std::max(layer[next], layer[current] + 1);
+                --indegree[next];
+                if (indegree[next] == 0) {
+                    frontier.push_back(next);
+                }
             }
         }
     }
@@ -2505,7 +4066,11 @@ NodeItem* EditorScene::buildNode(const QString& nodeId,
                                  const QVector<PropertyData>& properties) {
     NodeItem* node = new NodeItem(nodeId, typeName, displayName, size);
     node->setProperties(properties);
-    connect(node, &NodeItem::nodeDragFinished, this, &EditorScene::onNodeDragFinished);
+    connect(node, &NodeItem::displayNameChanged, this, &EditorScene::onNodeDisplayNameChanged);
+    connect(node, &NodeItem::groupIdChanged, this, &EditorScene::onNodeGroupIdChanged);
+    connect(node, &NodeItem::layerIdChanged, this, &EditorScene::onNodeLayerIdChanged);
+    connect(node, &NodeItem::zValueChanged, this, &EditorScene::onNodeZValueChanged);
+    connect(node, &NodeItem::nodeMoved, this, &EditorScene::onNodeMoved);
     for (const PortData& port : ports) {
         const PortDirection dir =
             port.direction.compare(QStringLiteral("output"), Qt::CaseInsensitive) == 0 ? PortDirection::Output
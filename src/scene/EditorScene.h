@@ -1,20 +1,38 @@
 #pragma once
 
 #include "items/EdgeItem.h"
+#include "model/DynamicTopologicalOrder.h"
+#include "model/GraphCsr.h"
 #include "model/GraphDocument.h"
+#include "model/GraphJournal.h"
+#include "model/NodeSearchIndex.h"
+#include "scene/EdgeBundleIndex.h"
 
 #include <QGraphicsScene>
 #include <QHash>
+#include <QList>
+#include <QMap>
+#include <QMultiHash>
+#include <QPair>
 #include <QPointF>
+#include <QRectF>
 #include <QSet>
 #include <QString>
 
 class QUndoStack;
+class BinaryGraphView;
 class NodeItem;
 class PortItem;
 class NodeMoveCommand;
+class MultiNodeMoveCommand;
+class NodeZOrderCommand;
+class DeleteItemsCommand;
+class ConnectEdgesCommand;
 class NodeRenameCommand;
 class NodePropertyCommand;
+class MultiNodePropertyCommand;
+class LayerFlagCommand;
+class GroupCollapseCommand;
 class QGraphicsItemGroup;
 class QGraphicsSceneContextMenuEvent;
 
@@ -29,6 +47,11 @@ enum class AutoLayoutMode {
     Grid
 };
 
+enum class LayerFlag {
+    Visible,
+    Locked
+};
+
 class EditorScene : public QGraphicsScene {
     Q_OBJECT
 
@@ -41,10 +64,16 @@ public:
 
     NodeItem* createNodeWithUndo(const QString& typeName, const QPointF& scenePos);
     EdgeItem* createEdgeWithUndo(PortItem* outputPort, PortItem* inputPort);
+    QVector<EdgeItem*> connectMany(const QVector<QPair<PortItem*, PortItem*>>& connections);
+    QVector<EdgeItem*> connectManyWithUndo(const QVector<QPair<PortItem*, PortItem*>>& connections);
     void deleteSelectionWithUndo();
     bool renameNodeWithUndo(const QString& nodeId, const QString& newName);
     bool moveNodeWithUndo(const QString& nodeId, const QPointF& newPos);
+    bool moveNodesWithUndo(const QHash<QString, QPointF>& scenePositions);
     bool setNodePropertyWithUndo(const QString& nodeId, const QString& key, const QString& value);
+    int setNodesPropertyWithUndo(const QVector<QString>& nodeIds, const QString& key, const QString& value);
+    int setSelectionPropertyWithUndo(const QString& key, const QString& value);
+    int setTypePropertyWithUndo(const QString& typeName, const QString& key, const QString& value);
     bool autoLayoutWithUndo(bool selectedOnly = true);
     bool rotateSelectionWithUndo(qreal deltaDegrees);
     bool bringSelectionToFrontWithUndo();
@@ -70,6 +99,45 @@ public:
 
     GraphDocument toDocument() const;
     bool fromDocument(const GraphDocument& document);
+    // Builds the scene straight from mapped `.edab` records. The view must
+    // hold a current-schema document; legacy files go through fromDocument().
+    bool fromBinaryView(const BinaryGraphView& view);
+    // Current state of the given entities, as recorded by the edit journal.
+    // Ids no longer in the scene are reported as removed.
+    GraphDelta deltaFor(const GraphChangeSet& changes) const;
+    // Everything toDocument() returns except nodes and edges.
+    GraphDocument documentSettings() const;
+
+    // Entities touched by undo stack steps since the last takeUnsavedChanges().
+    // Until the first take, and after requireFullSave() (the graph changed
+    // outside the undo stack), only a full save captures the document.
+    GraphChangeSet takeUnsavedChanges();
+    // Puts back changes taken for a save that failed.
+    void restoreUnsavedChanges(const GraphChangeSet& changes, bool fullSaveRequired);
+    bool fullSaveRequired() const;
+    void requireFullSave();
+    // Chunk tiles (see ChunkedGraphFormat) the given entities occupy now.
+    QSet<quint64> chunkTilesOf(const GraphChangeSet& changes) const;
+    // Complete current content of each tile, including empty ones.
+    QHash<quint64, GraphDocument> chunkTileContents(const QSet<quint64>& tiles) const;
+
+    // Lazy loading: documents with at least `nodeCount` nodes (0 disables)
+    // keep nodes as records and build items only for the tiles around the
+    // viewport. Grouped nodes always get items. Lookups by id, search, counts,
+    // toDocument() and the undo commands cover unloaded nodes too.
+    void setLazyLoadThreshold(int nodeCount);
+    int lazyLoadThreshold() const;
+    bool isLazyLoaded() const;
+    int loadedNodeCount() const;
+    // Builds the tiles around `sceneRect` and releases items of tiles well
+    // outside it; selected, grouped and dragged nodes are kept.
+    void setViewportRect(const QRectF& sceneRect);
+    // Item of a node, building its tile first if needed.
+    NodeItem* loadNode(const QString& nodeId);
+    // Builds every remaining tile and ends lazy loading for this document.
+    void loadAllTiles();
+    QVector<QString> unloadedNodeIds() const;
+    const NodeData* unloadedNode(const QString& nodeId) const;
 
     void setSnapToGrid(bool enabled);
     bool snapToGrid() const;
@@ -93,9 +161,23 @@ public:
     void setAutoLayoutSpacing(qreal horizontal, qreal vertical);
     qreal autoLayoutHorizontalSpacing() const;
     qreal autoLayoutVerticalSpacing() const;
+    bool setDagEnforced(bool enforced);
+    bool dagEnforced() const;
     QVector<LayerData> layers() const;
+    const LayerData* findLayerById(const QString& layerId) const;
     QString activeLayerId() const;
     int layerNodeCount(const QString& layerId) const;
+    // Built items only; see loadNode().
+    NodeItem* nodeById(const QString& nodeId) const;
+    QList<NodeItem*> nodeItems() const;
+    int nodeCount() const;  // whole document
+    EdgeItem* edgeById(const QString& edgeId) const;
+    int edgeCount() const;  // whole document
+    GraphCsr graphSnapshot() const;
+    QVector<NodeSearchHit> searchNodes(const QString& query, int limit = 50) const;
+    // Selects the cone's built nodes now; unloaded ones are selected as their
+    // tiles load, so a wide cone builds no tiles. Returns the cone size.
+    int selectConeFromSelection(GraphCsr::Direction direction, int maxHops = -1, const QString& typeFilter = QString());
 
 signals:
     void selectionInfoChanged(const QString& itemType,
@@ -107,6 +189,16 @@ signals:
     void graphChanged();
     void connectionStateChanged(bool active);
     void layerStateChanged();
+    void layerNodeCountChanged(const QString& layerId, int count);
+    void nodeAdded(const QString& nodeId);
+    void nodeAboutToBeRemoved(const QString& nodeId);
+    void nodeRenamed(const QString& nodeId);
+    void nodeMembershipChanged(const QString& nodeId);
+    void graphReset();
+    // Also emitted when a restored edge closes a cycle and enforcement is dropped.
+    void dagEnforcedChanged(bool enforced);
+    // An undo stack step was applied or undone; `changes` is its footprint.
+    void editCommitted(const GraphChangeSet& changes);
 
 protected:
     void mousePressEvent(QGraphicsSceneMouseEvent* event) override;
@@ -118,12 +210,24 @@ private slots:
     void onPortConnectionStart(PortItem* port);
     void onPortConnectionRelease(PortItem* port);
     void onSelectionChangedInternal();
-    void onNodeDragFinished(NodeItem* node, const QPointF& oldPos, const QPointF& newPos);
+    void onNodeDisplayNameChanged(NodeItem* node);
+    void onNodeGroupIdChanged(NodeItem* node, const QString& previousGroupId);
+    void onNodeLayerIdChanged(NodeItem* node, const QString& previousLayerId);
+    void onNodeZValueChanged(NodeItem* node, qreal previousZ);
+    void onNodeMoved(NodeItem* node);
+    void onUndoIndexChanged(int index);
 
 private:
     friend class NodeMoveCommand;
+    friend class MultiNodeMoveCommand;
+    friend class NodeZOrderCommand;
+    friend class DeleteItemsCommand;
+    friend class ConnectEdgesCommand;
     friend class NodeRenameCommand;
     friend class NodePropertyCommand;
+    friend class MultiNodePropertyCommand;
+    friend class LayerFlagCommand;
+    friend class GroupCollapseCommand;
 
     QString nextNodeId();
     QString nextPortId();
@@ -132,22 +236,93 @@ private:
     QString nextLayerId();
     void updateCounterFromId(const QString& id, int* counter);
     void ensureLayerModel();
-    const LayerData* findLayerById(const QString& layerId) const;
     LayerData* findLayerByIdMutable(const QString& layerId);
     bool isLayerVisible(const QString& layerId) const;
     bool isLayerLocked(const QString& layerId) const;
     void sanitizeNodeLayers();
+    void registerNode(NodeItem* node);
+    void unregisterNode(NodeItem* node);
+    void indexNodeForSearch(const NodeItem* node);
+    void trackNodeTile(NodeItem* node);
+    void untrackNodeTile(NodeItem* node);
+    bool isRegisteredNode(const NodeItem* node) const;
+    // With `deferredReroutes`, bundle siblings are collected there instead of
+    // being rerouted, so a batch can reroute each edge once at the end.
+    EdgeItem* addEdgeInternal(const QString& edgeId,
+                              PortItem* outputPort,
+                              PortItem* inputPort,
+                              QSet<EdgeItem*>* deferredReroutes = nullptr);
+    void registerEdge(EdgeItem* edge);
+    void unregisterEdge(EdgeItem* edge);
+    bool rebuildTopologicalOrder();
+    void beginDocumentLoad(const GraphDocument& settings);
+    void finishDocumentLoad(bool dagOnly);
+    bool useLazyLoad(int nodeCount, bool dagOnly) const;
+    bool loadNodeRecord(const NodeData& nodeData, bool lazy);
+    // Current text of a node's property, read from its item or its record.
+    bool nodePropertyText(const QString& nodeId, const QString& key, QString* value) const;
+    bool setUnloadedNodeProperty(const QString& nodeId, const QString& key, const QString& value);
+    void loadEdgeRecord(const EdgeData& edgeData, bool lazy);
+    void updateCountersFromData(const NodeData& nodeData);
+    void parkNode(const NodeData& nodeData);
+    void parkEdge(const EdgeData& edgeData);
+    EdgeData unparkEdge(const QString& edgeId);
+    void loadTile(quint64 tile);
+    bool canUnloadNode(const NodeItem* node) const;
+    void unloadNode(NodeItem* node);
+    EdgeItem* loadEdge(const QString& edgeId);
+    void loadIncidentEdges(const QString& nodeId);
+    bool nodeTile(const QString& nodeId, quint64* tile) const;
+    PortItem* findPort(const QString& nodeId, const QString& portId) const;
+    NodeData nodeDataFor(const NodeItem* node) const;
+    EdgeData edgeDataFor(const EdgeItem* edge) const;
+    void addLayerMember(NodeItem* node, const QString& layerId);
+    void removeLayerMember(NodeItem* node, const QString& layerId);
+    void addGroupMember(NodeItem* node, const QString& groupId);
+    void removeGroupMember(NodeItem* node, const QString& groupId);
+    void addZValue(qreal z);
+    void removeZValue(qreal z);
     void rebuildNodeGroups();
     void clearNodeGroups();
+    void syncNodeGroups(const QSet<QString>& groupIds);
+    QGraphicsItemGroup* createGroupItem(const QString& groupId, const QSet<NodeItem*>& members);
+    QList<NodeItem*> removeGroupItem(const QString& groupId);
     QGraphicsItemGroup* owningGroupItem(QGraphicsItem* item) const;
     QSet<QString> collectSelectedGroupIds() const;
     void refreshCollapsedVisibility();
+    void refreshLayerVisibility(const QString& layerId);
+    void refreshGroupVisibility(const QSet<QString>& groupIds);
+    void refreshNodeVisibility(NodeItem* node);
+    void refreshEdgeVisibility(EdgeItem* edge);
+    void refreshGroupDecoration(const QString& groupId);
+    void collectIncidentEdges(const NodeItem* node, QSet<EdgeItem*>* edges) const;
+    void applyPendingSelection(const QVector<NodeItem*>& nodes);
+    void invalidateGraphSnapshot();
+    void collectBundleSiblings(const EdgeItem* edge, QSet<EdgeItem*>* edges) const;
+    void collectCorridorEdges(const QRectF& sceneRect, QSet<EdgeItem*>* edges) const;
+    bool applyDeleteInternal(const QSet<QString>& nodeIds, const QSet<QString>& edgeIds, bool emitGraphChanged);
+    bool applyRestoreInternal(const QVector<NodeData>& nodes,
+                              const QVector<EdgeData>& edges,
+                              const QHash<QString, QString>& survivorGroupIds,
+                              const QSet<QString>& collapsedGroupIds,
+                              bool emitGraphChanged);
+    QPointF collapsedGroupAnchor(const QString& groupId, const NodeItem* fallbackNode) const;
+    bool applyLayerFlagInternal(const QString& layerId, LayerFlag flag, bool value);
+    bool applyGroupCollapsedInternal(const QSet<QString>& groupIds, bool collapsed);
     bool toggleGroupCollapsedByIdWithUndo(const QString& groupId);
     QPointF snapPoint(const QPointF& p) const;
-    NodeItem* findNodeByIdInternal(const QString& nodeId) const;
     bool applyNodeRenameInternal(const QString& nodeId, const QString& newName, bool emitGraphChanged);
     bool applyNodePositionInternal(const QString& nodeId, const QPointF& newPos, bool emitGraphChanged);
+    bool applyNodeScenePositionsInternal(const QHash<QString, QPointF>& scenePositions, bool emitGraphChanged);
+    void beginNodeDrag();
+    void beginGroupDrag();
+    void finishGroupDrag();
+    void finishNodeDrag();
+    void setNodeDragEdgeUpdatesSuspended(bool suspended);
     bool applyNodePropertyInternal(const QString& nodeId, const QString& key, const QString& value, bool emitGraphChanged);
+    int applyNodePropertyValuesInternal(const QString& key, const QHash<QString, QString>& values, bool emitGraphChanged);
+    bool applyNodeZValuesInternal(const QHash<QString, qreal>& zValues, bool emitGraphChanged);
+    bool applyZOrderWithUndo(const QHash<QString, qreal>& zValues, const QString& text);
     bool canConnect(PortItem* a, PortItem* b) const;
     bool hasEdgeBetweenPorts(PortItem* outputPort, PortItem* inputPort) const;
     bool inputPortHasConnection(PortItem* inputPort) const;
@@ -173,15 +348,54 @@ private:
     int m_layerCounter = 1;
     bool m_snapToGrid = true;
 
+    bool m_bulkLoading = false;
+    bool m_swappingTiles = false;  // items built or released for the viewport
+
+    int m_lazyLoadThreshold = 0;
+    bool m_lazyLoaded = false;
+    QRectF m_viewportRect;
+    QHash<quint64, QHash<QString, NodeData>> m_unloadedTiles;
+    QHash<QString, quint64> m_unloadedNodeTiles;
+    QHash<QString, EdgeData> m_unloadedEdges;  // edges with an unloaded endpoint
+    QMultiHash<QString, QString> m_unloadedEdgesByNode;
+    // Chunk tile of every registered node item, kept current as nodes move.
+    // Unloaded records are filed in m_unloadedTiles instead.
+    QHash<quint64, QSet<NodeItem*>> m_loadedTiles;
+    QHash<NodeItem*, quint64> m_loadedNodeTiles;
+    QHash<QString, int> m_unloadedLayerCounts;
+    // Unloaded nodes that are part of the selection, selected when built.
+    // Any other selection change drops them.
+    QSet<QString> m_pendingSelection;
+    bool m_pendingSelectionEdges = false;
+    bool m_applyingSelection = false;
+    mutable GraphCsr m_graphSnapshot;
+    mutable bool m_graphSnapshotValid = false;
+
+    QHash<QString, NodeItem*> m_nodesById;
+    QHash<QString, EdgeItem*> m_edgesById;
+    QHash<QPair<PortItem*, PortItem*>, int> m_portPairEdgeCounts;
+    QHash<PortItem*, int> m_inputPortEdgeCounts;
+    QHash<QString, QSet<NodeItem*>> m_layerMembers;
+    QHash<QString, QSet<NodeItem*>> m_groupMembers;
+    QMap<qreal, int> m_nodeZCounts;
+    DynamicTopologicalOrder m_topologicalOrder;
+    NodeSearchIndex m_searchIndex;
+    EdgeBundleIndex m_bundleIndex;
+    bool m_dagEnforced = false;
     PortItem* m_pendingPort = nullptr;
     EdgeItem* m_previewEdge = nullptr;
     QHash<QString, QGraphicsItemGroup*> m_nodeGroups;
     QSet<QString> m_collapsedGroups;
     QGraphicsItemGroup* m_draggingGroup = nullptr;
     QPointF m_draggingGroupStartPos;
-    GraphDocument m_draggingGroupBefore;
+    QHash<QString, QPointF> m_draggingGroupStartPositions;
     bool m_draggingGroupTracked = false;
+    QHash<QString, QPointF> m_nodeDragStartPositions;
+    QSet<EdgeItem*> m_nodeDragEdges;
     QUndoStack* m_undoStack = nullptr;
+    int m_undoIndex = 0;
+    GraphChangeSet m_unsavedChanges;
+    bool m_fullSaveRequired = true;
     InteractionMode m_mode = InteractionMode::Select;
     QString m_placementType;
     EdgeRoutingMode m_edgeRoutingMode = EdgeRoutingMode::Manhattan;
@@ -2,15 +2,35 @@
 #include "app/MainWindow.h"
 #include "items/EdgeItem.h"
 #include "items/NodeItem.h"
+#include "items/PortItem.h"
+#include "model/BinaryGraphFormat.h"
+#include "model/BinaryGraphView.h"
+#include "model/ChunkedGraphFormat.h"
+#include "model/CompressedGraphFormat.h"
+#include "model/GraphCsr.h"
+#include "model/GraphJournal.h"
 #include "model/GraphSerializer.h"
+#include "model/JsonChunkScanner.h"
+#include "model/JsonStreamWriter.h"
+#include "model/NetlistFormats.h"
+#include "model/NodeSearchIndex.h"
+#include "model/PropertyStore.h"
+#include "model/StringAtom.h"
+#include "panels/LayerPanel.h"
+#include "panels/ProjectTreeModel.h"
 #include "scene/EditorScene.h"
 
+#include <QBuffer>
 #include <QCoreApplication>
 #include <QDataStream>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileInfo>
 #include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QPainter>
 #include <QPainterPath>
 #include <QGraphicsItemGroup>
@@ -19,13 +39,18 @@
 #include <QMimeData>
 #include <QSignalSpy>
 #include <QStatusBar>
+#include <QTableWidget>
 #include <QTemporaryDir>
 #include <QToolBar>
 #include <QtTest>
+#include <QtEndian>
 #include <QtGlobal>
 #include <QUndoStack>
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <thread>
 
 namespace {
 struct SnapshotOptions {
@@ -264,7 +289,32 @@ private slots:
     void uiSnapshotGraphViewDragPreview();
     void uiActionClickSmokeCapture();
     void layoutSettingsMarkDirty();
+    void projectTreeModelLazyAndIncremental();
+    void layerNodeCountsIncremental();
+    void layerAndGroupVisibilityIncremental();
+    void groupMaintenanceIncremental();
+    void multiNodeMoveSingleCommand();
+    void deleteSelectionCompactUndo();
+    void groupMoveCompactUndo();
+    void connectManyUsesConnectivityRules();
+    void dagModeRejectsCycles();
+    void graphCsrConeQueries();
+    void nodeSearchIndexRanksMatches();
+    void typedPropertyStore();
+    void bulkPropertyEditSingleCommand();
+    void stringAtomsShareVocabulary();
+    void binaryFormatRoundtrip();
+    void binaryViewBuildsScene();
+    void jsonStreamMatchesQJsonDocument();
+    void jsonChunkedParallelLoad();
+    void backgroundSaveKeepsEditing();
+    void journalRecoversUnsavedEdits();
+    void chunkedFormatIncrementalSave();
+    void lazyLoadingFollowsViewport();
+    void compressedFormatRoundtrip();
+    void netlistImportExport();
     void stressLargeGraphBuild();
+    void stressParallelJsonDecode();
 };
 
 void EdaSuite::serializerRoundtrip() {
@@ -775,6 +825,22 @@ void EdaSuite::rotateAndLayerUndo() {
     QVERIFY(scene.sendSelectionBackwardWithUndo());
     QCOMPARE(undoStack.count(), 5);
     QCOMPARE(n1->zValue(), z1);
+
+    n3->setZValue(50.0);
+    scene.clearSelection();
+    n1->setSelected(true);
+    n2->setSelected(true);
+    QVERIFY(scene.bringSelectionToFrontWithUndo());
+    QCOMPARE(undoStack.count(), 6);
+    QCOMPARE(n2->zValue(), 51.0);
+    QCOMPARE(n1->zValue(), 52.0);
+    QCOMPARE(undoStack.undoText(), QStringLiteral("Bring To Front"));
+
+    undoStack.undo();
+    QCOMPARE(n1->zValue(), z1);
+    QVERIFY(n2->zValue() < n1->zValue());
+    undoStack.redo();
+    QCOMPARE(n1->zValue(), 52.0);
 }
 
 void EdaSuite::groupUngroupUndo() {
@@ -1702,6 +1768,1754 @@ void EdaSuite::layoutSettingsMarkDirty() {
     QVERIFY(window.isDocumentDirty(index));
 }
 
+void EdaSuite::projectTreeModelLazyAndIncremental() {
+    EditorScene scene;
+    QUndoStack undoStack;
+    scene.setUndoStack(&undoStack);
+
+    QVector<NodeItem*> created;
+    for (int i = 0; i < 300; ++i) {
+        NodeItem* node = scene.createNode(QStringLiteral("tm_Node"), QPointF(80.0 + (i % 20) * 160.0, 80.0 + (i / 20) * 110.0));
+        QVERIFY(node != nullptr);
+        created.push_back(node);
+    }
+    QCOMPARE(scene.nodeCount(), 300);
+    QCOMPARE(scene.nodeById(created[42]->nodeId()), created[42]);
+
+    ProjectTreeModel model;
+    model.setScene(&scene);
+    const QModelIndex layerIndex = model.indexForLayer(scene.activeLayerId());
+    QVERIFY(layerIndex.isValid());
+    QVERIFY(model.hasChildren(layerIndex));
+    QCOMPARE(model.rowCount(layerIndex), 0);
+    QCOMPARE(model.materializedNodeCount(), 0);
+
+    QVERIFY(model.canFetchMore(layerIndex));
+    model.fetchMore(layerIndex);
+    QCOMPARE(model.rowCount(layerIndex), ProjectTreeModel::FetchBatchSize);
+    model.fetchMore(layerIndex);
+    QCOMPARE(model.rowCount(layerIndex), 300);
+    QVERIFY(!model.canFetchMore(layerIndex));
+
+    QSignalSpy insertedSpy(&model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removedSpy(&model, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy changedSpy(&model, &QAbstractItemModel::dataChanged);
+
+    NodeItem* extra = scene.createNode(QStringLiteral("tm_Node"), QPointF(4000.0, 4000.0));
+    QVERIFY(extra != nullptr);
+    QCOMPARE(insertedSpy.count(), 1);
+    QCOMPARE(model.rowCount(layerIndex), 301);
+    const QModelIndex extraIndex = model.indexForNode(extra->nodeId());
+    QVERIFY(extraIndex.isValid());
+    QCOMPARE(extraIndex.data(Qt::UserRole).toString(), extra->nodeId());
+
+    extra->setDisplayName(QStringLiteral("RenamedExtra"));
+    QCOMPARE(changedSpy.count(), 1);
+    QVERIFY(extraIndex.data(Qt::DisplayRole).toString().startsWith(QStringLiteral("RenamedExtra")));
+
+    created[0]->setGroupId(QStringLiteral("G_tree"));
+    created[1]->setGroupId(QStringLiteral("G_tree"));
+    QCOMPARE(model.rowCount(layerIndex), 300);
+    const QModelIndex groupIndex = model.index(model.rowCount(layerIndex) - 1, 0, layerIndex);
+    QVERIFY(model.kindOf(groupIndex) == ProjectTreeModel::EntryKind::Group);
+    QCOMPARE(model.rowCount(groupIndex), 2);
+
+    insertedSpy.clear();
+    removedSpy.clear();
+    scene.clearSelection();
+    extra->setSelected(true);
+    scene.deleteSelectionWithUndo();
+    QCOMPARE(removedSpy.count(), 1);
+    QCOMPARE(insertedSpy.count(), 0);
+    QCOMPARE(model.rowCount(layerIndex), 299);
+    QVERIFY(!model.isNodeMaterialized(extra->nodeId()));
+
+    // Rows after a bulk delete still match the indexes handed out for nodes.
+    removedSpy.clear();
+    for (int i = 10; i < 40; i += 2) {
+        created[i]->setSelected(true);
+    }
+    scene.deleteSelectionWithUndo();
+    QCOMPARE(removedSpy.count(), 15);
+    QCOMPARE(model.rowCount(layerIndex), 284);
+    for (int row = 0; row < model.rowCount(layerIndex); ++row) {
+        const QModelIndex rowIndex = model.index(row, 0, layerIndex);
+        if (model.kindOf(rowIndex) == ProjectTreeModel::EntryKind::Node) {
+            QCOMPARE(model.indexForNode(rowIndex.data(Qt::UserRole).toString()).row(), row);
+        }
+    }
+    QCOMPARE(model.indexForNode(created[0]->nodeId()).parent().row(), model.rowCount(layerIndex) - 1);
+
+    QSignalSpy resetSpy(&model, &QAbstractItemModel::modelReset);
+    const GraphDocument snapshot = scene.toDocument();
+    QVERIFY(scene.fromDocument(snapshot));
+    QCOMPARE(resetSpy.count(), 1);
+    QCOMPARE(model.materializedNodeCount(), 0);
+
+    const QString lastId = snapshot.nodes.last().id;
+    const QModelIndex lazyIndex = model.indexForNode(lastId);
+    QVERIFY(lazyIndex.isValid());
+    QCOMPARE(lazyIndex.data(Qt::UserRole).toString(), lastId);
+    QCOMPARE(model.materializedNodeCount(), 1);
+
+    // The rows before it are still fetched later, without a duplicate.
+    const QModelIndex reloadedLayer = model.indexForLayer(scene.activeLayerId());
+    while (model.canFetchMore(reloadedLayer)) {
+        model.fetchMore(reloadedLayer);
+    }
+    int lastRows = 0;
+    for (int row = 0; row < model.rowCount(reloadedLayer); ++row) {
+        if (model.index(row, 0, reloadedLayer).data(Qt::UserRole).toString() == lastId) {
+            ++lastRows;
+        }
+    }
+    QCOMPARE(lastRows, 1);
+}
+
+void EdaSuite::layerNodeCountsIncremental() {
+    EditorScene scene;
+    QUndoStack undoStack;
+    scene.setUndoStack(&undoStack);
+
+    const QString defaultLayerId = scene.activeLayerId();
+    NodeItem* a = scene.createNode(QStringLiteral("tm_Node"), QPointF(120.0, 140.0));
+    NodeItem* b = scene.createNode(QStringLiteral("tm_Node"), QPointF(380.0, 140.0));
+    NodeItem* c = scene.createNode(QStringLiteral("tm_Node"), QPointF(640.0, 140.0));
+    QVERIFY(a != nullptr);
+    QVERIFY(b != nullptr);
+    QVERIFY(c != nullptr);
+    QCOMPARE(scene.layerNodeCount(defaultLayerId), 3);
+
+    const QString processLayerId = scene.createLayerWithUndo(QStringLiteral("Process"));
+    QCOMPARE(scene.layerNodeCount(processLayerId), 0);
+
+    LayerPanel panel;
+    panel.setScene(&scene);
+    QTableWidget* table = panel.findChild<QTableWidget*>();
+    QVERIFY(table != nullptr);
+    QCOMPARE(table->rowCount(), 2);
+    QCOMPARE(table->item(0, 4)->text(), QStringLiteral("3"));
+    QTableWidgetItem* defaultCountItem = table->item(0, 4);
+
+    QSignalSpy countSpy(&scene, &EditorScene::layerNodeCountChanged);
+    QSignalSpy layerSpy(&scene, &EditorScene::layerStateChanged);
+
+    a->setLayerId(processLayerId);
+    QCOMPARE(countSpy.count(), 2);
+    QCOMPARE(scene.layerNodeCount(defaultLayerId), 2);
+    QCOMPARE(scene.layerNodeCount(processLayerId), 1);
+    QCOMPARE(table->item(0, 4), defaultCountItem);
+    QCOMPARE(table->item(0, 4)->text(), QStringLiteral("2"));
+    QCOMPARE(table->item(1, 4)->text(), QStringLiteral("1"));
+
+    NodeItem* d = scene.createNode(QStringLiteral("tm_Node"), QPointF(900.0, 140.0));
+    QVERIFY(d != nullptr);
+    QCOMPARE(d->layerId(), processLayerId);
+    QCOMPARE(layerSpy.count(), 0);
+    QCOMPARE(table->item(0, 4), defaultCountItem);
+    QCOMPARE(table->item(1, 4)->text(), QStringLiteral("2"));
+
+    d->setPos(d->pos() + QPointF(40.0, 0.0));
+    QCOMPARE(table->item(0, 4), defaultCountItem);
+
+    scene.clearSelection();
+    b->setSelected(true);
+    scene.deleteSelectionWithUndo();
+    QCOMPARE(scene.layerNodeCount(defaultLayerId), 1);
+    QCOMPARE(table->item(0, 4)->text(), QStringLiteral("1"));
+
+    undoStack.undo();
+    QCOMPARE(scene.layerNodeCount(defaultLayerId), 2);
+    QCOMPARE(scene.layerNodeCount(processLayerId), 2);
+    QCOMPARE(table->item(0, 4)->text(), QStringLiteral("2"));
+
+    QVERIFY(scene.deleteLayerWithUndo(processLayerId));
+    QCOMPARE(scene.layerNodeCount(processLayerId), 0);
+    QCOMPARE(scene.layerNodeCount(defaultLayerId), 4);
+}
+
+void EdaSuite::layerAndGroupVisibilityIncremental() {
+    EditorScene scene;
+    scene.setSnapToGrid(false);
+    QUndoStack undoStack;
+    scene.setUndoStack(&undoStack);
+
+    NodeItem* a = scene.createNode(QStringLiteral("tm_Node"), QPointF(120.0, 120.0));
+    NodeItem* b = scene.createNode(QStringLiteral("tm_Node"), QPointF(340.0, 120.0));
+    NodeItem* c = scene.createNode(QStringLiteral("tm_Node"), QPointF(620.0, 120.0));
+    QVERIFY(a != nullptr);
+    QVERIFY(b != nullptr);
+    QVERIFY(c != nullptr);
+    EdgeItem* ab = scene.createEdge(a->firstOutputPort(), b->firstInputPort());
+    EdgeItem* bc = scene.createEdge(b->firstOutputPort(), c->firstInputPort());
+    QVERIFY(ab != nullptr);
+    QVERIFY(bc != nullptr);
+
+    const QString processLayerId = scene.createLayerWithUndo(QStringLiteral("Process"));
+    scene.clearSelection();
+    c->setSelected(true);
+    QVERIFY(scene.moveSelectionToLayerWithUndo(processLayerId));
+    QCOMPARE(c->layerId(), processLayerId);
+    const int baseCount = undoStack.count();
+
+    QVERIFY(scene.setLayerVisibleWithUndo(processLayerId, false));
+    QCOMPARE(undoStack.count(), baseCount + 1);
+    QVERIFY(a->isVisible());
+    QVERIFY(b->isVisible());
+    QVERIFY(!c->isVisible());
+    QVERIFY(ab->isVisible());
+    QVERIFY(!bc->isVisible());
+
+    undoStack.undo();
+    QVERIFY(c->isVisible());
+    QVERIFY(bc->isVisible());
+    QCOMPARE(findNodeById(scene, c->nodeId()), c);
+    undoStack.redo();
+    QVERIFY(!c->isVisible());
+    undoStack.undo();
+
+    QVERIFY(scene.setLayerLockedWithUndo(processLayerId, true));
+    QVERIFY(!(c->flags() & QGraphicsItem::ItemIsMovable));
+    QVERIFY(a->flags() & QGraphicsItem::ItemIsMovable);
+    undoStack.undo();
+    QVERIFY(c->flags() & QGraphicsItem::ItemIsMovable);
+
+    scene.clearSelection();
+    a->setSelected(true);
+    b->setSelected(true);
+    QVERIFY(scene.groupSelectionWithUndo());
+    const QString groupId = a->groupId();
+    QVERIFY(!groupId.isEmpty());
+    a = findNodeById(scene, a->nodeId());
+    b = findNodeById(scene, b->nodeId());
+    c = findNodeById(scene, c->nodeId());
+    QVERIFY(a != nullptr);
+    QVERIFY(b != nullptr);
+    QVERIFY(c != nullptr);
+
+    scene.clearSelection();
+    a->setSelected(true);
+    QVERIFY(scene.collapseSelectionWithUndo());
+    QVERIFY(!a->isVisible());
+    QVERIFY(!b->isVisible());
+    QVERIFY(c->isVisible());
+    EdgeItem* boundary = nullptr;
+    for (QGraphicsItem* item : scene.items()) {
+        EdgeItem* edge = dynamic_cast<EdgeItem*>(item);
+        if (edge && edge->targetPort() && edge->targetPort()->ownerNode() == c) {
+            boundary = edge;
+        }
+    }
+    QVERIFY(boundary != nullptr);
+    QVERIFY(boundary->passthrough());
+
+    undoStack.undo();
+    QVERIFY(a->isVisible());
+    QVERIFY(b->isVisible());
+    QVERIFY(!boundary->passthrough());
+    QCOMPARE(findNodeById(scene, a->nodeId()), a);
+}
+
+void EdaSuite::groupMaintenanceIncremental() {
+    EditorScene scene;
+    scene.setSnapToGrid(false);
+    QUndoStack undoStack;
+    scene.setUndoStack(&undoStack);
+
+    QVector<NodeItem*> nodes;
+    for (int i = 0; i < 7; ++i) {
+        NodeItem* node = scene.createNode(QStringLiteral("tm_Node"), QPointF(120.0 + i * 220.0, 140.0));
+        QVERIFY(node != nullptr);
+        nodes.push_back(node);
+    }
+
+    auto groupSelection = [&scene](const QVector<NodeItem*>& members) {
+        scene.clearSelection();
+        for (NodeItem* node : members) {
+            node->setSelected(true);
+        }
+        return scene.groupSelectionWithUndo();
+    };
+    auto findGroup = [&scene](const QString& groupId) -> QGraphicsItemGroup* {
+        for (QGraphicsItem* item : scene.items()) {
+            QGraphicsItemGroup* group = dynamic_cast<QGraphicsItemGroup*>(item);
+            if (group && group->data(0).toString() == groupId) {
+                return group;
+            }
+        }
+        return nullptr;
+    };
+    auto countFrames = [&scene]() {
+        int count = 0;
+        for (QGraphicsItem* item : scene.items()) {
+            if (item->data(0).toString() == QStringLiteral("group_frame")) {
+                ++count;
+            }
+        }
+        return count;
+    };
+
+    QVERIFY(groupSelection({nodes[0], nodes[1]}));
+    QVERIFY(groupSelection({nodes[2], nodes[3]}));
+    QVERIFY(groupSelection({nodes[4], nodes[5], nodes[6]}));
+    const QString firstGroupId = nodes[0]->groupId();
+    const QString secondGroupId = nodes[2]->groupId();
+    const QString thirdGroupId = nodes[4]->groupId();
+    QGraphicsItemGroup* firstGroup = findGroup(firstGroupId);
+    QGraphicsItemGroup* secondGroup = findGroup(secondGroupId);
+    QVERIFY(firstGroup != nullptr);
+    QVERIFY(secondGroup != nullptr);
+    QVERIFY(findGroup(thirdGroupId) != nullptr);
+    QCOMPARE(countFrames(), 3);
+
+    scene.clearSelection();
+    nodes[0]->setSelected(true);
+    QVERIFY(scene.ungroupSelectionWithUndo());
+    QVERIFY(findGroup(firstGroupId) == nullptr);
+    QCOMPARE(findGroup(secondGroupId), secondGroup);
+    QVERIFY(nodes[0]->groupId().isEmpty());
+    QVERIFY(nodes[0]->parentItem() == nullptr);
+    QCOMPARE(countFrames(), 2);
+
+    const QPointF thirdDragOffset(0.0, 60.0);
+    QGraphicsItemGroup* thirdGroup = findGroup(thirdGroupId);
+    thirdGroup->setPos(thirdGroup->pos() + thirdDragOffset);
+    const QPointF survivorScenePos = nodes[5]->scenePos();
+
+    scene.clearSelection();
+    nodes[6]->setSelected(true);
+    scene.deleteSelectionWithUndo();
+    QCOMPARE(findGroup(secondGroupId), secondGroup);
+    QVERIFY(findGroup(thirdGroupId) != nullptr);
+    QCOMPARE(nodes[5]->groupId(), thirdGroupId);
+    QCOMPARE(nodes[5]->scenePos(), survivorScenePos);
+    QCOMPARE(countFrames(), 2);
+
+    scene.clearSelection();
+    nodes[3]->setSelected(true);
+    scene.deleteSelectionWithUndo();
+    QVERIFY(findGroup(secondGroupId) == nullptr);
+    QVERIFY(nodes[2]->groupId().isEmpty());
+    QVERIFY(nodes[2]->parentItem() == nullptr);
+    QCOMPARE(countFrames(), 1);
+}
+
+void EdaSuite::multiNodeMoveSingleCommand() {
+    EditorScene scene;
+    scene.setSnapToGrid(false);
+    QUndoStack undoStack;
+    scene.setUndoStack(&undoStack);
+
+    NodeItem* a = scene.createNode(QStringLiteral("tm_Node"), QPointF(100.0, 100.0));
+    NodeItem* b = scene.createNode(QStringLiteral("tm_Node"), QPointF(400.0, 100.0));
+    NodeItem* c = scene.createNode(QStringLiteral("tm_Node"), QPointF(700.0, 100.0));
+    QVERIFY(a != nullptr);
+    QVERIFY(b != nullptr);
+    QVERIFY(c != nullptr);
+    EdgeItem* ab = scene.createEdge(a->firstOutputPort(), b->firstInputPort());
+    EdgeItem* bc = scene.createEdge(b->firstOutputPort(), c->firstInputPort());
+    QVERIFY(ab != nullptr);
+    QVERIFY(bc != nullptr);
+    const QPainterPath abBefore = ab->path();
+    const QPainterPath bcBefore = bc->path();
+    const int undoBase = undoStack.count();
+
+    QHash<QString, QPointF> targets;
+    targets.insert(a->nodeId(), QPointF(100.0, 300.0));
+    targets.insert(b->nodeId(), QPointF(400.0, 300.0));
+    QSignalSpy graphChangedSpy(&scene, &EditorScene::graphChanged);
+    QVERIFY(scene.moveNodesWithUndo(targets));
+    QCOMPARE(graphChangedSpy.count(), 1);
+    QCOMPARE(undoStack.count(), undoBase + 1);
+    QCOMPARE(a->scenePos(), QPointF(100.0, 300.0));
+    QCOMPARE(b->scenePos(), QPointF(400.0, 300.0));
+    QCOMPARE(c->scenePos(), QPointF(700.0, 100.0));
+    QVERIFY(ab->path() != abBefore);
+    QVERIFY(bc->path() != bcBefore);
+    QVERIFY(!scene.moveNodesWithUndo(targets));
+
+    undoStack.undo();
+    QCOMPARE(a->scenePos(), QPointF(100.0, 100.0));
+    QCOMPARE(b->scenePos(), QPointF(400.0, 100.0));
+    QCOMPARE(ab->path(), abBefore);
+    QCOMPARE(bc->path(), bcBefore);
+
+    undoStack.redo();
+    QCOMPARE(a->scenePos(), QPointF(100.0, 300.0));
+    QCOMPARE(b->scenePos(), QPointF(400.0, 300.0));
+}
+
+void EdaSuite::deleteSelectionCompactUndo() {
+    EditorScene scene;
+    scene.setSnapToGrid(false);
+    QUndoStack undoStack;
+    scene.setUndoStack(&undoStack);
+
+    NodeItem* a = scene.createNode(QStringLiteral("tm_Node"), QPointF(100.0, 100.0));
+    NodeItem* b = scene.createNode(QStringLiteral("tm_Node"), QPointF(340.0, 100.0));
+    NodeItem* c = scene.createNode(QStringLiteral("tm_Node"), QPointF(580.0, 100.0));
+    NodeItem* d = scene.createNode(QStringLiteral("tm_Node"), QPointF(820.0, 100.0));
+    QVERIFY(scene.createEdge(a->firstOutputPort(), b->firstInputPort()) != nullptr);
+    QVERIFY(scene.createEdge(b->firstOutputPort(), c->firstInputPort()) != nullptr);
+    EdgeItem* cd = scene.createEdge(c->firstOutputPort(), d->firstInputPort());
+    QVERIFY(cd != nullptr);
+    QCOMPARE(scene.edgeCount(), 3);
+
+    scene.clearSelection();
+    a->setSelected(true);
+    b->setSelected(true);
+    QVERIFY(scene.groupSelectionWithUndo());
+    const QString groupId = a->groupId();
+    QVERIFY(!groupId.isEmpty());
+    const GraphDocument before = scene.toDocument();
+
+    const QString deletedId = b->nodeId();
+    const int undoBase = undoStack.count();
+    scene.clearSelection();
+    b->setSelected(true);
+    scene.deleteSelectionWithUndo();
+    QCOMPARE(undoStack.count(), undoBase + 1);
+    QCOMPARE(undoStack.undoText(), QStringLiteral("Delete"));
+    QCOMPARE(scene.nodeCount(), 3);
+    QCOMPARE(scene.edgeCount(), 1);
+    QCOMPARE(scene.edgeById(cd->edgeId()), cd);
+    QVERIFY(scene.nodeById(deletedId) == nullptr);
+    QVERIFY(a->groupId().isEmpty());
+    QVERIFY(a->parentItem() == nullptr);
+
+    undoStack.undo();
+    const GraphDocument restored = scene.toDocument();
+    QCOMPARE(scene.nodeCount(), 4);
+    QCOMPARE(scene.edgeCount(), 3);
+    QCOMPARE(a->groupId(), groupId);
+    QVERIFY(scene.nodeById(deletedId) != nullptr);
+    QCOMPARE(scene.nodeById(deletedId)->groupId(), groupId);
+    QVERIFY(a->parentItem() != nullptr);
+    QCOMPARE(restored.nodes.size(), before.nodes.size());
+    for (int i = 0; i < before.nodes.size(); ++i) {
+        QCOMPARE(restored.nodes[i].id, before.nodes[i].id);
+        QCOMPARE(restored.nodes[i].position, before.nodes[i].position);
+        QCOMPARE(restored.nodes[i].groupId, before.nodes[i].groupId);
+    }
+    QCOMPARE(restored.edges.size(), before.edges.size());
+    for (int i = 0; i < before.edges.size(); ++i) {
+        QCOMPARE(restored.edges[i].id, before.edges[i].id);
+        QCOMPARE(restored.edges[i].fromPortId, before.edges[i].fromPortId);
+        QCOMPARE(restored.edges[i].toPortId, before.edges[i].toPortId);
+    }
+
+    undoStack.redo();
+    QCOMPARE(scene.nodeCount(), 3);
+    QCOMPARE(scene.edgeCount(), 1);
+    QVERIFY(scene.nodeById(deletedId) == nullptr);
+    QVERIFY(a->groupId().isEmpty());
+}
+
+void EdaSuite::groupMoveCompactUndo() {
+    EditorScene scene;
+    scene.setSceneRect(0.0, 0.0, 1600.0, 1000.0);
+    scene.setSnapToGrid(false);
+    QUndoStack undoStack;
+    scene.setUndoStack(&undoStack);
+
+    NodeItem* a = scene.createNode(QStringLiteral("tm_Node"), QPointF(160.0, 180.0));
+    NodeItem* b = scene.createNode(QStringLiteral("tm_Node"), QPointF(420.0, 180.0));
+    QVERIFY(a != nullptr);
+    QVERIFY(b != nullptr);
+    a->setSelected(true);
+    b->setSelected(true);
+    QVERIFY(scene.groupSelectionWithUndo());
+    QGraphicsItemGroup* group = dynamic_cast<QGraphicsItemGroup*>(a->parentItem());
+    QVERIFY(group != nullptr);
+    scene.clearSelection();
+
+    GraphView view;
+    view.resize(960, 640);
+    view.setScene(&scene);
+    view.show();
+    QCoreApplication::processEvents();
+
+    const int undoBase = undoStack.count();
+    const QPoint clickPos = view.mapFromScene(a->sceneBoundingRect().center());
+    QTest::mouseClick(view.viewport(), Qt::LeftButton, Qt::NoModifier, clickPos);
+    QCoreApplication::processEvents();
+    QCOMPARE(undoStack.count(), undoBase);
+
+    const QPointF groupPosBefore = group->pos();
+    QHash<QString, QPointF> targets;
+    targets.insert(a->nodeId(), a->scenePos() + QPointF(40.0, 60.0));
+    targets.insert(b->nodeId(), b->scenePos() + QPointF(40.0, 60.0));
+    QVERIFY(scene.moveNodesWithUndo(targets));
+    QCOMPARE(undoStack.count(), undoBase + 1);
+    QCOMPARE(a->parentItem(), group);
+    QCOMPARE(group->pos(), groupPosBefore + QPointF(40.0, 60.0));
+    QCOMPARE(a->scenePos(), QPointF(200.0, 240.0));
+
+    undoStack.undo();
+    QCOMPARE(a->parentItem(), group);
+    QCOMPARE(group->pos(), groupPosBefore);
+    QCOMPARE(a->scenePos(), QPointF(160.0, 180.0));
+    QCOMPARE(b->scenePos(), QPointF(420.0, 180.0));
+}
+
+void EdaSuite::connectManyUsesConnectivityRules() {
+    EditorScene scene;
+    scene.setSnapToGrid(false);
+    QUndoStack undoStack;
+    scene.setUndoStack(&undoStack);
+
+    NodeItem* a = scene.createNode(QStringLiteral("tm_Node"), QPointF(100.0, 100.0));
+    NodeItem* b = scene.createNode(QStringLiteral("tm_Node"), QPointF(340.0, 100.0));
+    NodeItem* c = scene.createNode(QStringLiteral("tm_Node"), QPointF(580.0, 100.0));
+    QVERIFY(a != nullptr);
+    QVERIFY(b != nullptr);
+    QVERIFY(c != nullptr);
+
+    QVector<QPair<PortItem*, PortItem*>> connections;
+    connections.push_back(qMakePair(a->firstOutputPort(), b->firstInputPort()));
+    connections.push_back(qMakePair(a->firstOutputPort(), b->firstInputPort()));
+    connections.push_back(qMakePair(c->firstOutputPort(), b->firstInputPort()));
+    connections.push_back(qMakePair(c->firstInputPort(), b->firstOutputPort()));
+    connections.push_back(qMakePair(a->firstOutputPort(), a->firstInputPort()));
+    QSignalSpy graphChangedSpy(&scene, &EditorScene::graphChanged);
+    const QVector<EdgeItem*> created = scene.connectManyWithUndo(connections);
+    QCOMPARE(created.size(), 2);
+    QCOMPARE(graphChangedSpy.count(), 1);
+    QCOMPARE(scene.edgeCount(), 2);
+    QCOMPARE(undoStack.count(), 4);
+    QCOMPARE(created[1]->sourcePort(), b->firstOutputPort());
+    QCOMPARE(created[1]->targetPort(), c->firstInputPort());
+    QVERIFY(scene.createEdge(c->firstOutputPort(), b->firstInputPort()) == nullptr);
+
+    undoStack.undo();
+    QCOMPARE(scene.edgeCount(), 0);
+    QVERIFY(scene.createEdge(c->firstOutputPort(), b->firstInputPort()) != nullptr);
+    QVERIFY(scene.createEdge(a->firstOutputPort(), b->firstInputPort()) == nullptr);
+}
+
+void EdaSuite::dagModeRejectsCycles() {
+    EditorScene scene;
+    scene.setSnapToGrid(false);
+
+    NodeItem* a = scene.createNode(QStringLiteral("tm_Node"), QPointF(100.0, 100.0));
+    NodeItem* b = scene.createNode(QStringLiteral("tm_Node"), QPointF(340.0, 100.0));
+    NodeItem* c = scene.createNode(QStringLiteral("tm_Node"), QPointF(580.0, 100.0));
+    QVERIFY(a != nullptr);
+    QVERIFY(b != nullptr);
+    QVERIFY(c != nullptr);
+    QVERIFY(scene.setDagEnforced(true));
+    QVERIFY(scene.dagEnforced());
+
+    QVERIFY(scene.createEdge(c->firstOutputPort(), b->firstInputPort()) != nullptr);
+    QVERIFY(scene.createEdge(b->firstOutputPort(), a->firstInputPort()) != nullptr);
+    QVERIFY(scene.createEdge(a->firstOutputPort(), c->firstInputPort()) == nullptr);
+    QCOMPARE(scene.edgeCount(), 2);
+
+    QVERIFY(scene.autoLayoutWithUndo(false));
+    QVERIFY(c->pos().x() < b->pos().x());
+    QVERIFY(b->pos().x() < a->pos().x());
+
+    const GraphDocument doc = scene.toDocument();
+    QVERIFY(doc.dagOnly);
+    EditorScene loaded;
+    QVERIFY(loaded.fromDocument(doc));
+    QVERIFY(loaded.dagEnforced());
+
+    QVERIFY(scene.setDagEnforced(false));
+    QVERIFY(scene.createEdge(a->firstOutputPort(), c->firstInputPort()) != nullptr);
+    QVERIFY(!scene.setDagEnforced(true));
+    QVERIFY(!scene.dagEnforced());
+
+    // Undo restoring a cycle-closing edge drops enforcement and says so.
+    QUndoStack undoStack;
+    scene.setUndoStack(&undoStack);
+    scene.clearSelection();
+    for (QGraphicsItem* item : scene.items()) {
+        EdgeItem* edge = dynamic_cast<EdgeItem*>(item);
+        if (edge && edge->sourcePort() == a->firstOutputPort()) {
+            edge->setSelected(true);
+        }
+    }
+    scene.deleteSelectionWithUndo();
+    QCOMPARE(scene.edgeCount(), 2);
+    QSignalSpy dagSpy(&scene, &EditorScene::dagEnforcedChanged);
+    QVERIFY(scene.setDagEnforced(true));
+    QCOMPARE(dagSpy.count(), 1);
+    undoStack.undo();
+    QCOMPARE(scene.edgeCount(), 3);
+    QVERIFY(!scene.dagEnforced());
+    QCOMPARE(dagSpy.count(), 2);
+    QCOMPARE(dagSpy.last().at(0).toBool(), false);
+    QVERIFY(!scene.toDocument().dagOnly);
+}
+
+void EdaSuite::graphCsrConeQueries() {
+    GraphDocument doc;
+    const QStringList types{QStringLiteral("Voter"),
+                            QStringLiteral("Sum"),
+                            QStringLiteral("SFT"),
+                            QStringLiteral("Sum"),
+                            QStringLiteral("Voter")};
+    for (int i = 0; i < types.size(); ++i) {
+        NodeData node;
+        node.id = QStringLiteral("n%1").arg(i + 1);
+        node.type = types[i];
+        doc.nodes.push_back(node);
+    }
+    const QVector<QPair<int, int>> links{{1, 2}, {2, 3}, {3, 4}, {1, 5}};
+    for (const QPair<int, int>& link : links) {
+        EdgeData edge;
+        edge.id = QStringLiteral("e%1").arg(doc.edges.size() + 1);
+        edge.fromNodeId = QStringLiteral("n%1").arg(link.first);
+        edge.toNodeId = QStringLiteral("n%1").arg(link.second);
+        doc.edges.push_back(edge);
+    }
+
+    const GraphCsr csr = GraphCsr::fromDocument(doc);
+    QCOMPARE(csr.nodeCount(), 5);
+    QCOMPARE(csr.edgeCount(), 4);
+    const int n1 = csr.indexOf(QStringLiteral("n1"));
+    const int n4 = csr.indexOf(QStringLiteral("n4"));
+    QCOMPARE(csr.cone({n1}, GraphCsr::Direction::FanOut).size(), 4);
+    QCOMPARE(csr.cone({n1}, GraphCsr::Direction::FanOut, 1).size(), 2);
+    QCOMPARE(csr.cone({n1}, GraphCsr::Direction::FanOut, -1, QStringLiteral("Sum")).size(), 2);
+    QCOMPARE(csr.cone({n4}, GraphCsr::Direction::FanIn).size(), 3);
+    QVERIFY(csr.reaches(n1, n4));
+    QVERIFY(!csr.reaches(n1, n4, 2));
+    QVERIFY(!csr.reaches(n4, n1));
+    QVERIFY(!csr.reaches(n1, n1));
+    const GraphCsr loop = GraphCsr::build({QStringLiteral("a"), QStringLiteral("b")},
+                                          {QStringLiteral("Sum"), QStringLiteral("Sum")},
+                                          {qMakePair(0, 1), qMakePair(1, 0)});
+    QVERIFY(loop.reaches(0, 0));
+    QVERIFY(!loop.reaches(0, 0, 1));
+
+    // Wide enough for the second level to be expanded on worker threads.
+    const int fanout = 10000;
+    QVector<QString> ids;
+    QVector<QPair<int, int>> edges;
+    ids.push_back(QStringLiteral("root"));
+    for (int i = 0; i < fanout; ++i) {
+        ids.push_back(QStringLiteral("mid%1").arg(i));
+        ids.push_back(QStringLiteral("leaf%1").arg(i));
+        edges.push_back(qMakePair(0, ids.size() - 2));
+        edges.push_back(qMakePair(ids.size() - 2, ids.size() - 1));
+    }
+    const GraphCsr wide = GraphCsr::build(ids, QVector<QString>(), edges);
+    QCOMPARE(wide.cone({0}, GraphCsr::Direction::FanOut).size(), fanout * 2);
+    QCOMPARE(wide.cone({wide.indexOf(QStringLiteral("leaf7"))}, GraphCsr::Direction::FanIn).size(), 2);
+
+    EditorScene scene;
+    NodeItem* a = scene.createNode(QStringLiteral("tm_Node"), QPointF(100.0, 100.0));
+    NodeItem* b = scene.createNode(QStringLiteral("tm_Node"), QPointF(340.0, 100.0));
+    NodeItem* c = scene.createNode(QStringLiteral("tm_Node"), QPointF(580.0, 100.0));
+    QVERIFY(scene.createEdge(a->firstOutputPort(), b->firstInputPort()) != nullptr);
+    QVERIFY(scene.createEdge(b->firstOutputPort(), c->firstInputPort()) != nullptr);
+    scene.clearSelection();
+    c->setSelected(true);
+    QCOMPARE(scene.selectConeFromSelection(GraphCsr::Direction::FanIn), 2);
+    QVERIFY(a->isSelected());
+    QVERIFY(b->isSelected());
+    QCOMPARE(scene.selectedItems().size(), 5);
+}
+
+void EdaSuite::nodeSearchIndexRanksMatches() {
+    NodeSearchIndex index;
+    index.upsert(QStringLiteral("n1"), QStringLiteral("RCP0001KM"), QStringLiteral("Sum"), {});
+    index.upsert(QStringLiteral("n2"), QStringLiteral("RCP0002KM"), QStringLiteral("Voter"), {QStringLiteral("2oo3")});
+    index.upsert(QStringLiteral("n3"), QStringLiteral("XRCP01"), QStringLiteral("SFT"), {QStringLiteral("rcp0001km")});
+
+    QVector<NodeSearchHit> hits = index.search(QStringLiteral("rcp0001km"));
+    QCOMPARE(hits.size(), 2);
+    QCOMPARE(hits[0].nodeId, QStringLiteral("n1"));
+    QCOMPARE(hits[0].score, 0);
+    QCOMPARE(hits[1].nodeId, QStringLiteral("n3"));
+
+    hits = index.search(QStringLiteral("RCP"));
+    QCOMPARE(hits.size(), 3);
+    QCOMPARE(hits[0].nodeId, QStringLiteral("n1"));
+    QCOMPARE(hits[1].nodeId, QStringLiteral("n2"));
+    QCOMPARE(hits[2].nodeId, QStringLiteral("n3"));
+    QCOMPARE(index.search(QStringLiteral("RCP"), 1).size(), 1);
+    QCOMPARE(index.search(QStringLiteral("oo")).size(), 1);
+    QCOMPARE(index.search(QStringLiteral("voter")).size(), 1);
+    QVERIFY(index.search(QStringLiteral("zzz")).isEmpty());
+
+    index.remove(QStringLiteral("n1"));
+    QCOMPARE(index.size(), 2);
+    QCOMPARE(index.search(QStringLiteral("rcp0001km")).size(), 1);
+
+    EditorScene scene;
+    NodeItem* node = scene.createNode(QStringLiteral("tm_Node"), QPointF(100.0, 100.0));
+    QVERIFY(node != nullptr);
+    const QString nodeId = node->nodeId();
+    QVERIFY(scene.renameNodeWithUndo(nodeId, QStringLiteral("RCP0042KM")));
+    hits = scene.searchNodes(QStringLiteral("0042"));
+    QCOMPARE(hits.size(), 1);
+    QCOMPARE(hits[0].nodeId, nodeId);
+    QVERIFY(scene.setNodePropertyWithUndo(nodeId, QStringLiteral("pressure"), QStringLiteral("17.25")));
+    QCOMPARE(scene.searchNodes(QStringLiteral("17.25")).size(), 1);
+
+    node->setSelected(true);
+    scene.deleteSelectionWithUndo();
+    QVERIFY(scene.searchNodes(QStringLiteral("0042")).isEmpty());
+}
+
+void EdaSuite::typedPropertyStore() {
+    PropertyStore store;
+    store.assign({PropertyData{QStringLiteral("enabled"), QStringLiteral("bool"), QStringLiteral("True")},
+                  PropertyData{QStringLiteral("votes"), QStringLiteral("int"), QStringLiteral("2")},
+                  PropertyData{QStringLiteral("gain"), QStringLiteral("double"), QStringLiteral("3")},
+                  PropertyData{QStringLiteral("tag"), QStringLiteral("string"), QStringLiteral("RCP")},
+                  PropertyData{QStringLiteral("bias"), QStringLiteral("double"), QStringLiteral("n/a")}});
+    QCOMPARE(store.size(), 5);
+    QVERIFY(store.boolValue(QStringLiteral("enabled")));
+    QCOMPARE(store.intValue(QStringLiteral("votes")), Q_INT64_C(2));
+    QCOMPARE(store.doubleValue(QStringLiteral("gain")), 3.0);
+    QCOMPARE(store.text(QStringLiteral("enabled")), QStringLiteral("True"));
+    QCOMPARE(store.text(QStringLiteral("gain")), QStringLiteral("3"));
+    QCOMPARE(store.text(QStringLiteral("tag")), QStringLiteral("RCP"));
+    QCOMPARE(store.text(QStringLiteral("bias")), QStringLiteral("n/a"));
+    QCOMPARE(store.typeName(QStringLiteral("bias")), QStringLiteral("double"));
+    QVERIFY(!store.setText(QStringLiteral("gain"), QStringLiteral("3.0000")));
+    QCOMPARE(store.text(QStringLiteral("gain")), QStringLiteral("3"));
+    QVERIFY(store.setText(QStringLiteral("gain"), QStringLiteral("0.25")));
+    QCOMPARE(store.text(QStringLiteral("gain")), QStringLiteral("0.25"));
+    QVERIFY(store.setText(QStringLiteral("bias"), QStringLiteral("-1")));
+    QCOMPARE(store.text(QStringLiteral("bias")), QStringLiteral("-1"));
+    QVERIFY(store.setText(QStringLiteral("votes"), QStringLiteral("5000000000")));
+    QCOMPARE(store.intValue(QStringLiteral("votes")), Q_INT64_C(5000000000));
+    QVERIFY(!store.setText(QStringLiteral("missing"), QStringLiteral("1")));
+
+    EditorScene scene;
+    NodeItem* a = scene.createNode(QStringLiteral("tm_Node"), QPointF(100.0, 100.0));
+    NodeItem* b = scene.createNode(QStringLiteral("tm_Node"), QPointF(340.0, 100.0));
+    QVERIFY(a != nullptr);
+    QVERIFY(b != nullptr);
+    QCOMPARE(a->propertyStore().schema(), b->propertyStore().schema());
+    QVERIFY(scene.setNodePropertyWithUndo(a->nodeId(), QStringLiteral("pressure"), QStringLiteral("2.5000")));
+    QCOMPARE(a->propertyValue(QStringLiteral("pressure")), QStringLiteral("2.5000"));
+    QCOMPARE(a->propertyStore().doubleValue(QStringLiteral("pressure")), 2.5);
+    QVERIFY(!scene.setNodePropertyWithUndo(a->nodeId(), QStringLiteral("pressure"), QStringLiteral("2.50")));
+    QCOMPARE(a->propertyValue(QStringLiteral("pressure")), QStringLiteral("2.5000"));
+}
+
+void EdaSuite::bulkPropertyEditSingleCommand() {
+    EditorScene scene;
+    QUndoStack undoStack;
+    scene.setUndoStack(&undoStack);
+
+    QVector<NodeItem*> sfts;
+    for (int i = 0; i < 5; ++i) {
+        NodeItem* node = scene.createNode(QStringLiteral("SFT"), QPointF(100.0 + i * 160.0, 100.0));
+        QVERIFY(node != nullptr);
+        sfts.push_back(node);
+    }
+    NodeItem* other = scene.createNode(QStringLiteral("tm_Node"), QPointF(100.0, 300.0));
+    QVERIFY(other != nullptr);
+    QVERIFY(scene.setNodePropertyWithUndo(sfts[4]->nodeId(), QStringLiteral("gain"), QStringLiteral("2.0")));
+    undoStack.clear();
+
+    scene.clearSelection();
+    for (NodeItem* node : sfts) {
+        node->setSelected(true);
+    }
+    other->setSelected(true);
+
+    QSignalSpy graphChangedSpy(&scene, &EditorScene::graphChanged);
+    QCOMPARE(scene.setSelectionPropertyWithUndo(QStringLiteral("gain"), QStringLiteral("2.0")), 4);
+    QCOMPARE(graphChangedSpy.count(), 1);
+    QCOMPARE(undoStack.count(), 1);
+    for (NodeItem* node : sfts) {
+        QCOMPARE(node->propertyValue(QStringLiteral("gain")), QStringLiteral("2.0"));
+    }
+
+    undoStack.undo();
+    for (int i = 0; i < 4; ++i) {
+        QCOMPARE(sfts[i]->propertyValue(QStringLiteral("gain")), QStringLiteral("1.0"));
+    }
+    QCOMPARE(sfts[4]->propertyValue(QStringLiteral("gain")), QStringLiteral("2.0"));
+    undoStack.redo();
+    QCOMPARE(sfts[0]->propertyValue(QStringLiteral("gain")), QStringLiteral("2.0"));
+
+    scene.clearSelection();
+    QCOMPARE(scene.setTypePropertyWithUndo(QStringLiteral("SFT"), QStringLiteral("enabled"), QStringLiteral("false")), 5);
+    QCOMPARE(undoStack.count(), 2);
+    QCOMPARE(other->propertyValue(QStringLiteral("enabled")), QStringLiteral("true"));
+    QCOMPARE(scene.setTypePropertyWithUndo(QStringLiteral("SFT"), QStringLiteral("enabled"), QStringLiteral("false")), 0);
+    QCOMPARE(undoStack.count(), 2);
+}
+
+void EdaSuite::stringAtomsShareVocabulary() {
+    const QString built = QStringLiteral("tm_") + QStringLiteral("Node");
+    const StringAtom a(QStringLiteral("tm_Node"));
+    const StringAtom b(built);
+    QVERIFY(a == b);
+    QVERIFY(a != StringAtom(QStringLiteral("SFT")));
+    QVERIFY(StringAtom().isEmpty());
+    QVERIFY(StringAtom(QString()) == StringAtom());
+    QCOMPARE(a.toString(), QStringLiteral("tm_Node"));
+    QCOMPARE(StringAtom::intern(built).constData(), a.toString().constData());
+    const int tableSize = StringAtom::tableSize();
+    StringAtom again(QStringLiteral("tm_Node"));
+    Q_UNUSED(again);
+    QCOMPARE(StringAtom::tableSize(), tableSize);
+    StringAtom found;
+    QVERIFY(StringAtom::find(built, &found));
+    QVERIFY(found == a);
+    QVERIFY(!StringAtom::find(QStringLiteral("never_interned_type"), &found));
+
+    EditorScene scene;
+    NodeItem* first = scene.createNode(QStringLiteral("tm_Node"), QPointF(100.0, 100.0));
+    NodeItem* second = scene.createNode(QStringLiteral("tm_Node"), QPointF(300.0, 100.0));
+    QVERIFY(first != nullptr);
+    QVERIFY(second != nullptr);
+    QCOMPARE(first->typeName(), second->typeName());
+    QVERIFY(scene.createEdge(first->firstOutputPort(), second->firstInputPort()) != nullptr);
+    const int sizeBeforeTypeEdit = StringAtom::tableSize();
+    QCOMPARE(scene.setTypePropertyWithUndo(QStringLiteral("no_such_type"), QStringLiteral("enabled"), QStringLiteral("0")), 0);
+    QCOMPARE(StringAtom::tableSize(), sizeBeforeTypeEdit);
+
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    const QString filePath = tmp.filePath(QStringLiteral("atoms.json"));
+    QString error;
+    GraphDocument saved = scene.toDocument();
+    saved.nodes[0].groupId = QStringLiteral("G_only_in_this_document");
+    saved.nodes[1].groupId = saved.nodes[0].groupId;
+    QVERIFY(GraphSerializer::saveToFile(saved, filePath, &error));
+
+    GraphDocument doc;
+    QVERIFY(GraphSerializer::loadFromFile(&doc, filePath, &error));
+    QCOMPARE(doc.nodes.size(), 2);
+    QCOMPARE(doc.edges.size(), 1);
+    // Document names are shared within the load but kept out of the atom table.
+    QCOMPARE(doc.nodes[0].groupId.constData(), doc.nodes[1].groupId.constData());
+    QVERIFY(!StringAtom::find(doc.nodes[0].groupId, nullptr));
+    QCOMPARE(doc.nodes[0].type.constData(), doc.nodes[1].type.constData());
+    QCOMPARE(doc.nodes[0].ports[0].name.constData(), doc.nodes[1].ports[0].name.constData());
+    QCOMPARE(doc.nodes[0].ports[0].direction.constData(), doc.nodes[1].ports[0].direction.constData());
+    QCOMPARE(doc.nodes[0].ports[0].direction.constData(), StringAtom::intern(doc.nodes[0].ports[0].direction).constData());
+
+    const EdgeData& edge = doc.edges.first();
+    for (const NodeData& node : doc.nodes) {
+        if (node.id == edge.fromNodeId) {
+            QCOMPARE(edge.fromNodeId.constData(), node.id.constData());
+        } else {
+            QCOMPARE(edge.toNodeId.constData(), node.id.constData());
+        }
+    }
+}
+
+void EdaSuite::binaryFormatRoundtrip() {
+    EditorScene scene;
+    QVector<NodeItem*> nodes;
+    for (int i = 0; i < 40; ++i) {
+        NodeItem* node = scene.createNode(i % 2 == 0 ? QStringLiteral("SFT") : QStringLiteral("tm_Node"),
+                                          QPointF(100.0 + (i % 8) * 160.0, 100.0 + (i / 8) * 120.0));
+        QVERIFY(node != nullptr);
+        nodes.push_back(node);
+    }
+    for (int i = 1; i < nodes.size(); ++i) {
+        QVERIFY(scene.createEdge(nodes[i - 1]->firstOutputPort(), nodes[i]->firstInputPort()) != nullptr);
+    }
+    QVERIFY(scene.setNodePropertyWithUndo(nodes[0]->nodeId(), QStringLiteral("gain"), QStringLiteral("2.5")));
+    nodes[3]->setDisplayName(QStringLiteral("Résumé \u03A9"));
+    const GraphDocument src = scene.toDocument();
+
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    const QString binaryPath = tmp.filePath(QStringLiteral("graph.edab"));
+    const QString jsonPath = tmp.filePath(QStringLiteral("graph.json"));
+    QString error;
+    QVERIFY(GraphSerializer::saveToFile(src, binaryPath, &error));
+    QVERIFY(GraphSerializer::saveToFile(src, jsonPath, &error));
+    QVERIFY(QFileInfo(binaryPath).size() * 3 < QFileInfo(jsonPath).size());
+
+    QFile binaryFile(binaryPath);
+    QVERIFY(binaryFile.open(QIODevice::ReadOnly));
+    const QByteArray payload = binaryFile.readAll();
+    binaryFile.close();
+    QVERIFY(BinaryGraphFormat::hasMagic(payload));
+
+    GraphDocument fromBinary;
+    GraphDocument fromJson;
+    QVERIFY2(GraphSerializer::loadFromFile(&fromBinary, binaryPath, &error), qPrintable(error));
+    QVERIFY2(GraphSerializer::loadFromFile(&fromJson, jsonPath, &error), qPrintable(error));
+    QCOMPARE(fromBinary.schemaVersion, fromJson.schemaVersion);
+    QCOMPARE(fromBinary.activeLayerId, fromJson.activeLayerId);
+    QCOMPARE(fromBinary.layers.size(), fromJson.layers.size());
+    QCOMPARE(fromBinary.nodes.size(), fromJson.nodes.size());
+    QCOMPARE(fromBinary.edges.size(), fromJson.edges.size());
+    for (int i = 0; i < fromJson.nodes.size(); ++i) {
+        const NodeData& a = fromBinary.nodes[i];
+        const NodeData& b = fromJson.nodes[i];
+        QCOMPARE(a.id, b.id);
+        QCOMPARE(a.type, b.type);
+        QCOMPARE(a.name, b.name);
+        QCOMPARE(a.position, b.position);
+        QCOMPARE(a.size, b.size);
+        QCOMPARE(a.layerId, b.layerId);
+        QCOMPARE(a.ports.size(), b.ports.size());
+        QCOMPARE(a.ports.last().direction, b.ports.last().direction);
+        QCOMPARE(a.properties.size(), b.properties.size());
+        for (int k = 0; k < b.properties.size(); ++k) {
+            QCOMPARE(a.properties[k].key, b.properties[k].key);
+            QCOMPARE(a.properties[k].value, b.properties[k].value);
+        }
+    }
+    QCOMPARE(fromBinary.nodes[3].name, QStringLiteral("Résumé \u03A9"));
+    QCOMPARE(fromBinary.edges.last().toPortId, fromJson.edges.last().toPortId);
+
+    // Legacy documents stored in binary still go through schema migration.
+    GraphDocument legacy;
+    legacy.schemaVersion = 0;
+    legacy.nodes.push_back(NodeData{QStringLiteral("N_A"), QStringLiteral("tm_Node"), QStringLiteral("A"),
+                                    QPointF(10.0, 20.0), QSizeF(120.0, 72.0), {}, {}});
+    const QString legacyPath = tmp.filePath(QStringLiteral("legacy.edab"));
+    QVERIFY(GraphSerializer::saveToFile(legacy, legacyPath, &error));
+    GraphDocument migrated;
+    QVERIFY(GraphSerializer::loadFromFile(&migrated, legacyPath, &error));
+    QCOMPARE(migrated.schemaVersion, 1);
+    QCOMPARE(migrated.nodes[0].ports.size(), 2);
+    QCOMPARE(migrated.nodes[0].layerId, QStringLiteral("L_1"));
+
+    const QString truncatedPath = tmp.filePath(QStringLiteral("truncated.edab"));
+    QFile truncated(truncatedPath);
+    QVERIFY(truncated.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    truncated.write(payload.left(payload.size() / 2));
+    truncated.close();
+    GraphDocument broken;
+    error.clear();
+    QVERIFY(!GraphSerializer::loadFromFile(&broken, truncatedPath, &error));
+    QVERIFY(!error.isEmpty());
+}
+
+void EdaSuite::binaryViewBuildsScene() {
+    EditorScene source;
+    QVector<NodeItem*> nodes;
+    for (int i = 0; i < 12; ++i) {
+        NodeItem* node = source.createNode(QStringLiteral("SFT"), QPointF(100.0 + i * 160.0, 100.0));
+        QVERIFY(node != nullptr);
+        nodes.push_back(node);
+    }
+    for (int i = 1; i < nodes.size(); ++i) {
+        QVERIFY(source.createEdge(nodes[i - 1]->firstOutputPort(), nodes[i]->firstInputPort()) != nullptr);
+    }
+    GraphDocument document = source.toDocument();
+    QVERIFY(!document.layers.isEmpty());
+    document.layers.first().name.clear();
+
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    const QString filePath = tmp.filePath(QStringLiteral("view.edab"));
+    QString error;
+    QVERIFY(GraphSerializer::saveToFile(document, filePath, &error));
+
+    BinaryGraphView view;
+    QVERIFY2(view.open(filePath, &error), qPrintable(error));
+    QCOMPARE(view.schemaVersion(), GraphSerializer::kCurrentSchemaVersion);
+    QCOMPARE(view.nodeCount(), document.nodes.size());
+    QCOMPARE(view.edgeCount(), document.edges.size());
+    const NodeRecordView first = view.node(0);
+    QVERIFY(first.id == document.nodes[0].id);
+    QVERIFY(first.type == QStringLiteral("SFT"));
+    QCOMPARE(first.portCount, document.nodes[0].ports.size());
+    QVERIFY(view.port(first.firstPort).id == document.nodes[0].ports[0].id);
+    QVERIFY(view.edge(0).toNodeId == document.edges[0].toNodeId);
+    // Equal strings resolve to the same table entry, not separate copies.
+    QCOMPARE(view.node(1).type.data(), first.type.data());
+
+    EditorScene rebuilt;
+    QSignalSpy resetSpy(&rebuilt, &EditorScene::graphReset);
+    QVERIFY(rebuilt.fromBinaryView(view));
+    QCOMPARE(resetSpy.count(), 1);
+    QCOMPARE(countNodes(rebuilt), nodes.size());
+    QCOMPARE(countEdges(rebuilt), nodes.size() - 1);
+    const GraphDocument roundtrip = rebuilt.toDocument();
+    QCOMPARE(roundtrip.nodes[5].id, document.nodes[5].id);
+    QCOMPARE(roundtrip.nodes[5].position, document.nodes[5].position);
+    QCOMPARE(roundtrip.nodes[5].properties.size(), document.nodes[5].properties.size());
+    // Settings are normalized as on the loadFromFile path.
+    QCOMPARE(roundtrip.layers.first().name, roundtrip.layers.first().id);
+    view.close();
+    QVERIFY(!view.isOpen());
+
+    // A string index past the table is rejected before any record is read.
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QByteArray corrupt = file.readAll();
+    file.close();
+    BinaryGraphView check;
+    QVERIFY(check.attach(corrupt, &error));
+    const quint32 sectionCount = qFromLittleEndian<quint32>(corrupt.constData() + 12);
+    for (quint32 i = 0; i < sectionCount; ++i) {
+        const char* entry = corrupt.constData() + BinaryGraphFormat::kHeaderSize + BinaryGraphFormat::kDirectoryEntrySize * i;
+        if (qFromLittleEndian<quint32>(entry) == BinaryGraphFormat::Nodes) {
+            const quint64 offset = qFromLittleEndian<quint64>(entry + 8);
+            qToLittleEndian<quint32>(0xFFFFFFFFu, corrupt.data() + offset + 48);
+            break;
+        }
+    }
+    error.clear();
+    QVERIFY(!check.attach(corrupt, &error));
+    QVERIFY(!error.isEmpty());
+    QVERIFY(!check.isOpen());
+}
+
+void EdaSuite::jsonStreamMatchesQJsonDocument() {
+    EditorScene scene;
+    NodeItem* a = scene.createNode(QStringLiteral("SFT"), QPointF(100.5, -20.25));
+    NodeItem* b = scene.createNode(QStringLiteral("tm_Node"), QPointF(300.0, 100.0));
+    QVERIFY(a != nullptr);
+    QVERIFY(b != nullptr);
+    QVERIFY(scene.createEdge(a->firstOutputPort(), b->firstInputPort()) != nullptr);
+    a->setDisplayName(QStringLiteral("quote\" back\\ tab\t nl\n bell\x07 é \u2126 ") + QString::fromUcs4(U"\U0001F600"));
+    GraphDocument document = scene.toDocument();
+    document.collapsedGroupIds = {QStringLiteral("G_9"), QString()};
+    document.edgeBundleSpacing = 0.1 + 0.2;
+    document.nodes[1].rotationDegrees = -0.0;
+    document.nodes[1].z = 1e21;
+    document.nodes[1].ports.clear();
+
+    for (JsonStreamWriter::Format format : {JsonStreamWriter::Format::Indented, JsonStreamWriter::Format::Compact}) {
+        QBuffer buffer;
+        QVERIFY(buffer.open(QIODevice::WriteOnly));
+        QString error;
+        QVERIFY2(GraphSerializer::writeJson(document, &buffer, format, &error), qPrintable(error));
+        const QByteArray streamed = buffer.data();
+
+        QJsonParseError parseError;
+        const QJsonDocument parsed = QJsonDocument::fromJson(streamed, &parseError);
+        QCOMPARE(parseError.error, QJsonParseError::NoError);
+        const QByteArray expected = parsed.toJson(format == JsonStreamWriter::Format::Compact ? QJsonDocument::Compact
+                                                                                             : QJsonDocument::Indented);
+        QCOMPARE(streamed, expected);
+    }
+
+    // A tiny buffer flushes many times but yields the same bytes.
+    QBuffer whole;
+    QBuffer chunked;
+    QVERIFY(whole.open(QIODevice::WriteOnly));
+    QVERIFY(chunked.open(QIODevice::WriteOnly));
+    QVERIFY(GraphSerializer::writeJson(document, &whole));
+    {
+        JsonStreamWriter writer(&chunked, JsonStreamWriter::Format::Indented, 256);
+        writer.beginObject();
+        writer.writeKey(QStringLiteral("items"));
+        writer.beginArray();
+        for (int i = 0; i < 200; ++i) {
+            writer.writeInt(i);
+        }
+        writer.endArray();
+        writer.writeKey(QStringLiteral("nested"));
+        writer.beginObject();
+        writer.endObject();
+        writer.endObject();
+        QVERIFY(writer.flush());
+    }
+    QJsonArray items;
+    for (int i = 0; i < 200; ++i) {
+        items.append(i);
+    }
+    QJsonObject root;
+    root[QStringLiteral("items")] = items;
+    root[QStringLiteral("nested")] = QJsonObject();
+    QCOMPARE(chunked.data(), QJsonDocument(root).toJson(QJsonDocument::Indented));
+
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    const QString filePath = tmp.filePath(QStringLiteral("streamed.json"));
+    QVERIFY(GraphSerializer::saveToFile(document, filePath));
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), whole.data());
+}
+
+void EdaSuite::jsonChunkedParallelLoad() {
+    JsonChunkScanner scanner({QByteArrayLiteral("items")});
+    const QByteArray sample = R"( { "a": "x\"]}", "items": [ {"k": "[{"}, 2 , "s\\"], "b": [1, {"c": null}] } )";
+    QVERIFY2(scanner.scan(sample), qPrintable(scanner.errorString()));
+    const QVector<JsonSpan> items = scanner.elements(QByteArrayLiteral("items"));
+    QCOMPARE(items.size(), 3);
+    QCOMPARE(sample.mid(items[0].begin, items[0].end - items[0].begin), QByteArray(R"({"k": "[{"})"));
+    QCOMPARE(sample.mid(items[2].begin, items[2].end - items[2].begin), QByteArray(R"("s\\")"));
+    QCOMPARE(scanner.members().size(), 2);
+    const QJsonObject skeleton = QJsonDocument::fromJson(scanner.skeleton()).object();
+    QCOMPARE(skeleton.value(QStringLiteral("a")).toString(), QStringLiteral("x\"]}"));
+    QVERIFY(!skeleton.contains(QStringLiteral("items")));
+    QVERIFY(!scanner.scan(QByteArrayLiteral(R"({"items": [1, 2})")));
+    QVERIFY(!scanner.scan(QByteArrayLiteral(R"({"a": "unterminated})")));
+
+    GraphDocument src;
+    src.layers = {LayerData{QStringLiteral("L_1"), QStringLiteral("Base"), true, false}};
+    src.activeLayerId = QStringLiteral("L_1");
+    const int nodeCount = 5000;
+    for (int i = 0; i < nodeCount; ++i) {
+        const QString id = QStringLiteral("N_%1").arg(i + 1);
+        src.nodes.push_back(NodeData{id,
+                                     i % 3 == 0 ? QStringLiteral("SFT") : QStringLiteral("tm_Node"),
+                                     QStringLiteral("Node \"%1\"").arg(i),
+                                     QPointF(i * 1.5, -i * 0.25),
+                                     QSizeF(120.0, 72.0),
+                                     {PortData{QStringLiteral("P_%1").arg(2 * i + 1), QStringLiteral("in1"), QStringLiteral("input")},
+                                      PortData{QStringLiteral("P_%1").arg(2 * i + 2), QStringLiteral("out1"), QStringLiteral("output")}},
+                                     {PropertyData{QStringLiteral("gain"), QStringLiteral("double"), QString::number(i)}},
+                                     0.0,
+                                     1.0,
+                                     QString(),
+                                     QStringLiteral("L_1")});
+        if (i > 0) {
+            src.edges.push_back(EdgeData{QStringLiteral("E_%1").arg(i),
+                                         src.nodes[i - 1].id,
+                                         src.nodes[i - 1].ports[1].id,
+                                         id,
+                                         src.nodes[i].ports[0].id});
+        }
+    }
+
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    const QString filePath = tmp.filePath(QStringLiteral("large.json"));
+    QString error;
+    QVERIFY(GraphSerializer::saveToFile(src, filePath, &error));
+
+    GraphDocument loaded;
+    QVERIFY2(GraphSerializer::loadFromFile(&loaded, filePath, &error), qPrintable(error));
+    QCOMPARE(loaded.nodes.size(), nodeCount);
+    QCOMPARE(loaded.edges.size(), nodeCount - 1);
+    for (int i = 0; i < nodeCount; i += 997) {
+        QCOMPARE(loaded.nodes[i].id, src.nodes[i].id);
+        QCOMPARE(loaded.nodes[i].name, src.nodes[i].name);
+        QCOMPARE(loaded.nodes[i].position, src.nodes[i].position);
+        QCOMPARE(loaded.nodes[i].properties[0].value, src.nodes[i].properties[0].value);
+    }
+    QCOMPARE(loaded.nodes.last().id, src.nodes.last().id);
+    QCOMPARE(loaded.edges.last().toPortId, src.edges.last().toPortId);
+    QCOMPARE(loaded.edges[2500].fromNodeId.constData(), loaded.nodes[2500].id.constData());
+    // Chunks pool their strings locally and meet in the atom table on merge.
+    QCOMPARE(loaded.nodes[0].type.constData(), loaded.nodes[4998].type.constData());
+    QCOMPARE(loaded.nodes[0].ports[0].direction.constData(), loaded.nodes[4999].ports[0].direction.constData());
+
+    // A broken element deep inside an element array still fails the load.
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QByteArray payload = file.readAll();
+    file.close();
+    const int at = payload.indexOf("\"N_4321\"");
+    QVERIFY(at > 0);
+    payload.replace(at, 8, "N_4321");
+    const QString brokenPath = tmp.filePath(QStringLiteral("broken.json"));
+    QFile broken(brokenPath);
+    QVERIFY(broken.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    broken.write(payload);
+    broken.close();
+    GraphDocument rejected;
+    error.clear();
+    QVERIFY(!GraphSerializer::loadFromFile(&rejected, brokenPath, &error));
+    QVERIFY(error.startsWith(QStringLiteral("Invalid JSON")));
+}
+
+void EdaSuite::backgroundSaveKeepsEditing() {
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    const QString savePath = tmp.filePath(QStringLiteral("background_save.json"));
+
+    MainWindow window;
+    const int index = window.newDocument(QStringLiteral("BackgroundSave"));
+    EditorScene* scene = window.activeScene();
+    QVERIFY(scene != nullptr);
+    QVERIFY(scene->createNodeWithUndo(QStringLiteral("Voter"), QPointF(120.0, 120.0)) != nullptr);
+    const int snapshotNodes = scene->toDocument().nodes.size();
+    window.setSaveFileDialogProvider([savePath](const QString&) { return savePath; });
+
+    // An edit made while the worker is still writing must keep the tab dirty.
+    QVERIFY(window.saveCurrentDocument(true, MainWindow::SaveMode::Background));
+    QVERIFY(scene->createNodeWithUndo(QStringLiteral("Sum"), QPointF(260.0, 120.0)) != nullptr);
+    window.waitForPendingSaves();
+    QCOMPARE(window.pendingSaveCount(), 0);
+    QCOMPARE(window.documentFilePath(index), savePath);
+    QVERIFY(window.isDocumentDirty(index));
+
+    GraphDocument saved;
+    QString error;
+    QVERIFY2(GraphSerializer::loadFromFile(&saved, savePath, &error), qPrintable(error));
+    QCOMPARE(saved.nodes.size(), snapshotNodes);
+
+    // Without further edits the completion, delivered through the event loop,
+    // marks the document clean.
+    QVERIFY(window.saveCurrentDocument(false, MainWindow::SaveMode::Background));
+    QTRY_COMPARE(window.pendingSaveCount(), 0);
+    QVERIFY(!window.isDocumentDirty(index));
+    QVERIFY2(GraphSerializer::loadFromFile(&saved, savePath, &error), qPrintable(error));
+    QCOMPARE(saved.nodes.size(), snapshotNodes + 1);
+
+    // QSaveFile renames its temporary over the target, so only the document
+    // and its edit journal remain.
+    QCOMPARE(QDir(tmp.path()).entryList(QDir::Files, QDir::Name),
+             (QStringList{QStringLiteral("background_save.json"), QStringLiteral("background_save.json.journal")}));
+}
+
+void EdaSuite::journalRecoversUnsavedEdits() {
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    const QString path = tmp.filePath(QStringLiteral("journaled.json"));
+    const QString journalPath = GraphJournal::journalPathFor(path);
+
+    GraphDocument base;
+    base.nodes.push_back(NodeData{QStringLiteral("N_1"),
+                                  QStringLiteral("tm_Node"),
+                                  QStringLiteral("Base"),
+                                  QPointF(10.0, 20.0),
+                                  QSizeF(120.0, 72.0),
+                                  {PortData{QStringLiteral("P_1"), QStringLiteral("in1"), QStringLiteral("input")},
+                                   PortData{QStringLiteral("P_2"), QStringLiteral("out1"), QStringLiteral("output")}},
+                                  {}});
+    QString error;
+    QVERIFY2(GraphSerializer::saveToFile(base, path, &error), qPrintable(error));
+
+    GraphDocument expected;
+    qint64 sizeAfterFirstEdit = 0;
+    {
+        // The window is dropped without closeEvent(), like a crash after the
+        // journal was flushed.
+        MainWindow window;
+        QVERIFY(window.openDocumentFromPath(path));
+        QVERIFY(QFileInfo::exists(journalPath));
+        EditorScene* scene = window.activeScene();
+        QVERIFY(scene != nullptr);
+
+        QVERIFY(scene->renameNodeWithUndo(QStringLiteral("N_1"), QStringLiteral("Renamed")));
+        sizeAfterFirstEdit = QFileInfo(journalPath).size();
+        QVERIFY(scene->moveNodeWithUndo(QStringLiteral("N_1"), QPointF(300.0, 200.0)));
+        NodeItem* added = scene->createNodeWithUndo(QStringLiteral("Sum"), QPointF(500.0, 200.0));
+        QVERIFY(added != nullptr);
+        NodeItem* removed = scene->createNodeWithUndo(QStringLiteral("Voter"), QPointF(700.0, 200.0));
+        QVERIFY(removed != nullptr);
+        scene->clearSelection();
+        removed->setSelected(true);
+        scene->deleteSelectionWithUndo();
+        expected = scene->toDocument();
+    }
+    QCOMPARE(expected.nodes.size(), 2);
+
+    // A single-node edit costs a record of its own size, not a document rewrite.
+    QVERIFY(sizeAfterFirstEdit > GraphJournal::kHeaderSize);
+    QVERIFY(sizeAfterFirstEdit < GraphJournal::kHeaderSize + 1024);
+    QVERIFY(GraphJournal::hasRecoverableEdits(path));
+
+    // A torn record at the end is ignored.
+    {
+        QFile journal(journalPath);
+        QVERIFY(journal.open(QIODevice::Append));
+        journal.write("\x40\x00\x00\x00\x01", 5);
+    }
+
+    MainWindow window;
+    QVERIFY(window.openDocumentFromPath(path));
+    const int index = window.activeDocumentIndex();
+    QVERIFY(window.isDocumentDirty(index));
+    const GraphDocument recovered = window.activeScene()->toDocument();
+    QCOMPARE(recovered.nodes.size(), expected.nodes.size());
+    for (int i = 0; i < expected.nodes.size(); ++i) {
+        QCOMPARE(recovered.nodes[i].id, expected.nodes[i].id);
+        QCOMPARE(recovered.nodes[i].type, expected.nodes[i].type);
+        QCOMPARE(recovered.nodes[i].name, expected.nodes[i].name);
+        QCOMPARE(recovered.nodes[i].position, expected.nodes[i].position);
+    }
+
+    // A full save becomes the new base and empties the journal.
+    QVERIFY(window.saveCurrentDocument());
+    QVERIFY(!window.isDocumentDirty(index));
+    QVERIFY(!GraphJournal::hasRecoverableEdits(path));
+    QCOMPARE(QFileInfo(journalPath).size(), static_cast<qint64>(GraphJournal::kHeaderSize));
+
+    QVERIFY(window.closeDocument(index));
+    QVERIFY(!QFileInfo::exists(journalPath));
+}
+
+void EdaSuite::chunkedFormatIncrementalSave() {
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    const QString path = tmp.filePath(QStringLiteral("chunked.edac"));
+
+    const auto makeNode = [](const QString& id, const QPointF& position) {
+        return NodeData{id,
+                        QStringLiteral("tm_Node"),
+                        id,
+                        position,
+                        QSizeF(120.0, 72.0),
+                        {PortData{QStringLiteral("P_1"), QStringLiteral("in1"), QStringLiteral("input")},
+                         PortData{QStringLiteral("P_2"), QStringLiteral("out1"), QStringLiteral("output")}},
+                        {}};
+    };
+    GraphDocument base;
+    base.nodes.push_back(makeNode(QStringLiteral("N_1"), QPointF(20.0, 20.0)));
+    base.nodes.push_back(makeNode(QStringLiteral("N_2"), QPointF(2100.0, 20.0)));
+    base.nodes.push_back(makeNode(QStringLiteral("N_3"), QPointF(20.0, 2100.0)));
+    base.edges.push_back(EdgeData{QStringLiteral("E_1"),
+                                  QStringLiteral("N_1"),
+                                  QStringLiteral("P_2"),
+                                  QStringLiteral("N_2"),
+                                  QStringLiteral("P_1")});
+    QString error;
+    QVERIFY2(GraphSerializer::saveToFile(base, path, &error), qPrintable(error));
+
+    GraphDocument loaded;
+    QVERIFY2(GraphSerializer::loadFromFile(&loaded, path, &error), qPrintable(error));
+    QCOMPARE(loaded.nodes.size(), 3);
+    QCOMPARE(loaded.edges.size(), 1);
+    QCOMPARE(loaded.edges[0].fromNodeId, QStringLiteral("N_1"));
+
+    const auto chunkOffsets = [&path]() {
+        QVector<ChunkedGraphFormat::ChunkEntry> entries;
+        QString tableError;
+        QHash<quint64, quint64> offsets;  // settings chunk under its kind's key
+        if (ChunkedGraphFormat::readChunkTable(path, &entries, &tableError)) {
+            for (const ChunkedGraphFormat::ChunkEntry& entry : entries) {
+                offsets.insert(entry.kind == ChunkedGraphFormat::SettingsChunk ? ~0ull : entry.tile, entry.offset);
+            }
+        }
+        return offsets;
+    };
+    const quint64 tileA = ChunkedGraphFormat::tileKey(QPointF(20.0, 20.0));
+    const quint64 tileB = ChunkedGraphFormat::tileKey(QPointF(2100.0, 20.0));
+    const quint64 tileC = ChunkedGraphFormat::tileKey(QPointF(20.0, 2100.0));
+    const quint64 tileD = ChunkedGraphFormat::tileKey(QPointF(4200.0, 20.0));
+    const QHash<quint64, quint64> initial = chunkOffsets();
+    QCOMPARE(initial.size(), 4);
+
+    MainWindow window;
+    QVERIFY(window.openDocumentFromPath(path));
+    EditorScene* scene = window.activeScene();
+    QVERIFY(scene != nullptr);
+
+    // A move inside one tile rewrites that tile and the settings chunk only.
+    QVERIFY(scene->moveNodeWithUndo(QStringLiteral("N_3"), QPointF(60.0, 2140.0)));
+    QVERIFY(window.saveCurrentDocument());
+    const QHash<quint64, quint64> afterMove = chunkOffsets();
+    QCOMPARE(afterMove.size(), 4);
+    QCOMPARE(afterMove.value(tileA), initial.value(tileA));
+    QCOMPARE(afterMove.value(tileB), initial.value(tileB));
+    QVERIFY(afterMove.value(tileC) != initial.value(tileC));
+    QVERIFY(afterMove.value(~0ull) != initial.value(~0ull));
+
+    // Moving the edge's source to another tile carries the edge along.
+    QVERIFY(scene->moveNodeWithUndo(QStringLiteral("N_1"), QPointF(4200.0, 20.0)));
+    QVERIFY(window.saveCurrentDocument());
+    const QHash<quint64, quint64> afterTransfer = chunkOffsets();
+    QVERIFY(!afterTransfer.contains(tileA));
+    QVERIFY(afterTransfer.contains(tileD));
+    QCOMPARE(afterTransfer.value(tileB), initial.value(tileB));
+
+    const GraphDocument expected = scene->toDocument();
+    QVERIFY2(GraphSerializer::loadFromFile(&loaded, path, &error), qPrintable(error));
+    std::sort(loaded.nodes.begin(), loaded.nodes.end(), [](const NodeData& a, const NodeData& b) { return a.id < b.id; });
+    QCOMPARE(loaded.nodes.size(), expected.nodes.size());
+    for (int i = 0; i < expected.nodes.size(); ++i) {
+        QCOMPARE(loaded.nodes[i].id, expected.nodes[i].id);
+        QCOMPARE(loaded.nodes[i].position, expected.nodes[i].position);
+    }
+    QCOMPARE(loaded.edges.size(), 1);
+    QCOMPARE(loaded.edges[0].id, QStringLiteral("E_1"));
+
+    // A damaged chunk is reported instead of loading a partial graph.
+    {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.seek(static_cast<qint64>(afterTransfer.value(tileB)) + 20));
+        char byte = 0;
+        QVERIFY(file.getChar(&byte));
+        QVERIFY(file.seek(static_cast<qint64>(afterTransfer.value(tileB)) + 20));
+        QVERIFY(file.putChar(static_cast<char>(byte ^ 0x5A)));
+    }
+    QVERIFY(!GraphSerializer::loadFromFile(&loaded, path, &error));
+    QVERIFY(error.contains(QStringLiteral("checksum")));
+}
+
+void EdaSuite::lazyLoadingFollowsViewport() {
+    // Four nodes per tile on a 10 x 10 tile grid, chained across tiles.
+    const qreal tile = ChunkedGraphFormat::kTileSize;
+    GraphDocument document;
+    for (int i = 0; i < 400; ++i) {
+        const int cell = i / 4;
+        const QString id = QStringLiteral("N_%1").arg(i + 1);
+        document.nodes.push_back(NodeData{id,
+                                          QStringLiteral("tm_Node"),
+                                          id,
+                                          QPointF((cell % 10) * tile + (i % 4) * 200.0 + 40.0, (cell / 10) * tile + 40.0),
+                                          QSizeF(120.0, 72.0),
+                                          {PortData{QStringLiteral("P_1"), QStringLiteral("in1"), QStringLiteral("input")},
+                                           PortData{QStringLiteral("P_2"), QStringLiteral("out1"), QStringLiteral("output")}},
+                                          {PropertyData{QStringLiteral("enabled"), QStringLiteral("bool"), QStringLiteral("true")}}});
+        if (i > 0) {
+            document.edges.push_back(EdgeData{QStringLiteral("E_%1").arg(i),
+                                              QStringLiteral("N_%1").arg(i),
+                                              QStringLiteral("P_2"),
+                                              id,
+                                              QStringLiteral("P_1")});
+        }
+    }
+
+    EditorScene scene;
+    QUndoStack undoStack;
+    scene.setUndoStack(&undoStack);
+    scene.setLazyLoadThreshold(100);
+    scene.setViewportRect(QRectF(0.0, 0.0, 800.0, 600.0));
+    QVERIFY(scene.fromDocument(document));
+    QVERIFY(scene.isLazyLoaded());
+    QCOMPARE(scene.loadedNodeCount(), 4);
+    QCOMPARE(scene.nodeCount(), 400);
+    QCOMPARE(scene.edgeCount(), 399);
+    QCOMPARE(scene.layerNodeCount(scene.activeLayerId()), 400);
+    QVERIFY(scene.nodeById(QStringLiteral("N_400")) == nullptr);
+
+    // Search, lookups and snapshots cover nodes without items.
+    const QVector<NodeSearchHit> hits = scene.searchNodes(QStringLiteral("N_400"));
+    QVERIFY(std::any_of(hits.begin(), hits.end(), [](const NodeSearchHit& hit) {
+        return hit.nodeId == QStringLiteral("N_400");
+    }));
+    QVERIFY(scene.unloadedNode(QStringLiteral("N_400")) != nullptr);
+    QCOMPARE(scene.graphSnapshot().edgeCount(), 399);
+    const GraphDocument saved = scene.toDocument();
+    QCOMPARE(saved.nodes.size(), 400);
+    QCOMPARE(saved.edges.size(), 399);
+    QCOMPARE(saved.nodes.last().id, QStringLiteral("N_99"));
+
+    // Bulk edits by type rewrite the unloaded records in place.
+    QCOMPARE(scene.setTypePropertyWithUndo(QStringLiteral("tm_Node"), QStringLiteral("enabled"), QStringLiteral("false")),
+             400);
+    QCOMPARE(scene.loadedNodeCount(), 4);
+    QCOMPARE(scene.unloadedNode(QStringLiteral("N_400"))->properties.first().value, QStringLiteral("false"));
+    undoStack.undo();
+    QCOMPARE(scene.loadedNodeCount(), 4);
+    QCOMPARE(scene.unloadedNode(QStringLiteral("N_400"))->properties.first().value, QStringLiteral("true"));
+    // A bulk edit that happens to hit one node takes the same path.
+    QCOMPARE(scene.setNodesPropertyWithUndo({QStringLiteral("N_400")}, QStringLiteral("enabled"), QStringLiteral("false")),
+             1);
+    QCOMPARE(scene.loadedNodeCount(), 4);
+    QCOMPARE(scene.unloadedNode(QStringLiteral("N_400"))->properties.first().value, QStringLiteral("false"));
+    undoStack.undo();
+    QCOMPARE(scene.unloadedNode(QStringLiteral("N_400"))->properties.first().value, QStringLiteral("true"));
+
+    // Editing an unloaded node builds its tile.
+    const QPointF original = document.nodes.last().position;
+    QVERIFY(scene.moveNodeWithUndo(QStringLiteral("N_400"), original + QPointF(300.0, 300.0)));
+    QVERIFY(scene.nodeById(QStringLiteral("N_400")) != nullptr);
+    QCOMPARE(scene.loadedNodeCount(), 8);
+
+    // Panning releases far tiles and builds the ones around the view.
+    scene.setViewportRect(QRectF(5.0 * tile, 5.0 * tile, 800.0, 600.0));
+    QCOMPARE(scene.loadedNodeCount(), 16);
+    QVERIFY(scene.nodeById(QStringLiteral("N_1")) == nullptr);
+    QVERIFY(scene.nodeById(QStringLiteral("N_400")) == nullptr);
+    QCOMPARE(scene.nodeCount(), 400);
+    QCOMPARE(scene.edgeCount(), 399);
+
+    // Undo reaches the released node, and its record keeps the result.
+    undoStack.undo();
+    QVERIFY(scene.nodeById(QStringLiteral("N_400")) != nullptr);
+    scene.setViewportRect(QRectF(5.0 * tile, 5.0 * tile, 800.0, 600.0));
+    const NodeData* record = scene.unloadedNode(QStringLiteral("N_400"));
+    QVERIFY(record != nullptr);
+    QCOMPARE(record->position, original);
+
+    // Selected nodes survive a pan.
+    NodeItem* selected = scene.loadNode(QStringLiteral("N_200"));
+    QVERIFY(selected != nullptr);
+    selected->setSelected(true);
+    scene.setViewportRect(QRectF(0.0, 0.0, 800.0, 600.0));
+    QCOMPARE(scene.nodeById(QStringLiteral("N_200")), selected);
+
+    // Deleting a node also removes its edge to an unloaded neighbour.
+    QVERIFY(scene.nodeById(QStringLiteral("N_5")) == nullptr);
+    scene.clearSelection();
+    scene.nodeById(QStringLiteral("N_4"))->setSelected(true);
+    scene.deleteSelectionWithUndo();
+    QCOMPARE(scene.nodeCount(), 399);
+    QCOMPARE(scene.edgeCount(), 397);
+    QCOMPARE(scene.graphSnapshot().edgeCount(), 397);
+    undoStack.undo();
+    QCOMPARE(scene.nodeCount(), 400);
+    QCOMPARE(scene.edgeCount(), 399);
+    QCOMPARE(scene.graphSnapshot().edgeCount(), 399);
+
+    // A fan-out cone selects its built part now and the rest as tiles load.
+    scene.clearSelection();
+    const int loadedBeforeCone = scene.loadedNodeCount();
+    scene.nodeById(QStringLiteral("N_1"))->setSelected(true);
+    QCOMPARE(scene.selectConeFromSelection(GraphCsr::Direction::FanOut), 399);
+    QCOMPARE(scene.loadedNodeCount(), loadedBeforeCone);
+    QVERIFY(scene.nodeById(QStringLiteral("N_4"))->isSelected());
+    NodeItem* pendingNode = scene.loadNode(QStringLiteral("N_5"));
+    QVERIFY(pendingNode != nullptr);
+    QVERIFY(pendingNode->isSelected());
+    QVERIFY(scene.edgeById(QStringLiteral("E_4"))->isSelected());
+    // Any other selection change drops the rest.
+    scene.clearSelection();
+    QVERIFY(!scene.loadNode(QStringLiteral("N_9"))->isSelected());
+
+    scene.loadAllTiles();
+    QVERIFY(!scene.isLazyLoaded());
+    QCOMPARE(scene.loadedNodeCount(), 400);
+    QCOMPARE(scene.edgeCount(), 399);
+    const GraphDocument reloaded = scene.toDocument();
+    QCOMPARE(reloaded.nodes.size(), 400);
+    QCOMPARE(reloaded.nodes.last().position, saved.nodes.last().position);
+}
+
+void EdaSuite::compressedFormatRoundtrip() {
+    // Large enough for the JSON to span several compressed blocks.
+    GraphDocument document;
+    for (int i = 0; i < 6000; ++i) {
+        const QString id = QStringLiteral("N_%1").arg(i + 1);
+        document.nodes.push_back(NodeData{id,
+                                          QStringLiteral("tm_Node"),
+                                          QStringLiteral("Node %1").arg(i),
+                                          QPointF((i % 100) * 160.0, (i / 100) * 120.0),
+                                          QSizeF(120.0, 72.0),
+                                          {PortData{QStringLiteral("P_1"), QStringLiteral("in1"), QStringLiteral("input")},
+                                           PortData{QStringLiteral("P_2"), QStringLiteral("out1"), QStringLiteral("output")}},
+                                          {PropertyData{QStringLiteral("gain"), QStringLiteral("double"),
+                                                        QString::number(i * 0.25)}}});
+        if (i > 0) {
+            document.edges.push_back(EdgeData{QStringLiteral("E_%1").arg(i),
+                                              QStringLiteral("N_%1").arg(i),
+                                              QStringLiteral("P_2"),
+                                              id,
+                                              QStringLiteral("P_1")});
+        }
+    }
+
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    const QString compressedPath = tmp.filePath(QStringLiteral("graph.edaz"));
+    const QString jsonPath = tmp.filePath(QStringLiteral("graph.json"));
+    QString error;
+    QVERIFY2(GraphSerializer::saveToFile(document, compressedPath, &error), qPrintable(error));
+    QVERIFY2(GraphSerializer::saveToFile(document, jsonPath, &error), qPrintable(error));
+    QVERIFY(QFileInfo(compressedPath).size() * 4 < QFileInfo(jsonPath).size());
+
+    QFile compressedFile(compressedPath);
+    QVERIFY(compressedFile.open(QIODevice::ReadOnly));
+    const QByteArray bytes = compressedFile.readAll();
+    compressedFile.close();
+    QVERIFY(CompressedGraphFormat::hasMagic(bytes));
+
+    GraphDocument fromCompressed;
+    GraphDocument fromJson;
+    QVERIFY2(GraphSerializer::loadFromFile(&fromCompressed, compressedPath, &error), qPrintable(error));
+    QVERIFY2(GraphSerializer::loadFromFile(&fromJson, jsonPath, &error), qPrintable(error));
+    QCOMPARE(fromCompressed.nodes.size(), 6000);
+    QCOMPARE(fromCompressed.edges.size(), 5999);
+    QCOMPARE(fromCompressed.activeLayerId, fromJson.activeLayerId);
+    for (int i : {0, 2999, 5999}) {
+        const NodeData& a = fromCompressed.nodes[i];
+        const NodeData& b = fromJson.nodes[i];
+        QCOMPARE(a.id, b.id);
+        QCOMPARE(a.name, b.name);
+        QCOMPARE(a.position, b.position);
+        QCOMPARE(a.ports.size(), b.ports.size());
+        QCOMPARE(a.properties.first().value, b.properties.first().value);
+    }
+    QCOMPARE(fromCompressed.edges.last().fromNodeId, QStringLiteral("N_5999"));
+
+    // Truncated and corrupted files are reported instead of half-loaded.
+    const auto writeFile = [](const QString& path, const QByteArray& content) {
+        QFile file(path);
+        return file.open(QIODevice::WriteOnly) && file.write(content) == content.size();
+    };
+    const QString brokenPath = tmp.filePath(QStringLiteral("broken.edaz"));
+    QVERIFY(writeFile(brokenPath, bytes.left(bytes.size() / 2)));
+    GraphDocument broken;
+    error.clear();
+    QVERIFY(!GraphSerializer::loadFromFile(&broken, brokenPath, &error));
+    QVERIFY(!error.isEmpty());
+
+    QByteArray corrupted = bytes;
+    const int offset = CompressedGraphFormat::kHeaderSize + CompressedGraphFormat::kBlockHeaderSize + 64;
+    corrupted[offset] = static_cast<char>(corrupted[offset] ^ 0x5A);
+    QVERIFY(writeFile(brokenPath, corrupted));
+    error.clear();
+    QVERIFY(!GraphSerializer::loadFromFile(&broken, brokenPath, &error));
+    QVERIFY(!error.isEmpty());
+
+    // A block claiming more compressed bytes than zlib can emit is refused before it is read.
+    QByteArray oversized = bytes;
+    qToLittleEndian<quint32>(0xFFFFFFF0u, oversized.data() + CompressedGraphFormat::kHeaderSize);
+    QVERIFY(writeFile(brokenPath, oversized));
+    error.clear();
+    QVERIFY(!GraphSerializer::loadFromFile(&broken, brokenPath, &error));
+    QCOMPARE(error, QStringLiteral("Compressed block has an invalid size"));
+
+    // So is one whose qCompress length prefix disagrees with the recorded raw size.
+    QByteArray tamperedPrefix = bytes;
+    qToBigEndian<quint32>(0x7FFFFFFFu,
+                          tamperedPrefix.data() + CompressedGraphFormat::kHeaderSize +
+                              CompressedGraphFormat::kBlockHeaderSize);
+    QVERIFY(writeFile(brokenPath, tamperedPrefix));
+    error.clear();
+    QVERIFY(!GraphSerializer::loadFromFile(&broken, brokenPath, &error));
+    QCOMPARE(error, QStringLiteral("Compressed block has an invalid size"));
+}
+
+void EdaSuite::netlistImportExport() {
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    const auto writeFile = [](const QString& path, const QByteArray& content) {
+        QFile file(path);
+        return file.open(QIODevice::WriteOnly) && file.write(content) == content.size();
+    };
+    const auto edgePorts = [](const GraphDocument& document, const EdgeData& edge) {
+        QString from;
+        QString to;
+        for (const NodeData& node : document.nodes) {
+            for (const PortData& port : node.ports) {
+                const bool output = port.direction == QStringLiteral("output");
+                if (output && node.id == edge.fromNodeId && port.id == edge.fromPortId) {
+                    from = port.name;
+                }
+                if (!output && node.id == edge.toNodeId && port.id == edge.toPortId) {
+                    to = port.name;
+                }
+            }
+        }
+        return from + QStringLiteral("->") + to;
+    };
+
+    const QString edgesPath = tmp.filePath(QStringLiteral("net.csv"));
+    QCOMPARE(NetlistFormats::csvNodeListPath(edgesPath), tmp.filePath(QStringLiteral("net.nodes.csv")));
+    QVERIFY(writeFile(tmp.filePath(QStringLiteral("net.nodes.csv")),
+                      "id,name,type,x,y,vendor\n"
+                      "u1,\"Gate, main\",Voter,10,20,acme\n"
+                      "u2,Filter,SFT,300,20,\n"
+                      "u3,Sink,,,,\"say \"\"hi\"\"\"\n"));
+    QVERIFY(writeFile(edgesPath,
+                      "source,source_port,target,target_port\r\n"
+                      "u1,q,u2,a\r\n"
+                      "u2,,u3,\r\n"
+                      "\r\n"
+                      "u1,q,u3,b\r\n"));
+
+    GraphDocument document;
+    QString error;
+    QVERIFY2(NetlistFormats::importFile(edgesPath, &document, NetlistImportOptions(), &error), qPrintable(error));
+    QCOMPARE(document.nodes.size(), 3);
+    QCOMPARE(document.edges.size(), 3);
+    QCOMPARE(document.nodes[0].id, QStringLiteral("N_1"));
+    QCOMPARE(document.nodes[0].name, QStringLiteral("Gate, main"));
+    QCOMPARE(document.nodes[0].type, QStringLiteral("Voter"));
+    QCOMPARE(document.nodes[0].size, QSizeF(120.0, 80.0));
+    QCOMPARE(document.nodes[0].position, QPointF(10.0, 20.0));
+    QCOMPARE(document.nodes[0].properties.size(), 1);
+    QCOMPARE(document.nodes[0].properties.first().value, QStringLiteral("acme"));
+    QCOMPARE(document.nodes[2].properties.first().value, QStringLiteral("say \"hi\""));
+    // The source port `q` is shared by both edges leaving u1.
+    QCOMPARE(document.nodes[0].ports.size(), 1);
+    QCOMPARE(document.nodes[2].ports.size(), 2);
+    QCOMPARE(edgePorts(document, document.edges[0]), QStringLiteral("q->a"));
+    QCOMPARE(edgePorts(document, document.edges[1]), QStringLiteral("out->in1"));
+    // Nodes without coordinates go below the positioned ones.
+    QVERIFY(document.nodes[2].position.y() > 20.0 + 80.0);
+
+    NetlistImportOptions layered;
+    layered.autoLayout = true;
+    GraphDocument arranged;
+    QVERIFY2(NetlistFormats::importFile(edgesPath, &arranged, layered, &error), qPrintable(error));
+    QCOMPARE(arranged.nodes[0].position.x(), 0.0);
+    QCOMPARE(arranged.nodes[1].position.x(), layered.xSpacing);
+    QCOMPARE(arranged.nodes[2].position.x(), 2 * layered.xSpacing);
+
+    // Fan-in without port names gives each edge its own input, even a second
+    // edge from the same source; self-loops and repeated edges between the
+    // same named ports are dropped and counted.
+    const QString fanInPath = tmp.filePath(QStringLiteral("fanin.csv"));
+    QVERIFY(writeFile(fanInPath,
+                      "source,source_port,target,target_port\n"
+                      "a,,sum,\n"
+                      "b,,sum,\n"
+                      "c,,sum,\n"
+                      "sum,,sum,\n"
+                      "b,,sum,\n"
+                      "b,,sum,x\n"
+                      "b,,sum,x\n"));
+    GraphDocument fanIn;
+    NetlistImportReport report;
+    QVERIFY2(NetlistFormats::importFile(fanInPath, &fanIn, NetlistImportOptions(), &error, &report),
+             qPrintable(error));
+    QCOMPARE(fanIn.edges.size(), 5);
+    QCOMPARE(report.skippedSelfLoops, 1);
+    QCOMPARE(report.skippedDuplicates, 1);
+    QSet<QString> fanInPorts;
+    for (const EdgeData& edge : fanIn.edges) {
+        fanInPorts.insert(edge.toNodeId + QLatin1Char('/') + edge.toPortId);
+    }
+    QCOMPARE(fanInPorts.size(), 5);
+    QCOMPARE(edgePorts(fanIn, fanIn.edges[2]), QStringLiteral("out->in3"));
+    QCOMPARE(edgePorts(fanIn, fanIn.edges[3]), QStringLiteral("out->in4"));
+    QCOMPARE(edgePorts(fanIn, fanIn.edges[4]), QStringLiteral("out->x"));
+
+    // Every format reads back what it wrote.
+    for (const QString& name : {QStringLiteral("out.graphml"), QStringLiteral("out.dot"), QStringLiteral("out.csv")}) {
+        const QString path = tmp.filePath(name);
+        QVERIFY2(NetlistFormats::exportFile(document, path, &error), qPrintable(error));
+        GraphDocument reloaded;
+        QVERIFY2(NetlistFormats::importFile(path, &reloaded, NetlistImportOptions(), &error), qPrintable(error));
+        QCOMPARE(reloaded.nodes.size(), document.nodes.size());
+        QCOMPARE(reloaded.edges.size(), document.edges.size());
+        for (int i = 0; i < document.nodes.size(); ++i) {
+            QCOMPARE(reloaded.nodes[i].name, document.nodes[i].name);
+            QCOMPARE(reloaded.nodes[i].type, document.nodes[i].type);
+            QCOMPARE(reloaded.nodes[i].position, document.nodes[i].position);
+        }
+        QCOMPARE(reloaded.nodes[2].properties.first().value, QStringLiteral("say \"hi\""));
+        for (int i = 0; i < document.edges.size(); ++i) {
+            QCOMPARE(edgePorts(reloaded, reloaded.edges[i]), edgePorts(document, document.edges[i]));
+        }
+    }
+
+    // DOT as other tools write it: comments, defaults, chains, subgraphs,
+    // `node:port` endpoints and attribute forms.
+    const QString dotPath = tmp.filePath(QStringLiteral("design.gv"));
+    QVERIFY(writeFile(dotPath,
+                      "# generated\n"
+                      "strict digraph \"top\" {\n"
+                      "  rankdir=LR; node [type=Sum];\n"
+                      "  /* inputs */ a [label=\"Adder \" + \"A\", pos=\"100,-50!\"];\n"
+                      "  subgraph cluster_0 { b; c [type=SFT] }\n"
+                      "  a -> b:x:n -> c // chain\n"
+                      "  c -> a [tailport=y, headport=<fb>];\n"
+                      "}\n"));
+    GraphDocument dot;
+    QVERIFY2(NetlistFormats::importFile(dotPath, &dot, NetlistImportOptions(), &error), qPrintable(error));
+    QCOMPARE(dot.nodes.size(), 3);
+    QCOMPARE(dot.edges.size(), 3);
+    QCOMPARE(dot.nodes[0].name, QStringLiteral("Adder A"));
+    QCOMPARE(dot.nodes[0].type, QStringLiteral("Sum"));
+    QCOMPARE(dot.nodes[0].position, QPointF(100.0, 50.0));
+    QCOMPARE(dot.nodes[2].type, QStringLiteral("SFT"));
+    QCOMPARE(edgePorts(dot, dot.edges[0]), QStringLiteral("out->x"));
+    QCOMPARE(edgePorts(dot, dot.edges[2]), QStringLiteral("y->fb"));
+
+    QVERIFY(writeFile(dotPath, "digraph { a -> b\n"));
+    error.clear();
+    QVERIFY(!NetlistFormats::importFile(dotPath, &dot, NetlistImportOptions(), &error));
+    QVERIFY(error.contains(QStringLiteral("design.gv")));
+
+    MainWindow window;
+    window.setCriticalMessageProvider([](const QString&, const QString&) {});
+    const int beforeCount = window.documentCount();
+    const int index = window.importNetlist(edgesPath, true);
+    QVERIFY(index >= 0);
+    QCOMPARE(window.documentCount(), beforeCount + 1);
+    QVERIFY(window.isDocumentDirty(index));
+    QVERIFY(window.documentFilePath(index).isEmpty());
+    QCOMPARE(window.activeScene()->nodeCount(), 3);
+    QCOMPARE(window.activeScene()->edgeCount(), 3);
+    QCOMPARE(window.importNetlist(tmp.filePath(QStringLiteral("missing.graphml"))), -1);
+    QCOMPARE(window.documentCount(), beforeCount + 1);
+}
+
 void EdaSuite::stressLargeGraphBuild() {
     EditorScene scene;
     QVector<NodeItem*> created;
@@ -1723,5 +3537,55 @@ void EdaSuite::stressLargeGraphBuild() {
     QCOMPARE(countEdges(scene), 999);
 }
 
+void EdaSuite::stressParallelJsonDecode() {
+    const int cores = static_cast<int>(std::thread::hardware_concurrency());
+    if (cores < 4) {
+        QSKIP("Decode scaling needs at least four cores");
+    }
+
+    GraphDocument src;
+    const int nodeCount = 60000;
+    for (int i = 0; i < nodeCount; ++i) {
+        src.nodes.push_back(NodeData{QStringLiteral("N_%1").arg(i + 1),
+                                     i % 2 == 0 ? QStringLiteral("SFT") : QStringLiteral("tm_Node"),
+                                     QStringLiteral("Node %1").arg(i),
+                                     QPointF(i * 2.0, i * 0.5),
+                                     QSizeF(120.0, 72.0),
+                                     {PortData{QStringLiteral("P_%1").arg(2 * i + 1), QStringLiteral("in1"), QStringLiteral("input")},
+                                      PortData{QStringLiteral("P_%1").arg(2 * i + 2), QStringLiteral("out1"), QStringLiteral("output")}},
+                                     {PropertyData{QStringLiteral("gain"), QStringLiteral("double"), QString::number(i)},
+                                      PropertyData{QStringLiteral("tag"), QStringLiteral("string"), QStringLiteral("T%1").arg(i)}}});
+    }
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    const QString filePath = tmp.filePath(QStringLiteral("decode.json"));
+    QString error;
+    QVERIFY2(GraphSerializer::saveToFile(src, filePath, &error), qPrintable(error));
+
+    // Best of three loads, so a stray scheduling hiccup does not decide it.
+    const auto timeLoad = [&](int threads) {
+        GraphSerializer::setDecodeThreadCount(threads);
+        qint64 best = std::numeric_limits<qint64>::max();
+        for (int run = 0; run < 3; ++run) {
+            GraphDocument loaded;
+            QElapsedTimer timer;
+            timer.start();
+            const bool ok = GraphSerializer::loadFromFile(&loaded, filePath, &error);
+            best = std::min(best, timer.elapsed());
+            if (!ok || loaded.nodes.size() != nodeCount) {
+                return qint64(-1);
+            }
+        }
+        return best;
+    };
+    const qint64 serialMs = timeLoad(1);
+    const qint64 parallelMs = timeLoad(cores);
+    GraphSerializer::setDecodeThreadCount(0);
+    QVERIFY2(serialMs >= 0 && parallelMs >= 0, qPrintable(error));
+    qInfo("JSON load of %d nodes: %lld ms on 1 worker, %lld ms on %d", nodeCount, serialMs, parallelMs, cores);
+    QVERIFY2(parallelMs * 3 < serialMs * 2,
+             qPrintable(QStringLiteral("%1 ms on %2 workers vs %3 ms on one").arg(parallelMs).arg(cores).arg(serialMs)));
+}
+
 QTEST_MAIN(EdaSuite)
 #include "test_suite.moc"